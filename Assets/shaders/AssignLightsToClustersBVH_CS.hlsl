@@ -22,6 +22,7 @@ static const uint NumChildNodes[] = {
 groupshared uint gs_NodeStack[1024];    // This should be enough to push 32 layers of nodes (32 nodes per layer).
 groupshared uint gs_StackPtr;           // The current index in the node stack.
 groupshared uint gs_ParentIndex;        // The index of the parent node in the BVH that is currently being processed.
+groupshared uint gs_NumNodesVisited;    // The number of BVH nodes whose child nodes were tested (for statistics only).
 
 groupshared uint gs_ClusterIndex1D;
 groupshared AABB gs_ClusterAABB;
@@ -96,6 +97,7 @@ void main( ComputeShaderInput IN )
         gs_SpotLightCount = 0;
         gs_StackPtr = 0;
         gs_ParentIndex = 0;
+        gs_NumNodesVisited = 0;
 
         gs_ClusterIndex1D = UniqueClusters[IN.GroupID.x];
         gs_ClusterAABB = ClusterAABBs[gs_ClusterIndex1D];
@@ -135,6 +137,7 @@ void main( ComputeShaderInput IN )
 
         if ( IN.GroupIndex == 0 )
         {
+            ++gs_NumNodesVisited;
             gs_ParentIndex = PopNode();
         }
 
@@ -185,6 +188,7 @@ void main( ComputeShaderInput IN )
 
         if ( IN.GroupIndex == 0 )
         {
+            ++gs_NumNodesVisited;
             gs_ParentIndex = PopNode();
         }
 
@@ -195,6 +199,13 @@ void main( ComputeShaderInput IN )
     // Now update the global light grids with the light lists and light counts.
     if ( IN.GroupIndex == 0 )
     {
+        // Drop the lights that did not fit in the light lists.
+        uint numLights = gs_PointLightCount + gs_SpotLightCount;
+        gs_PointLightCount = min( gs_PointLightCount, MAX_LIGHTS );
+        gs_SpotLightCount = min( gs_SpotLightCount, MAX_LIGHTS );
+
+        RecordLightCullingStats( numLights, gs_PointLightCount, gs_SpotLightCount, numLights - gs_PointLightCount - gs_SpotLightCount, 0, gs_NumNodesVisited );
+
         // Update light grid for point lights.
         InterlockedAdd( RWPointLightIndexCounter_Cluster[0], gs_PointLightCount, gs_PointLightStartOffset );
         RWPointLightGrid_Cluster[gs_ClusterIndex1D] = uint2( gs_PointLightStartOffset, gs_PointLightCount );
@@ -1,6 +1,7 @@
 #include "Include/CommonInclude.hlsli"
 
 #define NUM_THREADS 1024
+#define MAX_LIGHTS 1024
 
 groupshared uint gs_ClusterIndex1D;
 groupshared AABB gs_ClusterAABB;
@@ -9,12 +10,12 @@ groupshared uint gs_PointLightCount;
 groupshared uint gs_SpotLightCount;
 groupshared uint gs_PointLightStartOffset;
 groupshared uint gs_SpotLightStartOffset;
-groupshared uint gs_PointLightList[1024];
-groupshared uint gs_SpotLightList[1024];
+groupshared uint gs_PointLightList[MAX_LIGHTS];
+groupshared uint gs_SpotLightList[MAX_LIGHTS];
 
 #define AppendLight( lightIndex, counter, lightList ) \
     InterlockedAdd( counter, 1, index ); \
-    if ( index < 1024 ) \
+    if ( index < MAX_LIGHTS ) \
     { \
         lightList[index] = lightIndex; \
     }
@@ -73,6 +74,13 @@ void main( ComputeShaderInput IN )
     // Now update the global light grids with the light lists and light counts.
     if ( IN.GroupIndex == 0 )
     {
+        // Drop the lights that did not fit in the light lists.
+        uint numLights = gs_PointLightCount + gs_SpotLightCount;
+        gs_PointLightCount = min( gs_PointLightCount, MAX_LIGHTS );
+        gs_SpotLightCount = min( gs_SpotLightCount, MAX_LIGHTS );
+
+        RecordLightCullingStats( numLights, gs_PointLightCount, gs_SpotLightCount, numLights - gs_PointLightCount - gs_SpotLightCount, 0, 0 );
+
         // Update light grid for point lights.
         InterlockedAdd( RWPointLightIndexCounter_Cluster[0], gs_PointLightCount, gs_PointLightStartOffset );
         RWPointLightGrid_Cluster[gs_ClusterIndex1D] = uint2( gs_PointLightStartOffset, gs_PointLightCount );
@@ -4,6 +4,9 @@
 #define BLOCK_SIZE 16
 #endif
 
+// The maximum number of lights per tile (per light list).
+#define MAX_LIGHTS 1024
+
 typedef uint RenderPass;
 static const RenderPass OPAQUE = 0;
 static const RenderPass TRANSPARENT = 1;
@@ -22,14 +25,14 @@ groupshared uint PointLightIndexStartOffset_OPAQUE;
 groupshared uint PointLightIndexStartOffset_TRANSPARENT;
 groupshared uint SpotLightIndexStartOffset_OPAQUE;
 groupshared uint SpotLightIndexStartOffset_TRANSPARENT;
-groupshared uint PointLightList_OPAQUE[1024];
-groupshared uint PointLightList_TRANSPARENT[1024];
-groupshared uint SpotLightList_OPAQUE[1024];
-groupshared uint SpotLightList_TRANSPARENT[1024];
+groupshared uint PointLightList_OPAQUE[MAX_LIGHTS];
+groupshared uint PointLightList_TRANSPARENT[MAX_LIGHTS];
+groupshared uint SpotLightList_OPAQUE[MAX_LIGHTS];
+groupshared uint SpotLightList_TRANSPARENT[MAX_LIGHTS];
 
 #define AppendLight( lightIndex, counter, lightList ) \
     InterlockedAdd( counter, 1, index ); \
-    if ( index < 1024 ) \
+    if ( index < MAX_LIGHTS ) \
     { \
         lightList[index] = lightIndex; \
     }
@@ -134,6 +137,26 @@ void main( ComputeShaderInput IN )
     // First update the light grid (only thread 0 in group needs to do this)
     if ( IN.GroupIndex == 0 )
     {
+        // The light counts include the lights that did not fit in the light lists.
+        uint numLights = PointLightCount_OPAQUE + SpotLightCount_OPAQUE;
+        uint numOverflowedLights = PointLightCount_OPAQUE + SpotLightCount_OPAQUE;
+        uint numOverflowedTransparentLights = PointLightCount_TRANSPARENT + SpotLightCount_TRANSPARENT;
+
+        // Drop the lights that did not fit in the light lists.
+        PointLightCount_OPAQUE = min( PointLightCount_OPAQUE, MAX_LIGHTS );
+        PointLightCount_TRANSPARENT = min( PointLightCount_TRANSPARENT, MAX_LIGHTS );
+        SpotLightCount_OPAQUE = min( SpotLightCount_OPAQUE, MAX_LIGHTS );
+        SpotLightCount_TRANSPARENT = min( SpotLightCount_TRANSPARENT, MAX_LIGHTS );
+
+        // A light can be dropped from both the opaque and the transparent light lists
+        // so the lists are reported separately.
+        numOverflowedLights -= PointLightCount_OPAQUE + SpotLightCount_OPAQUE;
+        numOverflowedTransparentLights -= PointLightCount_TRANSPARENT + SpotLightCount_TRANSPARENT;
+
+        // All statistics (except the overflow of the transparent light lists) are
+        // recorded for the opaque light lists so they describe the same lists.
+        RecordLightCullingStats( numLights, PointLightCount_OPAQUE, SpotLightCount_OPAQUE, numOverflowedLights, numOverflowedTransparentLights, 0 );
+
         // Update the light grids for point lights
         InterlockedAdd( PointLightIndexCounter_OPAQUE[0], PointLightCount_OPAQUE, PointLightIndexStartOffset_OPAQUE );
         PointLightGrid_OPAQUE[IN.GroupID.xy] = uint2( PointLightIndexStartOffset_OPAQUE, PointLightCount_OPAQUE );
@@ -59,6 +59,16 @@ cbuffer _BVHParamsCB : register( b9 )
     BVHParams BVHParamsCB;
 }
 
+cbuffer _InstanceParamsCB : register( b10 )
+{
+    InstanceParams InstanceParamsCB;
+}
+
+cbuffer _PerViewCB : register( b11 )
+{
+    PerViewData PerViewCB;
+}
+
 /*******************************************************************************
  *
  * Samplers
@@ -158,6 +168,11 @@ StructuredBuffer<AABB> PointLightBVH : register( t31 );
 // Spot light BVH.
 StructuredBuffer<AABB> SpotLightBVH : register( t32 );
 
+// The per-object data of all the objects in the scene.
+StructuredBuffer<ObjectData> Objects : register( t33 );
+// The index of the object of each instance of the draws in a pass.
+StructuredBuffer<uint> InstanceObjects : register( t34 );
+
 
 /*******************************************************************************
  *
@@ -269,3 +284,9 @@ RWStructuredBuffer<AABB> RWSpotLightBVH : register( u34 );
 
 // Used for displaying the light counts for clustered shading.
 RWTexture2D<uint2> RWLightCounts : register( u35 );
+
+/**
+ * Light culling statistics (see RecordLightCullingStats in Functions.hlsli).
+ * The layout must match LightCullingMetrics::Counter in LightCullingMetrics.h.
+ */
+RWStructuredBuffer<uint> RWLightCullingStats : register( u36 );
@@ -2,6 +2,27 @@
 #error Do not include this header directly. Only include this file via CommonInclude.hlsli.
 #endif
 
+// Get the per-object data for a vertex of a scene mesh.
+// Every draw (instanced or not) looks up the object of the instance in the 
+// instance buffer. SV_InstanceID does not include the start instance 
+// location of the draw so the first instance is passed in a root constant.
+PerObjectData GetPerObjectData( uint instanceID )
+{
+    ObjectData object = Objects[InstanceObjects[InstanceParamsCB.FirstInstance + instanceID]];
+
+    PerObjectData perObjectData;
+    perObjectData.Model = object.Model;
+    perObjectData.View = PerViewCB.View;
+    perObjectData.InverseView = PerViewCB.InverseView;
+    perObjectData.Projection = PerViewCB.Projection;
+    perObjectData.ModelView = mul( PerViewCB.View, object.Model );
+    perObjectData.ModelViewProjection = mul( PerViewCB.ViewProjection, object.Model );
+    perObjectData.InverseTransposeModel = object.InverseTransposeModel;
+    perObjectData.InverseTransposeModelView = mul( PerViewCB.View, object.InverseTransposeModel );
+
+    return perObjectData;
+}
+
 float3 ExpandNormal( float3 n )
 {
     return n * 2.0f - 1.0f;
@@ -336,4 +357,42 @@ bool IntersectLinePlane( float3 a, float3 b, Plane p, out float3 q )
     }
 
     return intersect;
-}
\ No newline at end of file
+}
+
+// Indices of the counters in the light culling statistics buffer.
+// These must match LightCullingMetrics::Counter in LightCullingMetrics.h.
+static const uint LIGHT_CULLING_STATS_NUM_CELLS = 0;
+static const uint LIGHT_CULLING_STATS_NUM_POINT_LIGHT_INDICES = 1;
+static const uint LIGHT_CULLING_STATS_NUM_SPOT_LIGHT_INDICES = 2;
+static const uint LIGHT_CULLING_STATS_NUM_OVERFLOWED_LIGHTS = 3;
+static const uint LIGHT_CULLING_STATS_NUM_OVERFLOWED_TRANSPARENT_LIGHTS = 4;
+static const uint LIGHT_CULLING_STATS_NUM_BVH_NODES_VISITED = 5;
+static const uint LIGHT_CULLING_STATS_MAX_LIGHTS_PER_CELL = 6;
+static const uint LIGHT_CULLING_STATS_HISTOGRAM = 7;
+static const uint LIGHT_CULLING_STATS_NUM_HISTOGRAM_BINS = 13;
+
+/**
+ * Record the light culling statistics of a single cell (a tile or a cluster).
+ * This function should only be called by a single thread of the thread group.
+ * The histogram bins are powers of two: bin 0 counts the cells without lights,
+ * bin i counts the cells with [2^(i-1), 2^i) lights and the last bin counts
+ * all cells with more lights.
+ * numLights is the number of lights that overlap the cell (including the
+ * lights that did not fit in the group shared light lists).
+ * Techniques with separate light lists for transparent geometry report the
+ * lights that were dropped from those lists in numOverflowedTransparentLights
+ * (a light that is dropped from both lists is counted in both).
+ */
+void RecordLightCullingStats( uint numLights, uint numPointLightIndices, uint numSpotLightIndices, uint numOverflowedLights, uint numOverflowedTransparentLights, uint numBVHNodesVisited )
+{
+    uint bin = numLights > 0 ? min( firstbithigh( numLights ) + 1, LIGHT_CULLING_STATS_NUM_HISTOGRAM_BINS - 1 ) : 0;
+
+    InterlockedAdd( RWLightCullingStats[LIGHT_CULLING_STATS_NUM_CELLS], 1 );
+    InterlockedAdd( RWLightCullingStats[LIGHT_CULLING_STATS_NUM_POINT_LIGHT_INDICES], numPointLightIndices );
+    InterlockedAdd( RWLightCullingStats[LIGHT_CULLING_STATS_NUM_SPOT_LIGHT_INDICES], numSpotLightIndices );
+    InterlockedAdd( RWLightCullingStats[LIGHT_CULLING_STATS_NUM_OVERFLOWED_LIGHTS], numOverflowedLights );
+    InterlockedAdd( RWLightCullingStats[LIGHT_CULLING_STATS_NUM_OVERFLOWED_TRANSPARENT_LIGHTS], numOverflowedTransparentLights );
+    InterlockedAdd( RWLightCullingStats[LIGHT_CULLING_STATS_NUM_BVH_NODES_VISITED], numBVHNodesVisited );
+    InterlockedMax( RWLightCullingStats[LIGHT_CULLING_STATS_MAX_LIGHTS_PER_CELL], numLights );
+    InterlockedAdd( RWLightCullingStats[LIGHT_CULLING_STATS_HISTOGRAM + bin], 1 );
+}
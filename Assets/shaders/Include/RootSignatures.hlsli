@@ -8,7 +8,7 @@
  */
 
 // Simple Shading
-// 0. cbuffer _PerObjectCB : register( b0 )
+// 0. cbuffer _PerViewCB : register( b11 )
 // 1. cbuffer _MaterialCB : register( b1 )
 // 2. cbuffer _LightCountsCB : register( b2 )
 // 3. Texture2D AmbientTexture        : register( t0 );
@@ -23,16 +23,22 @@
 //    StructuredBuffer<PointLight> PointLights : register( t8 );
 //    StructuredBuffer<SpotLight> SpotLights : register( t9 );
 //    StructuredBuffer<DirectionalLight> DirectionalLights : register( t10 );
+// 4. cbuffer _InstanceParamsCB : register( b10 )
+// 5. StructuredBuffer<ObjectData> Objects : register( t33 );
+// 6. StructuredBuffer<uint> InstanceObjects : register( t34 );
 // Samplers:
 //    SamplerState LinearRepeatSampler     : register( s0 );
 //    SamplerState LinearClampSampler      : register( s1 );
 //    SamplerState AnisotropicSampler      : register( s2 );
 #define SimpleVS_RS \
     "RootFlags(ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT)," \
-    "CBV(b0, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "CBV(b11, visibility = SHADER_VISIBILITY_VERTEX)," \
     "CBV(b1, visibility = SHADER_VISIBILITY_PIXEL)," \
     "RootConstants(num32BitConstants=3, b2, visibility = SHADER_VISIBILITY_PIXEL)," \
     "DescriptorTable(SRV(t0, numDescriptors=11), visibility=SHADER_VISIBILITY_PIXEL)," \
+    "RootConstants(num32BitConstants=1, b10, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t33, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t34, visibility = SHADER_VISIBILITY_VERTEX)," \
     "StaticSampler(s0, filter=FILTER_MIN_MAG_MIP_LINEAR, visibility=SHADER_VISIBILITY_PIXEL)," \
     "StaticSampler(s1, filter=FILTER_MIN_MAG_MIP_LINEAR," \
                       "addressU=TEXTURE_ADDRESS_CLAMP," \
@@ -63,7 +69,7 @@
                       "visibility = SHADER_VISIBILITY_PIXEL)"
 
 // Forward Shading
-// 0. cbuffer _PerObjectCB : register( b0 )
+// 0. cbuffer _PerViewCB : register( b11 )
 // 1. cbuffer _MaterialCB : register( b1 )
 // 2. cbuffer _LightCountsCB : register( b2 )
 // 3. Texture2D AmbientTexture        : register( t0 );
@@ -78,16 +84,22 @@
 //    StructuredBuffer<PointLight> PointLights : register( t8 );
 //    StructuredBuffer<SpotLight> SpotLights : register( t9 );
 //    StructuredBuffer<DirectionalLight> DirectionalLights : register( t10 );
+// 4. cbuffer _InstanceParamsCB : register( b10 )
+// 5. StructuredBuffer<ObjectData> Objects : register( t33 );
+// 6. StructuredBuffer<uint> InstanceObjects : register( t34 );
 // Samplers: 
 //    SamplerState LinearRepeatSampler     : register( s0 );
 //    SamplerState LinearClampSampler      : register( s1 );
 //    SamplerState AnisotropicSampler      : register( s2 );
 #define ForwardVS_RS \
     "RootFlags(ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT)," \
-    "CBV(b0, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "CBV(b11, visibility = SHADER_VISIBILITY_VERTEX)," \
     "CBV(b1, visibility = SHADER_VISIBILITY_PIXEL)," \
     "RootConstants(num32BitConstants=3, b2, visibility = SHADER_VISIBILITY_PIXEL)," \
     "DescriptorTable(SRV(t0, numDescriptors=11), visibility=SHADER_VISIBILITY_PIXEL)," \
+    "RootConstants(num32BitConstants=1, b10, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t33, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t34, visibility = SHADER_VISIBILITY_VERTEX)," \
     "StaticSampler(s0, filter=FILTER_MIN_MAG_MIP_LINEAR, visibility=SHADER_VISIBILITY_PIXEL)," \
     "StaticSampler(s1, filter=FILTER_MIN_MAG_MIP_LINEAR," \
                       "addressU=TEXTURE_ADDRESS_CLAMP," \
@@ -98,7 +110,7 @@
                       "visibility = SHADER_VISIBILITY_PIXEL)"
 
 // Forward+ Shading
-// 0. cbuffer _PerObjectCB : register( b0 )
+// 0. cbuffer _PerViewCB : register( b11 )
 // 1. cbuffer _MaterialCB : register( b1 )
 // 2. cbuffer _LightCountsCB : register( b2 )
 // 3. Texture2D AmbientTexture        : register( t0 );
@@ -117,16 +129,22 @@
 //    StructuredBuffer<uint> SpotLightIndexList : register( t12 );
 //    Texture2D<uint2> PointLightGrid : register( t13 );
 //    Texture2D<uint2> SpotLightGrid : register( t14 );
+// 4. cbuffer _InstanceParamsCB : register( b10 )
+// 5. StructuredBuffer<ObjectData> Objects : register( t33 );
+// 6. StructuredBuffer<uint> InstanceObjects : register( t34 );
 // Samplers
 //    SamplerState LinearRepeatSampler     : register( s0 );
 //    SamplerState LinearClampSampler      : register( s1 );
 //    SamplerState AnisotropicSampler      : register( s2 );
 #define ForwardPlusVS_RS \
     "RootFlags(ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT)," \
-    "CBV(b0, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "CBV(b11, visibility = SHADER_VISIBILITY_VERTEX)," \
     "CBV(b1, visibility = SHADER_VISIBILITY_PIXEL)," \
     "RootConstants(num32BitConstants=3, b2, visibility = SHADER_VISIBILITY_PIXEL)," \
     "DescriptorTable(SRV(t0, numDescriptors=15), visibility=SHADER_VISIBILITY_PIXEL)," \
+    "RootConstants(num32BitConstants=1, b10, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t33, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t34, visibility = SHADER_VISIBILITY_VERTEX)," \
     "StaticSampler(s0, filter=FILTER_MIN_MAG_MIP_LINEAR, visibility=SHADER_VISIBILITY_PIXEL)," \
     "StaticSampler(s1, filter=FILTER_MIN_MAG_MIP_LINEAR," \
                       "addressU=TEXTURE_ADDRESS_CLAMP," \
@@ -137,7 +155,7 @@
                       "visibility = SHADER_VISIBILITY_PIXEL)"
 
 // Clustered Shading
-// 0. cbuffer _PerObjectCB : register( b0 )
+// 0. cbuffer _PerViewCB : register( b11 )
 // 1. cbuffer _MaterialCB : register( b1 )
 // 2. cbuffer _LightCountsCB : register( b2 )
 // 3. Texture2D AmbientTexture        : register( t0 );
@@ -158,17 +176,23 @@
 //    StructuredBuffer<uint2> PointLightGrid_Cluster : register( t23 );
 //    StructuredBuffer<uint2> SpotLightGrid_Cluster : register( t24 );
 // 4. cbuffer _ClusterDataCB : register( b5 )
+// 5. cbuffer _InstanceParamsCB : register( b10 )
+// 6. StructuredBuffer<ObjectData> Objects : register( t33 );
+// 7. StructuredBuffer<uint> InstanceObjects : register( t34 );
 // Samplers
 //    SamplerState LinearRepeatSampler     : register( s0 );
 //    SamplerState LinearClampSampler      : register( s1 );
 //    SamplerState AnisotropicSampler      : register( s2 );
 #define ClusteredVS_RS \
     "RootFlags(ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT)," \
-    "CBV(b0, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "CBV(b11, visibility = SHADER_VISIBILITY_VERTEX)," \
     "CBV(b1, visibility = SHADER_VISIBILITY_PIXEL)," \
     "RootConstants(num32BitConstants=3, b2, visibility = SHADER_VISIBILITY_PIXEL)," \
     "DescriptorTable(SRV(t0, numDescriptors=11), SRV(t21, numDescriptors=4), visibility=SHADER_VISIBILITY_PIXEL)," \
     "RootConstants(num32BitConstants=8, b5, visibility = SHADER_VISIBILITY_PIXEL)," \
+    "RootConstants(num32BitConstants=1, b10, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t33, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t34, visibility = SHADER_VISIBILITY_VERTEX)," \
     "StaticSampler(s0, filter=FILTER_MIN_MAG_MIP_LINEAR, visibility=SHADER_VISIBILITY_PIXEL)," \
     "StaticSampler(s1, filter=FILTER_MIN_MAG_MIP_LINEAR," \
                       "addressU=TEXTURE_ADDRESS_CLAMP," \
@@ -180,16 +204,22 @@
 
 
 // Cluster Samples
-// 0. cbuffer _PerObjectCB : register( b0 )
+// 0. cbuffer _PerViewCB : register( b11 )
 // 1. cbuffer _ClusterDataCB : register( b5 )
 // 2. Material textures t0-t7, RWStructuredBuffer<bool> RWClusterFlags : register( u4 );
 // 3. StructuredBuffer<float4> ClusterColors
+// 4. cbuffer _InstanceParamsCB : register( b10 )
+// 5. StructuredBuffer<ObjectData> Objects : register( t33 );
+// 6. StructuredBuffer<uint> InstanceObjects : register( t34 );
 #define ClusterSamples_RS \
     "RootFlags(ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT)," \
-    "CBV(b0, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "CBV(b11, visibility = SHADER_VISIBILITY_VERTEX)," \
     "RootConstants(num32BitConstants=8, b5, visibility = SHADER_VISIBILITY_PIXEL)," \
     "DescriptorTable(SRV(t0, numDescriptors=8),UAV(u4), visibility=SHADER_VISIBILITY_PIXEL)," \
-    "DescriptorTable(SRV(t15), visibility=SHADER_VISIBILITY_PIXEL )"
+    "DescriptorTable(SRV(t15), visibility=SHADER_VISIBILITY_PIXEL )," \
+    "RootConstants(num32BitConstants=1, b10, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t33, visibility = SHADER_VISIBILITY_VERTEX)," \
+    "SRV(t34, visibility = SHADER_VISIBILITY_VERTEX)"
 
 // Compute Cluster AABBs
 // 0. cbuffer CameraParamsCB : register( b3 )
@@ -249,12 +279,13 @@
 //    RWTexture2D<uint2> SpotLightGrid_OPAQUE : register( u17 );
 //    RWTexture2D<uint2> SpotLightGrid_TRANSPARENT : register( u18 );
 //------------------------------------------------------------------------------
+//    RWStructuredBuffer<uint> RWLightCullingStats : register( u36 );
 #define CullLights_RS \
     "RootFlags(0)," \
     "RootConstants(num32BitConstants=3,b2)," \
     "CBV(b3)," \
     "RootConstants(num32BitConstants=8, b4)," \
-    "DescriptorTable(SRV(t8, numDescriptors=3),SRV(t18, numDescriptors=3),UAV(u6, numDescriptors=13))," \
+    "DescriptorTable(SRV(t8, numDescriptors=3),SRV(t18, numDescriptors=3),UAV(u6, numDescriptors=13),UAV(u36))," \
     "StaticSampler(s1, filter=FILTER_MIN_MAG_MIP_LINEAR," \
                       "addressU=TEXTURE_ADDRESS_CLAMP," \
                       "addressV=TEXTURE_ADDRESS_CLAMP)"
@@ -273,10 +304,12 @@
 //    RWStructuredBuffer<uint2> RWSpotLightGrid_Cluster : register( u22 );
 //    RWStructuredBuffer<uint> RWPointLightIndexList_Cluster : register( u23 );
 //    RWStructuredBuffer<uint> RWSpotLightIndexList_Cluster : register( u24 );
+//------------------------------------------------------------------------------
+//    RWStructuredBuffer<uint> RWLightCullingStats : register( u36 );
 #define AssignLightsToClusters_RS \
     "RootFlags(0)," \
     "RootConstants(num32BitConstants=3,b2)," \
-    "DescriptorTable( SRV( t8, numDescriptors=2), SRV( t16, numDescriptors=2 ), UAV( u19, numDescriptors=6 ) )"
+    "DescriptorTable( SRV( t8, numDescriptors=2), SRV( t16, numDescriptors=2 ), UAV( u19, numDescriptors=6 ), UAV( u36 ) )"
 
 // Assign Lights to Clusters (BVH)
 // 0. cbuffer _BVHParamsCB : register( b9 )
@@ -298,11 +331,13 @@
 //    RWStructuredBuffer<uint2> RWSpotLightGrid_Cluster : register( u22 );
 //    RWStructuredBuffer<uint> RWPointLightIndexList_Cluster : register( u23 );
 //    RWStructuredBuffer<uint> RWSpotLightIndexList_Cluster : register( u24 );
+//------------------------------------------------------------------------------
+//    RWStructuredBuffer<uint> RWLightCullingStats : register( u36 );
 #define AssignLightsToClustersBVH_RS \
     "RootFlags(0)," \
     "RootConstants(num32BitConstants=3,b9)," \
     "RootConstants(num32BitConstants=3,b2)," \
-    "DescriptorTable( SRV( t8, numDescriptors=2), SRV( t16, numDescriptors=2 ), SRV( t29, numDescriptors=4 ), UAV( u19, numDescriptors=6 ) )"
+    "DescriptorTable( SRV( t8, numDescriptors=2), SRV( t16, numDescriptors=2 ), SRV( t29, numDescriptors=4 ), UAV( u19, numDescriptors=6 ), UAV( u36 ) )"
 
 // Debug Lights
 // 0. cbuffer _PerObjectCB : register( b0 )
@@ -157,6 +157,28 @@ struct PerObjectData
     float4x4 InverseTransposeModelView;
 };
 
+// The view and projection matrices are stored once per view (pass)
+// instead of once per object.
+struct PerViewData
+{
+    float4x4 View;
+    float4x4 InverseView;
+    float4x4 Projection;
+    float4x4 ViewProjection;
+};
+
+// The per-object data is computed once per frame and shared by all passes.
+struct ObjectData
+{
+    float4x4 Model;
+    float4x4 InverseTransposeModel;
+};
+
+struct InstanceParams
+{
+    uint FirstInstance;     // The index of the first instance of the draw in the instance buffer.
+};
+
 struct ClusterData
 {
     uint3 GridDim;      // The 3D dimensions of the cluster grid.
@@ -0,0 +1,31 @@
+@echo off
+REM Run the benchmark sweep (the Benchmark settings) of a .3dgep configuration file
+REM or of every .3dgep configuration file in this folder if no file is specified.
+REM The reports are written to a new folder in the Perf folder.
+REM Add --culling-only to only benchmark the light culling and light assignment stages.
+REM Usage: Benchmark_Win10_Rel_x64.bat [configuration.3dgep] [--culling-only]
+
+pushd .
+
+SET CONFIG_FILE=%~f1
+SET OPTIONS=%2
+IF "%~1"=="--culling-only" (
+    SET CONFIG_FILE=
+    SET OPTIONS=--culling-only
+)
+
+cd "%~dp0..\bin"
+
+SET EXE_PATH="%CD%\Release\Game.exe"
+
+IF NOT "%CONFIG_FILE%"=="" (
+    ECHO Benchmarking %~nx1
+    START "" /WAIT /D "%CD%" %EXE_PATH% -c "%CONFIG_FILE%" --benchmark %OPTIONS%
+) ELSE (
+    FOR %%F IN ("%~dp0*.3dgep") DO (
+        ECHO Benchmarking %%~nxF
+        START "" /WAIT /D "%CD%" %EXE_PATH% -c "%%~fF" --benchmark %OPTIONS%
+    )
+)
+
+popd
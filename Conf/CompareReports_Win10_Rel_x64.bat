@@ -0,0 +1,30 @@
+@echo off
+REM Compare two benchmark reports (.json files written next to the
+REM performance data in the Perf folder) and report the regressions.
+REM Usage: CompareReports_Win10_Rel_x64.bat <baseline.json> <candidate.json> [threshold in percent]
+REM The results are written to Game.log. The exit code is 1 if a regression was found.
+
+IF "%~2"=="" (
+    ECHO Usage: %~nx0 ^<baseline.json^> ^<candidate.json^> [threshold]
+    EXIT /B -1
+)
+
+SET THRESHOLD=%~3
+IF "%THRESHOLD%"=="" SET THRESHOLD=5
+
+pushd .
+
+cd "%~dp0..\bin"
+
+SET EXE_PATH="%CD%\Release\Game.exe"
+
+START "" /WAIT /D "%CD%" %EXE_PATH% --compare-reports "%~f1" "%~f2" --threshold %THRESHOLD%
+SET RESULT=%ERRORLEVEL%
+
+IF %RESULT%==0 ECHO No regressions found.
+IF %RESULT%==1 ECHO Regressions found. See bin\Release\Game.log for details.
+IF %RESULT% LSS 0 ECHO Failed to compare the reports. See bin\Release\Game.log for details.
+
+popd
+
+EXIT /B %RESULT%
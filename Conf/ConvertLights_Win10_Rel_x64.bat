@@ -0,0 +1,17 @@
+@echo off
+REM Move the lights of every .3dgep configuration file in this folder
+REM to a binary light set (.lights) file next to the configuration file.
+REM Configuration files that already use a light set file are re-saved.
+
+pushd .
+
+cd "%~dp0..\bin"
+
+SET EXE_PATH="%CD%\Release\Game.exe"
+
+FOR %%F IN ("%~dp0*.3dgep") DO (
+    ECHO Converting %%~nxF
+    START "" /WAIT /D "%CD%" %EXE_PATH% -c "%%~fF" --convert-lights
+)
+
+popd
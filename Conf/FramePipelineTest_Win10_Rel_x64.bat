@@ -0,0 +1,13 @@
+@echo off
+REM Run the update and render stages of the frame pipeline with 0 to 3 frames in flight
+REM (without a device) and check the order and the lifetime of the frames.
+REM The results are written to the log. The exit code is 0 if all checks passed.
+REM Usage: FramePipelineTest_Win10_Rel_x64.bat
+
+pushd .
+
+cd "%~dp0..\bin"
+
+START "" /WAIT /D "%CD%" "%CD%\Release\Game.exe" --frame-pipeline-test
+
+popd
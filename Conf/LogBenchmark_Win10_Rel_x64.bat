@@ -0,0 +1,12 @@
+@echo off
+REM Measure the time LOG_INFO takes on the calling thread and count the wakeups of the idle log thread.
+REM The results are written to "Log Benchmark.csv" in the Perf folder.
+REM Usage: LogBenchmark_Win10_Rel_x64.bat
+
+pushd .
+
+cd "%~dp0..\bin"
+
+START "" /WAIT /D "%CD%" "%CD%\Release\Game.exe" --log-benchmark
+
+popd
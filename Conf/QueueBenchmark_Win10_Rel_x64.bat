@@ -0,0 +1,12 @@
+@echo off
+REM Measure the throughput of the thread safe queues with 1 to 64 producer threads.
+REM The results are written to "Queue Benchmark.csv" in the Perf folder.
+REM Usage: QueueBenchmark_Win10_Rel_x64.bat
+
+pushd .
+
+cd "%~dp0..\bin"
+
+START "" /WAIT /D "%CD%" "%CD%\Release\Game.exe" --queue-benchmark
+
+popd
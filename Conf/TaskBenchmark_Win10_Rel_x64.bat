@@ -0,0 +1,15 @@
+@echo off
+REM Compare the task scheduler with std::async and OpenMP on CPU workloads of the engine.
+REM The results are written to "<configuration> Task Scheduler Benchmark.csv" in the Perf folder.
+REM Usage: TaskBenchmark_Win10_Rel_x64.bat [configuration.3dgep]
+
+pushd .
+
+SET CONFIG_FILE=%~f1
+IF "%CONFIG_FILE%"=="" SET CONFIG_FILE=%~dp0DefaultConfiguration.3dgep
+
+cd "%~dp0..\bin"
+
+START "" /WAIT /D "%CD%" "%CD%\Release\Game.exe" -c "%CONFIG_FILE%" --task-benchmark
+
+popd
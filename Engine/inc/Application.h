@@ -34,6 +34,7 @@
 #include "Common.h"
 #include "Events.h"
 #include "ReadDirectoryChanges.h"
+#include "FramePipeline.h"
 #include "Graphics/TextureFormat.h"
 
 #if defined(CreateWindow)
@@ -108,6 +109,18 @@ namespace Core
          */
         void RegisterDirectoryChangeListener( const std::wstring& dir, bool recursive = true );
 
+        /**
+         * The pipeline that runs the update and render stages of the frames.
+         * Set the latency of the pipeline before the application is run. With a latency
+         * greater than 0, frames are rendered on a separate thread while the next frame
+         * is updated, so update handlers must only pass data to render handlers through
+         * the frame context.
+         */
+        FramePipeline& GetFramePipeline()
+        {
+            return m_FramePipeline;
+        }
+
         /**
          * Run the application.
          */
@@ -267,6 +280,8 @@ namespace Core
 
         double m_FixedTimestep;
 
+        FramePipeline m_FramePipeline;
+
     private:
 
         // Directory change listener thread entry point.
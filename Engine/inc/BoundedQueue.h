@@ -0,0 +1,152 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file BoundedQueue.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief A blocking thread safe queue with a fixed capacity.
+ */
+
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+
+namespace Core
+{
+    /**
+     * A queue that blocks producers when it is full and consumers when it is empty.
+     * The queue can be closed to release all blocked threads.
+     */
+    template<typename T>
+    class BoundedQueue
+    {
+    public:
+        explicit BoundedQueue( size_t capacity );
+
+        /**
+         * Push a value into the back of the queue.
+         * Blocks while the queue is full.
+         * @returns false if the queue was closed.
+         */
+        bool Push( T value );
+
+        /**
+         * Pop a value from the front of the queue.
+         * Blocks while the queue is empty.
+         * @returns false if the queue is closed and empty.
+         */
+        bool Pop( T& value );
+
+        /**
+         * Close the queue. Values that are already in the queue can still be popped
+         * but new values are rejected.
+         */
+        void Close();
+
+        bool IsClosed() const;
+
+        /**
+         * Retrieve the number of items in the queue.
+         */
+        size_t Size() const;
+
+    private:
+        std::queue<T> m_Queue;
+        size_t m_Capacity;
+        bool m_Closed;
+
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_NotFull;
+        std::condition_variable m_NotEmpty;
+    };
+
+    template<typename T>
+    BoundedQueue<T>::BoundedQueue( size_t capacity )
+        : m_Capacity( std::max<size_t>( capacity, 1 ) )
+        , m_Closed( false )
+    {}
+
+    template<typename T>
+    bool BoundedQueue<T>::Push( T value )
+    {
+        std::unique_lock<std::mutex> lock( m_Mutex );
+        m_NotFull.wait( lock, [this]() { return m_Closed || m_Queue.size() < m_Capacity; } );
+
+        if ( m_Closed )
+            return false;
+
+        m_Queue.push( std::move( value ) );
+        lock.unlock();
+
+        m_NotEmpty.notify_one();
+
+        return true;
+    }
+
+    template<typename T>
+    bool BoundedQueue<T>::Pop( T& value )
+    {
+        std::unique_lock<std::mutex> lock( m_Mutex );
+        m_NotEmpty.wait( lock, [this]() { return m_Closed || !m_Queue.empty(); } );
+
+        if ( m_Queue.empty() )
+            return false;
+
+        value = std::move( m_Queue.front() );
+        m_Queue.pop();
+        lock.unlock();
+
+        m_NotFull.notify_one();
+
+        return true;
+    }
+
+    template<typename T>
+    void BoundedQueue<T>::Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_Mutex );
+            m_Closed = true;
+        }
+
+        m_NotFull.notify_all();
+        m_NotEmpty.notify_all();
+    }
+
+    template<typename T>
+    bool BoundedQueue<T>::IsClosed() const
+    {
+        std::lock_guard<std::mutex> lock( m_Mutex );
+        return m_Closed;
+    }
+
+    template<typename T>
+    size_t BoundedQueue<T>::Size() const
+    {
+        std::lock_guard<std::mutex> lock( m_Mutex );
+        return m_Queue.size();
+    }
+}
@@ -33,6 +33,7 @@
 #include <string>
 #include <locale>
 #include <codecvt>
+#include <ctime>
 
 #include "EngineDefines.h"
 #include "bitmask_operators.hpp"
@@ -175,6 +176,52 @@ namespace Core
         return converter.to_bytes( wstring );
     }
 
+    // Escape a (UTF-8) string for use in a JSON string literal.
+    inline std::string EscapeJSON( const std::string& string )
+    {
+        std::string escaped;
+        escaped.reserve( string.size() );
+        for ( char c : string )
+        {
+            switch ( c )
+            {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            default:
+                if ( static_cast<unsigned char>( c ) < 0x20 )
+                {
+                    char buffer[8];
+                    sprintf_s( buffer, "\\u%04x", c );
+                    escaped += buffer;
+                }
+                else
+                {
+                    escaped += c;
+                }
+                break;
+            }
+        }
+
+        return escaped;
+    }
+
+    // The current local time (year-month-day-hour-minute-second) for naming report files.
+    inline std::string GetTimestampString()
+    {
+        char buffer[80];
+        auto time = std::time( nullptr );
+        std::tm timeInfo;
+        localtime_s( &timeInfo, &time );
+
+        std::strftime( buffer, 80, "%Y-%m-%d-%H-%M-%S", &timeInfo );
+
+        return buffer;
+    }
+
     // Gets a string resource from the module's resources.
     ENGINE_DLL std::string GetStringResource( int ID, const std::string& type );
 
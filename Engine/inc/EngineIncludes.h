@@ -8,8 +8,10 @@
 #include "HighResolutionTimer.h"
 #include "LogManager.h"
 #include "LogStream.h"
+#include "FramePipeline.h"
 #include "Application.h"
 #include "SceneVisitor.h"
+#include "TaskScheduler.h"
 #include "ProfilerVisitor.h"
 #include "GUI/GUI.h"
 #include "Graphics/Profiler.h"
@@ -42,9 +44,16 @@
 #include "Graphics/StructuredBuffer.h"
 #include "Graphics/ReadbackBuffer.h"
 #include "Graphics/Mesh.h"
+#include "Graphics/Meshlet.h"
+#include "Graphics/MeshLOD.h"
+#include "Graphics/DrawList.h"
+#include "Graphics/Frustum.h"
+#include "Graphics/BVH.h"
 #include "Graphics/Material.h"
 #include "Graphics/Scene.h"
+#include "Graphics/SceneMeshList.h"
 #include "Graphics/SceneNode.h"
+#include "Graphics/TransformHierarchy.h"
 #include "Graphics/Shader.h"
 #include "Graphics/ShaderParameter.h"
 #include "Graphics/ShaderSignature.h"
@@ -52,7 +61,9 @@
 #include "Graphics/Sampler.h"
 #include "Graphics/ClearColor.h"
 #include "Graphics/RenderTarget.h"
+#include "Graphics/ResourceRegistry.h"
 #include "Graphics/Query.h"
 #include "Graphics/PointLight.h"
 #include "Graphics/SpotLight.h"
 #include "Graphics/DirectionalLight.h"
+#include "Graphics/LightSet.h"
@@ -44,6 +44,7 @@ namespace Graphics
 namespace Core
 {
     class Object;
+    class FrameContext;
 
     // Delegate template class for encapsulating event callback functions.
     template< typename... ArgumentTypes >
@@ -412,11 +413,15 @@ namespace Core
             , ElapsedTime( fDeltaTime )
             , TotalTime( fTotalTime )
             , FrameCounter( frameCounter )
+            , Frame( nullptr )
         {}
 
         double ElapsedTime;
         double TotalTime;
         uint64_t FrameCounter;
+
+        // The frame context of the frame that is updated (see FramePipeline).
+        FrameContext* Frame;
     };
     ENGINE_EXTERN template class ENGINE_DLL Delegate<UpdateEventArgs&>;
     using UpdateEvent = Delegate<UpdateEventArgs&>;
@@ -435,6 +440,8 @@ namespace Core
             , FrameCounter( frameCounter )
             , Camera( camera )
             , GraphicsCommandBuffer( graphicsCommandBuffer )
+            , LODPixelError( 0.0f )
+            , Frame( nullptr )
         {}
 
         double ElapsedTime;
@@ -443,6 +450,13 @@ namespace Core
         
         std::shared_ptr<Graphics::Camera> Camera;
         std::shared_ptr<Graphics::GraphicsCommandBuffer> GraphicsCommandBuffer;
+
+        // The maximum screen space error (in pixels) that is allowed when 
+        // selecting the level of detail of meshes. 0 disables level of detail selection.
+        float LODPixelError;
+
+        // The frame context of the frame that is rendered (see FramePipeline).
+        FrameContext* Frame;
     };
     ENGINE_EXTERN template class ENGINE_DLL Delegate<RenderEventArgs&>;
     using RenderEvent = Delegate<RenderEventArgs&>;
@@ -0,0 +1,187 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file FramePipeline.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Pipelines the update and render stages of frames.
+ */
+
+
+
+#include "EngineDefines.h"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Core
+{
+    class FramePipeline;
+
+    /**
+     * The data of one frame in the frame pipeline. The update stage fills in
+     * the frame context and the render stage consumes it. Frame contexts are
+     * kept in a ring and reused for later frames.
+     */
+    class ENGINE_DLL FrameContext
+    {
+    public:
+        explicit FrameContext( uint32_t index );
+
+        // The index of the frame context in the ring.
+        uint32_t GetIndex() const;
+
+        // The frame that currently uses the frame context.
+        uint64_t GetFrameCounter() const;
+
+        /**
+         * Add a function that the render stage runs before the frame is rendered.
+         * Use this for GPU work that is recorded by the update stage but must be
+         * submitted in frame order (for example, updating the light buffers).
+         * The functions run in the order they were added.
+         */
+        void Defer( std::function<void()> function );
+
+        /**
+         * Add a function that runs before the frame context is reused for a later
+         * frame (for example, to wait for the GPU or release per-frame resources).
+         */
+        void OnRelease( std::function<void()> function );
+
+        // The time since the previous frame (in seconds).
+        double ElapsedTime;
+        // The time since the application started (in seconds).
+        double TotalTime;
+
+    private:
+        friend class FramePipeline;
+
+        void Begin( uint64_t frameCounter );
+        void RunDeferred();
+        void Release();
+
+        uint32_t m_Index;
+        uint64_t m_FrameCounter;
+
+        std::vector< std::function<void()> > m_Deferred;
+        std::vector< std::function<void()> > m_OnRelease;
+    };
+
+    /**
+     * Runs the update and render stages of frames as a pipeline. The update stage
+     * of a frame can begin while the render stage is still working on up to
+     * "latency" earlier frames. With a latency of 0, every frame is rendered
+     * before the next frame is updated.
+     *
+     * Both stages can run on the same thread or on different threads. The
+     * pipeline does not use a device, so it can be used without one.
+     */
+    class ENGINE_DLL FramePipeline
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t NumUpdatedFrames;
+            uint64_t NumRenderedFrames;
+            // The total time (in seconds) the update stage waited for a free frame context.
+            double UpdateWaitTime;
+            // The total time (in seconds) the render stage waited for an updated frame.
+            double RenderWaitTime;
+        };
+
+        explicit FramePipeline( uint32_t latency = 0 );
+        ~FramePipeline();
+
+        FramePipeline( const FramePipeline& ) = delete;
+        FramePipeline& operator=( const FramePipeline& ) = delete;
+
+        /**
+         * Set the number of frames the update stage can run ahead of the render stage.
+         * The latency changes when the next frame begins its update stage, after all
+         * frames in flight have been rendered.
+         */
+        void SetLatency( uint32_t latency );
+        uint32_t GetLatency() const;
+
+        // The number of frame contexts (the latency + 1).
+        uint32_t GetNumFrameContexts() const;
+
+        /**
+         * Begin the update stage of the next frame.
+         * Blocks until the render stage has finished with the frame context.
+         * @returns nullptr if the pipeline was closed.
+         */
+        FrameContext* BeginUpdate();
+        void EndUpdate( FrameContext* frame );
+
+        /**
+         * Begin the render stage of the oldest frame that was updated.
+         * Blocks until a frame has been updated. The deferred functions of the
+         * frame are run before this function returns.
+         * @returns nullptr if the pipeline was closed and all updated frames have been rendered.
+         */
+        FrameContext* BeginRender();
+        void EndRender( FrameContext* frame );
+
+        /**
+         * Close the pipeline. Threads that wait in BeginUpdate return right away.
+         * BeginRender returns the frames that were already updated.
+         */
+        void Close();
+        bool IsClosed() const;
+
+        Statistics GetStatistics() const;
+
+    private:
+        /**
+         * Replace the frame contexts. Must be called while m_Mutex is locked.
+         * @returns The previous frame contexts. Release them after m_Mutex is unlocked
+         * because their release functions may use the pipeline.
+         */
+        std::vector< std::unique_ptr<FrameContext> > Resize( uint32_t numFrameContexts );
+
+        std::vector< std::unique_ptr<FrameContext> > m_FrameContexts;
+        uint32_t m_Latency;
+
+        // The number of frames that have begun and finished their update and render stages.
+        // Frames [m_NumRenderedFrames, m_NumUpdatedFrames) are in flight.
+        uint64_t m_NumUpdateFrames;
+        uint64_t m_NumUpdatedFrames;
+        uint64_t m_NumRenderFrames;
+        uint64_t m_NumRenderedFrames;
+        bool m_Closed;
+
+        double m_UpdateWaitTime;
+        double m_RenderWaitTime;
+
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_FrameUpdated;
+        std::condition_variable m_FrameRendered;
+    };
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file BVH.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief A bounding volume hierarchy for ray queries on the CPU.
+ */
+
+
+#include "../EngineDefines.h"
+
+namespace Graphics
+{
+    class Ray;
+
+    /**
+     * A bounding volume hierarchy over spheres or triangles.
+     * The hierarchy is built top-down using the surface area heuristic (SAH)
+     * with binned split candidates. The nodes are stored in a flat array (32 bytes
+     * per node) and the children of a node are always stored next to each other.
+     *
+     * The spheres of a sphere hierarchy can be moved without rebuilding the
+     * hierarchy. Moved spheres only refit the bounds of the nodes that contain them
+     * and the hierarchy is only rebuilt if the quality of the refitted tree 
+     * degrades too much (see Update).
+     */
+    class ENGINE_DLL BVH
+    {
+    public:
+        enum class PrimitiveType
+        {
+            Spheres,
+            Triangles,
+        };
+
+        static const uint32_t InvalidPrimitive = UINT32_MAX;
+
+        struct Node
+        {
+            glm::vec3 AABBMin;
+            // The index of the left child (the right child is LeftFirst + 1) for
+            // interior nodes or the first primitive index for leaf nodes.
+            uint32_t LeftFirst;
+            glm::vec3 AABBMax;
+            // The number of primitives in a leaf node (0 for interior nodes).
+            uint32_t Count;
+        };
+
+        struct Hit
+        {
+            // The index of the primitive that was hit (in the order the primitives were passed to Build).
+            uint32_t Primitive = InvalidPrimitive;
+            // The distance along the ray (in units of the length of the ray direction).
+            float Distance = FLT_MAX;
+            // The barycentric weights of the second and third vertex of a triangle that was hit.
+            glm::vec2 Barycentric = glm::vec2( 0 );
+        };
+
+        /**
+         * A function that is invoked for every primitive that is hit by the ray
+         * and that is closer than maxDistance. The function must return the distance
+         * to a refined intersection with the primitive or FLT_MAX if the refined 
+         * primitive is not hit. This can be used to build a hierarchy of hierarchies.
+         */
+        using IntersectFunction = std::function<float( uint32_t primitive, const Ray& ray, float maxDistance )>;
+
+        BVH();
+
+        /**
+         * Build the hierarchy over a list of spheres (center in xyz, radius in w).
+         */
+        void BuildSpheres( const std::vector<glm::vec4>& spheres );
+
+        /**
+         * Build the hierarchy over the triangles of an indexed triangle list.
+         */
+        void BuildTriangles( const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices );
+
+        /**
+         * Move (or resize) a sphere. The nodes that contain the sphere are 
+         * refitted the next time Refit or Update is called.
+         */
+        void UpdateSphere( uint32_t primitive, const glm::vec4& sphere );
+
+        /**
+         * Refit the bounds of the nodes that contain spheres that were moved.
+         */
+        void Refit();
+
+        /**
+         * Refit the hierarchy and rebuild it if the SAH cost of the refitted
+         * hierarchy is more than rebuildThreshold times the cost of the hierarchy
+         * when it was built.
+         * @returns true if the hierarchy was rebuilt.
+         */
+        bool Update( float rebuildThreshold = 1.5f );
+
+        /**
+         * Find the closest primitive that is hit by the ray.
+         * The ray direction does not need to be normalized.
+         * If the origin of the ray is inside a sphere, the distance to the 
+         * point where the ray exits the sphere is returned.
+         */
+        Hit Intersect( const Ray& ray, float maxDistance = FLT_MAX ) const;
+
+        /**
+         * Find the closest primitive that is hit by the ray using a custom
+         * intersection function for the primitives.
+         * Spheres that contain the origin of the ray are always passed to the
+         * intersection function.
+         */
+        Hit Intersect( const Ray& ray, float maxDistance, const IntersectFunction& intersectFunction ) const;
+
+        /**
+         * Find the closest primitives that are hit by a packet of 4 rays.
+         * The nodes are tested against the 4 rays at once (SSE) so packets of 
+         * coherent rays (for example, rays through neighboring pixels) are
+         * faster to trace than 4 individual rays.
+         */
+        void IntersectPacket( const Ray rays[4], Hit hits[4], float maxDistance = FLT_MAX ) const;
+
+        PrimitiveType GetPrimitiveType() const;
+        uint32_t GetNumPrimitives() const;
+        uint32_t GetNumNodes() const;
+        const Node& GetNode( uint32_t index ) const;
+        // The depth of the deepest leaf node (the root node has depth 0).
+        uint32_t GetDepth() const;
+
+        // The sphere of a sphere primitive.
+        const glm::vec4& GetSphere( uint32_t primitive ) const;
+        // The vertices of a triangle primitive.
+        void GetTriangle( uint32_t primitive, glm::vec3& v0, glm::vec3& v1, glm::vec3& v2 ) const;
+
+        /**
+         * The SAH cost of the hierarchy (the expected cost of tracing a ray
+         * relative to the cost of intersecting a primitive).
+         */
+        float GetSAHCost() const;
+
+    private:
+        // Build the hierarchy over the primitive bounds.
+        void Build();
+        // Compute the bounds of the primitives in a leaf node.
+        void UpdateLeafBounds( Node& node ) const;
+        // Find the closest hit (optionally using a custom intersection function).
+        Hit IntersectClosest( const Ray& ray, float maxDistance, const IntersectFunction* intersectFunction ) const;
+        // Returns the distance to the primitive or FLT_MAX if it is not hit.
+        // If conservative is true, spheres that contain the origin are hit at distance 0.
+        float IntersectPrimitive( uint32_t primitive, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, bool conservative, glm::vec2& barycentric ) const;
+
+        PrimitiveType m_PrimitiveType;
+
+        std::vector<Node> m_Nodes;
+        // The parent of each node (used to refit the hierarchy).
+        std::vector<uint32_t> m_Parents;
+        // The depth of the deepest leaf node.
+        // Determines the size of the traversal stack.
+        uint32_t m_Depth;
+        // Nodes that need to be refitted.
+        std::vector<uint8_t> m_DirtyNodes;
+        bool m_IsDirty;
+
+        // The primitives of the leaf nodes (indices into the primitive arrays).
+        std::vector<uint32_t> m_PrimitiveIndices;
+        // The leaf node that contains each primitive.
+        std::vector<uint32_t> m_PrimitiveLeaves;
+
+        // The bounds of each primitive.
+        std::vector<glm::vec3> m_PrimitiveMin;
+        std::vector<glm::vec3> m_PrimitiveMax;
+
+        std::vector<glm::vec4> m_Spheres;
+        // The first vertex and two edges of each triangle.
+        std::vector<glm::vec3> m_Triangles;
+
+        // The SAH cost of the hierarchy when it was built.
+        float m_BuildCost;
+    };
+}
@@ -49,5 +49,12 @@ namespace Graphics
          * Get the GPU frequency of queries running on this queue.
          */
         virtual uint64_t GetGPUFrequency() const = 0;
+
+        /**
+         * Sample the GPU timestamp counter and the CPU performance counter
+         * (QueryPerformanceCounter) at the same moment.
+         * Used to align GPU query results with CPU time.
+         */
+        virtual bool GetClockCalibration( uint64_t& gpuTimestamp, uint64_t& cpuTimestamp ) const = 0;
     };
 }
\ No newline at end of file
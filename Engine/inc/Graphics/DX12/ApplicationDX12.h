@@ -108,7 +108,15 @@ namespace Graphics
         void ProcessJoysticks( double deltaTime );
         void ProcessMessages();
 
+        // The render thread is started when the latency of the frame pipeline becomes 
+        // greater than 0 and stopped when the latency becomes 0 (see FramePipeline::SetLatency).
         void UpdateThread();
+        // Runs the render stage of the frame pipeline when its latency is greater than 0.
+        // Exits after the frame m_LastRenderThreadFrame was rendered.
+        void RenderThread();
+        // Render the next frame of the frame pipeline.
+        // @returns false if the frame pipeline was closed.
+        bool RenderFrame();
 
     private:
         // Handle to the module.
@@ -119,6 +127,8 @@ namespace Graphics
 
         std::atomic_uint64_t m_UpdateFrame;
         std::atomic_uint64_t m_RenderFrame;
+        // The last frame that is rendered by the render thread before it exits.
+        std::atomic_uint64_t m_LastRenderThreadFrame;
 
         std::mutex m_UpdateMutex;
         std::condition_variable m_UpdateConditionVar;
@@ -32,6 +32,7 @@
 
 
 #include "../Device.h"
+#include "../ResourceRegistry.h"
 #include "../../ThreadSafeQueue.h"
 
 namespace Graphics
@@ -198,6 +199,11 @@ namespace Graphics
         */
         virtual std::shared_ptr<Query> CreateQuery( QueryType queryType, uint32_t numQueries ) override;
 
+        /**
+        * Get the registry of the memory of the resources that were created by this device.
+        */
+        virtual ResourceRegistry& GetResourceRegistry() override;
+
 
         void Init();
 
@@ -241,5 +247,8 @@ namespace Graphics
         std::unique_ptr<DescriptorAllocatorDX12> m_DescriptorAllocators[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES];
         
         TextureMap m_TextureMap;
+        std::mutex m_TextureMapMutex;
+
+        ResourceRegistry m_ResourceRegistry;
     };
 }
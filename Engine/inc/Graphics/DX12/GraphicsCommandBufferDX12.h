@@ -198,6 +198,16 @@ namespace Graphics
          */
         virtual void BindGraphicsDynamicStructuredBuffer( uint32_t slotID, size_t numElements, size_t elementSize, const void* bufferData ) override;
 
+        /**
+         * Copy data to the upload heap and return the GPU virtual address of the data.
+         */
+        virtual uint64_t UploadDynamicBuffer( size_t bufferSizeInBytes, size_t alignment, const void* bufferData ) override;
+
+        /**
+         * Bind data that was uploaded with UploadDynamicBuffer to the graphics pipeline.
+         */
+        virtual void BindGraphicsDynamicBuffer( uint32_t slotID, uint64_t gpuAddress ) override;
+
         /**
         * Bind an index buffer to the rendering pipeline.
         * @indexBuffer The index buffer object to bind to the rendering pipeline.
@@ -99,6 +99,7 @@ namespace Graphics
          * Get the GPU frequency of queries running on this queue.
          */
         virtual uint64_t GetGPUFrequency() const override;
+        virtual bool GetClockCalibration( uint64_t& gpuTimestamp, uint64_t& cpuTimestamp ) const override;
         
         Microsoft::WRL::ComPtr<ID3D12CommandQueue> GetD3D12CommandQueue() const;
         D3D12_COMMAND_LIST_TYPE GetD3D12CommandListType() const;
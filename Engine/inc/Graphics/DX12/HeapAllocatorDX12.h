@@ -53,6 +53,11 @@ namespace Graphics
                            D3D12_RESOURCE_STATES d3d12ResourceState = D3D12_RESOURCE_STATE_GENERIC_READ );
         virtual ~HeapAllocatorDX12();
 
+        /**
+         * Allocate memory from the current page.
+         * Allocations that are larger than a page get their own buffer
+         * which is released (not reused) when the allocator is freed.
+         */
         HeapAllocation Allocate( size_t sizeInBytes, size_t alignment );
 
         /**
@@ -63,7 +68,7 @@ namespace Graphics
 
     protected:
         std::shared_ptr<DynamicBufferDX12> RequestBuffer();
-        std::shared_ptr<DynamicBufferDX12> CreateBuffer();
+        std::shared_ptr<DynamicBufferDX12> CreateBuffer( uint64_t sizeInBytes );
 
     private:
         using DynamicBufferPool = std::queue< std::shared_ptr<DynamicBufferDX12> >;
@@ -78,6 +83,8 @@ namespace Graphics
         
         DynamicBufferPool m_BufferPool;
         DynamicBufferPool m_AvailableBuffers;
+        // Buffers for allocations that don't fit in a page.
+        std::vector< std::shared_ptr<DynamicBufferDX12> > m_LargeBuffers;
 
         std::shared_ptr<DynamicBufferDX12> m_CurrentBuffer;
         size_t m_CurrentOffset;
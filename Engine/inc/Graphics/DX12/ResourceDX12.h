@@ -72,6 +72,10 @@ namespace Graphics
     protected:
         friend class GraphicsCommandBufferDX12;
 
+        // Add the memory of m_d3d12Resource to the resource registry of the device
+        // (or update it if the resource was recreated). Must be called when m_d3d12Resource changes.
+        void UpdateAllocation();
+
         std::weak_ptr<DeviceDX12> m_Device;
         Microsoft::WRL::ComPtr<ID3D12Device> m_d3d12Device;
 
@@ -82,5 +86,8 @@ namespace Graphics
         D3D12_RESOURCE_STATES m_d3d12ResourceState;
 
         std::wstring m_ResourceName;
+
+        // The ID of the resource in the resource registry of the device.
+        uint64_t m_AllocationID;
     };
 }
\ No newline at end of file
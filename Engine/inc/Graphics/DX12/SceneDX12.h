@@ -31,6 +31,8 @@
  */
 
 #include "../Scene.h"
+#include "../Material.h"
+#include "../../ThreadSafeQueue.h"
 
 class ProgressHandler;
 
@@ -42,6 +44,8 @@ namespace Core
 namespace Graphics
 {
     class DeviceDX12;
+    class MeshletData;
+    class MeshLODData;
 
     class SceneDX12 : public Scene
     {
@@ -63,6 +67,17 @@ namespace Graphics
         * @param format The format of the scene file.
         */
         virtual bool LoadFromString( std::shared_ptr<ComputeCommandBuffer> computeCommandBuffer, const std::string& scene, const std::string& format ) override;
+
+        /**
+        * Stream a scene from a file on disc.
+        * The scene node hierarchy is loaded first, then the meshes and textures
+        * are loaded on background threads in order of their distance to the camera.
+        */
+        virtual bool StreamFromFile( const std::wstring& fileName, const glm::mat4& rootTransform, const Camera& camera ) override;
+        virtual void ApplyStreamedAssets() override;
+        virtual void StopStreaming() override;
+        virtual SceneStreamingStatistics GetStreamingStatistics() const override;
+
         virtual void Render( Core::RenderEventArgs& renderEventArgs ) override;
 
         virtual std::shared_ptr<SceneNode> GetRootNode() const override;
@@ -74,9 +89,42 @@ namespace Graphics
     private:
         friend class ProgressHandler;
 
-        void ImportMaterial( std::shared_ptr<ComputeCommandBuffer> computeCommandBuffer, const aiMaterial& material, fs::path parentPath );
-        void ImportMesh( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer, const aiMesh& mesh );
-        std::shared_ptr<SceneNode> ImportSceneNode( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer, std::shared_ptr<SceneNode> parent, aiNode* aiNode );
+        // A texture that is assigned to a material when it has been streamed.
+        struct TextureRequest
+        {
+            std::shared_ptr<Graphics::Material> Material;
+            Graphics::Material::TextureType TextureType;
+            std::wstring FileName;
+        };
+
+        // The scene nodes that reference each mesh of the scene.
+        using MeshInstanceList = std::vector< std::vector< std::shared_ptr<SceneNode> > >;
+
+        // Read (and preprocess) the scene file or the previously exported version of the scene file.
+        const aiScene* ReadScene( Assimp::Importer& importer, const fs::path& filePath, bool& loadedExportedScene );
+
+        // If textureRequests is not null, the textures are not loaded but added to the list of texture requests.
+        void ImportMaterial( std::shared_ptr<ComputeCommandBuffer> computeCommandBuffer, const aiMaterial& material, fs::path parentPath, std::vector<TextureRequest>* textureRequests = nullptr );
+        std::shared_ptr<Mesh> ImportMesh( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer, const aiMesh& mesh, std::shared_ptr<const MeshletData> cachedMeshlets = nullptr, std::shared_ptr<const MeshLODData> cachedLODs = nullptr );
+        // If meshInstances is not null, meshes are not added to the scene nodes but added to the mesh instance list.
+        std::shared_ptr<SceneNode> ImportSceneNode( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer, std::shared_ptr<SceneNode> parent, aiNode* aiNode, MeshInstanceList* meshInstances = nullptr );
+
+        // Runs on the streaming thread.
+        void StreamScene( fs::path filePath, glm::mat4 rootTransform, glm::vec3 cameraPosition, glm::mat4 viewProjection );
+        // Run on the streaming worker threads.
+        void StreamMesh( uint32_t meshIndex, const aiMesh* mesh, std::shared_ptr<const MeshletData> cachedMeshlets, std::shared_ptr<const MeshLODData> cachedLODs,
+                         std::vector< std::shared_ptr<SceneNode> > nodes, bool isVisible );
+        void StreamTexture( std::wstring fileName, std::vector<TextureRequest> textureRequests, bool isVisible );
+
+        // The meshlets of all meshes are stored in a cache file next to the preprocessed scene file.
+        bool LoadMeshletCache( const fs::path& cachePath, size_t numMeshes, std::vector< std::shared_ptr<const MeshletData> >& meshlets ) const;
+        void SaveMeshletCache( const fs::path& cachePath ) const;
+        // The levels of detail of all meshes are stored in a cache file next to the preprocessed scene file.
+        bool LoadLODCache( const fs::path& cachePath, size_t numMeshes, std::vector< std::shared_ptr<const MeshLODData> >& lods ) const;
+        void SaveLODCache( const fs::path& cachePath ) const;
+
+        // Log the vertex cache, vertex fetch and LOD statistics of the imported meshes.
+        void LogOptimizationStatistics() const;
 
         using MaterialMap = std::map<std::string, std::shared_ptr<Material> >;
         using MaterialList = std::vector < std::shared_ptr<Material> >;
@@ -91,5 +139,30 @@ namespace Graphics
         std::shared_ptr<SceneNode> m_RootNode;
 
         std::wstring m_SceneFile;
+
+        // Statistics gathered by the mesh optimizer while importing the scene.
+        struct OptimizationStatistics
+        {
+            uint64_t NumTriangles = 0;
+            uint64_t NumVertices = 0;
+            uint64_t VertexBytes = 0;
+            uint64_t VerticesTransformedBefore = 0;
+            uint64_t VerticesTransformedAfter = 0;
+            uint64_t BytesFetchedBefore = 0;
+            uint64_t BytesFetchedAfter = 0;
+            uint32_t Num16BitIndexBuffers = 0;
+            uint32_t Num32BitIndexBuffers = 0;
+            uint32_t NumLODs = 0;
+            uint64_t NumLODTriangles = 0;
+        };
+
+        OptimizationStatistics m_OptimizationStatistics;
+        std::mutex m_OptimizationStatisticsMutex;
+
+        std::thread m_StreamingThread;
+        std::atomic_bool m_CancelStreaming;
+        // Streamed assets are added to the scene on the render thread (see ApplyStreamedAssets).
+        Core::ThreadSafeQueue< std::function<void()> > m_StreamedAssets;
+        SceneStreamingStatistics m_StreamingStatistics;
     };
 }
\ No newline at end of file
@@ -34,6 +34,8 @@ namespace Graphics
         // Destroy and close the window.
         virtual void CloseWindow() override;
 
+        virtual void SetClientSize( uint32_t width, uint32_t height ) override;
+
         virtual void SetFullScreen( bool fullscreen ) override;
 
         /**
@@ -61,6 +61,7 @@ namespace Graphics
     class Query;
     class ReadbackBuffer;
     class IndirectCommandSignature;
+    class ResourceRegistry;
 
     class ENGINE_DLL Device
     {
@@ -252,5 +253,10 @@ namespace Graphics
          * Create a GPU query.
          */
         virtual std::shared_ptr<Query> CreateQuery( QueryType queryType, uint32_t numQueries ) = 0;
+
+        /**
+         * Get the registry of the memory of the resources that were created by this device.
+         */
+        virtual ResourceRegistry& GetResourceRegistry() = 0;
     };
 }
\ No newline at end of file
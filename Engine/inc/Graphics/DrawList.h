@@ -0,0 +1,130 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file DrawList.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief A list of draws that is sorted by a 64-bit sort key.
+ */
+
+#include "../EngineDefines.h"
+
+#include <unordered_map>
+
+namespace Graphics
+{
+    class SceneNode;
+    class Mesh;
+    class Material;
+
+    /**
+     * Draws are sorted by a 64-bit key so that draws that use the same
+     * state (pipeline, material, vertex and index buffers) are submitted 
+     * one after the other and the state only has to be bound once.
+     * 
+     * The layout of the sort key (from the most significant bit):
+     * FrontToBack: | pass (4) | pipeline (8) | material (16) | mesh (16) | depth (20) |
+     * BackToFront: | pass (4) | pipeline (8) | ~depth (20) | material (16) | mesh (16) |
+     * 
+     * Opaque geometry is sorted by state first (and front to back for draws 
+     * that share the same state). Transparent geometry must be sorted back 
+     * to front, so the depth takes precedence over the state.
+     */
+    class ENGINE_DLL DrawList
+    {
+    public:
+        enum class SortOrder
+        {
+            FrontToBack,
+            BackToFront,
+        };
+
+        struct Draw
+        {
+            Graphics::SceneNode* Node;
+            Graphics::Mesh* Mesh;
+            Graphics::Material* Material;
+            uint32_t LOD;
+            // Index of the object data of the scene node (see SceneMeshList::GetObjectData).
+            uint32_t ObjectIndex;
+        };
+
+        DrawList( SortOrder sortOrder = SortOrder::FrontToBack );
+
+        void SetSortOrder( SortOrder sortOrder );
+        SortOrder GetSortOrder() const;
+
+        /**
+         * Remove all of the draws from the list.
+         * The memory that is allocated by the list is kept for the next frame.
+         */
+        void Clear();
+
+        /**
+         * Add a draw to the list.
+         * @param depth The (non-negative) distance from the camera to the draw.
+         * @param pass The pass index (0-15).
+         * @param pipeline The pipeline index (0-255).
+         */
+        void Add( const Draw& draw, float depth, uint32_t pass = 0, uint32_t pipeline = 0 );
+
+        /**
+         * Sort the draws by their sort keys (radix sort).
+         */
+        void Sort();
+
+        uint32_t GetNumDraws() const;
+        // Get a draw in sorted order (only valid after Sort is called).
+        const Draw& GetDraw( uint32_t index ) const;
+        uint64_t GetSortKey( uint32_t index ) const;
+
+        /**
+         * Build a sort key. Materials and meshes are identified by a 
+         * (16-bit) index that is assigned by the draw list.
+         */
+        static uint64_t MakeSortKey( SortOrder sortOrder, uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth );
+
+    private:
+        struct SortItem
+        {
+            uint64_t Key;
+            uint32_t Index;
+        };
+
+        // Get a (16-bit) index for a material or mesh in the order 
+        // in which they are added to the draw list.
+        uint32_t GetID( const void* object );
+
+        SortOrder m_SortOrder;
+
+        std::vector<Draw> m_Draws;
+        std::vector<SortItem> m_SortItems;
+        // Scratch buffer for the radix sort.
+        std::vector<SortItem> m_TempItems;
+
+        std::unordered_map<const void*, uint32_t> m_IDs;
+    };
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file Frustum.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief A view frustum defined by 6 planes.
+ */
+
+#include "../EngineDefines.h"
+
+namespace Graphics
+{
+    class ENGINE_DLL Frustum
+    {
+    public:
+        enum Plane
+        {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            NumPlanes
+        };
+
+        Frustum();
+
+        /**
+         * Extract the frustum planes from a projection matrix with NDCz = [0 .. 1].
+         * If the matrix is a view-projection matrix, the planes are in world space.
+         * If the matrix is a model-view-projection matrix, the planes are in object space.
+         */
+        explicit Frustum( const glm::mat4& viewProjection );
+
+        // Get one of the (normalized) frustum planes. 
+        // The plane normals point to the inside of the frustum.
+        const glm::vec4& GetPlane( Plane plane ) const;
+
+        // Returns true if the sphere is inside or intersects the frustum.
+        bool IntersectsSphere( const glm::vec3& center, float radius ) const;
+
+        // Returns true if the axis-aligned box is inside or intersects the frustum.
+        bool IntersectsAABB( const glm::vec3& min, const glm::vec3& max ) const;
+
+    private:
+        glm::vec4 m_Planes[NumPlanes];
+    };
+}
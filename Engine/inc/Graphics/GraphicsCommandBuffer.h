@@ -116,6 +116,31 @@ namespace Graphics
             BindGraphicsDynamicStructuredBuffer( slotID, data.size(), sizeof( T ), data.data() );
         }
 
+        /**
+         * Copy data to the upload heap of the command buffer.
+         * The uploaded data remains valid until the command buffer has finished executing
+         * so it can be bound multiple times (see BindGraphicsDynamicBuffer) without copying it again.
+         * @param bufferSizeInBytes The size of the data in bytes.
+         * @param alignment The alignment of the data (256 for constant buffers, the element size for structured buffers).
+         * @param bufferData A pointer to the data.
+         * @returns The GPU virtual address of the uploaded data.
+         */
+        virtual uint64_t UploadDynamicBuffer( size_t bufferSizeInBytes, size_t alignment, const void* bufferData ) = 0;
+
+        template<typename T>
+        uint64_t UploadDynamicBuffer( const std::vector<T>& data )
+        {
+            return UploadDynamicBuffer( data.size() * sizeof( T ), sizeof( T ), data.data() );
+        }
+
+        /**
+         * Bind data that was uploaded with UploadDynamicBuffer to the graphics pipeline.
+         * The slot must be an inline constant buffer or (structured) buffer parameter.
+         * @param slotID The slot to bind the data to.
+         * @param gpuAddress The address that was returned by UploadDynamicBuffer.
+         */
+        virtual void BindGraphicsDynamicBuffer( uint32_t slotID, uint64_t gpuAddress ) = 0;
+
         /**
          * Bind an index buffer to the rendering pipeline.
          * @param indexBuffer The index buffer object to bind to the rendering pipeline.
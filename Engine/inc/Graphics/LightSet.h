@@ -0,0 +1,159 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file LightSet.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Binary (structure of arrays) light set files.
+ */
+
+
+#include "../EngineDefines.h"
+
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "DirectionalLight.h"
+
+namespace Graphics
+{
+    /**
+     * A light set file stores the properties of the lights of a configuration
+     * as separate arrays (one array for every property of every light type).
+     * The file is memory mapped when it is opened so the arrays can be read
+     * directly from the file without parsing.
+     *
+     * The file starts with a header and a table that describes the streams
+     * (arrays) in the file. Every stream is aligned to 16 bytes. Streams
+     * that are unknown to the reader are skipped and properties that are not
+     * stored in the file get their default value, so new properties can be
+     * added without breaking older files.
+     */
+    class ENGINE_DLL LightSet
+    {
+    public:
+        // Identifies a light set file ("LSET").
+        static const uint32_t Magic = 0x5445534C;
+        static const uint32_t Version = 1;
+
+        enum class Stream : uint32_t
+        {
+            PointLightPosition,         // glm::vec3
+            PointLightColor,            // glm::vec3
+            PointLightRange,            // float
+            PointLightIntensity,        // float
+            PointLightEnabled,          // uint32_t
+            SpotLightPosition,          // glm::vec3
+            SpotLightDirection,         // glm::vec3
+            SpotLightColor,             // glm::vec3
+            SpotLightAngle,             // float
+            SpotLightRange,             // float
+            SpotLightIntensity,         // float
+            SpotLightEnabled,           // uint32_t
+            DirectionalLightDirection,  // glm::vec3
+            DirectionalLightColor,      // glm::vec3
+            DirectionalLightIntensity,  // float
+            DirectionalLightEnabled,    // uint32_t
+            NumStreams
+        };
+
+        struct FileHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t NumPointLights;
+            uint32_t NumSpotLights;
+            uint32_t NumDirectionalLights;
+            // The number of entries in the stream table that follows the header.
+            uint32_t NumStreams;
+            uint64_t FileSize;
+        };
+
+        struct StreamHeader
+        {
+            Stream Type;
+            // The size of a single element of the stream in bytes.
+            uint32_t ElementSize;
+            // The offset of the stream from the start of the file in bytes.
+            uint64_t Offset;
+        };
+
+        LightSet();
+        ~LightSet();
+
+        LightSet( const LightSet& ) = delete;
+        LightSet& operator=( const LightSet& ) = delete;
+
+        /**
+         * Memory map a light set file. The file stays mapped until the
+         * light set is closed (or destroyed).
+         */
+        bool Open( const fs::path& fileName );
+        void Close();
+        bool IsOpen() const;
+
+        uint32_t GetNumPointLights() const;
+        uint32_t GetNumSpotLights() const;
+        uint32_t GetNumDirectionalLights() const;
+
+        /**
+         * Get a pointer to the (memory mapped) elements of a stream.
+         * @returns nullptr if the stream is not stored in the file.
+         */
+        const void* GetStream( Stream stream ) const;
+
+        template<typename T>
+        const T* GetStream( Stream stream ) const
+        {
+            const StreamHeader* streamHeader = m_Streams[static_cast<uint32_t>( stream )];
+            return streamHeader && streamHeader->ElementSize == sizeof( T ) ? reinterpret_cast<const T*>( m_View + streamHeader->Offset ) : nullptr;
+        }
+
+        /**
+         * Copy the lights from the streams into (array of structures) lights.
+         */
+        void GetPointLights( std::vector<PointLight>& pointLights ) const;
+        void GetSpotLights( std::vector<SpotLight>& spotLights ) const;
+        void GetDirectionalLights( std::vector<DirectionalLight>& directionalLights ) const;
+
+        /**
+         * Write the lights to a light set file.
+         * The file is written to a temporary file first and replaces the 
+         * existing file when it has been written completely.
+         */
+        static bool Save( const fs::path& fileName,
+                          const std::vector<PointLight>& pointLights,
+                          const std::vector<SpotLight>& spotLights,
+                          const std::vector<DirectionalLight>& directionalLights );
+
+    private:
+        HANDLE m_File;
+        HANDLE m_FileMapping;
+        const uint8_t* m_View;
+        const FileHeader* m_Header;
+        // The stream table entries indexed by the stream type (or nullptr if the stream is not in the file).
+        const StreamHeader* m_Streams[static_cast<uint32_t>( Stream::NumStreams )];
+    };
+}
@@ -43,6 +43,9 @@ namespace Graphics
     class VertexBuffer;
     class IndexBuffer;
     class Material;
+    class MeshletData;
+    class MeshLODData;
+    class BVH;
 
     class ENGINE_DLL Mesh
     {
@@ -65,8 +68,66 @@ namespace Graphics
         void SetMaterial( std::shared_ptr<Material> material );
         std::shared_ptr<Material> GetMaterial() const;
 
+        // Meshlets are optional. They are generated when the mesh is imported
+        // and can be used to cull clusters of triangles on the CPU.
+        void SetMeshlets( std::shared_ptr<const MeshletData> meshlets );
+        std::shared_ptr<const MeshletData> GetMeshlets() const;
+
+        // Levels of detail are optional. If the mesh has levels of detail, 
+        // the index buffer contains the indices of all levels (starting with LOD 0).
+        void SetLODs( std::shared_ptr<const MeshLODData> lods );
+        std::shared_ptr<const MeshLODData> GetLODs() const;
+
+        // The triangle hierarchy is optional. It is built in object space and 
+        // is used for ray queries (see SceneMeshList::Raycast).
+        void SetBVH( std::shared_ptr<const BVH> bvh );
+        // The triangle hierarchy is built from these triangles the first time it is used (see GetBVH).
+        void SetBVHTriangles( std::vector<glm::vec3> positions, std::vector<uint32_t> indices );
+        // Returns true if the mesh has a triangle hierarchy (that may not be built yet).
+        bool HasBVH() const;
+        // Builds the triangle hierarchy if it was not built yet.
+        std::shared_ptr<const BVH> GetBVH() const;
+
+        // Compute a hash of the vertex and index data of a mesh.
+        // Data that is generated from the mesh (and cached) is only used if the hash matches.
+        static uint64_t ComputeHash( const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices );
+
+        // Compute the object space bounding box and bounding sphere of the mesh.
+        // The bounding volumes are used to cull meshes against the view frustum.
+        void ComputeBoundingVolumes( const std::vector<Vertex>& vertices );
+        // Meshes without bounding volumes are never culled.
+        bool HasBoundingVolumes() const;
+        const glm::vec3& GetAABBMin() const;
+        const glm::vec3& GetAABBMax() const;
+        // The center (xyz) and radius (w) of the bounding sphere.
+        const glm::vec4& GetBoundingSphere() const;
+
         virtual void Render( Core::RenderEventArgs& renderArgs, uint32_t instanceCount = 1, uint32_t firstInstance = 0 );
 
+        /**
+         * Render only the meshlets in the list of visible meshlets (see MeshletData::Cull).
+         * Meshlets that are adjacent in the index buffer are merged into a single draw call.
+         * The mesh must have meshlets and an index buffer.
+         */
+        void RenderMeshlets( Core::RenderEventArgs& renderArgs, const std::vector<uint32_t>& visibleMeshlets, uint32_t instanceCount = 1, uint32_t firstInstance = 0 );
+        // Draw the visible meshlets of the mesh using the currently bound buffers (see BindBuffers).
+        void DrawMeshlets( Core::RenderEventArgs& renderArgs, const std::vector<uint32_t>& visibleMeshlets, uint32_t instanceCount = 1, uint32_t firstInstance = 0 );
+
+        /**
+         * Render a level of detail of the mesh (see MeshLODData::SelectLOD).
+         * If the mesh does not have levels of detail, the full mesh is rendered.
+         */
+        void RenderLOD( Core::RenderEventArgs& renderArgs, uint32_t lod, uint32_t instanceCount = 1, uint32_t firstInstance = 0 );
+
+        /**
+         * Bind the vertex and index buffers of the mesh.
+         * BindBuffers and DrawLOD can be used instead of RenderLOD to avoid
+         * binding the buffers again when the same mesh is drawn multiple times.
+         */
+        void BindBuffers( Core::RenderEventArgs& renderArgs );
+        // Draw a level of detail of the mesh using the currently bound buffers.
+        void DrawLOD( Core::RenderEventArgs& renderArgs, uint32_t lod, uint32_t instanceCount = 1, uint32_t firstInstance = 0 );
+
         virtual void Accept( Core::SceneVisitor& visitor );
 
     protected:
@@ -79,5 +140,17 @@ namespace Graphics
         BufferMap m_VertexBuffers;
         std::shared_ptr<IndexBuffer> m_IndexBuffer;
         std::shared_ptr<Material> m_Material;
+        std::shared_ptr<const MeshletData> m_Meshlets;
+        std::shared_ptr<const MeshLODData> m_LODs;
+        // The triangle hierarchy is built on demand.
+        mutable std::shared_ptr<const BVH> m_BVH;
+        mutable std::vector<glm::vec3> m_BVHPositions;
+        mutable std::vector<uint32_t> m_BVHIndices;
+        mutable std::mutex m_BVHMutex;
+
+        bool m_HasBoundingVolumes;
+        glm::vec3 m_AABBMin;
+        glm::vec3 m_AABBMax;
+        glm::vec4 m_BoundingSphere;
     };
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file MeshLOD.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Discrete levels of detail for meshes.
+ */
+
+#include "../EngineDefines.h"
+
+#include "Mesh.h"
+
+namespace Graphics
+{
+    class Camera;
+
+    struct MeshLOD
+    {
+        // The range of indices of this level of detail in the mesh's index buffer.
+        uint32_t FirstIndex;
+        uint32_t IndexCount;
+        // The geometric error (in object space units) of this level of detail 
+        // relative to the original mesh.
+        float Error;
+    };
+
+    class ENGINE_DLL MeshLODData
+    {
+    public:
+        static const uint32_t MaxLODs = 6;
+
+        MeshLODData();
+
+        /**
+         * Build a chain of simplified levels of detail for a mesh.
+         * Each level of detail is simplified from the previous level and
+         * contains (approximately) reductionRatio times as many triangles.
+         * The chain stops early if the simplifier cannot reduce the mesh any further
+         * without moving seams or borders.
+         * LOD 0 is always the original mesh.
+         */
+        void Build( const std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t maxLODs = MaxLODs, float reductionRatio = 0.5f );
+
+        // Returns true if the LODs were built for a mesh with this hash (see Mesh::ComputeHash).
+        bool IsValid( uint64_t meshHash ) const;
+
+        /**
+         * Select the coarsest level of detail whose projected error 
+         * is less than maxPixelError pixels on screen.
+         * @param world The world transform of the mesh.
+         */
+        uint32_t SelectLOD( const Camera& camera, const glm::mat4& world, float maxPixelError ) const;
+
+        uint32_t GetNumLODs() const;
+        const MeshLOD& GetLOD( uint32_t lod ) const;
+        const std::vector<MeshLOD>& GetLODs() const;
+
+        // The indices of all levels of detail (starting with LOD 0).
+        const std::vector<uint32_t>& GetIndices() const;
+
+        // Binary serialization (used by the scene cache).
+        bool Save( std::ostream& stream ) const;
+        bool Load( std::istream& stream );
+
+    private:
+        uint64_t m_MeshHash;
+
+        // Bounding sphere of the mesh in object space.
+        glm::vec3 m_Center;
+        float m_Radius;
+
+        std::vector<MeshLOD> m_LODs;
+        std::vector<uint32_t> m_Indices;
+    };
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file MeshOptimizer.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Import-time index and vertex buffer optimizations.
+ *  Triangles are reordered for the post-transform vertex cache (Forsyth),
+ *  then clusters of triangles are sorted to reduce overdraw and finally
+ *  the vertex buffer is remapped so vertices are fetched in the order they
+ *  are first referenced by the index buffer.
+ */
+
+#include "../EngineDefines.h"
+
+#include "Mesh.h"
+
+namespace Graphics
+{
+    namespace MeshOptimizer
+    {
+        // The size of the (FIFO) post-transform cache used to compute statistics.
+        const uint32_t DefaultCacheSize = 16;
+
+        struct VertexCacheStatistics
+        {
+            // The number of times a vertex had to be transformed.
+            uint32_t VerticesTransformed = 0;
+            // Average Cache Miss Ratio (transformed vertices per triangle).
+            // 0.5 is optimal for large regular grids, 3.0 is the worst case.
+            float ACMR = 0.0f;
+            // Average Transformed Vertex Ratio (transformed vertices per referenced vertex).
+            // 1.0 is optimal.
+            float ATVR = 0.0f;
+        };
+
+        struct VertexFetchStatistics
+        {
+            // The number of bytes fetched from the vertex buffer (in cache lines).
+            uint32_t BytesFetched = 0;
+            // Bytes fetched divided by the size of the referenced vertices.
+            // 1.0 is optimal.
+            float OverfetchRatio = 0.0f;
+        };
+
+        /**
+         * Reorder the triangles in the index buffer to improve
+         * post-transform vertex cache utilization.
+         * Implements "Linear-Speed Vertex Cache Optimisation" (Tom Forsyth, 2006).
+         */
+        ENGINE_DLL void OptimizeVertexCache( std::vector<uint32_t>& indices, size_t vertexCount );
+
+        /**
+         * Reorder clusters of triangles to reduce overdraw without sacrificing
+         * too much of the vertex cache efficiency. The index buffer should already
+         * be optimized for the vertex cache.
+         * @param threshold Allow the ACMR of the resulting index buffer to be
+         * at most threshold times worse than the input.
+         */
+        ENGINE_DLL void OptimizeOverdraw( std::vector<uint32_t>& indices, const std::vector<Mesh::Vertex>& vertices, float threshold = 1.05f );
+
+        /**
+         * Reorder the vertex buffer so that vertices are stored in the order
+         * they are first referenced by the index buffer. Vertices that are
+         * not referenced by the index buffer are removed.
+         * @returns The number of vertices in the remapped vertex buffer.
+         */
+        ENGINE_DLL size_t OptimizeVertexFetch( std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices );
+
+        /**
+         * Simulate a FIFO post-transform cache to compute ACMR and ATVR.
+         */
+        ENGINE_DLL VertexCacheStatistics AnalyzeVertexCache( const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = DefaultCacheSize );
+
+        /**
+         * Simulate a small cache of 64 byte lines to compute the vertex fetch overfetch ratio.
+         */
+        ENGINE_DLL VertexFetchStatistics AnalyzeVertexFetch( const std::vector<uint32_t>& indices, size_t vertexCount, size_t vertexSize );
+    }
+}
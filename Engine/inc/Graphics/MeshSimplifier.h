@@ -0,0 +1,57 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file MeshSimplifier.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Mesh simplification using quadric error metrics.
+ */
+
+#include "../EngineDefines.h"
+
+#include "Mesh.h"
+
+namespace Graphics
+{
+    namespace MeshSimplifier
+    {
+        /**
+         * Simplify a triangle mesh by collapsing edges using the quadric error metric
+         * ("Surface Simplification Using Quadric Error Metrics", Garland & Heckbert, 1997).
+         * Edges are collapsed onto existing vertices so the simplified index buffer can
+         * be used with the original vertex buffer. Vertices on attribute seams (vertices
+         * that share a position but have different attributes) are never moved and 
+         * vertices on open borders only move along the border.
+         *
+         * @param indices The index buffer to simplify (in place).
+         * @param vertices The vertex buffer.
+         * @param targetIndexCount Stop when the index buffer contains at most this many indices.
+         * @param targetError Stop when the error of the next collapse exceeds this error (in object space units).
+         * @returns The (approximate) geometric error of the simplified mesh in object space units.
+         */
+        ENGINE_DLL float Simplify( std::vector<uint32_t>& indices, const std::vector<Mesh::Vertex>& vertices, size_t targetIndexCount, float targetError = FLT_MAX );
+    }
+}
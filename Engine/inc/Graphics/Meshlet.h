@@ -0,0 +1,128 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file Meshlet.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Meshlets are small clusters of triangles of a mesh that can be culled as a unit.
+ */
+
+#include "../EngineDefines.h"
+
+#include "Mesh.h"
+
+namespace Graphics
+{
+    class Frustum;
+
+    struct Meshlet
+    {
+        // Offset and number of vertices in MeshletData::GetVertexIndices.
+        uint32_t VertexOffset;
+        uint32_t VertexCount;
+        // Offset and number of triangles in MeshletData::GetPrimitiveIndices.
+        // This is also the range of triangles in the mesh's index buffer.
+        uint32_t TriangleOffset;
+        uint32_t TriangleCount;
+
+        // Bounding sphere of the meshlet in object space.
+        glm::vec3 Center;
+        float Radius;
+
+        // Normal cone of the meshlet in object space.
+        // If the camera is inside the cone (as seen from the apex), 
+        // all triangles of the meshlet are back facing.
+        glm::vec3 ConeApex;
+        float ConeCutoff;
+        glm::vec3 ConeAxis;
+    };
+
+    struct MeshletCullingStatistics
+    {
+        uint32_t NumMeshlets = 0;
+        uint32_t NumTriangles = 0;
+        uint32_t NumFrustumCulled = 0;
+        uint32_t NumBackfaceCulled = 0;
+        uint32_t NumTrianglesCulled = 0;
+
+        MeshletCullingStatistics& operator+=( const MeshletCullingStatistics& other )
+        {
+            NumMeshlets += other.NumMeshlets;
+            NumTriangles += other.NumTriangles;
+            NumFrustumCulled += other.NumFrustumCulled;
+            NumBackfaceCulled += other.NumBackfaceCulled;
+            NumTrianglesCulled += other.NumTrianglesCulled;
+            return *this;
+        }
+    };
+
+    class ENGINE_DLL MeshletData
+    {
+    public:
+        static const uint32_t MaxVertices = 64;
+        static const uint32_t MaxTriangles = 124;
+
+        MeshletData();
+
+        /**
+         * Split the mesh into meshlets. Triangles are added to meshlets in 
+         * index buffer order so the index buffer should already be optimized 
+         * for the vertex cache. Since triangles are not reordered, each meshlet
+         * is a contiguous range of triangles in the mesh's index buffer.
+         */
+        void Build( const std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t maxVertices = MaxVertices, uint32_t maxTriangles = MaxTriangles );
+
+        // Returns true if the meshlets were built for a mesh with this hash (see Mesh::ComputeHash).
+        bool IsValid( uint64_t meshHash ) const;
+
+        /**
+         * Cull the meshlets against the view frustum and the camera position.
+         * Both the frustum and the camera position must be in object space.
+         * The indices of the visible meshlets are appended to visibleMeshlets (if not null).
+         * Meshes that are rendered without back face culling must not be cone culled.
+         */
+        MeshletCullingStatistics Cull( const Frustum& frustum, const glm::vec3& cameraPosition, std::vector<uint32_t>* visibleMeshlets = nullptr, bool backfaceCulling = true ) const;
+
+        const std::vector<Meshlet>& GetMeshlets() const;
+        // Meshlet vertices are indices into the mesh's vertex buffer.
+        const std::vector<uint32_t>& GetVertexIndices() const;
+        // 3 meshlet-local vertex indices per triangle.
+        const std::vector<uint8_t>& GetPrimitiveIndices() const;
+
+        // Binary serialization (used by the scene cache).
+        bool Save( std::ostream& stream ) const;
+        bool Load( std::istream& stream );
+
+    private:
+        void ComputeBounds( Meshlet& meshlet, const std::vector<Mesh::Vertex>& vertices ) const;
+
+        uint64_t m_MeshHash;
+
+        std::vector<Meshlet> m_Meshlets;
+        std::vector<uint32_t> m_VertexIndices;
+        std::vector<uint8_t> m_PrimitiveIndices;
+    };
+}
@@ -28,6 +28,10 @@
  *  @author jeremiah
  *
  *  @brief GPU and CPU performance profiling.
+ *  Profiler markers are identified by a hash of their name that is computed at
+ *  compile time (see PROFILE_MARKER). Pushing and popping a marker only writes
+ *  an event to a lock-free ring buffer that is owned by the calling thread.
+ *  The events are aggregated into the tree of profile nodes on a background thread.
  */
 
 #include "../EngineDefines.h"
@@ -39,6 +43,9 @@
 #include <vector>
 #include <unordered_map>
 #include <chrono>
+#include <condition_variable>
+#include <future>
+#include <thread>
 
 #include <Graphics/GraphicsCommandBuffer.h> // Needed for static_cast
 
@@ -52,25 +59,50 @@ namespace Graphics
     class Device;
     class ComputeCommandQueue;
     class Query;
+    struct ProfileEvent;
+    struct ProfileEventBuffer;
+
+    // FNV-1a hash of a marker name. Use PROFILE_MARKER to compute it at compile time.
+    constexpr uint64_t HashMarkerName( const wchar_t* name )
+    {
+        uint64_t hash = 14695981039346656037ull;
+        while ( *name )
+        {
+            hash = ( hash ^ static_cast<uint64_t>( *name++ ) ) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // An interned profiler marker.
+    // The name must outlive the profiler (string literals or Profiler::InternMarker).
+    struct ProfileMarker
+    {
+        constexpr ProfileMarker( const wchar_t* name, uint64_t id )
+            : Name( name )
+            , ID( id )
+        {}
+
+        const wchar_t* Name;
+        uint64_t ID;
+    };
 
     struct ENGINE_DLL ProfileNode : public std::enable_shared_from_this<ProfileNode>
     {
-        ProfileNode( const std::wstring& name, uint32_t queryIndex, std::shared_ptr<Query> gpuQuery, std::shared_ptr<ProfileNode> parent );
+        ProfileNode( const std::wstring& name, uint64_t key, std::shared_ptr<ProfileNode> parent );
 
         std::string Name;
         std::wstring NameWStr;
         size_t ID;
         bool IsSelected;
         std::weak_ptr<ProfileNode> Parent;
-        std::vector<std::shared_ptr<ProfileNode> > Children;                    // Warning: Not thread-safe.
-        std::unordered_map< std::wstring, std::shared_ptr<ProfileNode> > ChildrenMap;   // Warning: Not thread-safe.
+        std::vector<std::shared_ptr<ProfileNode> > Children;                    // Warning: Only access while the profiler is locked.
+        std::unordered_map< uint64_t, std::shared_ptr<ProfileNode> > ChildrenMap;   // Warning: Only access while the profiler is locked.
 
         std::chrono::high_resolution_clock::time_point StartTime;
         std::chrono::high_resolution_clock::time_point EndTime;
 
-        // Index into the GPU query heap.
+        // Index into the GPU query heap (UINT32_MAX if the marker is never used with a command buffer).
         uint32_t QueryIndex;
-        std::shared_ptr<Query> GpuQuery;
         bool HasGpuQueryResults;
 
         // The last frame the CPU stats were modified.
@@ -81,10 +113,28 @@ namespace Graphics
         Core::Statistic<double> CpuStats;
         Core::Statistic<double> GpuStats;
 
-        std::shared_ptr<ProfileNode> GetChild( const std::wstring& name );
-        void Start( std::shared_ptr<ComputeCommandBuffer> commandBuffer );
-        void Stop( std::shared_ptr<ComputeCommandBuffer> commandBuffer, uint64_t frame );
-        
+        // The longest CPU sample of a frame.
+        struct FrameTime
+        {
+            uint64_t Frame;
+            double Time;
+        };
+
+        // The last two frames the marker was recorded in. The previous frame is kept
+        // because the markers of a frame can only be inspected after the next frame
+        // has started (see GetCpuFrameTime).
+        FrameTime CpuFrameTimes[2];
+
+        // Get (or create) the child node for a marker (and index).
+        std::shared_ptr<ProfileNode> GetChild( const ProfileMarker& marker, uint32_t index );
+
+        // The full path of the node in the profiler tree (for example, "Root/Frame/Opaque Pass").
+        std::string GetPath() const;
+
+        // Get the longest CPU sample (in seconds) of the marker in one of the last two frames
+        // it was recorded in. Returns 0 if the marker was not recorded in that frame.
+        double GetCpuFrameTime( uint64_t frame ) const;
+
         void UpdateQueryResult( const std::vector<QueryResult>& results );
 
         void DeleteChildren();
@@ -95,6 +145,11 @@ namespace Graphics
     class ENGINE_DLL Profiler
     {
     public:
+        // Markers that are not used with an index.
+        static const uint32_t NoIndex = UINT32_MAX;
+        // The number of events (a push or a pop) that a thread can record before they are aggregated.
+        static const uint32_t EventBufferCapacity = 4096;
+
         Profiler( std::shared_ptr<Device> device, uint32_t numProfilingMarkers );
         ~Profiler();
 
@@ -107,20 +162,49 @@ namespace Graphics
         static void Init( std::shared_ptr<Device> device, uint32_t numProfilingMarkers = 1024 );
         static void Shutdown();
 
+        // Intern a marker name that is only known at runtime.
+        // This takes a lock so store the result instead of calling it every frame.
+        static ProfileMarker InternMarker( const std::wstring& name );
+
+        // Name the calling thread in captured timelines.
+        static void SetThreadName( const std::wstring& name );
+
         void SetPaused( bool paused );
         bool IsPaused() const;
         void SetCurrentFrame( uint64_t frame );
         uint64_t GetCurrentFrame() const;
 
+        void PushProfilingMarker( const ProfileMarker& marker, std::shared_ptr<ComputeCommandBuffer> commandBuffer = nullptr );
+        // Push a marker that is displayed as the marker name followed by the index (for example, L"Pass " and 1).
+        void PushProfilingMarker( const ProfileMarker& marker, uint32_t index, std::shared_ptr<ComputeCommandBuffer> commandBuffer = nullptr );
+        // Slow path: the name is interned every call.
         void PushProfilingMarker( const std::wstring& name, std::shared_ptr<ComputeCommandBuffer> commandBuffer = nullptr );
         void PopProfilingMarker( std::shared_ptr<ComputeCommandBuffer> commandBuffer = nullptr );
 
         // This should be called after the command buffer has been submitted to the command queue.
         void UpdateQueryResults( std::shared_ptr<ComputeCommandQueue> commandQueue );
 
+        // Aggregate the recorded events of all threads into the profile nodes.
+        // This happens periodically on the aggregation thread but can be forced
+        // before reading the profile nodes.
+        void Flush();
+
+        // Lock the profile nodes while they are read (for example, by the GUI).
+        // Don't push profiler markers or clear the profiling data while the profiler is locked.
+        std::unique_lock<std::mutex> Lock();
+
         // Clear all profiling data
         void ClearAllProfilingData();
 
+        /**
+         * Record the begin and end time of every marker on every thread (and of the
+         * GPU queries, aligned to CPU time) for the next numFrames frames.
+         * The timeline is written to fileName in the Chrome trace event format
+         * which can be opened in chrome://tracing or https://ui.perfetto.dev.
+         */
+        void CaptureTimeline( uint32_t numFrames, const std::wstring& fileName );
+        bool IsCapturingTimeline() const;
+
         std::shared_ptr<ProfileNode> GetRootProfileMarker();
 
         void Accept( Core::ProfilerVisitor& visitor );
@@ -128,29 +212,91 @@ namespace Graphics
     protected:
 
     private:
-        friend struct ProfileNode;
+        // A GPU query that is assigned to a path in the profile tree.
+        struct GpuMarker
+        {
+            uint32_t QueryIndex;
+            std::wstring Name;
+        };
 
-        std::tuple< std::shared_ptr<Query>, uint32_t> AddQuery();
+        // A marker that is recorded while capturing a timeline.
+        struct TimelineEvent
+        {
+            std::shared_ptr<ProfileNode> Node;
+            // The thread that recorded the marker (0 for GPU queries).
+            uint32_t ThreadID;
+            uint64_t Frame;
+            // Microseconds since the start of the capture.
+            double StartTime;
+            double Duration;
+        };
+
+        void PushMarker( const ProfileMarker& marker, uint32_t index, ComputeCommandBuffer* commandBuffer );
+        const GpuMarker& GetGpuMarker( uint64_t path, const ProfileMarker& marker, uint32_t index );
+        void RecordEvent( ProfileEventBuffer& eventBuffer, const ProfileEvent& event );
+
+        // Runs on the aggregation thread.
+        void AggregateEvents();
+        void ProcessEvents( ProfileEventBuffer& eventBuffer );
+
+        // Add the GPU queries of this frame to the timeline.
+        void CaptureGpuEvents( ProfileNode& node, int64_t gpuTimestamp, double gpuFrequency, double gpuOffset );
+        // Write the captured timeline on a background thread.
+        void FinishTimeline();
 
         std::weak_ptr<Device> m_Device;
         std::shared_ptr<ProfileNode> m_RootNode;
-        std::shared_ptr<ProfileNode> m_CurrentNode;
         std::shared_ptr<Query> m_GpuTimestampQuery;
         std::atomic_uint32_t m_NumQueryTimers;
         std::vector<QueryResult> m_QueryResults;
-        uint64_t m_CurrentFrame;
+        std::atomic_uint64_t m_CurrentFrame;
+        // Protects the profile nodes.
         std::mutex m_Mutex;
-
-        bool m_Paused;
+        // Only one thread consumes the event buffers at a time.
+        std::mutex m_AggregateMutex;
+
+        // GPU queries are assigned once per path (the hash of the marker IDs from the root).
+        std::unordered_map<uint64_t, GpuMarker> m_GpuMarkers;
+        std::mutex m_GpuMarkersMutex;
+
+        std::thread m_AggregateThread;
+        std::condition_variable m_AggregateCondition;
+        std::mutex m_AggregateConditionMutex;
+        bool m_StopAggregating;
+
+        std::atomic_bool m_Paused;
+
+        // Timeline capture (protected by m_Mutex).
+        std::atomic_bool m_IsCapturingTimeline;
+        uint64_t m_TimelineStartFrame;
+        uint64_t m_TimelineEndFrame;
+        std::wstring m_TimelineFileName;
+        std::chrono::high_resolution_clock::time_point m_TimelineStartTime;
+        // The performance counter at m_TimelineStartTime (used to align the GPU timestamps).
+        int64_t m_TimelineStartCounter;
+        std::vector<TimelineEvent> m_TimelineEvents;
+        std::future<bool> m_TimelineTask;
     };
 
     class ENGINE_DLL ScopedProfileMarker
     {
     public:
+        ScopedProfileMarker( const ProfileMarker& marker, std::shared_ptr<ComputeCommandBuffer> commandBuffer = nullptr )
+            : m_CommandBuffer( commandBuffer )
+        {
+            Profiler::Get().PushProfilingMarker( marker, commandBuffer );
+        }
+
+        ScopedProfileMarker( const ProfileMarker& marker, uint32_t index, std::shared_ptr<ComputeCommandBuffer> commandBuffer = nullptr )
+            : m_CommandBuffer( commandBuffer )
+        {
+            Profiler::Get().PushProfilingMarker( marker, index, commandBuffer );
+        }
+
         ScopedProfileMarker( const std::wstring& name, std::shared_ptr<ComputeCommandBuffer> commandBuffer = nullptr )
             : m_CommandBuffer( commandBuffer )
         {
-            Profiler::Get().PushProfilingMarker( name, m_CommandBuffer.lock() );
+            Profiler::Get().PushProfilingMarker( name, commandBuffer );
         }
 
         ~ScopedProfileMarker()
@@ -162,9 +308,15 @@ namespace Graphics
     };
 }
 
+// A profiler marker with a name that is hashed at compile time.
+#define PROFILE_MARKER(name) Graphics::ProfileMarker( _W2(name), std::integral_constant<uint64_t, Graphics::HashMarkerName( _W2(name) )>::value )
+
+#define PROFILER_CONCAT2(a,b) a ## b
+#define PROFILER_CONCAT(a,b) PROFILER_CONCAT2(a,b)
+
 #if defined(PROFILE)
-#define CPU_MARKER(name) Graphics::ScopedProfileMarker profilerMarker##__LINE__( _W2(name) )
-#define GPU_MARKER(name,commandBuffer) Graphics::ScopedProfileMarker profilerMarker##__LINE__( _W2(name), std::static_pointer_cast<Graphics::ComputeCommandBuffer>( commandBuffer ) )
+#define CPU_MARKER(name) Graphics::ScopedProfileMarker PROFILER_CONCAT(profilerMarker, __LINE__)( PROFILE_MARKER(name) )
+#define GPU_MARKER(name,commandBuffer) Graphics::ScopedProfileMarker PROFILER_CONCAT(profilerMarker, __LINE__)( PROFILE_MARKER(name), std::static_pointer_cast<Graphics::ComputeCommandBuffer>( commandBuffer ) )
 #else
 #define CPU_MARKER(name)
 #define GPU_MARKER(name,commandBuffer)
@@ -45,6 +45,10 @@ namespace Graphics
             uint64_t NumSamples;                    // Valid for QueryType::Occlusion. Returns the number of samples written by the fragment shader between Query::Begin and Query::End.
             bool     AnySamples;                    // Valid for QueryType::OcclusionPredicate. Returns true if any samples were written by the fragment shader between Query::Begin and Query::End.
         };
+        // The raw GPU timestamps of Query::Begin and Query::End (valid for QueryType::Timer queries).
+        // Use ComputeCommandQueue::GetClockCalibration to convert them to CPU time.
+        uint64_t BeginTimestamp;
+        uint64_t EndTimestamp;
         // Are the results of the query valid?
         // You should check this before using the value.
         bool IsValid;
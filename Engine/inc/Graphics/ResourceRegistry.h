@@ -0,0 +1,159 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file ResourceRegistry.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Memory accounting of the resources that are created by a device.
+ */
+
+
+#include "../EngineDefines.h"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace Graphics
+{
+    enum class ResourceCategory
+    {
+        Buffer,
+        Texture,
+        RenderTarget,
+        DepthStencil,
+        UploadBuffer,       // CPU writable memory (for example, dynamic constant buffers).
+        ReadbackBuffer,     // CPU readable memory.
+        NumCategories
+    };
+
+    ENGINE_DLL const char* GetResourceCategoryName( ResourceCategory category );
+
+    // An allocation of a resource. Sizes are in bytes.
+    struct ResourceAllocation
+    {
+        uint64_t ID = 0;
+        std::wstring Name;
+        // The subsystem that created the resource (see ResourceRegistry::ScopedGroup).
+        std::wstring Group;
+        ResourceCategory Category = ResourceCategory::Buffer;
+        uint64_t Size = 0;
+        std::chrono::steady_clock::time_point CreationTime;
+        // The time (in seconds) between the creation and the release of the resource.
+        // Only valid for released resources.
+        double Lifetime = 0.0;
+    };
+
+    // The memory usage of a category or a group of resources.
+    struct ResourceMemoryUsage
+    {
+        uint64_t NumResources = 0;
+        uint64_t Size = 0;
+        uint64_t PeakSize = 0;
+    };
+
+    /**
+     * Records the size, category, name and lifetime of every resource that is
+     * created by a device. The registry does not depend on the graphics API (or
+     * on a device) so it can be used on its own to verify the accounting. The
+     * device implementation adds an allocation when the memory for a resource is
+     * created and removes it when the resource is released.
+     * All functions are thread safe.
+     */
+    class ENGINE_DLL ResourceRegistry
+    {
+    public:
+        static const uint64_t InvalidID = 0;
+        // The number of released allocations that are kept.
+        static const uint32_t MaxReleasedAllocations = 256;
+
+        /**
+         * Resources that are created on this thread while the group is in scope
+         * are added to the group (for example, L"Clustered Shading").
+         */
+        class ENGINE_DLL ScopedGroup
+        {
+        public:
+            ScopedGroup( const std::wstring& group );
+            ~ScopedGroup();
+
+        private:
+            std::wstring m_PreviousGroup;
+        };
+
+        ResourceRegistry();
+
+        /**
+         * Add an allocation to the registry.
+         * @returns The ID of the allocation.
+         */
+        uint64_t AddAllocation( ResourceCategory category, uint64_t size, const std::wstring& name = L"" );
+        // The memory of the resource was recreated (for example, the resource was resized).
+        // The name and the group of the allocation are kept.
+        void UpdateAllocation( uint64_t id, ResourceCategory category, uint64_t size );
+        void SetName( uint64_t id, const std::wstring& name );
+        void RemoveAllocation( uint64_t id );
+
+        // Get a copy of the live allocations (ordered by ID).
+        std::vector<ResourceAllocation> GetAllocations() const;
+        // Get a copy of the most recently released allocations.
+        std::vector<ResourceAllocation> GetReleasedAllocations() const;
+
+        ResourceMemoryUsage GetTotalUsage() const;
+        ResourceMemoryUsage GetCategoryUsage( ResourceCategory category ) const;
+        // Get the memory usage of every group (resources without a group are in the L"" group).
+        std::map<std::wstring, ResourceMemoryUsage> GetGroupUsage() const;
+
+        // The number of allocations that were added and removed since the registry was created.
+        uint64_t GetNumAllocationsAdded() const;
+        uint64_t GetNumAllocationsRemoved() const;
+
+        // Write the live allocations, the memory usage and the released allocations to a JSON file.
+        bool Save( const std::wstring& fileName ) const;
+        // Write the report to a file in the directory that is named after the current time 
+        // and the label (for example, the resolution of the window).
+        // Returns the name of the file or an empty string if the file could not be written.
+        std::wstring SaveReport( const std::wstring& directory, const std::wstring& label ) const;
+
+    private:
+        static void Add( ResourceMemoryUsage& usage, uint64_t size );
+        static void Remove( ResourceMemoryUsage& usage, uint64_t size );
+
+        std::unordered_map<uint64_t, ResourceAllocation> m_Allocations;
+        std::deque<ResourceAllocation> m_ReleasedAllocations;
+
+        ResourceMemoryUsage m_TotalUsage;
+        ResourceMemoryUsage m_CategoryUsage[static_cast<size_t>( ResourceCategory::NumCategories )];
+        std::map<std::wstring, ResourceMemoryUsage> m_GroupUsage;
+
+        uint64_t m_NextID;
+        uint64_t m_NumAllocationsAdded;
+        uint64_t m_NumAllocationsRemoved;
+
+        mutable std::mutex m_Mutex;
+    };
+}
@@ -48,6 +48,24 @@ namespace Graphics
     class Mesh;
     class CopyCommandBuffer;
     class ComputeCommandBuffer;
+    class Camera;
+    class SceneMeshList;
+
+    // Progress of a scene that is streamed in the background (see Scene::StreamFromFile).
+    struct SceneStreamingStatistics
+    {
+        uint32_t NumMeshes = 0;
+        uint32_t NumMeshesLoaded = 0;
+        uint32_t NumTextures = 0;
+        uint32_t NumTexturesLoaded = 0;
+        // Meshes (and their textures) that are visible from the initial camera.
+        uint32_t NumVisibleAssets = 0;
+        uint32_t NumVisibleAssetsLoaded = 0;
+        // The scene node hierarchy is available (but may not contain any meshes yet).
+        bool IsHierarchyLoaded = false;
+        // All meshes and textures have been loaded.
+        bool IsComplete = false;
+    };
 
     class ENGINE_DLL Scene : public Core::Object
     {
@@ -67,17 +85,59 @@ namespace Graphics
         * @param format The format of the scene file. Supported formats are: TODO: get a list of supported formats from ASSIMP.
         */
         virtual bool LoadFromString( std::shared_ptr<ComputeCommandBuffer> computeCommandBuffer, const std::string& scene, const std::string& format ) = 0;
+
+        /**
+        * Stream a scene from a file on disc. This function returns immediately.
+        * The scene node hierarchy is loaded first, then meshes and textures are
+        * loaded on background threads. Meshes that are visible from the camera are
+        * loaded first, then the remaining meshes are loaded by distance to the camera.
+        * Until its textures are loaded, a material is rendered using only its 
+        * material properties.
+        * Loaded assets are added to the scene in ApplyStreamedAssets.
+        *
+        * @param rootTransform The local transform of the root node of the scene.
+        * @param camera The camera that is used to prioritize the assets.
+        */
+        virtual bool StreamFromFile( const std::wstring& fileName, const glm::mat4& rootTransform, const Camera& camera ) = 0;
+
+        /**
+        * Add the assets that have been streamed since the last call to the scene.
+        * This should be called on the thread that renders the scene (before rendering).
+        */
+        virtual void ApplyStreamedAssets() = 0;
+
+        /**
+        * Cancel streaming and wait for the streaming threads to finish.
+        */
+        virtual void StopStreaming() = 0;
+
+        virtual SceneStreamingStatistics GetStreamingStatistics() const = 0;
+
         virtual void Render( Core::RenderEventArgs& renderEventArgs ) = 0;
 
         virtual std::shared_ptr<SceneNode> GetRootNode() const = 0;
 
         virtual void Accept( Core::SceneVisitor& visitor ) = 0;
 
+        /**
+        * Get a flattened list of the meshes in the scene (with world space bounding volumes).
+        * The list is updated (at most) once per frame so that it can be shared by
+        * all the passes that render the scene. The list is only rebuilt when the
+        * structure of the scene changes (see SceneMeshList::Update).
+        */
+        const SceneMeshList& GetMeshList( uint64_t frameCounter );
+        // The mesh list that was built last (or nullptr if the mesh list was never built).
+        const SceneMeshList* GetMeshList() const;
+
         // Register for the progress callback to be notified of scene loading progress.
         Core::ProgressEvent LoadingProgress;
 
     protected:
         virtual void OnLoadingProgress( Core::ProgressEventArgs& e );
 
+    private:
+        std::shared_ptr<SceneMeshList> m_MeshList;
+        uint64_t m_MeshListFrame = std::numeric_limits<uint64_t>::max();
+
     };
 }
\ No newline at end of file
@@ -0,0 +1,243 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file SceneMeshList.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief A flattened list of the meshes in a scene that can be culled against a view frustum.
+ */
+
+#include "../EngineDefines.h"
+
+#include "BVH.h"
+
+namespace Graphics
+{
+    class Scene;
+    class SceneNode;
+    class Mesh;
+    class Frustum;
+    class Ray;
+    class GraphicsCommandBuffer;
+    class TransformHierarchy;
+
+    /**
+     * Every mesh that is attached to a scene node is stored in the list
+     * together with the world space bounding volumes of the mesh so that
+     * the meshes can be culled without traversing the scene graph.
+     * The world space bounding spheres are stored as a structure of arrays
+     * so that 4 spheres are tested against a frustum plane at once (SSE).
+     * Spheres that intersect the frustum are also tested with their
+     * world space bounding box.
+     */
+    class ENGINE_DLL SceneMeshList
+    {
+    public:
+        struct Entry
+        {
+            Graphics::SceneNode* Node;
+            Graphics::Mesh* Mesh;
+            // World space axis-aligned bounding box.
+            glm::vec3 AABBMin;
+            glm::vec3 AABBMax;
+            // Index of the object data of the scene node.
+            uint32_t ObjectIndex;
+        };
+
+        // The per-object data of a scene node that is shared by all passes that render the node.
+        struct ObjectData
+        {
+            glm::mat4 World;
+            glm::mat4 InverseTransposeWorld;
+        };
+
+        struct RaycastHit
+        {
+            Graphics::SceneNode* Node = nullptr;
+            Graphics::Mesh* Mesh = nullptr;
+            // The index of the triangle in the (full detail) mesh.
+            uint32_t Triangle = BVH::InvalidPrimitive;
+            float Distance = FLT_MAX;
+            // The world space position of the hit.
+            glm::vec3 Point = glm::vec3( 0 );
+        };
+
+        struct CullingStatistics
+        {
+            uint32_t NumCulls = 0;
+            uint64_t NumMeshes = 0;
+            uint64_t NumVisibleMeshes = 0;
+        };
+
+        // Counters for the number of times state was bound (or did not have to be bound)
+        // while rendering the meshes of all passes in a frame.
+        struct DrawStatistics
+        {
+            uint32_t NumDraws = 0;
+            // Per object constant buffer.
+            uint32_t NumObjectBinds = 0;
+            uint32_t NumObjectBindsAvoided = 0;
+            // Material constant buffer and textures.
+            uint32_t NumMaterialBinds = 0;
+            uint32_t NumMaterialBindsAvoided = 0;
+            // Vertex and index buffers.
+            uint32_t NumBufferBinds = 0;
+            uint32_t NumBufferBindsAvoided = 0;
+            // Draws of the same mesh and material that were merged into instanced draws.
+            uint32_t NumInstancedDraws = 0;
+            uint32_t NumMergedDraws = 0;
+            // The object buffer is uploaded once per frame and reused by the other passes.
+            uint32_t NumObjectBufferUploads = 0;
+            uint32_t NumObjectBufferReuses = 0;
+            // Meshlets (and their triangles) that were culled before the mesh was drawn.
+            uint32_t NumMeshletsCulled = 0;
+            uint32_t NumMeshletTrianglesCulled = 0;
+        };
+
+        SceneMeshList();
+
+        /**
+         * Collect the meshes of the scene and compute their world space bounding volumes.
+         */
+        void Build( Scene& scene );
+
+        /**
+         * Rebuild the list if nodes or meshes were added to (or removed from) the scene.
+         * Otherwise only the object data and bounding volumes of the scene nodes 
+         * whose world transform changed since the last update are refreshed.
+         */
+        void Update( Scene& scene );
+
+        /**
+         * Get the indices of the meshes that are inside (or intersect) the frustum.
+         * The visible meshes are in the same order as the meshes in the list.
+         * Meshes without bounding volumes are always visible.
+         * Large lists are culled on multiple threads.
+         * @returns The number of visible meshes.
+         */
+        uint32_t Cull( const Frustum& frustum, std::vector<uint32_t>& visibleMeshes ) const;
+
+        /**
+         * Find the closest triangle of the scene meshes that is hit by the ray.
+         * The world space bounding spheres of the meshes are stored in a hierarchy
+         * that is built the first time a ray is traced after the list is built.
+         * The ray is transformed into the object space of the meshes that are hit
+         * and traced against the triangle hierarchy of the mesh (see Mesh::GetBVH).
+         * Meshes without a triangle hierarchy are ignored.
+         * @returns true if a mesh was hit.
+         */
+        bool Raycast( const Ray& ray, RaycastHit& hit, float maxDistance = FLT_MAX ) const;
+
+        uint32_t GetNumMeshes() const;
+        const Entry& GetEntry( uint32_t index ) const;
+
+        /**
+         * The object data of the scene nodes that have meshes.
+         * The object data is computed once when the list is built.
+         */
+        const std::vector<ObjectData>& GetObjectData() const;
+
+        /**
+         * The accumulated statistics of all the culls since the list was built.
+         */
+        CullingStatistics GetCullingStatistics() const;
+
+        /**
+         * Start rendering a new frame. The draw statistics of the previous
+         * frame are kept (see GetDrawStatistics) and the object data has 
+         * to be uploaded again.
+         */
+        void BeginFrame( uint64_t frameCounter );
+
+        /**
+         * Upload the object data to the command buffer, unless it was already
+         * uploaded in the current frame. All the passes of a frame record into 
+         * the command buffer of the frame, so they share the uploaded object data.
+         * @returns true if the object data was uploaded, false if the object data of the frame was reused.
+         */
+        bool UploadObjectData( GraphicsCommandBuffer& commandBuffer, uint64_t& gpuAddress ) const;
+
+        /**
+         * Add the draw statistics of a pass to the statistics of the current frame.
+         */
+        void AddDrawStatistics( const DrawStatistics& drawStatistics ) const;
+
+        /**
+         * The draw statistics of the last frame that was rendered.
+         */
+        DrawStatistics GetDrawStatistics() const;
+
+    private:
+        // Compute the world space bounding volumes of the meshes [first, last).
+        void UpdateBounds( uint32_t first, uint32_t last );
+        // Copy the world transform of the scene node of the object and update the bounds of its meshes.
+        void UpdateObject( uint32_t object );
+        void Cull( const Frustum& frustum, uint32_t first, uint32_t last, std::vector<uint32_t>& visibleMeshes ) const;
+
+        std::vector<Entry> m_Entries;
+
+        // The scene node of each object.
+        std::vector<Graphics::SceneNode*> m_ObjectNodes;
+        std::vector<ObjectData> m_ObjectData;
+        // The meshes of an object are stored next to each other in the list,
+        // the meshes of object i are [m_ObjectFirstEntry[i], m_ObjectFirstEntry[i + 1]).
+        std::vector<uint32_t> m_ObjectFirstEntry;
+
+        // The transform hierarchy of the scene when the list was built.
+        std::shared_ptr<TransformHierarchy> m_Transforms;
+        uint64_t m_StructureVersion;
+        // The version of the world transforms that were copied last.
+        uint64_t m_TransformVersion;
+        // The object of each transform in the hierarchy (or UINT32_MAX if the scene node has no meshes).
+        std::vector<uint32_t> m_TransformObjects;
+        std::vector<uint32_t> m_ChangedTransforms;
+
+        // World space bounding spheres (padded to a multiple of 4).
+        std::vector<float> m_CenterX;
+        std::vector<float> m_CenterY;
+        std::vector<float> m_CenterZ;
+        std::vector<float> m_Radius;
+
+        // The hierarchy of the bounding spheres of the meshes that can be hit by rays.
+        mutable BVH m_MeshBVH;
+        // The entry of each sphere in the mesh hierarchy.
+        mutable std::vector<uint32_t> m_MeshBVHEntries;
+        mutable bool m_IsMeshBVHValid;
+        mutable std::mutex m_MeshBVHMutex;
+
+        mutable std::mutex m_StatisticsMutex;
+        mutable CullingStatistics m_CullingStatistics;
+        mutable DrawStatistics m_DrawStatistics;
+        DrawStatistics m_LastDrawStatistics;
+
+        // The frame that is currently being rendered and the frame 
+        // in which the object data was uploaded.
+        uint64_t m_Frame;
+        mutable uint64_t m_ObjectBufferFrame;
+        mutable uint64_t m_ObjectBufferAddress;
+        mutable std::mutex m_ObjectBufferMutex;
+    };
+}
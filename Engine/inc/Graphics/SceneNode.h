@@ -11,13 +11,21 @@ namespace Core
 namespace Graphics
 {
     class Mesh;
+    class TransformHierarchy;
 
+    /**
+     * A scene node is a handle to a transform that is stored in a TransformHierarchy.
+     * All the scene nodes in a tree share the same transform hierarchy.
+     */
     class ENGINE_DLL SceneNode : public std::enable_shared_from_this<SceneNode>
     {
     public:
         explicit SceneNode( const glm::mat4& localTransform = glm::mat4( 1.0f ) );
         virtual ~SceneNode();
 
+        SceneNode( const SceneNode& ) = delete;
+        SceneNode& operator=( const SceneNode& ) = delete;
+
         /**
          * Assign a name to this scene node so that it can be searched for later.
          */
@@ -32,23 +40,40 @@ namespace Graphics
 
         /**
          * Gets the inverse of the local transform (relative to its parent world transform).
+         * Use this function sparingly as it is computed every time it is requested.
          */
         glm::mat4 GetInverseLocalTransform() const;
 
         /**
          * Gets the scene node's world transform (concatenated with parents world transform)
-         * This function should be used sparingly as it is computed every time
-         * it is requested.
+         * World transforms are cached in the transform hierarchy and only
+         * recomputed when a local transform in the hierarchy changes.
          */
         glm::mat4 GetWorldTransform() const;
         void SetWorldTransform( const glm::mat4& worldTransform );
 
         /**
          * Gets the inverse world transform of this scene node.
-         * Use this function sparingly as it is computed every time it is requested.
          */
         glm::mat4 GetInverseWorldTransform() const;
 
+        /**
+         * Gets the inverse transpose of the world transform (for transforming normals).
+         */
+        glm::mat4 GetInverseTransposeWorldTransform() const;
+
+        std::shared_ptr<SceneNode> GetParent() const;
+
+        /**
+         * The transform hierarchy that stores the transforms of this node (and its children).
+         */
+        std::shared_ptr<TransformHierarchy> GetTransformHierarchy() const;
+        /**
+         * The index of the transform of this node in the transform hierarchy.
+         * The index only changes when the structure of the hierarchy changes.
+         */
+        uint32_t GetTransformIndex() const;
+
         /**
          * Add a child node to this node.
          * NOTE: Circular references are not checked!
@@ -84,16 +109,20 @@ namespace Graphics
         glm::mat4 GetParentWorldTransform() const;
 
     private:
+        friend class TransformHierarchy;
+
+        // Move the transforms of this node and its children to the end of another hierarchy.
+        void MoveTransforms( std::shared_ptr<TransformHierarchy> transforms, const SceneNode* parent );
+
         typedef std::vector< std::shared_ptr<SceneNode> > NodeList;
         typedef std::multimap< std::string, std::shared_ptr<SceneNode> > NodeNameMap;
         typedef std::vector< std::shared_ptr<Mesh> > MeshList;
 
         std::string m_Name;
 
-        // Transforms node from parent's space to world space for rendering.
-        glm::mat4 m_LocalTransform;
-        // This is the inverse of the local -> world transform.
-        glm::mat4 m_InverseTransform;
+        // The local transform of this node is stored at m_TransformIndex in the transform hierarchy.
+        std::shared_ptr<TransformHierarchy> m_Transforms;
+        uint32_t m_TransformIndex;
 
         std::weak_ptr<SceneNode> m_pParentNode;
         NodeList m_Children;
@@ -0,0 +1,152 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file TransformHierarchy.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Flat (structure of arrays) storage for the transforms of a scene node hierarchy.
+ */
+
+#include "../EngineDefines.h"
+
+namespace Graphics
+{
+    class SceneNode;
+
+    /**
+     * Stores the local and world transforms of a scene node hierarchy in flat arrays.
+     * Transforms are stored in topological order (a parent is always stored before
+     * its children) so that all world transforms can be updated in a single
+     * linear pass over the arrays. Only transforms that are dirty (or have a
+     * dirty parent) are recomputed.
+     * Every update of the world transforms increments the version of the hierarchy
+     * so that users of the world transforms (see SceneMeshList) only have to copy the
+     * transforms that changed. Adding or removing transforms (or meshes, see 
+     * InvalidateStructure) increments the structure version.
+     * A SceneNode is a handle to a transform in a TransformHierarchy.
+     * All functions are thread safe.
+     */
+    class ENGINE_DLL TransformHierarchy
+    {
+    public:
+        static const uint32_t InvalidIndex = UINT32_MAX;
+
+        TransformHierarchy();
+
+        /**
+         * Allocate a new transform. New transforms are always appended to the
+         * end of the arrays so the parent is always stored before the new transform.
+         * @param node The scene node that owns the transform.
+         * @param parent The index of the parent transform or InvalidIndex for a root transform.
+         */
+        uint32_t Allocate( SceneNode* node, uint32_t parent, const glm::mat4& localTransform );
+
+        /**
+         * Release a transform. If more than half of the transforms are released,
+         * the arrays are compacted and the indices of the scene nodes are updated.
+         */
+        void Free( uint32_t index );
+
+        /**
+         * Change the parent of a transform. Only a parent that is stored before
+         * the transform (or InvalidIndex) is allowed.
+         */
+        void SetParent( uint32_t index, uint32_t parent );
+        uint32_t GetParent( uint32_t index ) const;
+
+        glm::mat4 GetLocalTransform( uint32_t index ) const;
+        void SetLocalTransform( uint32_t index, const glm::mat4& localTransform );
+
+        /**
+         * Get the world transform. Dirty transforms are updated first.
+         */
+        glm::mat4 GetWorldTransform( uint32_t index );
+        /**
+         * Get the inverse transpose of the world transform (for transforming normals).
+         */
+        glm::mat4 GetInverseTransposeWorldTransform( uint32_t index );
+
+        /**
+         * Update the world transforms of the dirty transforms (and their children).
+         */
+        void Update();
+
+        bool IsDirty() const;
+
+        /**
+         * Get the indices of the transforms whose world transform changed after 
+         * the version of the hierarchy. Dirty transforms are updated first.
+         * @returns The current version of the hierarchy.
+         */
+        uint64_t GetChangedTransforms( uint64_t version, std::vector<uint32_t>& changedTransforms );
+
+        /**
+         * The structure version is incremented when transforms are allocated, 
+         * released or reparented. The indices of the transforms only change
+         * when the structure version changes.
+         */
+        uint64_t GetStructureVersion() const;
+
+        /**
+         * Increment the structure version, for example when a mesh is added 
+         * to (or removed from) a scene node in the hierarchy.
+         */
+        void InvalidateStructure();
+
+        /**
+         * The number of transforms (that have not been released) in the hierarchy.
+         */
+        uint32_t GetNumTransforms() const;
+
+    private:
+        // The following functions must be called while m_Mutex is locked.
+
+        // Remove the released transforms from the arrays.
+        void Compact();
+        void UpdateTransforms();
+        uint32_t GetNumLiveTransforms() const;
+
+        void SetDirty( uint32_t index );
+
+        std::vector<SceneNode*> m_Nodes;
+        std::vector<uint32_t> m_Parents;
+        std::vector<glm::mat4> m_LocalTransforms;
+        std::vector<glm::mat4> m_WorldTransforms;
+        std::vector<glm::mat4> m_InverseTransposeWorldTransforms;
+        std::vector<uint8_t> m_Dirty;
+        // The version of the hierarchy in which the world transform was last updated.
+        std::vector<uint64_t> m_Versions;
+
+        uint32_t m_NumFree;
+        // All transforms before this index are up-to-date.
+        uint32_t m_FirstDirty;
+        std::atomic_bool m_IsDirty;
+        uint64_t m_Version;
+        uint64_t m_StructureVersion;
+        // Transforms are changed and (because world transforms are updated on request) read on multiple threads.
+        mutable std::mutex m_Mutex;
+    };
+}
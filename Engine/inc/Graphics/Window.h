@@ -43,6 +43,10 @@ namespace Graphics
         uint32_t GetWindowWidth() const;
         uint32_t GetWindowHeight() const;
 
+        // Resize the client area of the window (also if the window is hidden).
+        // The Resize event is invoked once the window has been resized.
+        virtual void SetClientSize( uint32_t width, uint32_t height ) = 0;
+
         virtual bool IsVSync() const;
         virtual void SetVSync( bool vSync );
 
@@ -0,0 +1,566 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file LockFreeQueue.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Bounded lock-free queues.
+ */
+
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace Core
+{
+    namespace Detail
+    {
+        /**
+         * Lets threads block until a lock-free queue changes. Notifying is cheap
+         * when no thread is waiting (no lock is taken).
+         */
+        class QueueWaiter
+        {
+        public:
+            QueueWaiter()
+                : m_NumWaiters( 0 )
+            {}
+
+            // Block until the predicate is true.
+            template<typename Predicate>
+            void Wait( Predicate predicate )
+            {
+                if ( Spin( predicate ) )
+                {
+                    return;
+                }
+
+                std::unique_lock<std::mutex> lock( m_Mutex );
+                ++m_NumWaiters;
+                std::atomic_thread_fence( std::memory_order_seq_cst );
+                m_Condition.wait( lock, predicate );
+                --m_NumWaiters;
+            }
+
+            // Block until the predicate is true or the timeout expires.
+            // @returns The value of the predicate.
+            template<typename Predicate, typename Rep, typename Period>
+            bool WaitFor( Predicate predicate, const std::chrono::duration<Rep, Period>& timeout )
+            {
+                if ( Spin( predicate ) )
+                {
+                    return true;
+                }
+
+                std::unique_lock<std::mutex> lock( m_Mutex );
+                ++m_NumWaiters;
+                std::atomic_thread_fence( std::memory_order_seq_cst );
+                bool result = m_Condition.wait_for( lock, timeout, predicate );
+                --m_NumWaiters;
+
+                return result;
+            }
+
+            // Must be called after every change to the queue that can make a predicate true.
+            void Notify()
+            {
+                // The change to the queue must be visible before the number of waiters is read,
+                // otherwise a thread that is about to wait could miss the change and the notification.
+                std::atomic_thread_fence( std::memory_order_seq_cst );
+                if ( m_NumWaiters.load( std::memory_order_relaxed ) > 0 )
+                {
+                    std::lock_guard<std::mutex> lock( m_Mutex );
+                    m_Condition.notify_all();
+                }
+            }
+
+        private:
+            template<typename Predicate>
+            static bool Spin( Predicate& predicate )
+            {
+                // Most waits are short. Don't go to sleep right away.
+                for ( int i = 0; i < 64; ++i )
+                {
+                    if ( predicate() )
+                    {
+                        return true;
+                    }
+                    std::this_thread::yield();
+                }
+
+                return false;
+            }
+
+            std::atomic_uint32_t m_NumWaiters;
+            std::mutex m_Mutex;
+            std::condition_variable m_Condition;
+        };
+
+        inline size_t RoundUpToPowerOfTwo( size_t capacity )
+        {
+            size_t size = 2;
+            while ( size < capacity )
+            {
+                size <<= 1;
+            }
+            return size;
+        }
+    }
+
+    /**
+     * A bounded multi-producer, multi-consumer queue that does not use locks
+     * (unless a thread blocks in Push or Pop). Every cell of the ring buffer has a
+     * sequence number that tells producers and consumers whether the cell can be
+     * written or read, so producers and consumers only contend on their own index.
+     * Values can be move-only.
+     *
+     * See: Dmitry Vyukov, "Bounded MPMC queue", 1024cores.net.
+     */
+    template<typename T>
+    class MPMCQueue
+    {
+    public:
+        // The capacity is rounded up to a power of two.
+        explicit MPMCQueue( size_t capacity = 1024 );
+        ~MPMCQueue();
+
+        MPMCQueue( const MPMCQueue& ) = delete;
+        MPMCQueue& operator=( const MPMCQueue& ) = delete;
+
+        /**
+         * Try to add a value to the back of the queue.
+         * @returns false if the queue is full (the value is not moved).
+         */
+        bool TryPush( T&& value );
+        bool TryPush( const T& value );
+        template<typename... Args>
+        bool TryEmplace( Args&&... args );
+
+        /**
+         * Try to remove a value from the front of the queue.
+         * @returns false if the queue is empty.
+         */
+        bool TryPop( T& value );
+
+        // Push a value. Blocks while the queue is full.
+        void Push( T value );
+        // Pop a value. Blocks while the queue is empty.
+        void Pop( T& value );
+        // Pop a value. Blocks while the queue is empty, but no longer than the timeout.
+        template<typename Rep, typename Period>
+        bool TryPopFor( T& value, const std::chrono::duration<Rep, Period>& timeout );
+
+        // The number of values in the queue. Only an estimate while other threads use the queue.
+        size_t Size() const;
+        bool Empty() const;
+        size_t Capacity() const;
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> Sequence;
+            typename std::aligned_storage<sizeof( T ), alignof( T )>::type Storage;
+        };
+
+        std::unique_ptr<Cell[]> m_Cells;
+        size_t m_Mask;
+
+        // Producers and consumers write to different cache lines.
+        alignas( 64 ) std::atomic<size_t> m_EnqueuePosition;
+        alignas( 64 ) std::atomic<size_t> m_DequeuePosition;
+
+        Detail::QueueWaiter m_NotEmpty;
+        Detail::QueueWaiter m_NotFull;
+    };
+
+    /**
+     * A bounded queue for exactly one producer thread and one consumer thread.
+     * Cheaper than the MPMCQueue because the producer and consumer never contend:
+     * both only write their own index and cache the index of the other thread.
+     */
+    template<typename T>
+    class SPSCQueue
+    {
+    public:
+        // The capacity is rounded up to a power of two.
+        explicit SPSCQueue( size_t capacity = 1024 );
+        ~SPSCQueue();
+
+        SPSCQueue( const SPSCQueue& ) = delete;
+        SPSCQueue& operator=( const SPSCQueue& ) = delete;
+
+        // Must only be called by the producer.
+        bool TryPush( T&& value );
+        bool TryPush( const T& value );
+        template<typename... Args>
+        bool TryEmplace( Args&&... args );
+        void Push( T value );
+
+        // Must only be called by the consumer.
+        bool TryPop( T& value );
+        void Pop( T& value );
+        template<typename Rep, typename Period>
+        bool TryPopFor( T& value, const std::chrono::duration<Rep, Period>& timeout );
+
+        size_t Size() const;
+        bool Empty() const;
+        size_t Capacity() const;
+
+    private:
+        using Storage = typename std::aligned_storage<sizeof( T ), alignof( T )>::type;
+
+        T* GetValue( size_t index )
+        {
+            return reinterpret_cast<T*>( &m_Values[index & m_Mask] );
+        }
+
+        std::unique_ptr<Storage[]> m_Values;
+        size_t m_Mask;
+
+        // Written by the consumer.
+        alignas( 64 ) std::atomic<size_t> m_Head;
+        size_t m_CachedTail;
+
+        // Written by the producer.
+        alignas( 64 ) std::atomic<size_t> m_Tail;
+        size_t m_CachedHead;
+
+        Detail::QueueWaiter m_NotEmpty;
+        Detail::QueueWaiter m_NotFull;
+    };
+
+    template<typename T>
+    MPMCQueue<T>::MPMCQueue( size_t capacity )
+        : m_Cells( new Cell[Detail::RoundUpToPowerOfTwo( capacity )] )
+        , m_Mask( Detail::RoundUpToPowerOfTwo( capacity ) - 1 )
+        , m_EnqueuePosition( 0 )
+        , m_DequeuePosition( 0 )
+    {
+        for ( size_t i = 0; i <= m_Mask; ++i )
+        {
+            m_Cells[i].Sequence.store( i, std::memory_order_relaxed );
+        }
+    }
+
+    template<typename T>
+    MPMCQueue<T>::~MPMCQueue()
+    {
+        // Destroy the values that were not popped.
+        size_t end = m_EnqueuePosition.load( std::memory_order_relaxed );
+        for ( size_t position = m_DequeuePosition.load( std::memory_order_relaxed ); position != end; ++position )
+        {
+            Cell& cell = m_Cells[position & m_Mask];
+            if ( cell.Sequence.load( std::memory_order_acquire ) == position + 1 )
+            {
+                reinterpret_cast<T*>( &cell.Storage )->~T();
+            }
+        }
+    }
+
+    template<typename T>
+    bool MPMCQueue<T>::TryPush( T&& value )
+    {
+        return TryEmplace( std::move( value ) );
+    }
+
+    template<typename T>
+    bool MPMCQueue<T>::TryPush( const T& value )
+    {
+        return TryEmplace( value );
+    }
+
+    template<typename T>
+    template<typename... Args>
+    bool MPMCQueue<T>::TryEmplace( Args&&... args )
+    {
+        Cell* cell;
+        size_t position = m_EnqueuePosition.load( std::memory_order_relaxed );
+        while ( true )
+        {
+            cell = &m_Cells[position & m_Mask];
+            size_t sequence = cell->Sequence.load( std::memory_order_acquire );
+            intptr_t difference = static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( position );
+            if ( difference == 0 )
+            {
+                // The cell is free. Claim it.
+                if ( m_EnqueuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+                {
+                    break;
+                }
+            }
+            else if ( difference < 0 )
+            {
+                // The cell still contains the value of the previous lap.
+                return false;
+            }
+            else
+            {
+                // Another producer claimed the cell.
+                position = m_EnqueuePosition.load( std::memory_order_relaxed );
+            }
+        }
+
+        new ( &cell->Storage ) T( std::forward<Args>( args )... );
+        cell->Sequence.store( position + 1, std::memory_order_release );
+
+        m_NotEmpty.Notify();
+
+        return true;
+    }
+
+    template<typename T>
+    bool MPMCQueue<T>::TryPop( T& value )
+    {
+        Cell* cell;
+        size_t position = m_DequeuePosition.load( std::memory_order_relaxed );
+        while ( true )
+        {
+            cell = &m_Cells[position & m_Mask];
+            size_t sequence = cell->Sequence.load( std::memory_order_acquire );
+            intptr_t difference = static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( position + 1 );
+            if ( difference == 0 )
+            {
+                if ( m_DequeuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+                {
+                    break;
+                }
+            }
+            else if ( difference < 0 )
+            {
+                // The cell has not been written yet.
+                return false;
+            }
+            else
+            {
+                position = m_DequeuePosition.load( std::memory_order_relaxed );
+            }
+        }
+
+        T* pValue = reinterpret_cast<T*>( &cell->Storage );
+        value = std::move( *pValue );
+        pValue->~T();
+        // The cell can be written in the next lap.
+        cell->Sequence.store( position + m_Mask + 1, std::memory_order_release );
+
+        m_NotFull.Notify();
+
+        return true;
+    }
+
+    template<typename T>
+    void MPMCQueue<T>::Push( T value )
+    {
+        while ( !TryPush( std::move( value ) ) )
+        {
+            m_NotFull.Wait( [this]() { return Size() < Capacity(); } );
+        }
+    }
+
+    template<typename T>
+    void MPMCQueue<T>::Pop( T& value )
+    {
+        while ( !TryPop( value ) )
+        {
+            m_NotEmpty.Wait( [this]() { return !Empty(); } );
+        }
+    }
+
+    template<typename T>
+    template<typename Rep, typename Period>
+    bool MPMCQueue<T>::TryPopFor( T& value, const std::chrono::duration<Rep, Period>& timeout )
+    {
+        auto endTime = std::chrono::steady_clock::now() + timeout;
+        while ( !TryPop( value ) )
+        {
+            auto now = std::chrono::steady_clock::now();
+            if ( now >= endTime || !m_NotEmpty.WaitFor( [this]() { return !Empty(); }, endTime - now ) )
+            {
+                return TryPop( value );
+            }
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    size_t MPMCQueue<T>::Size() const
+    {
+        size_t dequeuePosition = m_DequeuePosition.load( std::memory_order_relaxed );
+        size_t enqueuePosition = m_EnqueuePosition.load( std::memory_order_relaxed );
+        return enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0;
+    }
+
+    template<typename T>
+    bool MPMCQueue<T>::Empty() const
+    {
+        return Size() == 0;
+    }
+
+    template<typename T>
+    size_t MPMCQueue<T>::Capacity() const
+    {
+        return m_Mask + 1;
+    }
+
+    template<typename T>
+    SPSCQueue<T>::SPSCQueue( size_t capacity )
+        : m_Values( new Storage[Detail::RoundUpToPowerOfTwo( capacity )] )
+        , m_Mask( Detail::RoundUpToPowerOfTwo( capacity ) - 1 )
+        , m_Head( 0 )
+        , m_CachedTail( 0 )
+        , m_Tail( 0 )
+        , m_CachedHead( 0 )
+    {}
+
+    template<typename T>
+    SPSCQueue<T>::~SPSCQueue()
+    {
+        size_t tail = m_Tail.load( std::memory_order_acquire );
+        for ( size_t head = m_Head.load( std::memory_order_relaxed ); head != tail; ++head )
+        {
+            GetValue( head )->~T();
+        }
+    }
+
+    template<typename T>
+    bool SPSCQueue<T>::TryPush( T&& value )
+    {
+        return TryEmplace( std::move( value ) );
+    }
+
+    template<typename T>
+    bool SPSCQueue<T>::TryPush( const T& value )
+    {
+        return TryEmplace( value );
+    }
+
+    template<typename T>
+    template<typename... Args>
+    bool SPSCQueue<T>::TryEmplace( Args&&... args )
+    {
+        size_t tail = m_Tail.load( std::memory_order_relaxed );
+        if ( tail - m_CachedHead > m_Mask )
+        {
+            // Only read the index of the consumer when the queue appears to be full.
+            m_CachedHead = m_Head.load( std::memory_order_acquire );
+            if ( tail - m_CachedHead > m_Mask )
+            {
+                return false;
+            }
+        }
+
+        new ( GetValue( tail ) ) T( std::forward<Args>( args )... );
+        m_Tail.store( tail + 1, std::memory_order_release );
+
+        m_NotEmpty.Notify();
+
+        return true;
+    }
+
+    template<typename T>
+    bool SPSCQueue<T>::TryPop( T& value )
+    {
+        size_t head = m_Head.load( std::memory_order_relaxed );
+        if ( head == m_CachedTail )
+        {
+            // Only read the index of the producer when the queue appears to be empty.
+            m_CachedTail = m_Tail.load( std::memory_order_acquire );
+            if ( head == m_CachedTail )
+            {
+                return false;
+            }
+        }
+
+        T* pValue = GetValue( head );
+        value = std::move( *pValue );
+        pValue->~T();
+        m_Head.store( head + 1, std::memory_order_release );
+
+        m_NotFull.Notify();
+
+        return true;
+    }
+
+    template<typename T>
+    void SPSCQueue<T>::Push( T value )
+    {
+        while ( !TryPush( std::move( value ) ) )
+        {
+            m_NotFull.Wait( [this]() { return Size() < Capacity(); } );
+        }
+    }
+
+    template<typename T>
+    void SPSCQueue<T>::Pop( T& value )
+    {
+        while ( !TryPop( value ) )
+        {
+            m_NotEmpty.Wait( [this]() { return !Empty(); } );
+        }
+    }
+
+    template<typename T>
+    template<typename Rep, typename Period>
+    bool SPSCQueue<T>::TryPopFor( T& value, const std::chrono::duration<Rep, Period>& timeout )
+    {
+        auto endTime = std::chrono::steady_clock::now() + timeout;
+        while ( !TryPop( value ) )
+        {
+            auto now = std::chrono::steady_clock::now();
+            if ( now >= endTime || !m_NotEmpty.WaitFor( [this]() { return !Empty(); }, endTime - now ) )
+            {
+                return TryPop( value );
+            }
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    size_t SPSCQueue<T>::Size() const
+    {
+        size_t head = m_Head.load( std::memory_order_relaxed );
+        size_t tail = m_Tail.load( std::memory_order_relaxed );
+        return tail > head ? tail - head : 0;
+    }
+
+    template<typename T>
+    bool SPSCQueue<T>::Empty() const
+    {
+        return Size() == 0;
+    }
+
+    template<typename T>
+    size_t SPSCQueue<T>::Capacity() const
+    {
+        return m_Mask + 1;
+    }
+}
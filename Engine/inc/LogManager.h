@@ -33,7 +33,10 @@
 #include "NonCopyable.h"
 #include "Common.h"
 
+#include <chrono>
 #include <sstream>
+#include <tuple>
+#include <type_traits>
 
 namespace Core
 {
@@ -52,6 +55,231 @@ namespace Core
         static constexpr bool enable = true;
     };
 
+    /**
+     * A string that exists until the program exits (a string literal, __FILE__ or
+     * __FUNCTION__). Only the pointer is stored in the log message.
+     * For example: LogManager::LogInfo( LogLiteral( __FUNCTION__ ), ": ", value ).
+     */
+    template<typename Char>
+    struct LogLiteral
+    {
+        explicit LogLiteral( const Char* text )
+            : Text( text )
+        {}
+
+        const Char* Text;
+    };
+
+    namespace Detail
+    {
+        // A copy of a character array (that can be a local buffer).
+        template<typename Char, size_t N>
+        struct LogArray
+        {
+            Char Text[N];
+        };
+
+        /**
+         * How an argument of a log message is stored until the log thread formats it.
+         * Arguments that are not numbers or strings are formatted right away because
+         * they may have changed by the time the message is formatted.
+         */
+        template<typename T, typename Enable = void>
+        struct LogArgument
+        {
+            using Type = std::wstring;
+
+            static Type Capture( const T& value )
+            {
+                using ::to_wstring;
+                using std::to_wstring;
+
+                return to_wstring( value );
+            }
+        };
+
+        template<typename T>
+        struct LogArgument<T, std::enable_if_t<std::is_arithmetic<T>::value>>
+        {
+            using Type = std::remove_cv_t<T>;
+
+            static Type Capture( T value )
+            {
+                return value;
+            }
+        };
+
+        template<typename Char>
+        struct LogArgument<LogLiteral<Char>>
+        {
+            using Type = LogLiteral<Char>;
+
+            static Type Capture( const LogLiteral<Char>& literal )
+            {
+                return literal;
+            }
+        };
+
+        template<typename Char>
+        struct LogArgument<const LogLiteral<Char>> : LogArgument<LogLiteral<Char>>
+        {};
+
+        // Constant character arrays (including string literals) are copied into the message
+        // because they can be local buffers that don't exist when the message is formatted.
+        template<typename Char, size_t N>
+        struct LogArgument<const Char[N], std::enable_if_t<std::is_same<Char, char>::value || std::is_same<Char, wchar_t>::value>>
+        {
+            using Type = LogArray<Char, N>;
+
+            static Type Capture( const Char ( &text )[N] )
+            {
+                Type copy;
+                std::copy( text, text + N, copy.Text );
+                return copy;
+            }
+        };
+
+        template<typename T, typename Char>
+        using IsLogString = std::integral_constant<bool,
+            ( ( std::is_same<std::decay_t<T>, Char*>::value || std::is_same<std::decay_t<T>, const Char*>::value ) &&
+              !( std::is_array<T>::value && std::is_const<std::remove_extent_t<T>>::value ) ) ||
+            std::is_same<std::remove_cv_t<T>, std::basic_string<Char>>::value>;
+
+        // Other strings can be changed or freed before the message is formatted so they are copied.
+        template<typename T>
+        struct LogArgument<T, std::enable_if_t<IsLogString<T, char>::value>>
+        {
+            using Type = std::string;
+
+            static Type Capture( const char* text )
+            {
+                return text;
+            }
+
+            static Type Capture( std::string text )
+            {
+                return text;
+            }
+        };
+
+        template<typename T>
+        struct LogArgument<T, std::enable_if_t<IsLogString<T, wchar_t>::value>>
+        {
+            using Type = std::wstring;
+
+            static Type Capture( const wchar_t* text )
+            {
+                return text;
+            }
+
+            static Type Capture( std::wstring text )
+            {
+                return text;
+            }
+        };
+
+        template<typename T>
+        void AppendLogArgument( std::wstring& message, const T& value )
+        {
+            using ::to_wstring;
+            using std::to_wstring;
+
+            message += to_wstring( value );
+        }
+
+        inline void AppendLogArgument( std::wstring& message, const LogLiteral<char>& literal )
+        {
+            message += ConvertString( literal.Text );
+        }
+
+        inline void AppendLogArgument( std::wstring& message, const LogLiteral<wchar_t>& literal )
+        {
+            message += literal.Text;
+        }
+
+        // The array is not necessarily filled up to the terminating null character.
+        template<size_t N>
+        void AppendLogArgument( std::wstring& message, const LogArray<char, N>& array )
+        {
+            message += ConvertString( std::string( array.Text, std::find( array.Text, array.Text + N, '\0' ) ) );
+        }
+
+        template<size_t N>
+        void AppendLogArgument( std::wstring& message, const LogArray<wchar_t, N>& array )
+        {
+            message.append( array.Text, std::find( array.Text, array.Text + N, L'\0' ) );
+        }
+
+        inline void AppendLogArgument( std::wstring& message, const std::string& value )
+        {
+            message += ConvertString( value );
+        }
+
+        inline void AppendLogArgument( std::wstring& message, const std::wstring& value )
+        {
+            message += value;
+        }
+    }
+
+    /**
+     * A log message that is formatted by the log thread. The arguments are stored
+     * in the message itself (see Detail::LogArgument) so logging a message does not
+     * convert numbers to strings and (usually) does not allocate memory.
+     */
+    class LogMessage
+    {
+    public:
+        LogMessage();
+
+        template<typename... Args>
+        LogMessage( LogLevel level, Args&&... args );
+
+        LogMessage( LogMessage&& other );
+        LogMessage& operator=( LogMessage&& other );
+        ~LogMessage();
+
+        LogMessage( const LogMessage& ) = delete;
+        LogMessage& operator=( const LogMessage& ) = delete;
+
+        LogLevel GetLevel() const;
+
+        // The time the message was logged.
+        std::chrono::steady_clock::time_point GetTime() const;
+
+        /**
+         * Append the formatted message to a string.
+         */
+        void Format( std::wstring& message ) const;
+
+    private:
+        // A message is 256 bytes (on x64). Arguments that don't fit are formatted right away.
+        static const size_t MaxArgumentsSize = 232;
+
+        struct Operations
+        {
+            void ( *Format )( const void* arguments, std::wstring& message );
+            void ( *Move )( void* destination, void* source );
+            void ( *Destroy )( void* arguments );
+        };
+
+        template<typename Tuple, typename... Values>
+        void Construct( Values&&... values );
+
+        template<typename Tuple>
+        static void FormatArguments( const void* arguments, std::wstring& message );
+        template<typename Tuple>
+        static void MoveArguments( void* destination, void* source );
+        template<typename Tuple>
+        static void DestroyArguments( void* arguments );
+        template<typename Tuple>
+        static const Operations* GetOperations();
+
+        LogLevel m_Level;
+        std::chrono::steady_clock::time_point m_Time;
+        const Operations* m_Operations;
+        std::aligned_storage_t<MaxArgumentsSize, alignof( std::max_align_t )> m_Arguments;
+    };
+
     class ENGINE_DLL LogManager : public NonCopyable
     {
     public:
@@ -61,60 +289,164 @@ namespace Core
         static void Shutdown();
 
         template<typename... Args>
-        static void LogInfo( Args... args );
+        static void LogInfo( Args&&... args );
 
         template<typename... Args>
-        static void LogWarning( Args... args );
+        static void LogWarning( Args&&... args );
 
         template<typename... Args>
-        static void LogError( Args... args );
+        static void LogError( Args&&... args );
+
+        /**
+         * The number of messages that were dropped because the log buffer of
+         * the thread that logged the message was full.
+         */
+        static uint64_t GetNumDroppedMessages();
+
+        /**
+         * The number of times the log thread woke up (to write messages or to
+         * flush the log streams). It does not wake up while nothing is logged.
+         */
+        static uint64_t GetNumWakeups();
 
     private:
         static void UnregisterAllStreams();
-        static void Log( LogLevel level, const std::wstring& message );
-        static void Log( LogLevel level, const std::string& mssage );
+        static void Log( LogMessage&& message );
     };
 
+    inline LogMessage::LogMessage()
+        : m_Level( LogLevel::Info )
+        , m_Operations( nullptr )
+    {}
+
     template<typename... Args>
-    void LogManager::LogInfo( Args... args )
+    LogMessage::LogMessage( LogLevel level, Args&&... args )
+        : m_Level( level )
+        , m_Time( std::chrono::steady_clock::now() )
+        , m_Operations( nullptr )
     {
-        std::wstring str;
+        using Tuple = std::tuple<typename Detail::LogArgument<std::remove_reference_t<Args>>::Type...>;
 
-        using ::to_wstring;
-        using std::to_wstring;
+        Construct<Tuple>( Detail::LogArgument<std::remove_reference_t<Args>>::Capture( std::forward<Args>( args ) )... );
+    }
+
+    inline LogMessage::LogMessage( LogMessage&& other )
+        : m_Level( other.m_Level )
+        , m_Time( other.m_Time )
+        , m_Operations( other.m_Operations )
+    {
+        if ( m_Operations )
+        {
+            m_Operations->Move( &m_Arguments, &other.m_Arguments );
+            other.m_Operations = nullptr;
+        }
+    }
 
-        int unpack[]{ 0, ( str += to_wstring( args ), 0 )... };
+    inline LogMessage& LogMessage::operator=( LogMessage&& other )
+    {
+        if ( this != &other )
+        {
+            this->~LogMessage();
+            new ( this ) LogMessage( std::move( other ) );
+        }
 
-        Log( LogLevel::Info, str );
+        return *this;
     }
 
-    template<typename... Args>
-    void LogManager::LogWarning( Args... args )
+    inline LogMessage::~LogMessage()
     {
-        std::wstring str;
+        if ( m_Operations )
+        {
+            m_Operations->Destroy( &m_Arguments );
+            m_Operations = nullptr;
+        }
+    }
 
-        using ::to_wstring;
-        using std::to_wstring;
+    inline LogLevel LogMessage::GetLevel() const
+    {
+        return m_Level;
+    }
 
-        int unpack[]{ 0, ( str += to_wstring( args ), 0 )... };
+    inline std::chrono::steady_clock::time_point LogMessage::GetTime() const
+    {
+        return m_Time;
+    }
 
-        Log( LogLevel::Warning, str );
+    inline void LogMessage::Format( std::wstring& message ) const
+    {
+        if ( m_Operations )
+        {
+            m_Operations->Format( &m_Arguments, message );
+        }
     }
 
-    template<typename... Args>
-    void LogManager::LogError( Args... args )
+    template<typename Tuple, typename... Values>
+    void LogMessage::Construct( Values&&... values )
     {
-        std::wstring str;
+        if constexpr ( sizeof( Tuple ) <= MaxArgumentsSize && alignof( Tuple ) <= alignof( std::max_align_t ) )
+        {
+            new ( &m_Arguments ) Tuple( std::forward<Values>( values )... );
+            m_Operations = GetOperations<Tuple>();
+        }
+        else
+        {
+            // Too many arguments. Format the message now.
+            std::wstring message;
+            int unpack[]{ 0, ( Detail::AppendLogArgument( message, values ), 0 )... };
 
-        using ::to_wstring;
-        using std::to_wstring;
+            Construct< std::tuple<std::wstring> >( std::move( message ) );
+        }
+    }
 
-        int unpack[]{ 0, ( str += to_wstring( args ), 0 )... };
+    template<typename Tuple>
+    void LogMessage::FormatArguments( const void* arguments, std::wstring& message )
+    {
+        std::apply( [&message]( const auto&... values )
+        {
+            int unpack[]{ 0, ( Detail::AppendLogArgument( message, values ), 0 )... };
+        }, *static_cast<const Tuple*>( arguments ) );
+    }
+
+    template<typename Tuple>
+    void LogMessage::MoveArguments( void* destination, void* source )
+    {
+        Tuple* sourceArguments = static_cast<Tuple*>( source );
+        new ( destination ) Tuple( std::move( *sourceArguments ) );
+        sourceArguments->~Tuple();
+    }
+
+    template<typename Tuple>
+    void LogMessage::DestroyArguments( void* arguments )
+    {
+        static_cast<Tuple*>( arguments )->~Tuple();
+    }
+
+    template<typename Tuple>
+    const LogMessage::Operations* LogMessage::GetOperations()
+    {
+        static const Operations operations = { &FormatArguments<Tuple>, &MoveArguments<Tuple>, &DestroyArguments<Tuple> };
+        return &operations;
+    }
 
-        Log( LogLevel::Error, str );
+    template<typename... Args>
+    void LogManager::LogInfo( Args&&... args )
+    {
+        Log( LogMessage( LogLevel::Info, std::forward<Args>( args )... ) );
+    }
+
+    template<typename... Args>
+    void LogManager::LogWarning( Args&&... args )
+    {
+        Log( LogMessage( LogLevel::Warning, std::forward<Args>( args )... ) );
+    }
+
+    template<typename... Args>
+    void LogManager::LogError( Args&&... args )
+    {
+        Log( LogMessage( LogLevel::Error, std::forward<Args>( args )... ) );
     }
 }
 
-#define LOG_INFO(...) Core::LogManager::LogInfo( __FILE__, "(", __LINE__, "): [INFO] ", __FUNCTION__, ": ", __VA_ARGS__ )
-#define LOG_WARNING(...) Core::LogManager::LogWarning( __FILE__, "(", __LINE__, "): [WARNING] ", __FUNCTION__, ": ", __VA_ARGS__ )
-#define LOG_ERROR(...) Core::LogManager::LogError( __FILE__, "(", __LINE__, "): [ERROR] ", __FUNCTION__, ": ", __VA_ARGS__ )
+#define LOG_INFO(...) Core::LogManager::LogInfo( Core::LogLiteral( __FILE__ ), "(", __LINE__, "): [INFO] ", Core::LogLiteral( __FUNCTION__ ), ": ", __VA_ARGS__ )
+#define LOG_WARNING(...) Core::LogManager::LogWarning( Core::LogLiteral( __FILE__ ), "(", __LINE__, "): [WARNING] ", Core::LogLiteral( __FUNCTION__ ), ": ", __VA_ARGS__ )
+#define LOG_ERROR(...) Core::LogManager::LogError( Core::LogLiteral( __FILE__ ), "(", __LINE__, "): [ERROR] ", Core::LogLiteral( __FUNCTION__ ), ": ", __VA_ARGS__ )
@@ -48,6 +48,12 @@ namespace Core
          * Write a message to the log stream.
          */
         virtual void Write( LogLevel level, const std::wstring& message ) = 0;
+
+        /**
+         * Write buffered messages to their destination.
+         * The log manager flushes the streams periodically and after every error.
+         */
+        virtual void Flush() {}
     };
 
     /**
@@ -60,6 +66,7 @@ namespace Core
         virtual ~LogStreamFile();
 
         virtual void Write( LogLevel level, const std::wstring& message ) override;
+        virtual void Flush() override;
 
     private:
         std::mutex m_FileMutex;   // Protect access to file.
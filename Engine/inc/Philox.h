@@ -0,0 +1,109 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file Philox.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Counter-based random number generator.
+ */
+
+
+#include "EngineDefines.h"
+
+namespace Core
+{
+    /**
+     * Philox4x32-10 counter-based random number generator
+     * ("Parallel Random Numbers: As Easy as 1, 2, 3", Salmon et al. 2011).
+     *
+     * Instead of advancing an internal state, every call maps a 128-bit counter
+     * to 4 random 32-bit values using a key (the seed). Random numbers can be
+     * generated in any order and on any number of threads: the same seed and
+     * counter always produce the same numbers.
+     */
+    class Philox
+    {
+    public:
+        using Counter = std::array<uint32_t, 4>;
+
+        explicit Philox( uint64_t seed = 0 )
+            : m_Key{ static_cast<uint32_t>( seed ), static_cast<uint32_t>( seed >> 32 ) }
+        {}
+
+        /**
+         * Generate 4 random 32-bit values for the counter.
+         */
+        Counter operator()( Counter counter ) const
+        {
+            const uint32_t M0 = 0xD2511F53;
+            const uint32_t M1 = 0xCD9E8D57;
+            const uint32_t W0 = 0x9E3779B9;
+            const uint32_t W1 = 0xBB67AE85;
+
+            uint32_t key0 = m_Key[0];
+            uint32_t key1 = m_Key[1];
+
+            for ( int round = 0; round < 10; ++round )
+            {
+                uint64_t product0 = static_cast<uint64_t>( M0 ) * counter[0];
+                uint64_t product1 = static_cast<uint64_t>( M1 ) * counter[2];
+
+                counter = {
+                    static_cast<uint32_t>( product1 >> 32 ) ^ counter[1] ^ key0,
+                    static_cast<uint32_t>( product1 ),
+                    static_cast<uint32_t>( product0 >> 32 ) ^ counter[3] ^ key1,
+                    static_cast<uint32_t>( product0 )
+                };
+
+                key0 += W0;
+                key1 += W1;
+            }
+
+            return counter;
+        }
+
+        /**
+         * Generate 4 uniformly distributed floats in the range [0, 1).
+         */
+        glm::vec4 Uniform4( uint32_t c0, uint32_t c1 = 0, uint32_t c2 = 0, uint32_t c3 = 0 ) const
+        {
+            Counter r = ( *this )( Counter{ c0, c1, c2, c3 } );
+            return glm::vec4( ToFloat( r[0] ), ToFloat( r[1] ), ToFloat( r[2] ), ToFloat( r[3] ) );
+        }
+
+        /**
+         * Convert a random 32-bit value to a float in the range [0, 1).
+         * Only the upper 24 bits are used so the result is never rounded up to 1.
+         */
+        static float ToFloat( uint32_t x )
+        {
+            return ( x >> 8 ) * ( 1.0f / 16777216.0f );
+        }
+
+    private:
+        uint32_t m_Key[2];
+    };
+}
@@ -12,6 +12,13 @@ namespace boost
 {
     namespace serialization
     {
+        template<class Archive>
+        void serialize( Archive& ar, glm::uvec2& v, const unsigned int version )
+        {
+            ar & make_nvp( "X", v.x );
+            ar & make_nvp( "Y", v.y );
+        }
+
         template<class Archive>
         void serialize( Archive& ar, glm::vec3& v, const unsigned int version )
         {
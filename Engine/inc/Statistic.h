@@ -28,12 +28,135 @@
  *  @author jeremiah
  *
  *  @brief Used for recording numerical statistics.
+ *  The mean and variance are updated online (Welford) and percentiles are
+ *  estimated with a fixed size logarithmic histogram so that recording a
+ *  sample takes constant time and memory. The histogram is only allocated
+ *  for statistics whose percentiles are requested.
  */
 
 #include "EngineDefines.h"
 
+#include <vector>
+#include <cmath>
+#include <deque>
+
 namespace Core
 {
+    enum class StatisticMode
+    {
+        AllTime,    // Min, max, average, variance and percentiles cover all recorded samples.
+        Window,     // Only the last maxSamples samples are taken into account.
+    };
+
+    /**
+     * A streaming quantile sketch with a fixed number of logarithmic buckets.
+     * Each bucket covers values in the range (Gamma^(i-1), Gamma^i] so the relative error
+     * of a returned quantile is at most RelativeAccuracy (DDSketch, Masson et al. 2019).
+     * Values outside the range of the buckets are clamped to the first and last bucket
+     * and values smaller than MinValue (including negative values) are counted as zero.
+     * The buckets are allocated when the first (non-zero) value is added.
+     */
+    class QuantileSketch
+    {
+    public:
+        static const uint32_t NumBuckets = 2048;
+        // 1% relative error.
+        static constexpr double RelativeAccuracy = 0.01;
+        // The smallest value that can be distinguished from zero (1 ns if values are in seconds).
+        static constexpr double MinValue = 1e-9;
+
+        QuantileSketch()
+            : m_Gamma( ( 1.0 + RelativeAccuracy ) / ( 1.0 - RelativeAccuracy ) )
+            , m_InvLogGamma( 1.0 / std::log( m_Gamma ) )
+            , m_MinKey( static_cast<int32_t>( std::ceil( std::log( MinValue ) * m_InvLogGamma ) ) )
+            , m_NumZeros( 0 )
+            , m_Count( 0 )
+        {}
+
+        void Reset()
+        {
+            std::fill( m_Buckets.begin(), m_Buckets.end(), 0 );
+            m_NumZeros = 0;
+            m_Count = 0;
+        }
+
+        void Add( double value )
+        {
+            Update( value, 1 );
+        }
+
+        // Remove a value that was previously added.
+        void Remove( double value )
+        {
+            Update( value, -1 );
+        }
+
+        uint64_t GetCount() const
+        {
+            return m_Count;
+        }
+
+        /**
+         * Get the value at quantile q.
+         * @param q The quantile in the range [0, 1] (for example, 0.99 for the 99th percentile).
+         */
+        double GetQuantile( double q ) const
+        {
+            if ( m_Count == 0 )
+            {
+                return 0.0;
+            }
+
+            uint64_t rank = static_cast<uint64_t>( std::max( 0.0, std::min( q, 1.0 ) ) * ( m_Count - 1 ) );
+            if ( rank < m_NumZeros )
+            {
+                return 0.0;
+            }
+
+            uint64_t count = m_NumZeros;
+            for ( uint32_t i = 0; i < m_Buckets.size(); ++i )
+            {
+                count += m_Buckets[i];
+                if ( count > rank )
+                {
+                    // The value that minimizes the relative error for the bucket.
+                    return 2.0 * std::pow( m_Gamma, static_cast<double>( m_MinKey + static_cast<int32_t>( i ) ) ) / ( m_Gamma + 1.0 );
+                }
+            }
+
+            return 2.0 * std::pow( m_Gamma, static_cast<double>( m_MinKey + static_cast<int32_t>( NumBuckets ) - 1 ) ) / ( m_Gamma + 1.0 );
+        }
+
+    private:
+        void Update( double value, int32_t delta )
+        {
+            m_Count += delta;
+
+            if ( value < MinValue )
+            {
+                m_NumZeros += delta;
+                return;
+            }
+
+            int32_t key = static_cast<int32_t>( std::ceil( std::log( value ) * m_InvLogGamma ) );
+            int32_t index = std::max( 0, std::min( key - m_MinKey, static_cast<int32_t>( NumBuckets ) - 1 ) );
+
+            if ( m_Buckets.empty() )
+            {
+                m_Buckets.resize( NumBuckets, 0 );
+            }
+            m_Buckets[index] += delta;
+        }
+
+        double m_Gamma;
+        double m_InvLogGamma;
+        int32_t m_MinKey;
+
+        std::vector<uint32_t> m_Buckets;
+        uint64_t m_NumZeros;
+        uint64_t m_Count;
+    };
+
     template<typename T>
     class Statistic
     {
@@ -41,8 +164,13 @@ namespace Core
 
         using value_type = T;
 
-        Statistic( uint32_t maxSamples = 1024 )
+        /**
+         * @param maxSamples The number of samples that are kept for plotting.
+         * In StatisticMode::Window mode, this is also the size of the window.
+         */
+        Statistic( uint32_t maxSamples = 1024, StatisticMode mode = StatisticMode::AllTime )
             : m_MaxSamples( maxSamples )
+            , m_Mode( mode )
         {
             m_Samples.resize( m_MaxSamples );
             Reset();
@@ -52,20 +180,75 @@ namespace Core
         void Reset()
         {
             m_NumSamples = 0;
-            m_Total = 0;
-            m_Average = 0;
+            m_Mean = 0.0;
+            m_M2 = 0.0;
             m_Min = std::numeric_limits<T>::max();
-            m_Max = std::numeric_limits<T>::min();
+            m_Max = std::numeric_limits<T>::lowest();
+            m_WindowMin.clear();
+            m_WindowMax.clear();
+
+            // Release the histogram until percentiles are requested again.
+            m_Sketch = QuantileSketch();
+            m_HasSketch = false;
         }
 
         void Sample( T value )
         {
-            m_Samples[m_NumSamples++ % m_MaxSamples] = value;
+            uint32_t index = m_NumSamples % m_MaxSamples;
+            bool isWindowFull = m_NumSamples >= m_MaxSamples;
+
+            if ( m_Mode == StatisticMode::Window && isWindowFull )
+            {
+                // Replace the oldest sample in the window.
+                T oldValue = m_Samples[index];
+                double oldMean = m_Mean;
+                double delta = static_cast<double>( value ) - static_cast<double>( oldValue );
+
+                m_Mean += delta / m_MaxSamples;
+                m_M2 += delta * ( ( static_cast<double>( value ) - m_Mean ) + ( static_cast<double>( oldValue ) - oldMean ) );
+                m_M2 = std::max( m_M2, 0.0 );
+
+                if ( m_HasSketch )
+                {
+                    m_Sketch.Remove( static_cast<double>( oldValue ) );
+                }
+            }
+            else
+            {
+                // Welford's online algorithm.
+                double delta = static_cast<double>( value ) - m_Mean;
+                m_Mean += delta / ( static_cast<double>( m_NumSamples ) + 1.0 );
+                m_M2 += delta * ( static_cast<double>( value ) - m_Mean );
+            }
+
+            m_Samples[index] = value;
+            if ( m_HasSketch )
+            {
+                m_Sketch.Add( static_cast<double>( value ) );
+            }
+
+            if ( m_Mode == StatisticMode::Window )
+            {
+                // Monotonic queues of (sample number, value) give the
+                // window min and max in amortized constant time.
+                uint32_t first = isWindowFull ? m_NumSamples - m_MaxSamples + 1 : 0;
+                while ( !m_WindowMin.empty() && m_WindowMin.back().second >= value ) m_WindowMin.pop_back();
+                while ( !m_WindowMax.empty() && m_WindowMax.back().second <= value ) m_WindowMax.pop_back();
+                m_WindowMin.emplace_back( m_NumSamples, value );
+                m_WindowMax.emplace_back( m_NumSamples, value );
+                while ( m_WindowMin.front().first < first ) m_WindowMin.pop_front();
+                while ( m_WindowMax.front().first < first ) m_WindowMax.pop_front();
+
+                m_Min = m_WindowMin.front().second;
+                m_Max = m_WindowMax.front().second;
+            }
+            else
+            {
+                m_Max = std::max( m_Max, value );
+                m_Min = std::min( m_Min, value );
+            }
 
-            m_Total += value;
-            m_Average = m_Total / m_NumSamples;
-            m_Max = std::max( m_Max, value );
-            m_Min = std::min( m_Min, value );
+            ++m_NumSamples;
         }
 
         uint32_t GetNumSamples() const 
@@ -73,9 +256,14 @@ namespace Core
             return m_NumSamples;
         }
 
+        StatisticMode GetMode() const
+        {
+            return m_Mode;
+        }
+
         T GetAverage() const
         {
-            return m_Average;
+            return static_cast<T>( m_Mean );
         }
 
         T GetMax() const
@@ -94,31 +282,50 @@ namespace Core
         }
 
         /**
-         * Get the variance of the samples.
-         * Since the variance can only be computed once the average
-         * of all of the samples is known, we must compute it each time
-         * the value is requested. Use this function sparingly.
+         * Get the (population) variance of the samples.
          */
         T GetVariance() const
         {
-            T variance = 0.0;
-
-            uint32_t numSamples = std::min( m_NumSamples, m_MaxSamples );
-            for ( uint32_t i = 0; i < numSamples; ++i )
-            {
-                variance += std::pow( m_Samples[i] - m_Average, 2 );
-            }
-
-            return variance / static_cast<T>( numSamples );
+            uint32_t numSamples = m_Mode == StatisticMode::Window ? std::min( m_NumSamples, m_MaxSamples ) : m_NumSamples;
+            return numSamples > 0 ? static_cast<T>( m_M2 / static_cast<double>( numSamples ) ) : T( 0 );
         }
 
         /**
          * Get the standard deviation of the samples.
-         * This requires the variance to be computed.
          */
         double GetStandardDeviation() const
         {
-            return std::sqrt( GetVariance() );
+            return std::sqrt( static_cast<double>( GetVariance() ) );
+        }
+
+        /**
+         * Get an estimate of a percentile of the samples.
+         * The estimate has a relative error of at most QuantileSketch::RelativeAccuracy
+         * and is clamped to the min and max of the samples.
+         * The histogram of the samples is built when the first percentile is requested.
+         * In StatisticMode::AllTime mode, it only contains the samples that are kept
+         * at that time (the last maxSamples samples) and all later samples.
+         * @param percentile The percentile in the range [0, 100] (for example, 99.9).
+         */
+        T GetPercentile( double percentile ) const
+        {
+            if ( m_NumSamples == 0 )
+            {
+                return T( 0 );
+            }
+
+            if ( !m_HasSketch )
+            {
+                uint32_t numSamples = std::min( m_NumSamples, m_MaxSamples );
+                for ( uint32_t i = 0; i < numSamples; ++i )
+                {
+                    m_Sketch.Add( static_cast<double>( m_Samples[i] ) );
+                }
+                m_HasSketch = true;
+            }
+
+            double value = m_Sketch.GetQuantile( percentile / 100.0 );
+            return std::max( m_Min, std::min( static_cast<T>( value ), m_Max ) );
         }
 
         /**
@@ -135,15 +342,25 @@ namespace Core
     private:
         // Maximum number of samples to record.
         uint32_t m_MaxSamples;
+        StatisticMode m_Mode;
 
         // Number of recorded samples.
         uint32_t m_NumSamples;
 
-        T m_Total;
-        T m_Average;
+        // Running mean and sum of squared differences from the mean (Welford).
+        double m_Mean;
+        double m_M2;
         T m_Min;
         T m_Max;
 
         std::vector<T> m_Samples;
+
+        // Candidates for the min and max of the window (StatisticMode::Window only).
+        std::deque< std::pair<uint32_t, T> > m_WindowMin;
+        std::deque< std::pair<uint32_t, T> > m_WindowMax;
+
+        // Only built for statistics whose percentiles are requested (see GetPercentile).
+        mutable QuantileSketch m_Sketch;
+        mutable bool m_HasSketch;
     };
 }
\ No newline at end of file
@@ -0,0 +1,250 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file TaskScheduler.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief A work stealing task scheduler.
+ */
+
+
+#include "EngineDefines.h"
+#include "Graphics/Profiler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core
+{
+    // Workers execute the tasks with the highest priority first.
+    enum class TaskPriority : uint32_t
+    {
+        High,
+        Normal,
+        Low,
+        NumPriorities
+    };
+
+    class TaskGroup;
+
+    /**
+     * Executes tasks on a fixed number of worker threads. Every worker owns a
+     * (lock-free) deque per priority. Tasks that are created by a worker are pushed
+     * onto its own deque and popped in LIFO order (which keeps the data in cache)
+     * while idle workers steal the oldest tasks from the other workers.
+     * Tasks that are created by other threads are added to a shared queue.
+     * Workers sleep when there are no tasks.
+     */
+    class ENGINE_DLL TaskScheduler
+    {
+    public:
+        // The calling thread is not a worker.
+        static const uint32_t NoWorker = UINT32_MAX;
+
+        struct Statistics
+        {
+            uint64_t NumTasks;
+            // Tasks that were executed by a different worker than the one that created them.
+            uint64_t NumStolenTasks;
+            // The number of times a worker went to sleep because there were no tasks.
+            uint64_t NumSleeps;
+        };
+
+        /**
+         * @param numWorkers The number of worker threads. If 0, one worker is created
+         * for every hardware thread except one (the thread that waits for the tasks
+         * also executes tasks).
+         */
+        explicit TaskScheduler( uint32_t numWorkers = 0 );
+        ~TaskScheduler();
+
+        TaskScheduler( const TaskScheduler& ) = delete;
+        TaskScheduler& operator=( const TaskScheduler& ) = delete;
+
+        // Get the instance of the task scheduler.
+        // Must first call TaskScheduler::Init.
+        static TaskScheduler& Get();
+
+        // Initialize the static instance of the task scheduler.
+        // The profiler must be initialized first because tasks push profiler markers.
+        static void Init( uint32_t numWorkers = 0 );
+        static void Shutdown();
+
+        uint32_t GetNumWorkers() const;
+        // The number of threads that execute tasks (the workers and the thread that waits for them).
+        uint32_t GetConcurrency() const;
+        // The index of the calling thread if it is a worker of this scheduler, NoWorker otherwise.
+        uint32_t GetWorkerIndex() const;
+
+        Statistics GetStatistics() const;
+
+    private:
+        friend class TaskGroup;
+
+        struct Task;
+        struct Worker;
+
+        static const uint32_t NumPriorities = static_cast<uint32_t>( TaskPriority::NumPriorities );
+
+        void Submit( Task* task );
+        Task* FindTask( uint32_t workerIndex );
+        void Execute( Task* task );
+        // Execute one task on the calling thread.
+        // @returns false if there were no tasks.
+        bool ExecuteTask();
+
+        void WorkerThread( uint32_t workerIndex );
+
+        std::vector< std::unique_ptr<Worker> > m_Workers;
+
+        // Tasks that are created by threads that are not workers.
+        std::mutex m_SubmittedTasksMutex;
+        std::deque<Task*> m_SubmittedTasks[NumPriorities];
+        std::atomic_uint32_t m_NumSubmittedTasks;
+
+        // The number of tasks in all deques and queues.
+        std::atomic_int64_t m_NumQueuedTasks;
+        std::atomic_uint32_t m_NumSleepingWorkers;
+        std::mutex m_SleepMutex;
+        std::condition_variable m_WakeCondition;
+        bool m_Stop;
+
+        std::atomic_uint64_t m_NumTasks;
+        std::atomic_uint64_t m_NumStolenTasks;
+        std::atomic_uint64_t m_NumSleeps;
+    };
+
+    /**
+     * A group of tasks that can be waited for (fork/join). Tasks can add more tasks
+     * to the group while it is being waited for.
+     */
+    class ENGINE_DLL TaskGroup
+    {
+    public:
+        explicit TaskGroup( TaskScheduler& scheduler = TaskScheduler::Get() );
+        // Waits for the tasks that have not finished.
+        ~TaskGroup();
+
+        TaskGroup( const TaskGroup& ) = delete;
+        TaskGroup& operator=( const TaskGroup& ) = delete;
+
+        /**
+         * Run a function on one of the worker threads.
+         * @param marker The profiler marker that is pushed while the task is executed.
+         */
+        void Run( const Graphics::ProfileMarker& marker, std::function<void()> function, TaskPriority priority = TaskPriority::Normal );
+        void Run( std::function<void()> function, TaskPriority priority = TaskPriority::Normal );
+
+        /**
+         * Wait for all of the tasks of the group. The calling thread executes
+         * tasks (of any group) while it waits so waiting in a task does not
+         * block a worker.
+         */
+        void Wait();
+
+        bool IsDone() const;
+
+    private:
+        friend class TaskScheduler;
+
+        // Called when a task of the group is finished.
+        void Finish();
+
+        TaskScheduler& m_Scheduler;
+        std::atomic_uint32_t m_NumPendingTasks;
+        // Protects the last decrement of m_NumPendingTasks so the group
+        // is not destroyed while the last task is notifying the waiting thread.
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+    };
+
+    namespace Detail
+    {
+        template<typename Func>
+        void ParallelForRange( TaskGroup& group, const Graphics::ProfileMarker& marker, TaskPriority priority, uint32_t first, uint32_t last, uint32_t grainSize, const Func& func )
+        {
+            // Split off the second half of the range until it is no larger than the grain size.
+            // Idle workers steal the oldest (and largest) halves first.
+            while ( last - first > grainSize )
+            {
+                uint32_t middle = first + ( last - first ) / 2;
+                group.Run( marker, [&group, &marker, priority, middle, last, grainSize, &func]()
+                {
+                    ParallelForRange( group, marker, priority, middle, last, grainSize, func );
+                }, priority );
+
+                last = middle;
+            }
+
+            func( first, last );
+        }
+    }
+
+    /**
+     * Call func( first, last ) for sub-ranges of [begin, end) on the worker threads
+     * and the calling thread. Returns when the whole range has been processed.
+     * @param grainSize The maximum number of items that is passed to a single call of func.
+     * If 0, the grain size is chosen from the size of the range and the number of threads.
+     */
+    template<typename Func>
+    void ParallelFor( const Graphics::ProfileMarker& marker, uint32_t begin, uint32_t end, uint32_t grainSize, const Func& func, TaskPriority priority = TaskPriority::Normal )
+    {
+        if ( begin >= end )
+        {
+            return;
+        }
+
+        TaskScheduler& scheduler = TaskScheduler::Get();
+        if ( grainSize == 0 )
+        {
+            // A few chunks per thread leaves room for balancing the load without
+            // making the tasks so small that the scheduling overhead dominates.
+            grainSize = std::max( 1u, ( end - begin ) / ( scheduler.GetConcurrency() * 8 ) );
+        }
+
+        if ( end - begin <= grainSize )
+        {
+            func( begin, end );
+            return;
+        }
+
+        TaskGroup group( scheduler );
+        Detail::ParallelForRange( group, marker, priority, begin, end, grainSize, func );
+        group.Wait();
+    }
+
+    template<typename Func>
+    void ParallelFor( uint32_t begin, uint32_t end, uint32_t grainSize, const Func& func, TaskPriority priority = TaskPriority::Normal )
+    {
+        ParallelFor( PROFILE_MARKER( "Parallel For" ), begin, end, grainSize, func, priority );
+    }
+}
@@ -30,17 +30,31 @@
  *  @brief Thread safe queue.
  */
 
+#include "LockFreeQueue.h"
+
+#include <atomic>
 #include <queue>
 #include <mutex>
 
 namespace Core
 {
+    /**
+     * An unbounded multi-producer, multi-consumer queue. Values go through a
+     * lock-free ring buffer (see MPMCQueue). The mutex is only used when the ring
+     * buffer is full and values overflow into a std::queue. Values pushed by a
+     * single thread are popped in the order they were pushed.
+     */
     template<typename T>
     class ThreadSafeQueue
     {
     public:
-        ThreadSafeQueue();
-        ThreadSafeQueue( const ThreadSafeQueue& copy );
+        /**
+         * @param capacity The capacity of the lock-free ring buffer.
+         */
+        explicit ThreadSafeQueue( size_t capacity = 1024 );
+
+        ThreadSafeQueue( const ThreadSafeQueue& ) = delete;
+        ThreadSafeQueue& operator=( const ThreadSafeQueue& ) = delete;
 
         /**
          * Push a value into the back of the queue.
@@ -64,52 +78,69 @@ namespace Core
         size_t Size() const;
 
     private:
-        std::queue<T> m_Queue;
-        mutable std::mutex m_Mutex;
+        MPMCQueue<T> m_Queue;
+
+        // Values that did not fit in the ring buffer.
+        std::queue<T> m_Overflow;
+        std::atomic<size_t> m_OverflowSize;
+        mutable std::mutex m_OverflowMutex;
     };
 
     template<typename T>
-    ThreadSafeQueue<T>::ThreadSafeQueue()
+    ThreadSafeQueue<T>::ThreadSafeQueue( size_t capacity )
+        : m_Queue( capacity )
+        , m_OverflowSize( 0 )
     {}
 
-    template<typename T>
-    ThreadSafeQueue<T>::ThreadSafeQueue( const ThreadSafeQueue<T>& copy )
-    {
-        std::lock_guard<std::mutex> lock( copy.m_Mutex );
-        m_Queue = other.m_Queue;
-    }
-
     template<typename T>
     void ThreadSafeQueue<T>::Push( T value )
     {
-        std::lock_guard<std::mutex> lock( m_Mutex );
-        m_Queue.push( std::move(value) );
+        // While values are waiting in the overflow queue, new values must go there too
+        // or they would be popped before the values that were pushed earlier.
+        if ( m_OverflowSize == 0 && m_Queue.TryPush( std::move( value ) ) )
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock( m_OverflowMutex );
+        m_Overflow.push( std::move( value ) );
+        ++m_OverflowSize;
     }
 
     template<typename T>
     bool ThreadSafeQueue<T>::TryPop( T& value )
     {
-        std::lock_guard<std::mutex> lock( m_Mutex );
-        if ( m_Queue.empty() )
+        // The values that a thread pushed into the ring buffer were pushed before its values in the overflow queue.
+        if ( m_Queue.TryPop( value ) )
+        {
+            return true;
+        }
+
+        if ( m_OverflowSize == 0 )
+        {
             return false;
+        }
+
+        std::lock_guard<std::mutex> lock( m_OverflowMutex );
+        if ( m_Overflow.empty() )
+            return false;
+
+        value = std::move( m_Overflow.front() );
+        m_Overflow.pop();
+        --m_OverflowSize;
 
-        value = m_Queue.front();
-        m_Queue.pop();
-        
         return true;
     }
 
     template<typename T>
     bool ThreadSafeQueue<T>::Empty() const
     {
-        std::lock_guard<std::mutex> lock( m_Mutex );
-        return m_Queue.empty();
+        return m_Queue.Empty() && m_OverflowSize == 0;
     }
 
     template<typename T>
     size_t ThreadSafeQueue<T>::Size() const
     {
-        std::lock_guard<std::mutex> lock( m_Mutex );
-        return m_Queue.size();
+        return m_Queue.Size() + m_OverflowSize;
     }
 }
\ No newline at end of file
@@ -0,0 +1,229 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file WorkStealingDeque.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief A lock-free work stealing deque (Chase-Lev).
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Core
+{
+    /**
+     * A deque that is owned by a single thread. The owner pushes and pops values
+     * at the bottom (LIFO) while any other thread can steal values from the top (FIFO).
+     * The values must be trivially copyable (usually a pointer).
+     *
+     * See: Chase and Lev, "Dynamic Circular Work-Stealing Deque", SPAA 2005 and
+     * Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models", PPoPP 2013.
+     */
+    template<typename T>
+    class WorkStealingDeque
+    {
+    public:
+        explicit WorkStealingDeque( size_t capacity = 256 );
+
+        WorkStealingDeque( const WorkStealingDeque& ) = delete;
+        WorkStealingDeque& operator=( const WorkStealingDeque& ) = delete;
+
+        /**
+         * Push a value onto the bottom of the deque. The deque grows when it is full.
+         * Must only be called by the owner.
+         */
+        void Push( T value );
+
+        /**
+         * Pop a value from the bottom of the deque.
+         * Must only be called by the owner.
+         * @returns false if the deque is empty.
+         */
+        bool Pop( T& value );
+
+        /**
+         * Steal a value from the top of the deque.
+         * Can be called by any thread.
+         * @returns false if the deque is empty or another thread took the value first.
+         */
+        bool Steal( T& value );
+
+        /**
+         * The (approximate) number of values in the deque.
+         */
+        size_t Size() const;
+        bool Empty() const;
+
+    private:
+        // A circular array. The size is always a power of two.
+        struct Array
+        {
+            explicit Array( int64_t capacity )
+                : Capacity( capacity )
+                , Mask( capacity - 1 )
+                , Values( new std::atomic<T>[static_cast<size_t>( capacity )] )
+            {}
+
+            T Get( int64_t index ) const
+            {
+                return Values[index & Mask].load( std::memory_order_relaxed );
+            }
+
+            void Put( int64_t index, T value )
+            {
+                Values[index & Mask].store( value, std::memory_order_relaxed );
+            }
+
+            // Copy the values in [top, bottom) to an array that is twice as large.
+            Array* Grow( int64_t top, int64_t bottom ) const
+            {
+                Array* array = new Array( Capacity * 2 );
+                for ( int64_t i = top; i < bottom; ++i )
+                {
+                    array->Put( i, Get( i ) );
+                }
+                return array;
+            }
+
+            int64_t Capacity;
+            int64_t Mask;
+            std::unique_ptr<std::atomic<T>[]> Values;
+        };
+
+        // The owner and the thieves write to different cache lines.
+        alignas( 64 ) std::atomic<int64_t> m_Top;
+        alignas( 64 ) std::atomic<int64_t> m_Bottom;
+        std::atomic<Array*> m_Array;
+
+        // Thieves may still be reading from an array after the deque has grown,
+        // so the old arrays are only deleted with the deque.
+        std::vector< std::unique_ptr<Array> > m_Arrays;
+    };
+
+    template<typename T>
+    WorkStealingDeque<T>::WorkStealingDeque( size_t capacity )
+        : m_Top( 0 )
+        , m_Bottom( 0 )
+    {
+        size_t size = 1;
+        while ( size < capacity )
+        {
+            size <<= 1;
+        }
+
+        m_Arrays.emplace_back( new Array( static_cast<int64_t>( size ) ) );
+        m_Array.store( m_Arrays.back().get(), std::memory_order_relaxed );
+    }
+
+    template<typename T>
+    void WorkStealingDeque<T>::Push( T value )
+    {
+        int64_t bottom = m_Bottom.load( std::memory_order_relaxed );
+        int64_t top = m_Top.load( std::memory_order_acquire );
+        Array* array = m_Array.load( std::memory_order_relaxed );
+
+        if ( bottom - top > array->Capacity - 1 )
+        {
+            array = array->Grow( top, bottom );
+            m_Arrays.emplace_back( array );
+            m_Array.store( array, std::memory_order_release );
+        }
+
+        array->Put( bottom, value );
+        std::atomic_thread_fence( std::memory_order_release );
+        m_Bottom.store( bottom + 1, std::memory_order_relaxed );
+    }
+
+    template<typename T>
+    bool WorkStealingDeque<T>::Pop( T& value )
+    {
+        int64_t bottom = m_Bottom.load( std::memory_order_relaxed ) - 1;
+        Array* array = m_Array.load( std::memory_order_relaxed );
+        m_Bottom.store( bottom, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        int64_t top = m_Top.load( std::memory_order_relaxed );
+
+        if ( top > bottom )
+        {
+            // The deque is empty.
+            m_Bottom.store( bottom + 1, std::memory_order_relaxed );
+            return false;
+        }
+
+        value = array->Get( bottom );
+        if ( top == bottom )
+        {
+            // This is the last value. Race the thieves for it.
+            bool taken = m_Top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+            m_Bottom.store( bottom + 1, std::memory_order_relaxed );
+            return taken;
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    bool WorkStealingDeque<T>::Steal( T& value )
+    {
+        int64_t top = m_Top.load( std::memory_order_acquire );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        int64_t bottom = m_Bottom.load( std::memory_order_acquire );
+
+        if ( top >= bottom )
+        {
+            return false;
+        }
+
+        Array* array = m_Array.load( std::memory_order_acquire );
+        T stolen = array->Get( top );
+        if ( !m_Top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) )
+        {
+            // Lost the race with the owner or another thief.
+            return false;
+        }
+
+        value = stolen;
+        return true;
+    }
+
+    template<typename T>
+    size_t WorkStealingDeque<T>::Size() const
+    {
+        int64_t bottom = m_Bottom.load( std::memory_order_relaxed );
+        int64_t top = m_Top.load( std::memory_order_relaxed );
+        return static_cast<size_t>( std::max<int64_t>( bottom - top, 0 ) );
+    }
+
+    template<typename T>
+    bool WorkStealingDeque<T>::Empty() const
+    {
+        return Size() == 0;
+    }
+}
@@ -0,0 +1,255 @@
+#include <EnginePCH.h>
+
+#include <FramePipeline.h>
+
+using namespace Core;
+using namespace std::chrono;
+
+FrameContext::FrameContext( uint32_t index )
+    : ElapsedTime( 0.0 )
+    , TotalTime( 0.0 )
+    , m_Index( index )
+    , m_FrameCounter( 0 )
+{}
+
+uint32_t FrameContext::GetIndex() const
+{
+    return m_Index;
+}
+
+uint64_t FrameContext::GetFrameCounter() const
+{
+    return m_FrameCounter;
+}
+
+void FrameContext::Defer( std::function<void()> function )
+{
+    m_Deferred.push_back( std::move( function ) );
+}
+
+void FrameContext::OnRelease( std::function<void()> function )
+{
+    m_OnRelease.push_back( std::move( function ) );
+}
+
+void FrameContext::Begin( uint64_t frameCounter )
+{
+    Release();
+
+    m_FrameCounter = frameCounter;
+    ElapsedTime = 0.0;
+    TotalTime = 0.0;
+}
+
+void FrameContext::RunDeferred()
+{
+    for ( auto& function : m_Deferred )
+    {
+        function();
+    }
+    m_Deferred.clear();
+}
+
+void FrameContext::Release()
+{
+    // Deferred functions of a frame that was never rendered are dropped.
+    m_Deferred.clear();
+
+    for ( auto& function : m_OnRelease )
+    {
+        function();
+    }
+    m_OnRelease.clear();
+}
+
+FramePipeline::FramePipeline( uint32_t latency )
+    : m_Latency( latency )
+    , m_NumUpdateFrames( 0 )
+    , m_NumUpdatedFrames( 0 )
+    , m_NumRenderFrames( 0 )
+    , m_NumRenderedFrames( 0 )
+    , m_Closed( false )
+    , m_UpdateWaitTime( 0.0 )
+    , m_RenderWaitTime( 0.0 )
+{
+    Resize( latency + 1 );
+}
+
+FramePipeline::~FramePipeline()
+{
+    Close();
+
+    // Release the per-frame resources of the frames in flight.
+    for ( auto& frameContext : m_FrameContexts )
+    {
+        frameContext->Release();
+    }
+}
+
+void FramePipeline::SetLatency( uint32_t latency )
+{
+    scoped_lock lock( m_Mutex );
+    m_Latency = latency;
+}
+
+uint32_t FramePipeline::GetLatency() const
+{
+    scoped_lock lock( m_Mutex );
+    return m_Latency;
+}
+
+uint32_t FramePipeline::GetNumFrameContexts() const
+{
+    scoped_lock lock( m_Mutex );
+    return static_cast<uint32_t>( m_FrameContexts.size() );
+}
+
+std::vector< std::unique_ptr<FrameContext> > FramePipeline::Resize( uint32_t numFrameContexts )
+{
+    std::vector< std::unique_ptr<FrameContext> > frameContexts;
+    frameContexts.swap( m_FrameContexts );
+
+    for ( uint32_t i = 0; i < numFrameContexts; ++i )
+    {
+        m_FrameContexts.push_back( std::make_unique<FrameContext>( i ) );
+    }
+
+    return frameContexts;
+}
+
+FrameContext* FramePipeline::BeginUpdate()
+{
+    std::unique_lock<std::mutex> lock( m_Mutex );
+    assert( m_NumUpdateFrames == m_NumUpdatedFrames && "The previous frame is still being updated." );
+
+    const uint64_t frameCounter = m_NumUpdateFrames;
+    auto startTime = high_resolution_clock::now();
+
+    // The latency can only change while there are no frames in flight.
+    std::vector< std::unique_ptr<FrameContext> > releasedFrameContexts;
+    if ( m_Latency + 1 != m_FrameContexts.size() )
+    {
+        m_FrameRendered.wait( lock, [this, frameCounter]()
+        {
+            return m_Closed || m_NumRenderedFrames == frameCounter;
+        } );
+
+        if ( !m_Closed )
+        {
+            releasedFrameContexts = Resize( m_Latency + 1 );
+        }
+    }
+
+    // Wait until the frame that used the frame context before has been rendered.
+    const uint64_t numFrameContexts = m_FrameContexts.size();
+    m_FrameRendered.wait( lock, [this, frameCounter, numFrameContexts]()
+    {
+        return m_Closed || frameCounter < m_NumRenderedFrames + numFrameContexts;
+    } );
+
+    m_UpdateWaitTime += duration<double>( high_resolution_clock::now() - startTime ).count();
+
+    FrameContext* frame = nullptr;
+    if ( !m_Closed )
+    {
+        frame = m_FrameContexts[frameCounter % numFrameContexts].get();
+        ++m_NumUpdateFrames;
+    }
+
+    // The render stage is done with the frame context (and with the frame contexts that were replaced).
+    // The release functions run without holding the lock.
+    lock.unlock();
+    for ( auto& frameContext : releasedFrameContexts )
+    {
+        frameContext->Release();
+    }
+
+    if ( frame )
+    {
+        frame->Begin( frameCounter );
+    }
+
+    return frame;
+}
+
+void FramePipeline::EndUpdate( FrameContext* frame )
+{
+    {
+        scoped_lock lock( m_Mutex );
+        assert( frame && frame->GetFrameCounter() == m_NumUpdatedFrames );
+
+        ++m_NumUpdatedFrames;
+    }
+    m_FrameUpdated.notify_all();
+}
+
+FrameContext* FramePipeline::BeginRender()
+{
+    std::unique_lock<std::mutex> lock( m_Mutex );
+    assert( m_NumRenderFrames == m_NumRenderedFrames && "The previous frame is still being rendered." );
+
+    const uint64_t frameCounter = m_NumRenderFrames;
+    auto startTime = high_resolution_clock::now();
+
+    m_FrameUpdated.wait( lock, [this, frameCounter]()
+    {
+        return m_Closed || frameCounter < m_NumUpdatedFrames;
+    } );
+
+    m_RenderWaitTime += duration<double>( high_resolution_clock::now() - startTime ).count();
+
+    // Frames that were updated before the pipeline was closed are still rendered.
+    if ( frameCounter >= m_NumUpdatedFrames )
+    {
+        return nullptr;
+    }
+
+    FrameContext* frame = m_FrameContexts[frameCounter % m_FrameContexts.size()].get();
+    ++m_NumRenderFrames;
+
+    // The update stage is done with the frame context.
+    lock.unlock();
+    frame->RunDeferred();
+
+    return frame;
+}
+
+void FramePipeline::EndRender( FrameContext* frame )
+{
+    {
+        scoped_lock lock( m_Mutex );
+        assert( frame && frame->GetFrameCounter() == m_NumRenderedFrames );
+
+        ++m_NumRenderedFrames;
+    }
+    m_FrameRendered.notify_all();
+}
+
+void FramePipeline::Close()
+{
+    {
+        scoped_lock lock( m_Mutex );
+        m_Closed = true;
+    }
+    m_FrameUpdated.notify_all();
+    m_FrameRendered.notify_all();
+}
+
+bool FramePipeline::IsClosed() const
+{
+    scoped_lock lock( m_Mutex );
+    return m_Closed;
+}
+
+FramePipeline::Statistics FramePipeline::GetStatistics() const
+{
+    scoped_lock lock( m_Mutex );
+
+    Statistics statistics;
+    statistics.NumUpdatedFrames = m_NumUpdatedFrames;
+    statistics.NumRenderedFrames = m_NumRenderedFrames;
+    statistics.UpdateWaitTime = m_UpdateWaitTime;
+    statistics.RenderWaitTime = m_RenderWaitTime;
+
+    return statistics;
+}
@@ -0,0 +1,759 @@
+#include <EnginePCH.h>
+
+#include <Graphics/BVH.h>
+#include <Graphics/Ray.h>
+
+#include <xmmintrin.h>
+
+using namespace Graphics;
+
+// The number of bins that are used to find the best split of a node.
+static const uint32_t gs_NumBins = 16;
+// Nodes with more primitives are always split.
+static const uint32_t gs_MaxLeafSize = 8;
+// The size of the traversal stack on the (call) stack.
+// Deeper hierarchies use a traversal stack on the heap.
+static const uint32_t gs_MaxStackSize = 64;
+// The cost of traversing a node relative to the cost of intersecting a primitive.
+static const float gs_TraversalCost = 1.0f;
+
+namespace
+{
+    float SurfaceArea( const glm::vec3& aabbMin, const glm::vec3& aabbMax )
+    {
+        glm::vec3 extent = glm::max( aabbMax - aabbMin, glm::vec3( 0 ) );
+        return 2.0f * ( extent.x * extent.y + extent.y * extent.z + extent.z * extent.x );
+    }
+
+    // Avoid infinities in the reciprocal of the ray direction (0 * inf = NaN).
+    glm::vec3 SafeInverse( const glm::vec3& direction )
+    {
+        glm::vec3 inverse;
+        for ( int i = 0; i < 3; ++i )
+        {
+            float d = std::abs( direction[i] ) > 1e-20f ? direction[i] : std::copysign( 1e-20f, direction[i] );
+            inverse[i] = 1.0f / d;
+        }
+        return inverse;
+    }
+
+    // Returns the distance to the box or FLT_MAX if the box is not hit closer than maxDistance.
+    float IntersectAABB( const BVH::Node& node, const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance )
+    {
+        glm::vec3 t1 = ( node.AABBMin - origin ) * invDirection;
+        glm::vec3 t2 = ( node.AABBMax - origin ) * invDirection;
+        glm::vec3 tNear = glm::min( t1, t2 );
+        glm::vec3 tFar = glm::max( t1, t2 );
+
+        float tMin = glm::max( glm::max( tNear.x, tNear.y ), glm::max( tNear.z, 0.0f ) );
+        float tMax = glm::min( glm::min( tFar.x, tFar.y ), tFar.z );
+
+        return ( tMin <= tMax && tMin < maxDistance ) ? tMin : FLT_MAX;
+    }
+}
+
+BVH::BVH()
+    : m_PrimitiveType( PrimitiveType::Spheres )
+    , m_Depth( 0 )
+    , m_IsDirty( false )
+    , m_BuildCost( 0.0f )
+{}
+
+void BVH::BuildSpheres( const std::vector<glm::vec4>& spheres )
+{
+    m_PrimitiveType = PrimitiveType::Spheres;
+    m_Spheres = spheres;
+    m_Triangles.clear();
+
+    const size_t numSpheres = spheres.size();
+    m_PrimitiveMin.resize( numSpheres );
+    m_PrimitiveMax.resize( numSpheres );
+    for ( size_t i = 0; i < numSpheres; ++i )
+    {
+        glm::vec3 center( spheres[i] );
+        float radius = std::abs( spheres[i].w );
+        m_PrimitiveMin[i] = center - radius;
+        m_PrimitiveMax[i] = center + radius;
+    }
+
+    Build();
+}
+
+void BVH::BuildTriangles( const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices )
+{
+    m_PrimitiveType = PrimitiveType::Triangles;
+    m_Spheres.clear();
+
+    const size_t numTriangles = indices.size() / 3;
+    m_Triangles.resize( numTriangles * 3 );
+    m_PrimitiveMin.resize( numTriangles );
+    m_PrimitiveMax.resize( numTriangles );
+    for ( size_t i = 0; i < numTriangles; ++i )
+    {
+        const glm::vec3& v0 = positions[indices[i * 3 + 0]];
+        const glm::vec3& v1 = positions[indices[i * 3 + 1]];
+        const glm::vec3& v2 = positions[indices[i * 3 + 2]];
+
+        m_Triangles[i * 3 + 0] = v0;
+        m_Triangles[i * 3 + 1] = v1 - v0;
+        m_Triangles[i * 3 + 2] = v2 - v0;
+
+        m_PrimitiveMin[i] = glm::min( v0, glm::min( v1, v2 ) );
+        m_PrimitiveMax[i] = glm::max( v0, glm::max( v1, v2 ) );
+    }
+
+    Build();
+}
+
+void BVH::Build()
+{
+    const uint32_t numPrimitives = static_cast<uint32_t>( m_PrimitiveMin.size() );
+
+    m_Nodes.clear();
+    m_Parents.clear();
+    m_PrimitiveIndices.resize( numPrimitives );
+    std::iota( m_PrimitiveIndices.begin(), m_PrimitiveIndices.end(), 0 );
+    m_PrimitiveLeaves.assign( numPrimitives, 0 );
+    m_Depth = 0;
+    m_DirtyNodes.clear();
+    m_IsDirty = false;
+    m_BuildCost = 0.0f;
+
+    if ( numPrimitives == 0 )
+    {
+        return;
+    }
+
+    // A binary tree with N leaves has 2N - 1 nodes.
+    m_Nodes.reserve( numPrimitives * 2 - 1 );
+    m_Parents.reserve( numPrimitives * 2 - 1 );
+
+    Node root;
+    root.LeftFirst = 0;
+    root.Count = numPrimitives;
+    UpdateLeafBounds( root );
+    m_Nodes.push_back( root );
+    m_Parents.push_back( UINT32_MAX );
+
+    // The primitives are binned by the centers of their bounds.
+    std::vector<glm::vec3> centroids( numPrimitives );
+    for ( uint32_t i = 0; i < numPrimitives; ++i )
+    {
+        centroids[i] = ( m_PrimitiveMin[i] + m_PrimitiveMax[i] ) * 0.5f;
+    }
+
+    struct Bin
+    {
+        glm::vec3 AABBMin;
+        glm::vec3 AABBMax;
+        uint32_t Count;
+    };
+
+    std::vector<uint32_t> stack;
+    stack.push_back( 0 );
+
+    while ( !stack.empty() )
+    {
+        const uint32_t nodeIndex = stack.back();
+        stack.pop_back();
+
+        const uint32_t first = m_Nodes[nodeIndex].LeftFirst;
+        const uint32_t count = m_Nodes[nodeIndex].Count;
+
+        if ( count <= 1 )
+        {
+            continue;
+        }
+
+        // Split candidates are placed in the bounds of the primitive centroids.
+        glm::vec3 centroidMin( FLT_MAX );
+        glm::vec3 centroidMax( -FLT_MAX );
+        for ( uint32_t i = first; i < first + count; ++i )
+        {
+            const glm::vec3& centroid = centroids[m_PrimitiveIndices[i]];
+            centroidMin = glm::min( centroidMin, centroid );
+            centroidMax = glm::max( centroidMax, centroid );
+        }
+
+        float bestCost = FLT_MAX;
+        int bestAxis = -1;
+        uint32_t bestSplit = 0;
+
+        for ( int axis = 0; axis < 3; ++axis )
+        {
+            const float extent = centroidMax[axis] - centroidMin[axis];
+            if ( extent <= 0.0f )
+            {
+                continue;
+            }
+
+            Bin bins[gs_NumBins];
+            for ( Bin& bin : bins )
+            {
+                bin = { glm::vec3( FLT_MAX ), glm::vec3( -FLT_MAX ), 0 };
+            }
+
+            const float scale = gs_NumBins / extent;
+            for ( uint32_t i = first; i < first + count; ++i )
+            {
+                uint32_t primitive = m_PrimitiveIndices[i];
+                uint32_t b = std::min( gs_NumBins - 1, static_cast<uint32_t>( ( centroids[primitive][axis] - centroidMin[axis] ) * scale ) );
+                bins[b].AABBMin = glm::min( bins[b].AABBMin, m_PrimitiveMin[primitive] );
+                bins[b].AABBMax = glm::max( bins[b].AABBMax, m_PrimitiveMax[primitive] );
+                ++bins[b].Count;
+            }
+
+            // Sweep the bins from the right to compute the cost of the right side of every split.
+            float rightCost[gs_NumBins];
+            glm::vec3 aabbMin( FLT_MAX ), aabbMax( -FLT_MAX );
+            uint32_t rightCount = 0;
+            for ( uint32_t b = gs_NumBins - 1; b > 0; --b )
+            {
+                aabbMin = glm::min( aabbMin, bins[b].AABBMin );
+                aabbMax = glm::max( aabbMax, bins[b].AABBMax );
+                rightCount += bins[b].Count;
+                rightCost[b] = rightCount > 0 ? rightCount * SurfaceArea( aabbMin, aabbMax ) : 0.0f;
+            }
+
+            aabbMin = glm::vec3( FLT_MAX );
+            aabbMax = glm::vec3( -FLT_MAX );
+            uint32_t leftCount = 0;
+            for ( uint32_t b = 0; b < gs_NumBins - 1; ++b )
+            {
+                aabbMin = glm::min( aabbMin, bins[b].AABBMin );
+                aabbMax = glm::max( aabbMax, bins[b].AABBMax );
+                leftCount += bins[b].Count;
+
+                if ( leftCount == 0 || leftCount == count )
+                {
+                    continue;
+                }
+
+                // The primitives in bins [0, b] go to the left child.
+                float cost = leftCount * SurfaceArea( aabbMin, aabbMax ) + rightCost[b + 1];
+                if ( cost < bestCost )
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b + 1;
+                }
+            }
+        }
+
+        const Node& node = m_Nodes[nodeIndex];
+        const float leafCost = count * SurfaceArea( node.AABBMin, node.AABBMax );
+        const float splitCost = gs_TraversalCost * SurfaceArea( node.AABBMin, node.AABBMax ) + bestCost;
+
+        if ( count <= gs_MaxLeafSize && ( bestAxis < 0 || splitCost >= leafCost ) )
+        {
+            continue;
+        }
+
+        uint32_t* begin = m_PrimitiveIndices.data() + first;
+        uint32_t* end = begin + count;
+        uint32_t* middle = nullptr;
+
+        if ( bestAxis >= 0 )
+        {
+            const float scale = gs_NumBins / ( centroidMax[bestAxis] - centroidMin[bestAxis] );
+            middle = std::partition( begin, end, [&]( uint32_t primitive )
+            {
+                uint32_t b = std::min( gs_NumBins - 1, static_cast<uint32_t>( ( centroids[primitive][bestAxis] - centroidMin[bestAxis] ) * scale ) );
+                return b < bestSplit;
+            } );
+        }
+        else
+        {
+            // All centroids are at the same position, split the primitives in half.
+            middle = begin + count / 2;
+        }
+
+        const uint32_t leftCount = static_cast<uint32_t>( middle - begin );
+
+        Node leftChild;
+        leftChild.LeftFirst = first;
+        leftChild.Count = leftCount;
+        UpdateLeafBounds( leftChild );
+
+        Node rightChild;
+        rightChild.LeftFirst = first + leftCount;
+        rightChild.Count = count - leftCount;
+        UpdateLeafBounds( rightChild );
+
+        const uint32_t leftIndex = static_cast<uint32_t>( m_Nodes.size() );
+        m_Nodes.push_back( leftChild );
+        m_Nodes.push_back( rightChild );
+        m_Parents.push_back( nodeIndex );
+        m_Parents.push_back( nodeIndex );
+
+        m_Nodes[nodeIndex].LeftFirst = leftIndex;
+        m_Nodes[nodeIndex].Count = 0;
+
+        stack.push_back( leftIndex + 1 );
+        stack.push_back( leftIndex );
+    }
+
+    // Children are always stored after their parent.
+    std::vector<uint32_t> depths( m_Nodes.size(), 0 );
+    for ( uint32_t i = 0; i < m_Nodes.size(); ++i )
+    {
+        if ( i > 0 )
+        {
+            depths[i] = depths[m_Parents[i]] + 1;
+            m_Depth = std::max( m_Depth, depths[i] );
+        }
+
+        const Node& node = m_Nodes[i];
+        for ( uint32_t j = node.LeftFirst; j < node.LeftFirst + node.Count; ++j )
+        {
+            m_PrimitiveLeaves[m_PrimitiveIndices[j]] = i;
+        }
+    }
+
+    m_DirtyNodes.assign( m_Nodes.size(), 0 );
+    m_BuildCost = GetSAHCost();
+}
+
+void BVH::UpdateLeafBounds( Node& node ) const
+{
+    node.AABBMin = glm::vec3( FLT_MAX );
+    node.AABBMax = glm::vec3( -FLT_MAX );
+    for ( uint32_t i = node.LeftFirst; i < node.LeftFirst + node.Count; ++i )
+    {
+        uint32_t primitive = m_PrimitiveIndices[i];
+        node.AABBMin = glm::min( node.AABBMin, m_PrimitiveMin[primitive] );
+        node.AABBMax = glm::max( node.AABBMax, m_PrimitiveMax[primitive] );
+    }
+}
+
+void BVH::UpdateSphere( uint32_t primitive, const glm::vec4& sphere )
+{
+    assert( m_PrimitiveType == PrimitiveType::Spheres && primitive < m_Spheres.size() );
+
+    m_Spheres[primitive] = sphere;
+
+    glm::vec3 center( sphere );
+    float radius = std::abs( sphere.w );
+    m_PrimitiveMin[primitive] = center - radius;
+    m_PrimitiveMax[primitive] = center + radius;
+
+    // Mark the path to the root node dirty (until a node is found that is already dirty).
+    for ( uint32_t node = m_PrimitiveLeaves[primitive]; node != UINT32_MAX && !m_DirtyNodes[node]; node = m_Parents[node] )
+    {
+        m_DirtyNodes[node] = 1;
+    }
+    m_IsDirty = true;
+}
+
+void BVH::Refit()
+{
+    if ( !m_IsDirty )
+    {
+        return;
+    }
+
+    // Child nodes are always stored after their parent node.
+    for ( size_t i = m_Nodes.size(); i-- > 0; )
+    {
+        if ( !m_DirtyNodes[i] )
+        {
+            continue;
+        }
+
+        Node& node = m_Nodes[i];
+        if ( node.Count > 0 )
+        {
+            UpdateLeafBounds( node );
+        }
+        else
+        {
+            const Node& left = m_Nodes[node.LeftFirst];
+            const Node& right = m_Nodes[node.LeftFirst + 1];
+            node.AABBMin = glm::min( left.AABBMin, right.AABBMin );
+            node.AABBMax = glm::max( left.AABBMax, right.AABBMax );
+        }
+        m_DirtyNodes[i] = 0;
+    }
+
+    m_IsDirty = false;
+}
+
+bool BVH::Update( float rebuildThreshold )
+{
+    if ( !m_IsDirty )
+    {
+        return false;
+    }
+
+    Refit();
+
+    if ( GetSAHCost() > m_BuildCost * rebuildThreshold )
+    {
+        Build();
+        return true;
+    }
+
+    return false;
+}
+
+float BVH::GetSAHCost() const
+{
+    if ( m_Nodes.empty() )
+    {
+        return 0.0f;
+    }
+
+    const float rootArea = SurfaceArea( m_Nodes[0].AABBMin, m_Nodes[0].AABBMax );
+    if ( rootArea <= 0.0f )
+    {
+        return 0.0f;
+    }
+
+    double cost = 0.0;
+    for ( const Node& node : m_Nodes )
+    {
+        float area = SurfaceArea( node.AABBMin, node.AABBMax );
+        cost += node.Count > 0 ? area * node.Count : area * gs_TraversalCost;
+    }
+
+    return static_cast<float>( cost / rootArea );
+}
+
+float BVH::IntersectPrimitive( uint32_t primitive, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, bool conservative, glm::vec2& barycentric ) const
+{
+    if ( m_PrimitiveType == PrimitiveType::Spheres )
+    {
+        const glm::vec4& sphere = m_Spheres[primitive];
+        glm::vec3 oc = origin - glm::vec3( sphere );
+
+        float a = glm::dot( direction, direction );
+        float b = glm::dot( oc, direction );
+        float c = glm::dot( oc, oc ) - sphere.w * sphere.w;
+        float discriminant = b * b - a * c;
+        if ( discriminant < 0.0f || a <= 0.0f )
+        {
+            return FLT_MAX;
+        }
+
+        float sqrtDiscriminant = std::sqrt( discriminant );
+        float tFar = ( -b + sqrtDiscriminant ) / a;
+        if ( tFar < 0.0f )
+        {
+            return FLT_MAX;
+        }
+
+        float tNear = ( -b - sqrtDiscriminant ) / a;
+        float t = tNear >= 0.0f ? tNear : ( conservative ? 0.0f : tFar );
+
+        return t < maxDistance ? t : FLT_MAX;
+    }
+    else
+    {
+        // Moller-Trumbore ray-triangle intersection.
+        const glm::vec3& v0 = m_Triangles[primitive * 3 + 0];
+        const glm::vec3& edge1 = m_Triangles[primitive * 3 + 1];
+        const glm::vec3& edge2 = m_Triangles[primitive * 3 + 2];
+
+        glm::vec3 p = glm::cross( direction, edge2 );
+        float determinant = glm::dot( edge1, p );
+        if ( std::abs( determinant ) < 1e-12f )
+        {
+            return FLT_MAX;
+        }
+
+        float invDeterminant = 1.0f / determinant;
+        glm::vec3 s = origin - v0;
+        float u = glm::dot( s, p ) * invDeterminant;
+        if ( u < 0.0f || u > 1.0f )
+        {
+            return FLT_MAX;
+        }
+
+        glm::vec3 q = glm::cross( s, edge1 );
+        float v = glm::dot( direction, q ) * invDeterminant;
+        if ( v < 0.0f || u + v > 1.0f )
+        {
+            return FLT_MAX;
+        }
+
+        float t = glm::dot( edge2, q ) * invDeterminant;
+        if ( t < 0.0f || t >= maxDistance )
+        {
+            return FLT_MAX;
+        }
+
+        barycentric = glm::vec2( u, v );
+        return t;
+    }
+}
+
+BVH::Hit BVH::Intersect( const Ray& ray, float maxDistance ) const
+{
+    return IntersectClosest( ray, maxDistance, nullptr );
+}
+
+BVH::Hit BVH::Intersect( const Ray& ray, float maxDistance, const IntersectFunction& intersectFunction ) const
+{
+    return IntersectClosest( ray, maxDistance, &intersectFunction );
+}
+
+BVH::Hit BVH::IntersectClosest( const Ray& ray, float maxDistance, const IntersectFunction* intersectFunction ) const
+{
+    Hit hit;
+    if ( m_Nodes.empty() )
+    {
+        return hit;
+    }
+
+    const glm::vec3 origin = ray.m_Origin;
+    const glm::vec3 direction = ray.m_Direction;
+    const glm::vec3 invDirection = SafeInverse( direction );
+
+    float closest = maxDistance;
+
+    struct StackEntry
+    {
+        uint32_t Node;
+        float Distance;
+    };
+
+    // A depth first traversal never has more than depth + 1 nodes on the stack.
+    const uint32_t maxStackSize = m_Depth + 1;
+    StackEntry localStack[gs_MaxStackSize];
+    std::vector<StackEntry> heapStack;
+    StackEntry* stack = localStack;
+    if ( maxStackSize > gs_MaxStackSize )
+    {
+        heapStack.resize( maxStackSize );
+        stack = heapStack.data();
+    }
+    uint32_t stackSize = 0;
+
+    float rootDistance = IntersectAABB( m_Nodes[0], origin, invDirection, closest );
+    if ( rootDistance != FLT_MAX )
+    {
+        stack[stackSize++] = { 0, rootDistance };
+    }
+
+    while ( stackSize > 0 )
+    {
+        StackEntry entry = stack[--stackSize];
+        // A closer hit may have been found after the node was pushed.
+        if ( entry.Distance >= closest )
+        {
+            continue;
+        }
+
+        const Node& node = m_Nodes[entry.Node];
+        if ( node.Count > 0 )
+        {
+            for ( uint32_t i = node.LeftFirst; i < node.LeftFirst + node.Count; ++i )
+            {
+                uint32_t primitive = m_PrimitiveIndices[i];
+                glm::vec2 barycentric;
+                float t = IntersectPrimitive( primitive, origin, direction, closest, intersectFunction != nullptr, barycentric );
+                if ( t != FLT_MAX && intersectFunction )
+                {
+                    t = ( *intersectFunction )( primitive, ray, closest );
+                }
+                if ( t < closest )
+                {
+                    closest = t;
+                    hit.Primitive = primitive;
+                    hit.Distance = t;
+                    hit.Barycentric = barycentric;
+                }
+            }
+        }
+        else
+        {
+            uint32_t nearChild = node.LeftFirst;
+            uint32_t farChild = node.LeftFirst + 1;
+            float nearDistance = IntersectAABB( m_Nodes[nearChild], origin, invDirection, closest );
+            float farDistance = IntersectAABB( m_Nodes[farChild], origin, invDirection, closest );
+            if ( farDistance < nearDistance )
+            {
+                std::swap( nearChild, farChild );
+                std::swap( nearDistance, farDistance );
+            }
+
+            // Push the far child first so the near child is visited first.
+            assert( stackSize + 2 <= maxStackSize );
+            if ( farDistance != FLT_MAX )
+            {
+                stack[stackSize++] = { farChild, farDistance };
+            }
+            if ( nearDistance != FLT_MAX )
+            {
+                stack[stackSize++] = { nearChild, nearDistance };
+            }
+        }
+    }
+
+    return hit;
+}
+
+void BVH::IntersectPacket( const Ray rays[4], Hit hits[4], float maxDistance ) const
+{
+    for ( int i = 0; i < 4; ++i )
+    {
+        hits[i] = Hit();
+    }
+
+    if ( m_Nodes.empty() )
+    {
+        return;
+    }
+
+    // The rays are stored as a structure of arrays.
+    alignas( 16 ) float origin[3][4];
+    alignas( 16 ) float invDirection[3][4];
+    alignas( 16 ) float closest[4];
+    glm::vec3 averageDirection( 0 );
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        glm::vec3 inverse = SafeInverse( rays[i].m_Direction );
+        for ( int axis = 0; axis < 3; ++axis )
+        {
+            origin[axis][i] = rays[i].m_Origin[axis];
+            invDirection[axis][i] = inverse[axis];
+        }
+        closest[i] = maxDistance;
+        averageDirection += rays[i].m_Direction;
+    }
+
+    const __m128 originX = _mm_load_ps( origin[0] );
+    const __m128 originY = _mm_load_ps( origin[1] );
+    const __m128 originZ = _mm_load_ps( origin[2] );
+    const __m128 invDirectionX = _mm_load_ps( invDirection[0] );
+    const __m128 invDirectionY = _mm_load_ps( invDirection[1] );
+    const __m128 invDirectionZ = _mm_load_ps( invDirection[2] );
+    const __m128 zero = _mm_setzero_ps();
+    __m128 closest4 = _mm_load_ps( closest );
+
+    const uint32_t maxStackSize = m_Depth + 1;
+    uint32_t localStack[gs_MaxStackSize];
+    std::vector<uint32_t> heapStack;
+    uint32_t* stack = localStack;
+    if ( maxStackSize > gs_MaxStackSize )
+    {
+        heapStack.resize( maxStackSize );
+        stack = heapStack.data();
+    }
+    uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while ( stackSize > 0 )
+    {
+        const Node& node = m_Nodes[stack[--stackSize]];
+
+        // Test the node against all 4 rays.
+        __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( node.AABBMin.x ), originX ), invDirectionX );
+        __m128 t2 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( node.AABBMax.x ), originX ), invDirectionX );
+        __m128 tMin = _mm_max_ps( _mm_min_ps( t1, t2 ), zero );
+        __m128 tMax = _mm_max_ps( t1, t2 );
+
+        t1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( node.AABBMin.y ), originY ), invDirectionY );
+        t2 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( node.AABBMax.y ), originY ), invDirectionY );
+        tMin = _mm_max_ps( tMin, _mm_min_ps( t1, t2 ) );
+        tMax = _mm_min_ps( tMax, _mm_max_ps( t1, t2 ) );
+
+        t1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( node.AABBMin.z ), originZ ), invDirectionZ );
+        t2 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( node.AABBMax.z ), originZ ), invDirectionZ );
+        tMin = _mm_max_ps( tMin, _mm_min_ps( t1, t2 ) );
+        tMax = _mm_min_ps( tMax, _mm_max_ps( t1, t2 ) );
+
+        const int mask = _mm_movemask_ps( _mm_and_ps( _mm_cmple_ps( tMin, tMax ), _mm_cmplt_ps( tMin, closest4 ) ) );
+        if ( mask == 0 )
+        {
+            continue;
+        }
+
+        if ( node.Count > 0 )
+        {
+            for ( uint32_t i = node.LeftFirst; i < node.LeftFirst + node.Count; ++i )
+            {
+                uint32_t primitive = m_PrimitiveIndices[i];
+                for ( int r = 0; r < 4; ++r )
+                {
+                    if ( ( mask & ( 1 << r ) ) == 0 )
+                    {
+                        continue;
+                    }
+
+                    glm::vec2 barycentric;
+                    float t = IntersectPrimitive( primitive, rays[r].m_Origin, rays[r].m_Direction, closest[r], false, barycentric );
+                    if ( t < closest[r] )
+                    {
+                        closest[r] = t;
+                        hits[r].Primitive = primitive;
+                        hits[r].Distance = t;
+                        hits[r].Barycentric = barycentric;
+                    }
+                }
+            }
+            closest4 = _mm_load_ps( closest );
+        }
+        else
+        {
+            assert( stackSize + 2 <= maxStackSize );
+
+            // Visit the child that is closest along the average direction of the packet first.
+            const Node& left = m_Nodes[node.LeftFirst];
+            const Node& right = m_Nodes[node.LeftFirst + 1];
+            glm::vec3 offset = ( left.AABBMin + left.AABBMax ) - ( right.AABBMin + right.AABBMax );
+
+            if ( glm::dot( offset, averageDirection ) > 0.0f )
+            {
+                stack[stackSize++] = node.LeftFirst;
+                stack[stackSize++] = node.LeftFirst + 1;
+            }
+            else
+            {
+                stack[stackSize++] = node.LeftFirst + 1;
+                stack[stackSize++] = node.LeftFirst;
+            }
+        }
+    }
+}
+
+BVH::PrimitiveType BVH::GetPrimitiveType() const
+{
+    return m_PrimitiveType;
+}
+
+uint32_t BVH::GetNumPrimitives() const
+{
+    return static_cast<uint32_t>( m_PrimitiveMin.size() );
+}
+
+uint32_t BVH::GetDepth() const
+{
+    return m_Depth;
+}
+
+uint32_t BVH::GetNumNodes() const
+{
+    return static_cast<uint32_t>( m_Nodes.size() );
+}
+
+const BVH::Node& BVH::GetNode( uint32_t index ) const
+{
+    assert( index < m_Nodes.size() );
+    return m_Nodes[index];
+}
+
+const glm::vec4& BVH::GetSphere( uint32_t primitive ) const
+{
+    assert( primitive < m_Spheres.size() );
+    return m_Spheres[primitive];
+}
+
+void BVH::GetTriangle( uint32_t primitive, glm::vec3& v0, glm::vec3& v1, glm::vec3& v2 ) const
+{
+    assert( primitive * 3 < m_Triangles.size() );
+    v0 = m_Triangles[primitive * 3 + 0];
+    v1 = v0 + m_Triangles[primitive * 3 + 1];
+    v2 = v0 + m_Triangles[primitive * 3 + 2];
+}
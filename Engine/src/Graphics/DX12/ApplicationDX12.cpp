@@ -136,6 +136,7 @@ ApplicationDX12::ApplicationDX12()
     , m_RequestQuit( false )
     , m_UpdateFrame( 0 )
     , m_RenderFrame( 0 )
+    , m_LastRenderThreadFrame( UINT64_MAX )
 {
     m_hInstance = g_DLLHandle;
     if ( !m_hInstance )
@@ -241,6 +242,7 @@ int32_t ApplicationDX12::Run()
 #if defined(PROFILE)
     SetThreadName( updateThread, "Update" );
 #endif
+    Profiler::SetThreadName( L"Main" );
 
     HighResolutionTimer timer;
     double totalTime = 0.0f;
@@ -565,11 +567,22 @@ void ApplicationDX12::UpdateThread()
     double totalTime = 0.0f;
     
     Profiler& profiler = Profiler::Get();
+    Profiler::SetThreadName( L"Update" );
+
+    // With a latency of 0, every frame is rendered on this thread right after it was updated.
+    std::thread renderThread;
 
     while ( m_bIsRunning )
     {
         CPU_MARKER( __FUNCTION__ );
 
+        // Wait until the render stage is done with the frame context.
+        FrameContext* frame = m_FramePipeline.BeginUpdate();
+        if ( !frame )
+        {
+            break;
+        }
+
         timer.Tick();
 
         double elapsedTime = timer.ElapsedSeconds();
@@ -583,10 +596,40 @@ void ApplicationDX12::UpdateThread()
 
         ImGui::NewFrame();
 
-        Core::UpdateEventArgs updateEventArgs( *this, elapsedTime, totalTime, m_UpdateFrame );
+        frame->ElapsedTime = elapsedTime;
+        frame->TotalTime = totalTime;
+
+        const uint64_t frameCounter = frame->GetFrameCounter();
+
+        Core::UpdateEventArgs updateEventArgs( *this, elapsedTime, totalTime, frameCounter );
+        updateEventArgs.Frame = frame;
         OnUpdate( updateEventArgs );
-        Core::RenderEventArgs renderEventArgs( *this, elapsedTime, totalTime, m_UpdateFrame );
-        OnRender( renderEventArgs );
+
+        // The latency can be changed at runtime (also during the update stage of this frame).
+        const bool pipelined = m_FramePipeline.GetLatency() > 0;
+        if ( !pipelined && renderThread.joinable() )
+        {
+            // The render thread renders this frame (and the frames before it) and exits.
+            m_LastRenderThreadFrame = frameCounter;
+        }
+
+        m_FramePipeline.EndUpdate( frame );
+
+        if ( pipelined && !renderThread.joinable() )
+        {
+            m_LastRenderThreadFrame = UINT64_MAX;
+            renderThread = std::thread( &ApplicationDX12::RenderThread, this );
+        }
+        else if ( !pipelined && renderThread.joinable() )
+        {
+            renderThread.join();
+        }
+
+        // Render this frame unless it was already rendered by the render thread that was just stopped.
+        while ( !renderThread.joinable() && m_RenderFrame <= frameCounter )
+        {
+            RenderFrame();
+        }
 
         ++m_UpdateFrame;
 
@@ -597,6 +640,41 @@ void ApplicationDX12::UpdateThread()
 
         std::this_thread::yield();
     }
+
+    // The render thread renders the frames that were already updated and exits.
+    m_FramePipeline.Close();
+    if ( renderThread.joinable() )
+    {
+        renderThread.join();
+    }
+}
+
+void ApplicationDX12::RenderThread()
+{
+    Profiler::SetThreadName( L"Render" );
+
+    while ( m_RenderFrame <= m_LastRenderThreadFrame && RenderFrame() )
+    {}
+}
+
+bool ApplicationDX12::RenderFrame()
+{
+    // Runs the functions that were deferred by the update stage (in frame order).
+    FrameContext* frame = m_FramePipeline.BeginRender();
+    if ( !frame )
+    {
+        return false;
+    }
+
+    Core::RenderEventArgs renderEventArgs( *this, frame->ElapsedTime, frame->TotalTime, frame->GetFrameCounter() );
+    renderEventArgs.Frame = frame;
+    OnRender( renderEventArgs );
+
+    m_RenderFrame = frame->GetFrameCounter() + 1;
+
+    m_FramePipeline.EndRender( frame );
+
+    return true;
 }
 
 // Translate the XInput button IDs to Joystick button IDs.
@@ -255,10 +255,13 @@ std::shared_ptr<Sampler> DeviceDX12::CreateSampler()
 
 std::shared_ptr<Texture> DeviceDX12::CreateTexture( std::shared_ptr<ComputeCommandBuffer> computeCommandBuffer, const std::wstring& fileName )
 {
-    TextureMap::const_iterator iter = m_TextureMap.find( fileName );
-    if ( iter != m_TextureMap.end() )
     {
-        return iter->second;
+        scoped_lock lock( m_TextureMapMutex );
+        TextureMap::const_iterator iter = m_TextureMap.find( fileName );
+        if ( iter != m_TextureMap.end() )
+        {
+            return iter->second;
+        }
     }
 
     Core::Application::Get().SetLoadingMessage( fileName );
@@ -270,9 +273,10 @@ std::shared_ptr<Texture> DeviceDX12::CreateTexture( std::shared_ptr<ComputeComma
         computeCommandBuffer->GenerateMips( texture );
     }
 
-    m_TextureMap.emplace( fileName, texture );
-
-    return texture;
+    // Textures can be loaded by multiple (streaming) threads. If the same texture
+    // was loaded by another thread in the meantime, the first texture is kept.
+    scoped_lock lock( m_TextureMapMutex );
+    return m_TextureMap.emplace( fileName, texture ).first->second;
 }
 
 std::shared_ptr<Texture> DeviceDX12::CreateTexture2D( uint16_t width, uint16_t height, uint16_t slices, const TextureFormat& format )
@@ -293,6 +297,11 @@ std::shared_ptr<Query> DeviceDX12::CreateQuery( QueryType queryType, uint32_t nu
     return std::make_shared<QueryDX12>( shared_from_this(), queryType, numQueries );
 }
 
+ResourceRegistry& DeviceDX12::GetResourceRegistry()
+{
+    return m_ResourceRegistry;
+}
+
 D3D12_CPU_DESCRIPTOR_HANDLE DeviceDX12::AllocateDescriptors( D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptors )
 {
     return m_DescriptorAllocators[type]->Allocate( numDescriptors );
@@ -700,6 +700,34 @@ void GraphicsCommandBufferDX12::BindGraphicsDynamicStructuredBuffer( uint32_t sl
     m_d3d12CommandList->SetGraphicsRootShaderResourceView( slotID, heapAllocation.GpuAddress );
 }
 
+uint64_t GraphicsCommandBufferDX12::UploadDynamicBuffer( size_t bufferSizeInBytes, size_t alignment, const void* bufferData )
+{
+    HeapAllocation heapAllocation = m_UploadHeap->Allocate( bufferSizeInBytes, alignment );
+    memcpy( heapAllocation.CpuPtr, bufferData, bufferSizeInBytes );
+
+    return heapAllocation.GpuAddress;
+}
+
+void GraphicsCommandBufferDX12::BindGraphicsDynamicBuffer( uint32_t slotID, uint64_t gpuAddress )
+{
+    if ( m_pCurrentGraphicsShaderSignature )
+    {
+        const ShaderParameter& shaderParameter = m_pCurrentGraphicsShaderSignature->GetParameter( slotID );
+        switch ( shaderParameter.GetType() )
+        {
+        case ParameterType::ConstantBuffer:
+            m_d3d12CommandList->SetGraphicsRootConstantBufferView( slotID, gpuAddress );
+            break;
+        case ParameterType::Buffer:
+            m_d3d12CommandList->SetGraphicsRootShaderResourceView( slotID, gpuAddress );
+            break;
+        default:
+            LOG_ERROR( "Only constant buffers and buffers can be bound as dynamic buffers." );
+            break;
+        }
+    }
+}
+
 void Graphics::GraphicsCommandBufferDX12::SetBuffer( std::shared_ptr<ResourceDX12> resourceDX12, size_t numElements, size_t elementSize, const void* bufferData, D3D12_RESOURCE_FLAGS flags )
 {
     size_t bufferSize = numElements * elementSize;
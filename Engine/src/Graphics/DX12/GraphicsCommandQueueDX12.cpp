@@ -249,6 +249,11 @@ uint64_t GraphicsCommandQueueDX12::GetGPUFrequency() const
     return m_GPUFrequency;
 }
 
+bool GraphicsCommandQueueDX12::GetClockCalibration( uint64_t& gpuTimestamp, uint64_t& cpuTimestamp ) const
+{
+    return m_GPUFrequency > 0 && SUCCEEDED( m_d3d12CommandQueue->GetClockCalibration( &gpuTimestamp, &cpuTimestamp ) );
+}
+
 ComPtr<ID3D12CommandQueue> GraphicsCommandQueueDX12::GetD3D12CommandQueue() const
 {
     return m_d3d12CommandQueue;
@@ -32,13 +32,27 @@ HeapAllocatorDX12::~HeapAllocatorDX12()
 
 HeapAllocation HeapAllocatorDX12::Allocate( size_t sizeInBytes, size_t alignment )
 {
-    // Cannot request more than a single page size.
-    assert( sizeInBytes <= m_PageSize );
-
     scoped_lock lock( m_Mutex );
 
     // Aligned size
     const size_t alignedSize = Math::AlignUp( sizeInBytes, alignment );
+
+    HeapAllocation heapAllocation;
+
+    if ( alignedSize > m_PageSize )
+    {
+        // The allocation does not fit in a single page. 
+        // Buffers are (at least) 64 KB aligned so the allocation is also aligned.
+        std::shared_ptr<DynamicBufferDX12> largeBuffer = CreateBuffer( alignedSize );
+        assert( largeBuffer );
+        m_LargeBuffers.push_back( largeBuffer );
+
+        heapAllocation.CpuPtr = largeBuffer->m_DataPtr;
+        heapAllocation.GpuAddress = largeBuffer->m_d3d12GPUVirtualAddress;
+
+        return heapAllocation;
+    }
+
     m_CurrentOffset = Math::AlignUp( m_CurrentOffset, alignment );
 
     if ( !m_CurrentBuffer || m_CurrentOffset + alignedSize > m_PageSize )
@@ -48,7 +62,6 @@ HeapAllocation HeapAllocatorDX12::Allocate( size_t sizeInBytes, size_t alignment
         m_CurrentOffset = 0;
     }
 
-    HeapAllocation heapAllocation;
     heapAllocation.CpuPtr = static_cast<uint8_t*>( m_CurrentBuffer->m_DataPtr ) + m_CurrentOffset;
     heapAllocation.GpuAddress = m_CurrentBuffer->m_d3d12GPUVirtualAddress + m_CurrentOffset;
 
@@ -69,20 +82,20 @@ std::shared_ptr<DynamicBufferDX12> HeapAllocatorDX12::RequestBuffer()
     }
     else
     {
-        ret = CreateBuffer();
+        ret = CreateBuffer( m_PageSize );
         m_BufferPool.push( ret );
     }
 
     return ret;
 }
 
-std::shared_ptr<DynamicBufferDX12> HeapAllocatorDX12::CreateBuffer()
+std::shared_ptr<DynamicBufferDX12> HeapAllocatorDX12::CreateBuffer( uint64_t sizeInBytes )
 {
     ComPtr<ID3D12Resource> d3d12Resource;
     if ( FAILED( m_d3d12Device->CreateCommittedResource(
         &CD3DX12_HEAP_PROPERTIES( m_d3d12HeapType ),
         D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer( m_PageSize, m_d3d12ResourceFlags ),
+        &CD3DX12_RESOURCE_DESC::Buffer( sizeInBytes, m_d3d12ResourceFlags ),
         m_d3d12ResouceState,
         nullptr,
         IID_PPV_ARGS( &d3d12Resource ) ) ) )
@@ -99,6 +112,7 @@ void HeapAllocatorDX12::Free()
     scoped_lock lock( m_Mutex );
 
     m_AvailableBuffers = m_BufferPool;
+    m_LargeBuffers.clear();
     m_CurrentBuffer.reset();
     m_CurrentOffset = 0;
 }
\ No newline at end of file
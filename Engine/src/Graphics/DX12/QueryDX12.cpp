@@ -117,6 +117,8 @@ std::vector<QueryResult> QueryDX12::GetQueryResults( uint64_t startIndex, uint64
                     double elapsedTime = ( t1 - t0 ) / gpuFrequency;
 
                     results[i].ElapsedTime = elapsedTime;
+                    results[i].BeginTimestamp = t0;
+                    results[i].EndTimestamp = t1;
                     results[i].IsValid = ( elapsedTime > 0.0 );
                 }
             }
@@ -3,6 +3,7 @@
 #include <Graphics/DX12/ResourceDX12.h>
 #include <Graphics/DX12/DeviceDX12.h>
 #include <Graphics/DX12/GraphicsCommandBufferDX12.h>
+#include <Graphics/ResourceRegistry.h>
 
 using namespace Graphics;
 using namespace Microsoft::WRL;
@@ -79,17 +80,24 @@ ResourceDX12::ResourceDX12( std::shared_ptr<DeviceDX12> device )
     : m_Device( device )
     , m_d3d12Device( device->GetD3D12Device() )
     , m_d3d12ResourceState( D3D12_RESOURCE_STATE_COMMON )
+    , m_AllocationID( ResourceRegistry::InvalidID )
 {}
 
 ResourceDX12::ResourceDX12( std::shared_ptr<DeviceDX12> device, Microsoft::WRL::ComPtr<ID3D12Resource> d3d12Resource, D3D12_RESOURCE_STATES state, uint64_t offset )
     : m_Device( device )
     , m_d3d12Device( device->GetD3D12Device() )
+    , m_AllocationID( ResourceRegistry::InvalidID )
 {
     SetD3D12Resource( d3d12Resource, state, offset );
 }
 
 ResourceDX12::~ResourceDX12()
 {
+    std::shared_ptr<DeviceDX12> device = m_Device.lock();
+    if ( device && m_AllocationID != ResourceRegistry::InvalidID )
+    {
+        device->GetResourceRegistry().RemoveAllocation( m_AllocationID );
+    }
 }
 
 void ResourceDX12::SetName( const std::wstring& name )
@@ -99,6 +107,12 @@ void ResourceDX12::SetName( const std::wstring& name )
     {
         m_d3d12Resource->SetName( m_ResourceName.c_str() );
     }
+
+    std::shared_ptr<DeviceDX12> device = m_Device.lock();
+    if ( device && m_AllocationID != ResourceRegistry::InvalidID )
+    {
+        device->GetResourceRegistry().SetName( m_AllocationID, m_ResourceName );
+    }
 }
 
 ResourceState ResourceDX12::GetResourceState() const
@@ -123,6 +137,71 @@ void ResourceDX12::SetD3D12Resource( Microsoft::WRL::ComPtr<ID3D12Resource> d3d1
         }
     }
     m_d3d12ResourceState = state;
+
+    // A resource at an offset in another resource does not own the memory.
+    if ( offset == 0 )
+    {
+        UpdateAllocation();
+    }
+}
+
+void ResourceDX12::UpdateAllocation()
+{
+    std::shared_ptr<DeviceDX12> device = m_Device.lock();
+    if ( !device )
+    {
+        return;
+    }
+
+    ResourceRegistry& registry = device->GetResourceRegistry();
+
+    if ( !m_d3d12Resource )
+    {
+        if ( m_AllocationID != ResourceRegistry::InvalidID )
+        {
+            registry.RemoveAllocation( m_AllocationID );
+            m_AllocationID = ResourceRegistry::InvalidID;
+        }
+        return;
+    }
+
+    D3D12_RESOURCE_DESC d3d12ResourceDesc = m_d3d12Resource->GetDesc();
+    uint64_t size = m_d3d12Device->GetResourceAllocationInfo( 0, 1, &d3d12ResourceDesc ).SizeInBytes;
+
+    ResourceCategory category = ResourceCategory::Texture;
+    D3D12_HEAP_PROPERTIES d3d12HeapProperties = {};
+    // Fails for resources that are not in a heap (for example, reserved resources).
+    m_d3d12Resource->GetHeapProperties( &d3d12HeapProperties, nullptr );
+
+    if ( d3d12HeapProperties.Type == D3D12_HEAP_TYPE_UPLOAD )
+    {
+        category = ResourceCategory::UploadBuffer;
+    }
+    else if ( d3d12HeapProperties.Type == D3D12_HEAP_TYPE_READBACK )
+    {
+        category = ResourceCategory::ReadbackBuffer;
+    }
+    else if ( d3d12ResourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER )
+    {
+        category = ResourceCategory::Buffer;
+    }
+    else if ( ( d3d12ResourceDesc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL ) != 0 )
+    {
+        category = ResourceCategory::DepthStencil;
+    }
+    else if ( ( d3d12ResourceDesc.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET ) != 0 )
+    {
+        category = ResourceCategory::RenderTarget;
+    }
+
+    if ( m_AllocationID == ResourceRegistry::InvalidID )
+    {
+        m_AllocationID = registry.AddAllocation( category, size, m_ResourceName );
+    }
+    else
+    {
+        registry.UpdateAllocation( m_AllocationID, category, size );
+    }
 }
 
 D3D12_RESOURCE_STATES ResourceDX12::GetD3D12ResourceState() const 
@@ -10,10 +10,19 @@
 #include <Graphics/DX12/VertexBufferDX12.h>
 #include <Graphics/DX12/IndexBufferDX12.h>
 #include <Graphics/ComputeCommandBuffer.h>
+#include <Graphics/ComputeCommandQueue.h>
+#include <Graphics/Camera.h>
+#include <Graphics/Fence.h>
+#include <Graphics/Frustum.h>
 #include <Graphics/Mesh.h>
+#include <Graphics/Meshlet.h>
+#include <Graphics/MeshLOD.h>
+#include <Graphics/MeshOptimizer.h>
 #include <Graphics/SceneNode.h>
 #include <Graphics/Material.h>
+#include <Graphics/ResourceRegistry.h>
 
+#include <BoundedQueue.h>
 #include <LogManager.h>
 #include <SceneVisitor.h>
 
@@ -22,6 +31,29 @@ using namespace Graphics;
 
 #define EXPORT_FORMAT "assbin"
 #define EXPORT_EXTENSION "assbin"
+#define MESHLET_EXTENSION "meshlets"
+#define LOD_EXTENSION "lods"
+
+// Identifies a meshlet cache file ("MSHL").
+static const uint32_t gs_MeshletCacheMagic = 0x4C48534D;
+// Identifies a level of detail cache file ("MLOD").
+static const uint32_t gs_LODCacheMagic = 0x444F4C4D;
+
+// The maximum number of threads that are used to stream meshes and textures.
+static const uint32_t gs_MaxStreamingThreads = 4;
+
+// Some materials actually store normal maps in the bump map slot. Assimp can't tell the difference between 
+// these two texture types, so we try to make an assumption about whether the texture is a normal map or a bump
+// map based on its pixel depth. Bump maps are usually 8 BPP (grayscale) and normal maps are usually 24 BPP or higher.
+static Material::TextureType GetTextureType( Material::TextureType textureType, std::shared_ptr<Texture> texture )
+{
+    if ( textureType == Material::TextureType::Bump && texture && texture->GetBPP() >= 24 )
+    {
+        return Material::TextureType::Normal;
+    }
+
+    return textureType;
+}
 
 // A private class that is registered with Assimp's importer
 // Provides feedback on the loading progress of the scene files.
@@ -41,7 +73,8 @@ public:
 
         m_Scene.OnLoadingProgress( progressEventArgs );
 
-        return !progressEventArgs.Cancel;
+        // Stop reading the scene file if streaming was stopped (for example, when the application exits).
+        return !progressEventArgs.Cancel && !m_Scene.m_CancelStreaming;
     }
 
 private:
@@ -52,11 +85,12 @@ private:
 
 SceneDX12::SceneDX12( std::shared_ptr<DeviceDX12> device )
     : m_Device( device )
+    , m_CancelStreaming( false )
 {}
 
 SceneDX12::~SceneDX12()
 {
-
+    StopStreaming();
 }
 
 bool SceneDX12::LoadFromFile( std::shared_ptr<ComputeCommandBuffer> computeCommandBuffer, const std::wstring& fileName )
@@ -75,41 +109,17 @@ bool SceneDX12::LoadFromFile( std::shared_ptr<ComputeCommandBuffer> computeComma
         parentPath = fs::current_path();
     }
 
-    const aiScene* scene;
-    Assimp::Importer importer;
-
-    importer.SetProgressHandler( new ProgressHandler( *this, fileName ) );
-
-    Application::Get().SetLoadingMessage( fileName );
-
-    fs::path exportPath = filePath;
-    exportPath.replace_extension( EXPORT_EXTENSION );
-
-    if ( fs::exists( exportPath ) && fs::is_regular_file( exportPath ) )
-    {
-        LOG_INFO( "Loading scene ", exportPath );
-        // If a previously exported file exists, load that instead (scene has already been preprocessed).
-        scene = importer.ReadFile( exportPath.string(), 0 );
-    }
-    else
-    {
-        LOG_INFO( "Loading scene ", filePath );
+    // The meshlet and LOD caches are only valid for a previously exported scene.
+    bool loadedExportedScene = false;
 
-        // If no serialized version of the model file exists (or the original model is newer than the serialized version),
-        // reimport the original scene and export it as binary.
-        importer.SetPropertyFloat( AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f );
-        importer.SetPropertyInteger( AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE );
+    Assimp::Importer importer;
+    const aiScene* scene = ReadScene( importer, filePath, loadedExportedScene );
 
-        unsigned int preprocessFlags = aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_OptimizeGraph;
-        scene = importer.ReadFile( filePath.string(), preprocessFlags );
+    fs::path meshletPath = filePath;
+    meshletPath.replace_extension( MESHLET_EXTENSION );
 
-        if ( scene )
-        {
-            // Now export the preprocessed scene so we can load it faster next time.
-            Assimp::Exporter exporter;
-            exporter.Export( scene, EXPORT_FORMAT, exportPath.string(), preprocessFlags );
-        }
-    }
+    fs::path lodPath = filePath;
+    lodPath.replace_extension( LOD_EXTENSION );
 
     if ( !scene )
     {
@@ -137,10 +147,29 @@ bool SceneDX12::LoadFromFile( std::shared_ptr<ComputeCommandBuffer> computeComma
         {
             ImportMaterial( computeCommandBuffer, *scene->mMaterials[i], parentPath );
         }
+        // Load previously generated meshlets.
+        std::vector< std::shared_ptr<const MeshletData> > cachedMeshlets;
+        bool meshletCacheValid = loadedExportedScene && LoadMeshletCache( meshletPath, scene->mNumMeshes, cachedMeshlets );
+        // Load previously generated levels of detail.
+        std::vector< std::shared_ptr<const MeshLODData> > cachedLODs;
+        bool lodCacheValid = loadedExportedScene && LoadLODCache( lodPath, scene->mNumMeshes, cachedLODs );
+
         // Import meshes
+        m_OptimizationStatistics = OptimizationStatistics();
         for ( unsigned int i = 0; i < scene->mNumMeshes; ++i )
         {
-            ImportMesh( computeCommandBuffer, *scene->mMeshes[i] );
+            m_Meshes.push_back( ImportMesh( computeCommandBuffer, *scene->mMeshes[i], meshletCacheValid ? cachedMeshlets[i] : nullptr, lodCacheValid ? cachedLODs[i] : nullptr ) );
+        }
+        LogOptimizationStatistics();
+
+        if ( !meshletCacheValid )
+        {
+            SaveMeshletCache( meshletPath );
+        }
+
+        if ( !lodCacheValid )
+        {
+            SaveLODCache( lodPath );
         }
 
         m_RootNode = ImportSceneNode( computeCommandBuffer, m_RootNode, scene->mRootNode );
@@ -183,10 +212,12 @@ bool SceneDX12::LoadFromString( std::shared_ptr<ComputeCommandBuffer> computeCom
             ImportMaterial( computeCommandBuffer, *scene->mMaterials[i], fs::current_path() );
         }
         // Import meshes
+        m_OptimizationStatistics = OptimizationStatistics();
         for ( unsigned int i = 0; i < scene->mNumMeshes; ++i )
         {
-            ImportMesh( computeCommandBuffer, *scene->mMeshes[i] );
+            m_Meshes.push_back( ImportMesh( computeCommandBuffer, *scene->mMeshes[i] ) );
         }
+        LogOptimizationStatistics();
 
         m_RootNode = ImportSceneNode( computeCommandBuffer, m_RootNode, scene->mRootNode );
     }
@@ -194,6 +225,375 @@ bool SceneDX12::LoadFromString( std::shared_ptr<ComputeCommandBuffer> computeCom
     return true;
 }
 
+const aiScene* SceneDX12::ReadScene( Assimp::Importer& importer, const fs::path& filePath, bool& loadedExportedScene )
+{
+    const aiScene* scene = nullptr;
+
+    importer.SetProgressHandler( new ProgressHandler( *this, filePath.wstring() ) );
+
+    Application::Get().SetLoadingMessage( filePath.wstring() );
+
+    fs::path exportPath = filePath;
+    exportPath.replace_extension( EXPORT_EXTENSION );
+
+    loadedExportedScene = false;
+
+    if ( fs::exists( exportPath ) && fs::is_regular_file( exportPath ) )
+    {
+        loadedExportedScene = true;
+        LOG_INFO( "Loading scene ", exportPath );
+        // If a previously exported file exists, load that instead (scene has already been preprocessed).
+        scene = importer.ReadFile( exportPath.string(), 0 );
+    }
+    else
+    {
+        LOG_INFO( "Loading scene ", filePath );
+
+        // If no serialized version of the model file exists (or the original model is newer than the serialized version),
+        // reimport the original scene and export it as binary.
+        importer.SetPropertyFloat( AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f );
+        importer.SetPropertyInteger( AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE );
+
+        unsigned int preprocessFlags = aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_OptimizeGraph;
+        scene = importer.ReadFile( filePath.string(), preprocessFlags );
+
+        if ( scene )
+        {
+            // Now export the preprocessed scene so we can load it faster next time.
+            Assimp::Exporter exporter;
+            exporter.Export( scene, EXPORT_FORMAT, exportPath.string(), preprocessFlags );
+        }
+    }
+
+    return scene;
+}
+
+bool SceneDX12::StreamFromFile( const std::wstring& fileName, const glm::mat4& rootTransform, const Camera& camera )
+{
+    // Stop streaming the previous scene.
+    StopStreaming();
+
+    if ( !fs::exists( fileName ) )
+    {
+        LOG_ERROR( "Scene file not found ", fs::path( fileName ) );
+        return false;
+    }
+
+    m_SceneFile = fileName;
+    m_CancelStreaming = false;
+    m_StreamingStatistics = SceneStreamingStatistics();
+
+    glm::vec3 cameraPosition = glm::vec3( camera.GetInverseViewMatrix()[3] );
+    glm::mat4 viewProjection = camera.GetProjectionMatrix() * camera.GetViewMatrix();
+
+    m_StreamingThread = std::thread( &SceneDX12::StreamScene, this, fs::path( fileName ), rootTransform, cameraPosition, viewProjection );
+
+    return true;
+}
+
+void SceneDX12::StreamScene( fs::path filePath, glm::mat4 rootTransform, glm::vec3 cameraPosition, glm::mat4 viewProjection )
+{
+    // Streamed resources are created on the streaming threads.
+    ResourceRegistry::ScopedGroup resourceGroup( L"Scene" );
+
+    fs::path parentPath = filePath.has_parent_path() ? filePath.parent_path() : fs::current_path();
+
+    bool loadedExportedScene = false;
+    Assimp::Importer importer;
+    const aiScene* scene = ReadScene( importer, filePath, loadedExportedScene );
+
+    if ( !scene )
+    {
+        // Reading the scene file was cancelled (see ProgressHandler::Update).
+        if ( !m_CancelStreaming )
+        {
+            LogManager::LogError( importer.GetErrorString() );
+        }
+        return;
+    }
+
+    fs::path meshletPath = filePath;
+    meshletPath.replace_extension( MESHLET_EXTENSION );
+
+    fs::path lodPath = filePath;
+    lodPath.replace_extension( LOD_EXTENSION );
+
+    m_MaterialMap.clear();
+    m_Materials.clear();
+    m_Meshes.clear();
+
+    // Create placeholder materials (material properties only).
+    // The textures are loaded by the streaming threads.
+    std::vector<TextureRequest> textureRequests;
+    std::vector<size_t> firstTextureRequest( scene->mNumMaterials + 1, 0 );
+    for ( unsigned int i = 0; i < scene->mNumMaterials; ++i )
+    {
+        ImportMaterial( nullptr, *scene->mMaterials[i], parentPath, &textureRequests );
+        firstTextureRequest[i + 1] = textureRequests.size();
+    }
+
+    // Textures that are shared by multiple materials are only loaded once.
+    std::map< std::wstring, std::vector<TextureRequest> > textureFiles;
+    for ( const TextureRequest& textureRequest : textureRequests )
+    {
+        textureFiles[textureRequest.FileName].push_back( textureRequest );
+    }
+
+    std::vector< std::shared_ptr<const MeshletData> > cachedMeshlets;
+    bool meshletCacheValid = loadedExportedScene && LoadMeshletCache( meshletPath, scene->mNumMeshes, cachedMeshlets );
+    std::vector< std::shared_ptr<const MeshLODData> > cachedLODs;
+    bool lodCacheValid = loadedExportedScene && LoadLODCache( lodPath, scene->mNumMeshes, cachedLODs );
+
+    // Load the scene node hierarchy. Meshes are added to the scene nodes when they are loaded.
+    MeshInstanceList meshInstances( scene->mNumMeshes );
+    std::shared_ptr<SceneNode> rootNode = ImportSceneNode( nullptr, nullptr, scene->mRootNode, &meshInstances );
+    rootNode->SetLocalTransform( rootTransform );
+
+    // Meshes that are visible from the camera are loaded first, 
+    // then meshes are loaded from front to back.
+    struct MeshPriority
+    {
+        uint32_t MeshIndex;
+        bool IsVisible;
+        float Distance;
+    };
+
+    Frustum frustum( viewProjection );
+    std::vector<MeshPriority> meshPriorities;
+    meshPriorities.reserve( scene->mNumMeshes );
+
+    for ( unsigned int i = 0; i < scene->mNumMeshes; ++i )
+    {
+        const aiMesh& mesh = *scene->mMeshes[i];
+
+        glm::vec3 min( std::numeric_limits<float>::max() );
+        glm::vec3 max( -std::numeric_limits<float>::max() );
+        for ( unsigned int v = 0; v < mesh.mNumVertices; ++v )
+        {
+            glm::vec3 position( mesh.mVertices[v].x, mesh.mVertices[v].y, mesh.mVertices[v].z );
+            min = glm::min( min, position );
+            max = glm::max( max, position );
+        }
+        glm::vec3 center = ( min + max ) * 0.5f;
+        float radius = glm::length( max - min ) * 0.5f;
+
+        MeshPriority meshPriority = { i, false, std::numeric_limits<float>::max() };
+        for ( auto node : meshInstances[i] )
+        {
+            glm::mat4 worldTransform = node->GetWorldTransform();
+            float scale = glm::max( glm::length( glm::vec3( worldTransform[0] ) ), glm::max( glm::length( glm::vec3( worldTransform[1] ) ), glm::length( glm::vec3( worldTransform[2] ) ) ) );
+
+            glm::vec3 worldCenter = glm::vec3( worldTransform * glm::vec4( center, 1 ) );
+            float worldRadius = radius * scale;
+
+            meshPriority.IsVisible = meshPriority.IsVisible || frustum.IntersectsSphere( worldCenter, worldRadius );
+            meshPriority.Distance = glm::min( meshPriority.Distance, glm::max( glm::distance( worldCenter, cameraPosition ) - worldRadius, 0.0f ) );
+        }
+
+        meshPriorities.push_back( meshPriority );
+    }
+
+    std::sort( meshPriorities.begin(), meshPriorities.end(), []( const MeshPriority& a, const MeshPriority& b )
+    {
+        return a.IsVisible != b.IsVisible ? a.IsVisible : a.Distance < b.Distance;
+    } );
+
+    // Build the list of streaming jobs in priority order. 
+    // The textures of a mesh's material are loaded before the mesh.
+    std::vector< std::function<void()> > jobs;
+    std::set<std::wstring> scheduledTextures;
+    uint32_t numVisibleAssets = 0;
+
+    auto ScheduleTextures = [&]( unsigned int materialIndex, bool isVisible )
+    {
+        for ( size_t i = firstTextureRequest[materialIndex]; i < firstTextureRequest[materialIndex + 1]; ++i )
+        {
+            const std::wstring& fileName = textureRequests[i].FileName;
+            if ( scheduledTextures.insert( fileName ).second )
+            {
+                jobs.push_back( std::bind( &SceneDX12::StreamTexture, this, fileName, textureFiles[fileName], isVisible ) );
+                numVisibleAssets += isVisible ? 1 : 0;
+            }
+        }
+    };
+
+    m_Meshes.resize( scene->mNumMeshes );
+    for ( const MeshPriority& meshPriority : meshPriorities )
+    {
+        uint32_t i = meshPriority.MeshIndex;
+
+        ScheduleTextures( scene->mMeshes[i]->mMaterialIndex, meshPriority.IsVisible );
+
+        jobs.push_back( std::bind( &SceneDX12::StreamMesh, this, i, scene->mMeshes[i], 
+                                   meshletCacheValid ? cachedMeshlets[i] : nullptr, lodCacheValid ? cachedLODs[i] : nullptr,
+                                   meshInstances[i], meshPriority.IsVisible ) );
+        numVisibleAssets += meshPriority.IsVisible ? 1 : 0;
+    }
+
+    // Textures of materials that are not used by any mesh.
+    for ( unsigned int i = 0; i < scene->mNumMaterials; ++i )
+    {
+        ScheduleTextures( i, false );
+    }
+
+    // Publish the scene node hierarchy.
+    uint32_t numMeshes = scene->mNumMeshes;
+    uint32_t numTextures = static_cast<uint32_t>( scheduledTextures.size() );
+    m_StreamedAssets.Push( [this, rootNode, numMeshes, numTextures, numVisibleAssets]()
+    {
+        m_RootNode = rootNode;
+        m_StreamingStatistics.NumMeshes = numMeshes;
+        m_StreamingStatistics.NumTextures = numTextures;
+        m_StreamingStatistics.NumVisibleAssets = numVisibleAssets;
+        m_StreamingStatistics.IsHierarchyLoaded = true;
+    } );
+
+    LOG_INFO( "Streaming ", numMeshes, " meshes and ", numTextures, " textures (", numVisibleAssets, " visible)." );
+
+    // The job queue is bounded so that the streaming threads 
+    // can not run too far ahead of the priority order.
+    const uint32_t numThreads = glm::clamp( std::thread::hardware_concurrency(), 2u, gs_MaxStreamingThreads + 1 ) - 1;
+    Core::BoundedQueue< std::function<void()> > jobQueue( numThreads * 2 );
+
+    m_OptimizationStatistics = OptimizationStatistics();
+
+    std::vector<std::thread> streamingThreads;
+    for ( uint32_t i = 0; i < numThreads; ++i )
+    {
+        streamingThreads.emplace_back( [this, &jobQueue]()
+        {
+            std::function<void()> job;
+            while ( jobQueue.Pop( job ) )
+            {
+                if ( !m_CancelStreaming )
+                {
+                    job();
+                }
+            }
+        } );
+    }
+
+    for ( auto& job : jobs )
+    {
+        if ( m_CancelStreaming || !jobQueue.Push( std::move( job ) ) )
+        {
+            break;
+        }
+    }
+
+    jobQueue.Close();
+    for ( auto& streamingThread : streamingThreads )
+    {
+        streamingThread.join();
+    }
+
+    if ( m_CancelStreaming )
+    {
+        return;
+    }
+
+    LogOptimizationStatistics();
+
+    if ( !meshletCacheValid )
+    {
+        SaveMeshletCache( meshletPath );
+    }
+
+    if ( !lodCacheValid )
+    {
+        SaveLODCache( lodPath );
+    }
+
+    m_StreamedAssets.Push( [this]()
+    {
+        m_StreamingStatistics.IsComplete = true;
+    } );
+}
+
+void SceneDX12::StreamMesh( uint32_t meshIndex, const aiMesh* mesh, std::shared_ptr<const MeshletData> cachedMeshlets, std::shared_ptr<const MeshLODData> cachedLODs,
+                            std::vector< std::shared_ptr<SceneNode> > nodes, bool isVisible )
+{
+    ResourceRegistry::ScopedGroup resourceGroup( L"Scene" );
+
+    std::shared_ptr<ComputeCommandQueue> commandQueue = m_Device.lock()->GetComputeQueue();
+    std::shared_ptr<ComputeCommandBuffer> commandBuffer = commandQueue->GetComputeCommandBuffer();
+
+    std::shared_ptr<Mesh> pMesh = ImportMesh( commandBuffer, *mesh, cachedMeshlets, cachedLODs );
+
+    // Wait for the upload to finish before the mesh is added to the scene.
+    commandQueue->Submit( commandBuffer )->WaitFor();
+
+    m_Meshes[meshIndex] = pMesh;
+
+    m_StreamedAssets.Push( [this, pMesh, nodes, isVisible]()
+    {
+        for ( auto node : nodes )
+        {
+            node->AddMesh( pMesh );
+        }
+
+        ++m_StreamingStatistics.NumMeshesLoaded;
+        if ( isVisible )
+        {
+            ++m_StreamingStatistics.NumVisibleAssetsLoaded;
+        }
+    } );
+}
+
+void SceneDX12::StreamTexture( std::wstring fileName, std::vector<TextureRequest> textureRequests, bool isVisible )
+{
+    ResourceRegistry::ScopedGroup resourceGroup( L"Scene" );
+
+    std::shared_ptr<DeviceDX12> device = m_Device.lock();
+    std::shared_ptr<ComputeCommandQueue> commandQueue = device->GetComputeQueue();
+    std::shared_ptr<ComputeCommandBuffer> commandBuffer = commandQueue->GetComputeCommandBuffer();
+
+    std::shared_ptr<Texture> pTexture = device->CreateTexture( commandBuffer, fileName );
+
+    // Wait for the upload (and mipmap generation) to finish before the texture is used.
+    commandQueue->Submit( commandBuffer )->WaitFor();
+
+    m_StreamedAssets.Push( [this, pTexture, textureRequests, isVisible]()
+    {
+        for ( const TextureRequest& textureRequest : textureRequests )
+        {
+            textureRequest.Material->SetTexture( GetTextureType( textureRequest.TextureType, pTexture ), pTexture );
+        }
+
+        ++m_StreamingStatistics.NumTexturesLoaded;
+        if ( isVisible )
+        {
+            ++m_StreamingStatistics.NumVisibleAssetsLoaded;
+        }
+    } );
+}
+
+void SceneDX12::ApplyStreamedAssets()
+{
+    std::function<void()> applyAsset;
+    while ( m_StreamedAssets.TryPop( applyAsset ) )
+    {
+        applyAsset();
+    }
+}
+
+void SceneDX12::StopStreaming()
+{
+    if ( m_StreamingThread.joinable() )
+    {
+        m_CancelStreaming = true;
+        m_StreamingThread.join();
+
+        // Scenes that are loaded later are not cancelled.
+        m_CancelStreaming = false;
+    }
+}
+
+SceneStreamingStatistics SceneDX12::GetStreamingStatistics() const
+{
+    return m_StreamingStatistics;
+}
+
 void SceneDX12::Render( Core::RenderEventArgs& renderEventArgs )
 {
     if ( m_RootNode )
@@ -216,7 +616,7 @@ void SceneDX12::Accept( Core::SceneVisitor& visitor )
     }
 }
 
-void SceneDX12::ImportMaterial( std::shared_ptr<ComputeCommandBuffer> computeCommandBuffer, const aiMaterial& material, fs::path parentPath )
+void SceneDX12::ImportMaterial( std::shared_ptr<ComputeCommandBuffer> computeCommandBuffer, const aiMaterial& material, fs::path parentPath, std::vector<TextureRequest>* textureRequests )
 {
     aiString materialName;
     aiString aiTexturePath;
@@ -236,6 +636,21 @@ void SceneDX12::ImportMaterial( std::shared_ptr<ComputeCommandBuffer> computeCom
 
     std::shared_ptr<Material> pMaterial = deviceDX12->CreateMaterial();
 
+    // Load the texture now or defer loading to the streaming threads.
+    auto LoadTexture = [&]( Material::TextureType textureType, const aiString& texturePath )
+    {
+        std::wstring fileName = ( parentPath / fs::path( texturePath.C_Str() ) ).wstring();
+        if ( textureRequests )
+        {
+            textureRequests->push_back( { pMaterial, textureType, fileName } );
+        }
+        else
+        {
+            std::shared_ptr<Texture> pTexture = deviceDX12->CreateTexture( computeCommandBuffer, fileName );
+            pMaterial->SetTexture( GetTextureType( textureType, pTexture ), pTexture );
+        }
+    };
+
     if ( material.Get( AI_MATKEY_COLOR_AMBIENT, ambientColor ) == aiReturn_SUCCESS )
     {
         pMaterial->SetAmbientColor( glm::vec4( ambientColor.r, ambientColor.g, ambientColor.b, ambientColor.a ) );
@@ -277,36 +692,28 @@ void SceneDX12::ImportMaterial( std::shared_ptr<ComputeCommandBuffer> computeCom
     if ( material.GetTextureCount( aiTextureType_AMBIENT ) > 0 &&
          material.GetTexture( aiTextureType_AMBIENT, 0, &aiTexturePath, nullptr, nullptr, &blendFactor, &aiBlendOperation ) == aiReturn_SUCCESS )
     {
-        fs::path texturePath( aiTexturePath.C_Str() );
-        std::shared_ptr<Texture> pTexture = deviceDX12->CreateTexture( computeCommandBuffer, ( parentPath / texturePath ).wstring() );
-        pMaterial->SetTexture( Material::TextureType::Ambient, pTexture );
+        LoadTexture( Material::TextureType::Ambient, aiTexturePath );
     }
 
     // Load emissive textures.
     if ( material.GetTextureCount( aiTextureType_EMISSIVE ) > 0 &&
          material.GetTexture( aiTextureType_EMISSIVE, 0, &aiTexturePath, nullptr, nullptr, &blendFactor, &aiBlendOperation ) == aiReturn_SUCCESS )
     {
-        fs::path texturePath( aiTexturePath.C_Str() );
-        std::shared_ptr<Texture> pTexture = deviceDX12->CreateTexture( computeCommandBuffer, ( parentPath / texturePath ).wstring() );
-        pMaterial->SetTexture( Material::TextureType::Emissive, pTexture );
+        LoadTexture( Material::TextureType::Emissive, aiTexturePath );
     }
 
     // Load diffuse textures.
     if ( material.GetTextureCount( aiTextureType_DIFFUSE ) > 0 &&
          material.GetTexture( aiTextureType_DIFFUSE, 0, &aiTexturePath, nullptr, nullptr, &blendFactor, &aiBlendOperation ) == aiReturn_SUCCESS )
     {
-        fs::path texturePath( aiTexturePath.C_Str() );
-        std::shared_ptr<Texture> pTexture = deviceDX12->CreateTexture( computeCommandBuffer, ( parentPath / texturePath ).wstring() );
-        pMaterial->SetTexture( Material::TextureType::Diffuse, pTexture );
+        LoadTexture( Material::TextureType::Diffuse, aiTexturePath );
     }
 
     // Load specular texture.
     if ( material.GetTextureCount( aiTextureType_SPECULAR ) > 0 &&
          material.GetTexture( aiTextureType_SPECULAR, 0, &aiTexturePath, nullptr, nullptr, &blendFactor, &aiBlendOperation ) == aiReturn_SUCCESS )
     {
-        fs::path texturePath( aiTexturePath.C_Str() );
-        std::shared_ptr<Texture> pTexture = deviceDX12->CreateTexture( computeCommandBuffer, ( parentPath / texturePath ).wstring() );
-        pMaterial->SetTexture( Material::TextureType::Specular, pTexture );
+        LoadTexture( Material::TextureType::Specular, aiTexturePath );
     }
 
 
@@ -314,47 +721,34 @@ void SceneDX12::ImportMaterial( std::shared_ptr<ComputeCommandBuffer> computeCom
     if ( material.GetTextureCount( aiTextureType_SHININESS ) > 0 &&
          material.GetTexture( aiTextureType_SHININESS, 0, &aiTexturePath, nullptr, nullptr, &blendFactor, &aiBlendOperation ) == aiReturn_SUCCESS )
     {
-        fs::path texturePath( aiTexturePath.C_Str() );
-        std::shared_ptr<Texture> pTexture = deviceDX12->CreateTexture( computeCommandBuffer, ( parentPath / texturePath ).wstring() );
-        pMaterial->SetTexture( Material::TextureType::SpecularPower, pTexture );
+        LoadTexture( Material::TextureType::SpecularPower, aiTexturePath );
     }
 
     if ( material.GetTextureCount( aiTextureType_OPACITY ) > 0 &&
          material.GetTexture( aiTextureType_OPACITY, 0, &aiTexturePath, nullptr, nullptr, &blendFactor, &aiBlendOperation ) == aiReturn_SUCCESS )
     {
-        fs::path texturePath( aiTexturePath.C_Str() );
-        std::shared_ptr<Texture> pTexture = deviceDX12->CreateTexture( computeCommandBuffer, ( parentPath / texturePath ).wstring() );
-        pMaterial->SetTexture( Material::TextureType::Opacity, pTexture );
+        LoadTexture( Material::TextureType::Opacity, aiTexturePath );
     }
 
     // Load normal map texture.
     if ( material.GetTextureCount( aiTextureType_NORMALS ) > 0 &&
          material.GetTexture( aiTextureType_NORMALS, 0, &aiTexturePath ) == aiReturn_SUCCESS )
     {
-        fs::path texturePath( aiTexturePath.C_Str() );
-        std::shared_ptr<Texture> pTexture = deviceDX12->CreateTexture( computeCommandBuffer, ( parentPath / texturePath ).wstring() );
-        pMaterial->SetTexture( Material::TextureType::Normal, pTexture );
+        LoadTexture( Material::TextureType::Normal, aiTexturePath );
     }
     // Load bump map (only if there is no normal map).
     else if ( material.GetTextureCount( aiTextureType_HEIGHT ) > 0 &&
               material.GetTexture( aiTextureType_HEIGHT, 0, &aiTexturePath, nullptr, nullptr, &blendFactor ) == aiReturn_SUCCESS )
     {
-        fs::path texturePath( aiTexturePath.C_Str() );
-        std::shared_ptr<Texture> pTexture = deviceDX12->CreateTexture( computeCommandBuffer, ( parentPath / texturePath ).wstring() );
-
-        // Some materials actually store normal maps in the bump map slot. Assimp can't tell the difference between 
-        // these two texture types, so we try to make an assumption about whether the texture is a normal map or a bump
-        // map based on its pixel depth. Bump maps are usually 8 BPP (grayscale) and normal maps are usually 24 BPP or higher.
-        Material::TextureType textureType = ( pTexture->GetBPP() >= 24 ) ? Material::TextureType::Normal : Material::TextureType::Bump;
-
-        pMaterial->SetTexture( textureType, pTexture );
+        // The texture is treated as a normal map if it looks like one (see GetTextureType).
+        LoadTexture( Material::TextureType::Bump, aiTexturePath );
     }
 
     //m_MaterialMap.insert( MaterialMap::value_type( materialName.C_Str(), pMaterial ) );
     m_Materials.push_back( pMaterial );
 }
 
-void SceneDX12::ImportMesh( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer, const aiMesh& mesh )
+std::shared_ptr<Mesh> SceneDX12::ImportMesh( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer, const aiMesh& mesh, std::shared_ptr<const MeshletData> cachedMeshlets, std::shared_ptr<const MeshLODData> cachedLODs )
 {
     std::shared_ptr<Device> device = m_Device.lock();
 
@@ -423,13 +817,11 @@ void SceneDX12::ImportMesh( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer
         }
     }
 
-    std::shared_ptr<VertexBuffer> vertexBuffer = device->CreateVertexBuffer( copyCommandBuffer, vertexData );
-    pMesh->SetVertexBuffer( 0, vertexBuffer );
-
     // Extract the index buffer.
+    std::vector<uint32_t> indices;
     if ( mesh.HasFaces() )
     {
-        std::vector<unsigned int> indices;
+        indices.reserve( mesh.mNumFaces * 3 );
         for ( unsigned int i = 0; i < mesh.mNumFaces; ++i )
         {
             const aiFace& face = mesh.mFaces[i];
@@ -441,17 +833,112 @@ void SceneDX12::ImportMesh( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer
                 indices.push_back( face.mIndices[2] );
             }
         }
-        if ( indices.size() > 0 )
+    }
+
+    if ( indices.size() > 0 )
+    {
+        MeshOptimizer::VertexCacheStatistics cacheBefore = MeshOptimizer::AnalyzeVertexCache( indices, vertexData.size() );
+        MeshOptimizer::VertexFetchStatistics fetchBefore = MeshOptimizer::AnalyzeVertexFetch( indices, vertexData.size(), sizeof( Mesh::Vertex ) );
+
+        // Reorder the triangles for the post-transform cache, then reduce overdraw 
+        // and finally reorder the vertices to match the order of the index buffer.
+        MeshOptimizer::OptimizeVertexCache( indices, vertexData.size() );
+        MeshOptimizer::OptimizeOverdraw( indices, vertexData );
+        MeshOptimizer::OptimizeVertexFetch( vertexData, indices );
+
+        MeshOptimizer::VertexCacheStatistics cacheAfter = MeshOptimizer::AnalyzeVertexCache( indices, vertexData.size() );
+        MeshOptimizer::VertexFetchStatistics fetchAfter = MeshOptimizer::AnalyzeVertexFetch( indices, vertexData.size(), sizeof( Mesh::Vertex ) );
+
+        // Meshes can be imported on multiple threads while streaming.
+        scoped_lock lock( m_OptimizationStatisticsMutex );
+
+        m_OptimizationStatistics.NumTriangles += indices.size() / 3;
+        m_OptimizationStatistics.NumVertices += vertexData.size();
+        m_OptimizationStatistics.VertexBytes += vertexData.size() * sizeof( Mesh::Vertex );
+        m_OptimizationStatistics.VerticesTransformedBefore += cacheBefore.VerticesTransformed;
+        m_OptimizationStatistics.VerticesTransformedAfter += cacheAfter.VerticesTransformed;
+        m_OptimizationStatistics.BytesFetchedBefore += fetchBefore.BytesFetched;
+        m_OptimizationStatistics.BytesFetchedAfter += fetchAfter.BytesFetched;
+    }
+
+    std::shared_ptr<VertexBuffer> vertexBuffer = device->CreateVertexBuffer( copyCommandBuffer, vertexData );
+    pMesh->SetVertexBuffer( 0, vertexBuffer );
+    pMesh->ComputeBoundingVolumes( vertexData );
+
+    // Cached data is only used if it was generated from the same (optimized) mesh.
+    uint64_t meshHash = ( cachedLODs || cachedMeshlets ) ? Mesh::ComputeHash( vertexData, indices ) : 0;
+
+    if ( indices.size() > 0 )
+    {
+        // Use the cached levels of detail if they match the optimized mesh, otherwise generate them.
+        std::shared_ptr<const MeshLODData> lods;
+        if ( cachedLODs && cachedLODs->IsValid( meshHash ) )
+        {
+            lods = cachedLODs;
+        }
+        else
+        {
+            std::shared_ptr<MeshLODData> lodData = std::make_shared<MeshLODData>();
+            lodData->Build( vertexData, indices );
+            lods = lodData;
+        }
+        pMesh->SetLODs( lods );
+
+        // The index buffer contains the indices of all levels of detail.
+        const std::vector<uint32_t>& lodIndices = lods->GetIndices();
+        std::shared_ptr<IndexBuffer> indexBuffer;
+        bool use16BitIndices = vertexData.size() <= std::numeric_limits<uint16_t>::max();
+
+        // Use 16-bit indices if all of the vertices can be addressed.
+        if ( use16BitIndices )
+        {
+            std::vector<uint16_t> indices16( lodIndices.begin(), lodIndices.end() );
+            indexBuffer = device->CreateIndexBuffer( copyCommandBuffer, indices16 );
+        }
+        else
         {
-            std::shared_ptr<IndexBuffer> indexBuffer = device->CreateIndexBuffer( copyCommandBuffer, indices );
-            pMesh->SetIndexBuffer( indexBuffer );
+            indexBuffer = device->CreateIndexBuffer( copyCommandBuffer, lodIndices );
+        }
+
+        pMesh->SetIndexBuffer( indexBuffer );
+
+        // The triangle hierarchy of the full detail mesh (for ray queries) 
+        // is only built when the mesh is hit by a ray for the first time.
+        std::vector<glm::vec3> positions( vertexData.size() );
+        std::transform( vertexData.begin(), vertexData.end(), positions.begin(), []( const Mesh::Vertex& vertex ) { return vertex.Position; } );
+
+        pMesh->SetBVHTriangles( std::move( positions ), indices );
+
+        scoped_lock lock( m_OptimizationStatisticsMutex );
+
+        m_OptimizationStatistics.NumLODs += lods->GetNumLODs();
+        m_OptimizationStatistics.NumLODTriangles += ( lodIndices.size() - indices.size() ) / 3;
+        if ( use16BitIndices )
+        {
+            ++m_OptimizationStatistics.Num16BitIndexBuffers;
+        }
+        else
+        {
+            ++m_OptimizationStatistics.Num32BitIndexBuffers;
         }
     }
 
-    m_Meshes.push_back( pMesh );
+    // Use the cached meshlets if they match the optimized mesh, otherwise generate them.
+    if ( cachedMeshlets && cachedMeshlets->IsValid( meshHash ) )
+    {
+        pMesh->SetMeshlets( cachedMeshlets );
+    }
+    else
+    {
+        std::shared_ptr<MeshletData> meshlets = std::make_shared<MeshletData>();
+        meshlets->Build( vertexData, indices );
+        pMesh->SetMeshlets( meshlets );
+    }
+
+    return pMesh;
 }
 
-std::shared_ptr<SceneNode> SceneDX12::ImportSceneNode( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer, std::shared_ptr<SceneNode> parent, aiNode* aiNode )
+std::shared_ptr<SceneNode> SceneDX12::ImportSceneNode( std::shared_ptr<CopyCommandBuffer> copyCommandBuffer, std::shared_ptr<SceneNode> parent, aiNode* aiNode, MeshInstanceList* meshInstances )
 {
     if ( !aiNode )
     {
@@ -478,18 +965,170 @@ std::shared_ptr<SceneNode> SceneDX12::ImportSceneNode( std::shared_ptr<CopyComma
     // Add meshes to scene node
     for ( unsigned int i = 0; i < aiNode->mNumMeshes; ++i )
     {
-        assert( aiNode->mMeshes[i] < m_Meshes.size() );
+        if ( meshInstances )
+        {
+            // The mesh is added to the node when it has been streamed.
+            assert( aiNode->mMeshes[i] < meshInstances->size() );
+            ( *meshInstances )[aiNode->mMeshes[i]].push_back( pNode );
+        }
+        else
+        {
+            assert( aiNode->mMeshes[i] < m_Meshes.size() );
 
-        std::shared_ptr<Mesh> pMesh = m_Meshes[aiNode->mMeshes[i]];
-        pNode->AddMesh( pMesh );
+            std::shared_ptr<Mesh> pMesh = m_Meshes[aiNode->mMeshes[i]];
+            pNode->AddMesh( pMesh );
+        }
     }
 
     // Recursively Import children
     for ( unsigned int i = 0; i < aiNode->mNumChildren; ++i )
     {
-        std::shared_ptr<SceneNode> pChild = ImportSceneNode( copyCommandBuffer, pNode, aiNode->mChildren[i] );
+        std::shared_ptr<SceneNode> pChild = ImportSceneNode( copyCommandBuffer, pNode, aiNode->mChildren[i], meshInstances );
         pNode->AddChild( pChild );
     }
 
     return pNode;
 }
+
+bool SceneDX12::LoadMeshletCache( const fs::path& cachePath, size_t numMeshes, std::vector< std::shared_ptr<const MeshletData> >& meshlets ) const
+{
+    std::ifstream stream( cachePath, std::ios::binary );
+    if ( !stream )
+    {
+        return false;
+    }
+
+    uint32_t magic;
+    uint32_t numCachedMeshes;
+    if ( !stream.read( reinterpret_cast<char*>( &magic ), sizeof( magic ) ) || magic != gs_MeshletCacheMagic ||
+         !stream.read( reinterpret_cast<char*>( &numCachedMeshes ), sizeof( numCachedMeshes ) ) || numCachedMeshes != numMeshes )
+    {
+        LOG_WARNING( "Invalid meshlet cache ", cachePath );
+        return false;
+    }
+
+    meshlets.reserve( numMeshes );
+    for ( size_t i = 0; i < numMeshes; ++i )
+    {
+        std::shared_ptr<MeshletData> meshletData = std::make_shared<MeshletData>();
+        if ( !meshletData->Load( stream ) )
+        {
+            LOG_WARNING( "Invalid meshlet cache ", cachePath );
+            meshlets.clear();
+            return false;
+        }
+        meshlets.push_back( meshletData );
+    }
+
+    LOG_INFO( "Loaded meshlets ", cachePath );
+
+    return true;
+}
+
+void SceneDX12::SaveMeshletCache( const fs::path& cachePath ) const
+{
+    std::ofstream stream( cachePath, std::ios::binary | std::ios::trunc );
+    if ( !stream )
+    {
+        LOG_WARNING( "Failed to open meshlet cache for writing ", cachePath );
+        return;
+    }
+
+    uint32_t numMeshes = static_cast<uint32_t>( m_Meshes.size() );
+    stream.write( reinterpret_cast<const char*>( &gs_MeshletCacheMagic ), sizeof( gs_MeshletCacheMagic ) );
+    stream.write( reinterpret_cast<const char*>( &numMeshes ), sizeof( numMeshes ) );
+
+    for ( auto mesh : m_Meshes )
+    {
+        std::shared_ptr<const MeshletData> meshlets = mesh->GetMeshlets();
+        if ( !meshlets || !meshlets->Save( stream ) )
+        {
+            LOG_WARNING( "Failed to write meshlet cache ", cachePath );
+            stream.close();
+            fs::remove( cachePath );
+            return;
+        }
+    }
+}
+
+bool SceneDX12::LoadLODCache( const fs::path& cachePath, size_t numMeshes, std::vector< std::shared_ptr<const MeshLODData> >& lods ) const
+{
+    std::ifstream stream( cachePath, std::ios::binary );
+    if ( !stream )
+    {
+        return false;
+    }
+
+    uint32_t magic;
+    uint32_t numCachedMeshes;
+    if ( !stream.read( reinterpret_cast<char*>( &magic ), sizeof( magic ) ) || magic != gs_LODCacheMagic ||
+         !stream.read( reinterpret_cast<char*>( &numCachedMeshes ), sizeof( numCachedMeshes ) ) || numCachedMeshes != numMeshes )
+    {
+        LOG_WARNING( "Invalid LOD cache ", cachePath );
+        return false;
+    }
+
+    lods.reserve( numMeshes );
+    for ( size_t i = 0; i < numMeshes; ++i )
+    {
+        std::shared_ptr<MeshLODData> lodData = std::make_shared<MeshLODData>();
+        if ( !lodData->Load( stream ) )
+        {
+            LOG_WARNING( "Invalid LOD cache ", cachePath );
+            lods.clear();
+            return false;
+        }
+        lods.push_back( lodData );
+    }
+
+    LOG_INFO( "Loaded levels of detail ", cachePath );
+
+    return true;
+}
+
+void SceneDX12::SaveLODCache( const fs::path& cachePath ) const
+{
+    std::ofstream stream( cachePath, std::ios::binary | std::ios::trunc );
+    if ( !stream )
+    {
+        LOG_WARNING( "Failed to open LOD cache for writing ", cachePath );
+        return;
+    }
+
+    uint32_t numMeshes = static_cast<uint32_t>( m_Meshes.size() );
+    stream.write( reinterpret_cast<const char*>( &gs_LODCacheMagic ), sizeof( gs_LODCacheMagic ) );
+    stream.write( reinterpret_cast<const char*>( &numMeshes ), sizeof( numMeshes ) );
+
+    for ( auto mesh : m_Meshes )
+    {
+        std::shared_ptr<const MeshLODData> lods = mesh->GetLODs();
+        if ( !lods || !lods->Save( stream ) )
+        {
+            LOG_WARNING( "Failed to write LOD cache ", cachePath );
+            stream.close();
+            fs::remove( cachePath );
+            return;
+        }
+    }
+}
+
+void SceneDX12::LogOptimizationStatistics() const
+{
+    const OptimizationStatistics& stats = m_OptimizationStatistics;
+    if ( stats.NumTriangles == 0 )
+    {
+        return;
+    }
+
+    const double numTriangles = static_cast<double>( stats.NumTriangles );
+    const double numVertices = static_cast<double>( stats.NumVertices );
+    const double vertexBytes = static_cast<double>( stats.VertexBytes );
+
+    LOG_INFO( "Mesh optimization ", fs::path( m_SceneFile ).filename(), ": ",
+              stats.NumTriangles, " triangles, ", stats.NumVertices, " vertices, ",
+              stats.Num16BitIndexBuffers, " 16-bit index buffers, ", stats.Num32BitIndexBuffers, " 32-bit index buffers." );
+    LOG_INFO( "ACMR: ", stats.VerticesTransformedBefore / numTriangles, " -> ", stats.VerticesTransformedAfter / numTriangles,
+              " ATVR: ", stats.VerticesTransformedBefore / numVertices, " -> ", stats.VerticesTransformedAfter / numVertices,
+              " Overfetch: ", stats.BytesFetchedBefore / vertexBytes, " -> ", stats.BytesFetchedAfter / vertexBytes );
+    LOG_INFO( "Levels of detail: ", stats.NumLODs, " (", stats.NumLODTriangles, " additional triangles)" );
+}
@@ -519,6 +519,8 @@ void TextureDX12::Resize( uint32_t width, uint32_t height, uint32_t depthOrArray
         m_d3d12Resource->SetName( m_ResourceName.c_str() );
     }
 
+    UpdateAllocation();
+
     InitViews( d3d12ResourceDesc );
 }
 
@@ -196,6 +196,15 @@ void WindowDX12::CloseWindow()
     ::DestroyWindow( m_hWindow );
 }
 
+void WindowDX12::SetClientSize( uint32_t width, uint32_t height )
+{
+    RECT windowRect = { 0, 0, static_cast<LONG>( width ), static_cast<LONG>( height ) };
+    ::AdjustWindowRect( &windowRect, static_cast<DWORD>( ::GetWindowLongPtr( m_hWindow, GWL_STYLE ) ), FALSE );
+
+    // The WM_SIZE message resizes the swap chain (see OnResize).
+    ::SetWindowPos( m_hWindow, nullptr, 0, 0, windowRect.right - windowRect.left, windowRect.bottom - windowRect.top, SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE );
+}
+
 void WindowDX12::SetFullScreen( bool fullscreen )
 {
     if ( m_dxgiSwapChain ) 
@@ -0,0 +1,172 @@
+#include <EnginePCH.h>
+
+#include <Graphics/DrawList.h>
+
+using namespace Graphics;
+
+// The number of bits in each field of the sort key.
+static const uint32_t gs_PassBits = 4;
+static const uint32_t gs_PipelineBits = 8;
+static const uint32_t gs_MaterialBits = 16;
+static const uint32_t gs_MeshBits = 16;
+static const uint32_t gs_DepthBits = 20;
+
+static_assert( gs_PassBits + gs_PipelineBits + gs_MaterialBits + gs_MeshBits + gs_DepthBits == 64, "The sort key must be 64 bits." );
+
+namespace
+{
+    inline uint64_t Field( uint32_t value, uint32_t numBits )
+    {
+        return std::min<uint64_t>( value, ( 1ull << numBits ) - 1 );
+    }
+
+    // Quantize a non-negative depth value to gs_DepthBits.
+    // The bit pattern of a positive float increases monotonically with the 
+    // value of the float so the most significant bits of the float (sign, 
+    // exponent and most significant bits of the mantissa) can be used
+    // as a (logarithmically distributed) depth value.
+    inline uint64_t QuantizeDepth( float depth )
+    {
+        // Also handles NaN.
+        depth = depth > 0.0f ? depth : 0.0f;
+
+        uint32_t bits;
+        std::memcpy( &bits, &depth, sizeof( float ) );
+
+        return bits >> ( 32 - gs_DepthBits );
+    }
+}
+
+DrawList::DrawList( SortOrder sortOrder )
+    : m_SortOrder( sortOrder )
+{}
+
+void DrawList::SetSortOrder( SortOrder sortOrder )
+{
+    m_SortOrder = sortOrder;
+}
+
+DrawList::SortOrder DrawList::GetSortOrder() const
+{
+    return m_SortOrder;
+}
+
+void DrawList::Clear()
+{
+    m_Draws.clear();
+    m_SortItems.clear();
+    m_IDs.clear();
+}
+
+uint32_t DrawList::GetID( const void* object )
+{
+    auto iter = m_IDs.find( object );
+    if ( iter == m_IDs.end() )
+    {
+        iter = m_IDs.insert( { object, static_cast<uint32_t>( m_IDs.size() ) } ).first;
+    }
+    return iter->second;
+}
+
+void DrawList::Add( const Draw& draw, float depth, uint32_t pass, uint32_t pipeline )
+{
+    uint32_t index = static_cast<uint32_t>( m_Draws.size() );
+    uint64_t key = MakeSortKey( m_SortOrder, pass, pipeline, GetID( draw.Material ), GetID( draw.Mesh ), depth );
+
+    m_Draws.push_back( draw );
+    m_SortItems.push_back( { key, index } );
+}
+
+uint64_t DrawList::MakeSortKey( SortOrder sortOrder, uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth )
+{
+    uint64_t key = Field( pass, gs_PassBits );
+    key = ( key << gs_PipelineBits ) | Field( pipeline, gs_PipelineBits );
+
+    uint64_t quantizedDepth = QuantizeDepth( depth );
+
+    switch ( sortOrder )
+    {
+    case SortOrder::FrontToBack:
+        key = ( key << gs_MaterialBits ) | Field( material, gs_MaterialBits );
+        key = ( key << gs_MeshBits ) | Field( mesh, gs_MeshBits );
+        key = ( key << gs_DepthBits ) | quantizedDepth;
+        break;
+    case SortOrder::BackToFront:
+        key = ( key << gs_DepthBits ) | ( ~quantizedDepth & ( ( 1ull << gs_DepthBits ) - 1 ) );
+        key = ( key << gs_MaterialBits ) | Field( material, gs_MaterialBits );
+        key = ( key << gs_MeshBits ) | Field( mesh, gs_MeshBits );
+        break;
+    }
+
+    return key;
+}
+
+void DrawList::Sort()
+{
+    const size_t numItems = m_SortItems.size();
+    if ( numItems < 2 )
+    {
+        return;
+    }
+
+    // Least significant digit radix sort with 8-bit digits.
+    // The histograms of all digits are computed in a single pass over the keys.
+    const uint32_t numDigits = sizeof( uint64_t );
+    uint32_t histograms[numDigits][256] = {};
+
+    for ( const SortItem& item : m_SortItems )
+    {
+        for ( uint32_t digit = 0; digit < numDigits; ++digit )
+        {
+            ++histograms[digit][( item.Key >> ( digit * 8 ) ) & 0xff];
+        }
+    }
+
+    m_TempItems.resize( numItems );
+
+    for ( uint32_t digit = 0; digit < numDigits; ++digit )
+    {
+        uint32_t* histogram = histograms[digit];
+        uint32_t shift = digit * 8;
+
+        // If all of the keys have the same value for this digit, the pass can be skipped.
+        // This is common for the pass and pipeline fields of the key.
+        if ( histogram[( m_SortItems[0].Key >> shift ) & 0xff] == numItems )
+        {
+            continue;
+        }
+
+        // Convert the histogram to offsets (exclusive prefix sum).
+        uint32_t offset = 0;
+        for ( uint32_t i = 0; i < 256; ++i )
+        {
+            uint32_t count = histogram[i];
+            histogram[i] = offset;
+            offset += count;
+        }
+
+        for ( const SortItem& item : m_SortItems )
+        {
+            m_TempItems[histogram[( item.Key >> shift ) & 0xff]++] = item;
+        }
+
+        std::swap( m_SortItems, m_TempItems );
+    }
+}
+
+uint32_t DrawList::GetNumDraws() const
+{
+    return static_cast<uint32_t>( m_Draws.size() );
+}
+
+const DrawList::Draw& DrawList::GetDraw( uint32_t index ) const
+{
+    assert( index < m_SortItems.size() );
+    return m_Draws[m_SortItems[index].Index];
+}
+
+uint64_t DrawList::GetSortKey( uint32_t index ) const
+{
+    assert( index < m_SortItems.size() );
+    return m_SortItems[index].Key;
+}
@@ -0,0 +1,78 @@
+#include <EnginePCH.h>
+
+#include <Graphics/Frustum.h>
+
+using namespace Graphics;
+
+Frustum::Frustum()
+{
+    for ( int i = 0; i < NumPlanes; ++i )
+    {
+        m_Planes[i] = glm::vec4( 0 );
+    }
+}
+
+Frustum::Frustum( const glm::mat4& m )
+{
+    // Gribb & Hartmann: "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"
+    // GLM matrices are column-major so the rows are gathered from the columns.
+    glm::vec4 row0( m[0][0], m[1][0], m[2][0], m[3][0] );
+    glm::vec4 row1( m[0][1], m[1][1], m[2][1], m[3][1] );
+    glm::vec4 row2( m[0][2], m[1][2], m[2][2], m[3][2] );
+    glm::vec4 row3( m[0][3], m[1][3], m[2][3], m[3][3] );
+
+    m_Planes[Left] = row3 + row0;
+    m_Planes[Right] = row3 - row0;
+    m_Planes[Bottom] = row3 + row1;
+    m_Planes[Top] = row3 - row1;
+    m_Planes[Near] = row2;
+    m_Planes[Far] = row3 - row2;
+
+    for ( int i = 0; i < NumPlanes; ++i )
+    {
+        float length = glm::length( glm::vec3( m_Planes[i] ) );
+        if ( length > 0.0f )
+        {
+            m_Planes[i] /= length;
+        }
+    }
+}
+
+const glm::vec4& Frustum::GetPlane( Plane plane ) const
+{
+    assert( plane < NumPlanes );
+    return m_Planes[plane];
+}
+
+bool Frustum::IntersectsSphere( const glm::vec3& center, float radius ) const
+{
+    for ( int i = 0; i < NumPlanes; ++i )
+    {
+        if ( glm::dot( glm::vec3( m_Planes[i] ), center ) + m_Planes[i].w < -radius )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Frustum::IntersectsAABB( const glm::vec3& min, const glm::vec3& max ) const
+{
+    for ( int i = 0; i < NumPlanes; ++i )
+    {
+        const glm::vec4& plane = m_Planes[i];
+
+        // Find the corner of the box that is furthest along the plane normal.
+        glm::vec3 p( plane.x > 0.0f ? max.x : min.x,
+                     plane.y > 0.0f ? max.y : min.y,
+                     plane.z > 0.0f ? max.z : min.z );
+
+        if ( glm::dot( glm::vec3( plane ), p ) + plane.w < 0.0f )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,339 @@
+#include <EnginePCH.h>
+
+#include <Graphics/LightSet.h>
+
+#include <LogManager.h>
+
+using namespace Graphics;
+
+// Streams are aligned so they can be read directly from the mapped file using SIMD loads.
+static const uint64_t gs_StreamAlignment = 16;
+
+static uint64_t AlignStreamOffset( uint64_t offset )
+{
+    return ( offset + gs_StreamAlignment - 1 ) & ~( gs_StreamAlignment - 1 );
+}
+
+// Returns the light type that a stream belongs to (0 = point, 1 = spot, 2 = directional).
+static uint32_t GetStreamLightType( LightSet::Stream stream )
+{
+    if ( stream < LightSet::Stream::SpotLightPosition )
+    {
+        return 0;
+    }
+    else if ( stream < LightSet::Stream::DirectionalLightDirection )
+    {
+        return 1;
+    }
+    return 2;
+}
+
+// Copy the elements of a stream to the lights.
+// If the stream is not in the file, the lights keep their default values.
+template<typename ElementType, typename LightType, typename Func>
+static void CopyStream( const LightSet& lightSet, LightSet::Stream stream, std::vector<LightType>& lights, Func setElement )
+{
+    const ElementType* elements = lightSet.GetStream<ElementType>( stream );
+    if ( elements )
+    {
+        for ( size_t i = 0; i < lights.size(); ++i )
+        {
+            setElement( lights[i], elements[i] );
+        }
+    }
+}
+
+LightSet::LightSet()
+    : m_File( INVALID_HANDLE_VALUE )
+    , m_FileMapping( NULL )
+    , m_View( nullptr )
+    , m_Header( nullptr )
+    , m_Streams{}
+{}
+
+LightSet::~LightSet()
+{
+    Close();
+}
+
+bool LightSet::Open( const fs::path& fileName )
+{
+    Close();
+
+    m_File = CreateFileW( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    if ( m_File == INVALID_HANDLE_VALUE )
+    {
+        LOG_WARNING( "Failed to open light set ", fileName );
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if ( !GetFileSizeEx( m_File, &fileSize ) || static_cast<uint64_t>( fileSize.QuadPart ) < sizeof( FileHeader ) )
+    {
+        LOG_WARNING( "Invalid light set ", fileName );
+        Close();
+        return false;
+    }
+
+    m_FileMapping = CreateFileMappingW( m_File, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if ( m_FileMapping )
+    {
+        m_View = static_cast<const uint8_t*>( MapViewOfFile( m_FileMapping, FILE_MAP_READ, 0, 0, 0 ) );
+    }
+
+    if ( !m_View )
+    {
+        LOG_WARNING( "Failed to map light set ", fileName );
+        Close();
+        return false;
+    }
+
+    uint64_t size = static_cast<uint64_t>( fileSize.QuadPart );
+    m_Header = reinterpret_cast<const FileHeader*>( m_View );
+
+    if ( m_Header->Magic != Magic || m_Header->Version > Version || m_Header->FileSize != size ||
+         sizeof( FileHeader ) + static_cast<uint64_t>( m_Header->NumStreams ) * sizeof( StreamHeader ) > size )
+    {
+        LOG_WARNING( "Invalid light set ", fileName );
+        Close();
+        return false;
+    }
+
+    const uint32_t numLights[] = { m_Header->NumPointLights, m_Header->NumSpotLights, m_Header->NumDirectionalLights };
+
+    const StreamHeader* streamTable = reinterpret_cast<const StreamHeader*>( m_View + sizeof( FileHeader ) );
+    for ( uint32_t i = 0; i < m_Header->NumStreams; ++i )
+    {
+        const StreamHeader& streamHeader = streamTable[i];
+        // Skip streams that were added in later versions.
+        if ( streamHeader.Type >= Stream::NumStreams )
+        {
+            continue;
+        }
+
+        uint64_t streamSize = static_cast<uint64_t>( streamHeader.ElementSize ) * numLights[GetStreamLightType( streamHeader.Type )];
+        if ( streamHeader.Offset % gs_StreamAlignment != 0 || streamHeader.Offset + streamSize > size )
+        {
+            LOG_WARNING( "Invalid light set ", fileName );
+            Close();
+            return false;
+        }
+
+        m_Streams[static_cast<uint32_t>( streamHeader.Type )] = &streamHeader;
+    }
+
+    return true;
+}
+
+void LightSet::Close()
+{
+    if ( m_View )
+    {
+        UnmapViewOfFile( m_View );
+        m_View = nullptr;
+    }
+    if ( m_FileMapping )
+    {
+        CloseHandle( m_FileMapping );
+        m_FileMapping = NULL;
+    }
+    if ( m_File != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( m_File );
+        m_File = INVALID_HANDLE_VALUE;
+    }
+
+    m_Header = nullptr;
+    std::fill( std::begin( m_Streams ), std::end( m_Streams ), nullptr );
+}
+
+bool LightSet::IsOpen() const
+{
+    return m_Header != nullptr;
+}
+
+uint32_t LightSet::GetNumPointLights() const
+{
+    return m_Header ? m_Header->NumPointLights : 0;
+}
+
+uint32_t LightSet::GetNumSpotLights() const
+{
+    return m_Header ? m_Header->NumSpotLights : 0;
+}
+
+uint32_t LightSet::GetNumDirectionalLights() const
+{
+    return m_Header ? m_Header->NumDirectionalLights : 0;
+}
+
+const void* LightSet::GetStream( Stream stream ) const
+{
+    const StreamHeader* streamHeader = m_Streams[static_cast<uint32_t>( stream )];
+    return streamHeader ? m_View + streamHeader->Offset : nullptr;
+}
+
+void LightSet::GetPointLights( std::vector<PointLight>& pointLights ) const
+{
+    pointLights.clear();
+    pointLights.resize( GetNumPointLights() );
+
+    CopyStream<glm::vec3>( *this, Stream::PointLightPosition, pointLights, []( PointLight& light, const glm::vec3& position ) { light.m_PositionWS = glm::vec4( position, 1 ); } );
+    CopyStream<glm::vec3>( *this, Stream::PointLightColor, pointLights, []( PointLight& light, const glm::vec3& color ) { light.m_Color = color; } );
+    CopyStream<float>( *this, Stream::PointLightRange, pointLights, []( PointLight& light, float range ) { light.m_Range = range; } );
+    CopyStream<float>( *this, Stream::PointLightIntensity, pointLights, []( PointLight& light, float intensity ) { light.m_Intensity = intensity; } );
+    CopyStream<uint32_t>( *this, Stream::PointLightEnabled, pointLights, []( PointLight& light, uint32_t enabled ) { light.m_Enabled = enabled; } );
+}
+
+void LightSet::GetSpotLights( std::vector<SpotLight>& spotLights ) const
+{
+    spotLights.clear();
+    spotLights.resize( GetNumSpotLights() );
+
+    CopyStream<glm::vec3>( *this, Stream::SpotLightPosition, spotLights, []( SpotLight& light, const glm::vec3& position ) { light.m_PositionWS = glm::vec4( position, 1 ); } );
+    CopyStream<glm::vec3>( *this, Stream::SpotLightDirection, spotLights, []( SpotLight& light, const glm::vec3& direction ) { light.m_DirectionWS = glm::vec4( direction, 0 ); } );
+    CopyStream<glm::vec3>( *this, Stream::SpotLightColor, spotLights, []( SpotLight& light, const glm::vec3& color ) { light.m_Color = color; } );
+    CopyStream<float>( *this, Stream::SpotLightAngle, spotLights, []( SpotLight& light, float angle ) { light.m_SpotlightAngle = angle; } );
+    CopyStream<float>( *this, Stream::SpotLightRange, spotLights, []( SpotLight& light, float range ) { light.m_Range = range; } );
+    CopyStream<float>( *this, Stream::SpotLightIntensity, spotLights, []( SpotLight& light, float intensity ) { light.m_Intensity = intensity; } );
+    CopyStream<uint32_t>( *this, Stream::SpotLightEnabled, spotLights, []( SpotLight& light, uint32_t enabled ) { light.m_Enabled = enabled; } );
+}
+
+void LightSet::GetDirectionalLights( std::vector<DirectionalLight>& directionalLights ) const
+{
+    directionalLights.clear();
+    directionalLights.resize( GetNumDirectionalLights() );
+
+    CopyStream<glm::vec3>( *this, Stream::DirectionalLightDirection, directionalLights, []( DirectionalLight& light, const glm::vec3& direction ) { light.m_DirectionWS = glm::vec4( direction, 0 ); } );
+    CopyStream<glm::vec3>( *this, Stream::DirectionalLightColor, directionalLights, []( DirectionalLight& light, const glm::vec3& color ) { light.m_Color = color; } );
+    CopyStream<float>( *this, Stream::DirectionalLightIntensity, directionalLights, []( DirectionalLight& light, float intensity ) { light.m_Intensity = intensity; } );
+    CopyStream<uint32_t>( *this, Stream::DirectionalLightEnabled, directionalLights, []( DirectionalLight& light, uint32_t enabled ) { light.m_Enabled = enabled; } );
+}
+
+namespace
+{
+    // Describes a stream to write and how to gather its elements from the lights.
+    struct StreamWriter
+    {
+        LightSet::StreamHeader Header;
+        size_t NumElements;
+        std::function<void( uint8_t* )> Gather;
+    };
+
+    template<typename ElementType, typename LightType, typename Func>
+    StreamWriter MakeStreamWriter( LightSet::Stream stream, const std::vector<LightType>& lights, Func getElement )
+    {
+        StreamWriter writer;
+        writer.Header.Type = stream;
+        writer.Header.ElementSize = sizeof( ElementType );
+        writer.Header.Offset = 0;
+        writer.NumElements = lights.size();
+        writer.Gather = [&lights, getElement]( uint8_t* data )
+        {
+            ElementType* elements = reinterpret_cast<ElementType*>( data );
+            for ( size_t i = 0; i < lights.size(); ++i )
+            {
+                elements[i] = getElement( lights[i] );
+            }
+        };
+        return writer;
+    }
+}
+
+bool LightSet::Save( const fs::path& fileName,
+                     const std::vector<PointLight>& pointLights,
+                     const std::vector<SpotLight>& spotLights,
+                     const std::vector<DirectionalLight>& directionalLights )
+{
+    std::vector<StreamWriter> streams = {
+        MakeStreamWriter<glm::vec3>( Stream::PointLightPosition, pointLights, []( const PointLight& light ) { return glm::vec3( light.m_PositionWS ); } ),
+        MakeStreamWriter<glm::vec3>( Stream::PointLightColor, pointLights, []( const PointLight& light ) { return light.m_Color; } ),
+        MakeStreamWriter<float>( Stream::PointLightRange, pointLights, []( const PointLight& light ) { return light.m_Range; } ),
+        MakeStreamWriter<float>( Stream::PointLightIntensity, pointLights, []( const PointLight& light ) { return light.m_Intensity; } ),
+        MakeStreamWriter<uint32_t>( Stream::PointLightEnabled, pointLights, []( const PointLight& light ) { return light.m_Enabled; } ),
+        MakeStreamWriter<glm::vec3>( Stream::SpotLightPosition, spotLights, []( const SpotLight& light ) { return glm::vec3( light.m_PositionWS ); } ),
+        MakeStreamWriter<glm::vec3>( Stream::SpotLightDirection, spotLights, []( const SpotLight& light ) { return glm::vec3( light.m_DirectionWS ); } ),
+        MakeStreamWriter<glm::vec3>( Stream::SpotLightColor, spotLights, []( const SpotLight& light ) { return light.m_Color; } ),
+        MakeStreamWriter<float>( Stream::SpotLightAngle, spotLights, []( const SpotLight& light ) { return light.m_SpotlightAngle; } ),
+        MakeStreamWriter<float>( Stream::SpotLightRange, spotLights, []( const SpotLight& light ) { return light.m_Range; } ),
+        MakeStreamWriter<float>( Stream::SpotLightIntensity, spotLights, []( const SpotLight& light ) { return light.m_Intensity; } ),
+        MakeStreamWriter<uint32_t>( Stream::SpotLightEnabled, spotLights, []( const SpotLight& light ) { return light.m_Enabled; } ),
+        MakeStreamWriter<glm::vec3>( Stream::DirectionalLightDirection, directionalLights, []( const DirectionalLight& light ) { return glm::vec3( light.m_DirectionWS ); } ),
+        MakeStreamWriter<glm::vec3>( Stream::DirectionalLightColor, directionalLights, []( const DirectionalLight& light ) { return light.m_Color; } ),
+        MakeStreamWriter<float>( Stream::DirectionalLightIntensity, directionalLights, []( const DirectionalLight& light ) { return light.m_Intensity; } ),
+        MakeStreamWriter<uint32_t>( Stream::DirectionalLightEnabled, directionalLights, []( const DirectionalLight& light ) { return light.m_Enabled; } ),
+    };
+
+    // Compute the offsets of the streams.
+    uint64_t offset = sizeof( FileHeader ) + streams.size() * sizeof( StreamHeader );
+    size_t maxStreamSize = 0;
+    for ( auto& stream : streams )
+    {
+        size_t streamSize = stream.NumElements * stream.Header.ElementSize;
+        stream.Header.Offset = AlignStreamOffset( offset );
+        offset = stream.Header.Offset + streamSize;
+        maxStreamSize = std::max( maxStreamSize, streamSize );
+    }
+
+    FileHeader header;
+    header.Magic = Magic;
+    header.Version = Version;
+    header.NumPointLights = static_cast<uint32_t>( pointLights.size() );
+    header.NumSpotLights = static_cast<uint32_t>( spotLights.size() );
+    header.NumDirectionalLights = static_cast<uint32_t>( directionalLights.size() );
+    header.NumStreams = static_cast<uint32_t>( streams.size() );
+    header.FileSize = offset;
+
+    fs::path tempFileName = fileName;
+    tempFileName += ".tmp";
+
+    {
+        std::ofstream stream( tempFileName, std::ios::binary | std::ios::trunc );
+        if ( !stream )
+        {
+            LOG_WARNING( "Failed to open light set for writing ", tempFileName );
+            return false;
+        }
+
+        stream.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+        for ( auto& streamWriter : streams )
+        {
+            stream.write( reinterpret_cast<const char*>( &streamWriter.Header ), sizeof( StreamHeader ) );
+        }
+
+        // The elements of every stream are gathered into the same buffer before they are written.
+        std::vector<uint8_t> data( maxStreamSize + gs_StreamAlignment, 0 );
+        uint64_t position = sizeof( FileHeader ) + streams.size() * sizeof( StreamHeader );
+        for ( auto& streamWriter : streams )
+        {
+            // Pad to the start of the stream.
+            std::fill( data.begin(), data.begin() + gs_StreamAlignment, uint8_t( 0 ) );
+            stream.write( reinterpret_cast<const char*>( data.data() ), streamWriter.Header.Offset - position );
+
+            size_t streamSize = streamWriter.NumElements * streamWriter.Header.ElementSize;
+            streamWriter.Gather( data.data() );
+            stream.write( reinterpret_cast<const char*>( data.data() ), streamSize );
+            position = streamWriter.Header.Offset + streamSize;
+        }
+
+        if ( !stream )
+        {
+            LOG_WARNING( "Failed to write light set ", tempFileName );
+            stream.close();
+            fs::remove( tempFileName );
+            return false;
+        }
+    }
+
+    // Replace the existing file only after the new file was written successfully.
+    std::error_code error;
+    fs::rename( tempFileName, fileName, error );
+    if ( error )
+    {
+        LOG_WARNING( "Failed to replace light set ", fileName, ": ", error.message() );
+        fs::remove( tempFileName, error );
+        return false;
+    }
+
+    return true;
+}
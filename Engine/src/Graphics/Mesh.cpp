@@ -1,6 +1,9 @@
 #include <EnginePCH.h>
 
 #include <Graphics/Mesh.h>
+#include <Graphics/BVH.h>
+#include <Graphics/Meshlet.h>
+#include <Graphics/MeshLOD.h>
 
 #include <Events.h>
 #include <SceneVisitor.h>
@@ -16,6 +19,10 @@ using namespace Graphics;
 
 Mesh::Mesh( std::shared_ptr<Device> device )
     : m_Device( device )
+    , m_HasBoundingVolumes( false )
+    , m_AABBMin( 0 )
+    , m_AABBMax( 0 )
+    , m_BoundingSphere( 0 )
 {}
 
 Mesh::~Mesh()
@@ -41,8 +48,148 @@ std::shared_ptr<Material> Mesh::GetMaterial() const
     return m_Material;
 }
 
+void Mesh::SetMeshlets( std::shared_ptr<const MeshletData> meshlets )
+{
+    m_Meshlets = meshlets;
+}
+
+std::shared_ptr<const MeshletData> Mesh::GetMeshlets() const
+{
+    return m_Meshlets;
+}
+
+void Mesh::SetLODs( std::shared_ptr<const MeshLODData> lods )
+{
+    m_LODs = lods;
+}
+
+std::shared_ptr<const MeshLODData> Mesh::GetLODs() const
+{
+    return m_LODs;
+}
+
+void Mesh::SetBVH( std::shared_ptr<const BVH> bvh )
+{
+    scoped_lock lock( m_BVHMutex );
+    m_BVH = bvh;
+    m_BVHPositions.clear();
+    m_BVHIndices.clear();
+}
+
+void Mesh::SetBVHTriangles( std::vector<glm::vec3> positions, std::vector<uint32_t> indices )
+{
+    scoped_lock lock( m_BVHMutex );
+    m_BVH.reset();
+    m_BVHPositions = std::move( positions );
+    m_BVHIndices = std::move( indices );
+}
+
+bool Mesh::HasBVH() const
+{
+    scoped_lock lock( m_BVHMutex );
+    return m_BVH || !m_BVHIndices.empty();
+}
+
+std::shared_ptr<const BVH> Mesh::GetBVH() const
+{
+    scoped_lock lock( m_BVHMutex );
+    if ( !m_BVH && !m_BVHIndices.empty() )
+    {
+        std::shared_ptr<BVH> bvh = std::make_shared<BVH>();
+        bvh->BuildTriangles( m_BVHPositions, m_BVHIndices );
+        m_BVH = bvh;
+
+        // The hierarchy stores its own copy of the triangles.
+        m_BVHPositions = std::vector<glm::vec3>();
+        m_BVHIndices = std::vector<uint32_t>();
+    }
+
+    return m_BVH;
+}
+
+uint64_t Mesh::ComputeHash( const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices )
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    auto hashBytes = [&hash]( const void* data, size_t size )
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>( data );
+        for ( size_t i = 0; i < size; ++i )
+        {
+            hash = ( hash ^ bytes[i] ) * 1099511628211ull;
+        }
+    };
+
+    // Only hash the attributes, not the padding at the end of the vertex.
+    const size_t vertexSize = offsetof( Vertex, TexCoord ) + sizeof( Vertex::TexCoord );
+    for ( const Vertex& vertex : vertices )
+    {
+        hashBytes( &vertex, vertexSize );
+    }
+    hashBytes( indices.data(), indices.size() * sizeof( uint32_t ) );
+
+    return hash;
+}
+
+void Mesh::ComputeBoundingVolumes( const std::vector<Vertex>& vertices )
+{
+    m_HasBoundingVolumes = !vertices.empty();
+    if ( !m_HasBoundingVolumes )
+    {
+        return;
+    }
+
+    m_AABBMin = glm::vec3( std::numeric_limits<float>::max() );
+    m_AABBMax = glm::vec3( -std::numeric_limits<float>::max() );
+
+    for ( const Vertex& vertex : vertices )
+    {
+        m_AABBMin = glm::min( m_AABBMin, vertex.Position );
+        m_AABBMax = glm::max( m_AABBMax, vertex.Position );
+    }
+
+    // The sphere is centered on the bounding box, but the radius is
+    // computed from the vertices which gives a tighter fit than the
+    // radius of the bounding box.
+    glm::vec3 center = ( m_AABBMin + m_AABBMax ) * 0.5f;
+    float radiusSquared = 0.0f;
+    for ( const Vertex& vertex : vertices )
+    {
+        radiusSquared = glm::max( radiusSquared, glm::distance2( vertex.Position, center ) );
+    }
+
+    m_BoundingSphere = glm::vec4( center, glm::sqrt( radiusSquared ) );
+}
+
+bool Mesh::HasBoundingVolumes() const
+{
+    return m_HasBoundingVolumes;
+}
+
+const glm::vec3& Mesh::GetAABBMin() const
+{
+    return m_AABBMin;
+}
+
+const glm::vec3& Mesh::GetAABBMax() const
+{
+    return m_AABBMax;
+}
+
+const glm::vec4& Mesh::GetBoundingSphere() const
+{
+    return m_BoundingSphere;
+}
+
 void Mesh::Render( Core::RenderEventArgs& renderArgs, uint32_t instanceCount, uint32_t firstInstance )
 {
+    // The index buffer contains all levels of detail, only render LOD 0.
+    if ( m_LODs && m_IndexBuffer )
+    {
+        RenderLOD( renderArgs, 0, instanceCount, firstInstance );
+        return;
+    }
+
     std::shared_ptr<Graphics::GraphicsCommandBuffer> commandBuffer = renderArgs.GraphicsCommandBuffer;
 
     if ( commandBuffer )
@@ -77,3 +224,102 @@ void Mesh::Accept( Core::SceneVisitor& visitor )
     visitor.Visit( *this );
 }
 
+void Mesh::RenderMeshlets( Core::RenderEventArgs& renderArgs, const std::vector<uint32_t>& visibleMeshlets, uint32_t instanceCount, uint32_t firstInstance )
+{
+    std::shared_ptr<Graphics::GraphicsCommandBuffer> commandBuffer = renderArgs.GraphicsCommandBuffer;
+
+    assert( m_Meshlets && m_IndexBuffer );
+
+    if ( commandBuffer && !visibleMeshlets.empty() )
+    {
+        BindBuffers( renderArgs );
+        DrawMeshlets( renderArgs, visibleMeshlets, instanceCount, firstInstance );
+    }
+}
+
+void Mesh::DrawMeshlets( Core::RenderEventArgs& renderArgs, const std::vector<uint32_t>& visibleMeshlets, uint32_t instanceCount, uint32_t firstInstance )
+{
+    std::shared_ptr<Graphics::GraphicsCommandBuffer> commandBuffer = renderArgs.GraphicsCommandBuffer;
+
+    assert( m_Meshlets && m_IndexBuffer );
+
+    if ( commandBuffer && !visibleMeshlets.empty() )
+    {
+        const std::vector<Meshlet>& meshlets = m_Meshlets->GetMeshlets();
+
+        // Meshlets are built from the triangles of LOD 0, which are 
+        // at the start of the index buffer (see MeshLODData).
+        // Merge consecutive meshlets into a single draw call.
+        uint32_t firstTriangle = meshlets[visibleMeshlets[0]].TriangleOffset;
+        uint32_t numTriangles = meshlets[visibleMeshlets[0]].TriangleCount;
+        for ( size_t i = 1; i < visibleMeshlets.size(); ++i )
+        {
+            const Meshlet& meshlet = meshlets[visibleMeshlets[i]];
+            if ( meshlet.TriangleOffset == firstTriangle + numTriangles )
+            {
+                numTriangles += meshlet.TriangleCount;
+            }
+            else
+            {
+                commandBuffer->DrawIndexed( numTriangles * 3, firstTriangle * 3, 0, instanceCount, firstInstance );
+                firstTriangle = meshlet.TriangleOffset;
+                numTriangles = meshlet.TriangleCount;
+            }
+        }
+        commandBuffer->DrawIndexed( numTriangles * 3, firstTriangle * 3, 0, instanceCount, firstInstance );
+    }
+}
+
+void Mesh::RenderLOD( Core::RenderEventArgs& renderArgs, uint32_t lod, uint32_t instanceCount, uint32_t firstInstance )
+{
+    if ( !m_LODs || !m_IndexBuffer )
+    {
+        Render( renderArgs, instanceCount, firstInstance );
+    }
+    else
+    {
+        BindBuffers( renderArgs );
+        DrawLOD( renderArgs, lod, instanceCount, firstInstance );
+    }
+}
+
+void Mesh::BindBuffers( Core::RenderEventArgs& renderArgs )
+{
+    std::shared_ptr<Graphics::GraphicsCommandBuffer> commandBuffer = renderArgs.GraphicsCommandBuffer;
+
+    if ( commandBuffer )
+    {
+        for ( auto vertexBuffer : m_VertexBuffers )
+        {
+            commandBuffer->BindVertexBuffer( vertexBuffer.first, vertexBuffer.second );
+        }
+
+        if ( m_IndexBuffer )
+        {
+            commandBuffer->BindIndexBuffer( m_IndexBuffer );
+        }
+    }
+}
+
+void Mesh::DrawLOD( Core::RenderEventArgs& renderArgs, uint32_t lod, uint32_t instanceCount, uint32_t firstInstance )
+{
+    std::shared_ptr<Graphics::GraphicsCommandBuffer> commandBuffer = renderArgs.GraphicsCommandBuffer;
+
+    if ( commandBuffer )
+    {
+        if ( m_LODs && m_IndexBuffer )
+        {
+            const MeshLOD& meshLOD = m_LODs->GetLOD( std::min( lod, m_LODs->GetNumLODs() - 1 ) );
+            commandBuffer->DrawIndexed( meshLOD.IndexCount, meshLOD.FirstIndex, 0, instanceCount, firstInstance );
+        }
+        else if ( m_IndexBuffer )
+        {
+            commandBuffer->DrawIndexed( static_cast<uint32_t>( m_IndexBuffer->GetNumIndices() ), 0, 0, instanceCount, firstInstance );
+        }
+        else
+        {
+            assert( m_VertexBuffers.size() > 0 );
+            commandBuffer->Draw( static_cast<uint32_t>( m_VertexBuffers.begin()->second->GetVertexCount() ), 0, instanceCount, firstInstance );
+        }
+    }
+}
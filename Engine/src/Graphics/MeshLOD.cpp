@@ -0,0 +1,194 @@
+#include <EnginePCH.h>
+
+#include <Graphics/MeshLOD.h>
+#include <Graphics/MeshOptimizer.h>
+#include <Graphics/MeshSimplifier.h>
+#include <Graphics/Camera.h>
+
+using namespace Graphics;
+
+// Used to validate the binary LOD data.
+static const uint32_t gs_MeshLODDataVersion = 2;
+
+// Stop generating levels of detail if the simplifier removes less than 10% of the triangles.
+static const float gs_MinReduction = 0.9f;
+
+// Meshes with fewer triangles than this are not simplified.
+static const size_t gs_MinTriangles = 64;
+
+template<typename T>
+static void Write( std::ostream& stream, const T& value )
+{
+    stream.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+template<typename T>
+static void Write( std::ostream& stream, const std::vector<T>& values )
+{
+    Write( stream, static_cast<uint32_t>( values.size() ) );
+    if ( !values.empty() )
+    {
+        stream.write( reinterpret_cast<const char*>( values.data() ), sizeof( T ) * values.size() );
+    }
+}
+
+template<typename T>
+static bool Read( std::istream& stream, T& value )
+{
+    return static_cast<bool>( stream.read( reinterpret_cast<char*>( &value ), sizeof( T ) ) );
+}
+
+template<typename T>
+static bool Read( std::istream& stream, std::vector<T>& values )
+{
+    uint32_t size;
+    if ( !Read( stream, size ) )
+    {
+        return false;
+    }
+    values.resize( size );
+    if ( size > 0 )
+    {
+        return static_cast<bool>( stream.read( reinterpret_cast<char*>( values.data() ), sizeof( T ) * size ) );
+    }
+    return true;
+}
+
+MeshLODData::MeshLODData()
+    : m_MeshHash( 0 )
+    , m_Center( 0 )
+    , m_Radius( 0 )
+{}
+
+void MeshLODData::Build( const std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t maxLODs, float reductionRatio )
+{
+    assert( maxLODs > 0 );
+    assert( reductionRatio > 0.0f && reductionRatio < 1.0f );
+
+    m_MeshHash = Mesh::ComputeHash( vertices, indices );
+
+    m_LODs.clear();
+    m_Indices = indices;
+
+    // Bounding sphere (used to compute the distance to the camera).
+    glm::vec3 min( std::numeric_limits<float>::max() );
+    glm::vec3 max( -std::numeric_limits<float>::max() );
+    for ( uint32_t index : indices )
+    {
+        min = glm::min( min, vertices[index].Position );
+        max = glm::max( max, vertices[index].Position );
+    }
+    m_Center = indices.empty() ? glm::vec3( 0 ) : ( min + max ) * 0.5f;
+    m_Radius = 0.0f;
+    for ( uint32_t index : indices )
+    {
+        m_Radius = std::max( m_Radius, glm::distance( m_Center, vertices[index].Position ) );
+    }
+
+    m_LODs.push_back( { 0, static_cast<uint32_t>( indices.size() ), 0.0f } );
+
+    std::vector<uint32_t> lodIndices = indices;
+    float error = 0.0f;
+
+    while ( m_LODs.size() < maxLODs && lodIndices.size() / 3 >= gs_MinTriangles )
+    {
+        const size_t previousIndexCount = lodIndices.size();
+        const size_t targetIndexCount = static_cast<size_t>( previousIndexCount / 3 * reductionRatio ) * 3;
+
+        // Errors are accumulated since each level is simplified from the previous level.
+        error += MeshSimplifier::Simplify( lodIndices, vertices, targetIndexCount );
+
+        if ( lodIndices.empty() || lodIndices.size() > previousIndexCount * gs_MinReduction )
+        {
+            break;
+        }
+
+        MeshOptimizer::OptimizeVertexCache( lodIndices, vertices.size() );
+
+        m_LODs.push_back( { static_cast<uint32_t>( m_Indices.size() ), static_cast<uint32_t>( lodIndices.size() ), error } );
+        m_Indices.insert( m_Indices.end(), lodIndices.begin(), lodIndices.end() );
+    }
+}
+
+bool MeshLODData::IsValid( uint64_t meshHash ) const
+{
+    return m_MeshHash == meshHash && !m_LODs.empty();
+}
+
+uint32_t MeshLODData::SelectLOD( const Camera& camera, const glm::mat4& world, float maxPixelError ) const
+{
+    if ( maxPixelError <= 0.0f || m_LODs.size() < 2 )
+    {
+        return 0;
+    }
+
+    // Uniform scale is assumed (use the largest axis scale to be conservative).
+    float scale = std::max( glm::length( glm::vec3( world[0] ) ), std::max( glm::length( glm::vec3( world[1] ) ), glm::length( glm::vec3( world[2] ) ) ) );
+
+    glm::vec3 center = glm::vec3( world * glm::vec4( m_Center, 1 ) );
+    glm::vec3 cameraPosition = glm::vec3( camera.GetInverseViewMatrix()[3] );
+
+    // Distance to the closest point on the bounding sphere.
+    float distance = std::max( glm::distance( center, cameraPosition ) - m_Radius * scale, camera.GetNearClipPlane() );
+
+    // The number of pixels covered by one (world space) unit at this distance.
+    float pixelsPerUnit = camera.GetProjectionMatrix()[1][1] * camera.GetViewport().Height * 0.5f / distance;
+
+    for ( uint32_t lod = static_cast<uint32_t>( m_LODs.size() - 1 ); lod > 0; --lod )
+    {
+        if ( m_LODs[lod].Error * scale * pixelsPerUnit <= maxPixelError )
+        {
+            return lod;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t MeshLODData::GetNumLODs() const
+{
+    return static_cast<uint32_t>( m_LODs.size() );
+}
+
+const MeshLOD& MeshLODData::GetLOD( uint32_t lod ) const
+{
+    assert( lod < m_LODs.size() );
+    return m_LODs[lod];
+}
+
+const std::vector<MeshLOD>& MeshLODData::GetLODs() const
+{
+    return m_LODs;
+}
+
+const std::vector<uint32_t>& MeshLODData::GetIndices() const
+{
+    return m_Indices;
+}
+
+bool MeshLODData::Save( std::ostream& stream ) const
+{
+    Write( stream, gs_MeshLODDataVersion );
+    Write( stream, m_MeshHash );
+    Write( stream, m_Center );
+    Write( stream, m_Radius );
+    Write( stream, m_LODs );
+    Write( stream, m_Indices );
+
+    return static_cast<bool>( stream );
+}
+
+bool MeshLODData::Load( std::istream& stream )
+{
+    uint32_t version;
+    if ( !Read( stream, version ) || version != gs_MeshLODDataVersion )
+    {
+        return false;
+    }
+
+    return Read( stream, m_MeshHash ) &&
+           Read( stream, m_Center ) &&
+           Read( stream, m_Radius ) &&
+           Read( stream, m_LODs ) &&
+           Read( stream, m_Indices );
+}
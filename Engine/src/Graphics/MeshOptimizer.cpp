@@ -0,0 +1,432 @@
+#include <EnginePCH.h>
+
+#include <Graphics/MeshOptimizer.h>
+
+using namespace Graphics;
+
+// Constants used by the Forsyth vertex cache optimizer.
+// See: https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+static const int gs_ForsythCacheSize = 32;
+static const float gs_CacheDecayPower = 1.5f;
+static const float gs_LastTriangleScore = 0.75f;
+static const float gs_ValenceBoostScale = 2.0f;
+static const float gs_ValenceBoostPower = 0.5f;
+
+// The size of a cache line used to simulate vertex fetch.
+static const size_t gs_CacheLineSize = 64;
+// The number of cache lines used to simulate vertex fetch.
+static const uint32_t gs_FetchCacheLines = 64;
+
+static float ComputeVertexScore( int cachePosition, uint32_t remainingValence )
+{
+    if ( remainingValence == 0 )
+    {
+        // This vertex is not used by any more triangles.
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if ( cachePosition >= 0 )
+    {
+        if ( cachePosition < 3 )
+        {
+            // This vertex was used in the last triangle. It gets a fixed score
+            // so that the optimizer does not prefer re-using the same edge.
+            score = gs_LastTriangleScore;
+        }
+        else
+        {
+            const float scaler = 1.0f / ( gs_ForsythCacheSize - 3 );
+            score = 1.0f - ( cachePosition - 3 ) * scaler;
+            score = std::pow( score, gs_CacheDecayPower );
+        }
+    }
+
+    // Bonus points for having a low number of triangles still
+    // using this vertex, so lone vertices are removed quickly.
+    float valenceBoost = std::pow( static_cast<float>( remainingValence ), -gs_ValenceBoostPower );
+    score += gs_ValenceBoostScale * valenceBoost;
+
+    return score;
+}
+
+// A simple FIFO cache simulation based on timestamps.
+// Returns the number of cache misses caused by the triangle.
+static uint32_t UpdateFIFOCache( const uint32_t* triangle, std::vector<uint32_t>& timestamps, uint32_t& cacheTime, uint32_t cacheSize )
+{
+    uint32_t misses = 0;
+    for ( int i = 0; i < 3; ++i )
+    {
+        uint32_t v = triangle[i];
+        if ( cacheTime - timestamps[v] > cacheSize )
+        {
+            timestamps[v] = cacheTime++;
+            ++misses;
+        }
+    }
+    return misses;
+}
+
+void MeshOptimizer::OptimizeVertexCache( std::vector<uint32_t>& indices, size_t vertexCount )
+{
+    const size_t triangleCount = indices.size() / 3;
+    if ( triangleCount == 0 || vertexCount == 0 )
+    {
+        return;
+    }
+
+    // Build the vertex -> triangle adjacency.
+    std::vector<uint32_t> remainingValence( vertexCount, 0 );
+    for ( uint32_t index : indices )
+    {
+        assert( index < vertexCount );
+        ++remainingValence[index];
+    }
+
+    std::vector<uint32_t> adjacencyOffsets( vertexCount + 1, 0 );
+    for ( size_t v = 0; v < vertexCount; ++v )
+    {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remainingValence[v];
+    }
+
+    std::vector<uint32_t> adjacentTriangles( indices.size() );
+    {
+        std::vector<uint32_t> fill( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+        for ( size_t t = 0; t < triangleCount; ++t )
+        {
+            for ( int i = 0; i < 3; ++i )
+            {
+                adjacentTriangles[fill[indices[t * 3 + i]]++] = static_cast<uint32_t>( t );
+            }
+        }
+    }
+
+    std::vector<float> vertexScore( vertexCount );
+    for ( size_t v = 0; v < vertexCount; ++v )
+    {
+        vertexScore[v] = ComputeVertexScore( -1, remainingValence[v] );
+    }
+
+    std::vector<bool> triangleEmitted( triangleCount, false );
+
+    // The LRU cache (+3 so the newly added triangle can be inserted before vertices are evicted).
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> newCache;
+    cache.reserve( gs_ForsythCacheSize + 3 );
+    newCache.reserve( gs_ForsythCacheSize + 3 );
+
+    std::vector<uint32_t> result;
+    result.reserve( indices.size() );
+
+    size_t inputCursor = 0;
+    int64_t bestTriangle = -1;
+
+    for ( size_t emitted = 0; emitted < triangleCount; ++emitted )
+    {
+        if ( bestTriangle < 0 )
+        {
+            // No triangles are adjacent to the cache. Pick the next triangle in the input stream.
+            while ( triangleEmitted[inputCursor] )
+            {
+                ++inputCursor;
+            }
+            bestTriangle = static_cast<int64_t>( inputCursor );
+        }
+
+        const uint32_t* triangle = &indices[static_cast<size_t>( bestTriangle ) * 3];
+        result.insert( result.end(), triangle, triangle + 3 );
+        triangleEmitted[static_cast<size_t>( bestTriangle )] = true;
+
+        // Remove the emitted triangle from the adjacency lists of its vertices.
+        for ( int i = 0; i < 3; ++i )
+        {
+            uint32_t v = triangle[i];
+            uint32_t* begin = &adjacentTriangles[adjacencyOffsets[v]];
+            uint32_t* end = begin + remainingValence[v];
+            uint32_t* it = std::find( begin, end, static_cast<uint32_t>( bestTriangle ) );
+            assert( it != end );
+            std::swap( *it, *( end - 1 ) );
+            --remainingValence[v];
+        }
+
+        // Push the vertices of the triangle to the front of the cache.
+        newCache.clear();
+        newCache.insert( newCache.end(), triangle, triangle + 3 );
+        for ( uint32_t v : cache )
+        {
+            if ( v != triangle[0] && v != triangle[1] && v != triangle[2] )
+            {
+                newCache.push_back( v );
+            }
+        }
+
+        // Vertices that fall out of the cache lose their cache score.
+        for ( size_t i = gs_ForsythCacheSize; i < newCache.size(); ++i )
+        {
+            uint32_t v = newCache[i];
+            vertexScore[v] = ComputeVertexScore( -1, remainingValence[v] );
+        }
+        if ( newCache.size() > static_cast<size_t>( gs_ForsythCacheSize ) )
+        {
+            newCache.resize( gs_ForsythCacheSize );
+        }
+        std::swap( cache, newCache );
+
+        for ( size_t i = 0; i < cache.size(); ++i )
+        {
+            uint32_t v = cache[i];
+            vertexScore[v] = ComputeVertexScore( static_cast<int>( i ), remainingValence[v] );
+        }
+
+        // Update the scores of the triangles that use vertices in the cache
+        // and find the best triangle to emit next.
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for ( uint32_t v : cache )
+        {
+            for ( uint32_t j = 0; j < remainingValence[v]; ++j )
+            {
+                uint32_t t = adjacentTriangles[adjacencyOffsets[v] + j];
+                float score = vertexScore[indices[t * 3 + 0]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+                if ( score > bestScore )
+                {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+    }
+
+    indices.swap( result );
+}
+
+void MeshOptimizer::OptimizeOverdraw( std::vector<uint32_t>& indices, const std::vector<Mesh::Vertex>& vertices, float threshold )
+{
+    const size_t triangleCount = indices.size() / 3;
+    if ( triangleCount == 0 || vertices.empty() )
+    {
+        return;
+    }
+
+    const uint32_t cacheSize = DefaultCacheSize;
+    std::vector<uint32_t> timestamps( vertices.size(), 0 );
+    uint32_t cacheTime = cacheSize + 1;
+
+    // Split the index buffer into hard clusters.
+    // A hard boundary occurs where all three vertices of a triangle miss the cache.
+    // Reordering clusters at these boundaries does not affect the cache efficiency.
+    std::vector<size_t> hardClusters;
+    for ( size_t t = 0; t < triangleCount; ++t )
+    {
+        uint32_t misses = UpdateFIFOCache( &indices[t * 3], timestamps, cacheTime, cacheSize );
+        if ( t == 0 || misses == 3 )
+        {
+            hardClusters.push_back( t );
+        }
+    }
+
+    // Split the hard clusters into smaller (soft) clusters as long as
+    // the cache miss ratio of each soft cluster stays below the threshold.
+    std::vector<size_t> clusters;
+    for ( size_t c = 0; c < hardClusters.size(); ++c )
+    {
+        size_t start = hardClusters[c];
+        size_t end = ( c + 1 < hardClusters.size() ) ? hardClusters[c + 1] : triangleCount;
+
+        // Compute the cache miss ratio of the entire hard cluster.
+        cacheTime += cacheSize + 1;
+        uint32_t clusterMisses = 0;
+        for ( size_t t = start; t < end; ++t )
+        {
+            clusterMisses += UpdateFIFOCache( &indices[t * 3], timestamps, cacheTime, cacheSize );
+        }
+        float clusterThreshold = threshold * ( static_cast<float>( clusterMisses ) / static_cast<float>( end - start ) );
+
+        // Each time a soft cluster is started, the cache is assumed to be empty.
+        cacheTime += cacheSize + 1;
+        clusters.push_back( start );
+        uint32_t softMisses = 0;
+        size_t softStart = start;
+        for ( size_t t = start; t < end; ++t )
+        {
+            softMisses += UpdateFIFOCache( &indices[t * 3], timestamps, cacheTime, cacheSize );
+
+            if ( t + 1 < end && static_cast<float>( softMisses ) / static_cast<float>( t + 1 - softStart ) <= clusterThreshold )
+            {
+                clusters.push_back( t + 1 );
+                cacheTime += cacheSize + 1;
+                softMisses = 0;
+                softStart = t + 1;
+            }
+        }
+    }
+
+    // Compute the (area weighted) centroid of the mesh.
+    glm::vec3 meshCentroid( 0 );
+    float meshArea = 0.0f;
+    for ( size_t t = 0; t < triangleCount; ++t )
+    {
+        const glm::vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+        const glm::vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+        const glm::vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+        float area = glm::length( glm::cross( p1 - p0, p2 - p0 ) );
+        meshCentroid += ( p0 + p1 + p2 ) * ( area / 3.0f );
+        meshArea += area;
+    }
+    meshCentroid = ( meshArea > 0.0f ) ? meshCentroid / meshArea : vertices[indices[0]].Position;
+
+    // Compute a sort key for each cluster. Clusters that face away from the
+    // center of the mesh are likely to occlude other clusters so they are drawn first.
+    struct ClusterSortKey
+    {
+        float Key;
+        size_t Cluster;
+    };
+
+    std::vector<ClusterSortKey> sortKeys( clusters.size() );
+    for ( size_t c = 0; c < clusters.size(); ++c )
+    {
+        size_t start = clusters[c];
+        size_t end = ( c + 1 < clusters.size() ) ? clusters[c + 1] : triangleCount;
+
+        glm::vec3 centroid( 0 );
+        glm::vec3 normal( 0 );
+        float area = 0.0f;
+        for ( size_t t = start; t < end; ++t )
+        {
+            const glm::vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+            const glm::vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+            const glm::vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+            glm::vec3 n = glm::cross( p1 - p0, p2 - p0 );
+            float a = glm::length( n );
+            centroid += ( p0 + p1 + p2 ) * ( a / 3.0f );
+            normal += n;
+            area += a;
+        }
+
+        float normalLength = glm::length( normal );
+        float key = 0.0f;
+        if ( area > 0.0f && normalLength > 0.0f )
+        {
+            key = glm::dot( centroid / area - meshCentroid, normal / normalLength );
+        }
+
+        sortKeys[c] = { key, c };
+    }
+
+    std::stable_sort( sortKeys.begin(), sortKeys.end(), []( const ClusterSortKey& a, const ClusterSortKey& b )
+    {
+        return a.Key > b.Key;
+    } );
+
+    std::vector<uint32_t> result;
+    result.reserve( indices.size() );
+    for ( const ClusterSortKey& sortKey : sortKeys )
+    {
+        size_t start = clusters[sortKey.Cluster];
+        size_t end = ( sortKey.Cluster + 1 < clusters.size() ) ? clusters[sortKey.Cluster + 1] : triangleCount;
+        result.insert( result.end(), indices.begin() + start * 3, indices.begin() + end * 3 );
+    }
+
+    indices.swap( result );
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch( std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices )
+{
+    const uint32_t unused = std::numeric_limits<uint32_t>::max();
+
+    std::vector<uint32_t> remap( vertices.size(), unused );
+    std::vector<Mesh::Vertex> result;
+    result.reserve( vertices.size() );
+
+    for ( uint32_t& index : indices )
+    {
+        assert( index < vertices.size() );
+        if ( remap[index] == unused )
+        {
+            remap[index] = static_cast<uint32_t>( result.size() );
+            result.push_back( vertices[index] );
+        }
+        index = remap[index];
+    }
+
+    vertices.swap( result );
+
+    return vertices.size();
+}
+
+MeshOptimizer::VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache( const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize )
+{
+    VertexCacheStatistics statistics;
+
+    const size_t triangleCount = indices.size() / 3;
+    if ( triangleCount == 0 || vertexCount == 0 )
+    {
+        return statistics;
+    }
+
+    std::vector<uint32_t> timestamps( vertexCount, 0 );
+    std::vector<bool> referenced( vertexCount, false );
+    uint32_t cacheTime = cacheSize + 1;
+    uint32_t uniqueVertices = 0;
+
+    for ( size_t t = 0; t < triangleCount; ++t )
+    {
+        statistics.VerticesTransformed += UpdateFIFOCache( &indices[t * 3], timestamps, cacheTime, cacheSize );
+    }
+
+    for ( uint32_t index : indices )
+    {
+        if ( !referenced[index] )
+        {
+            referenced[index] = true;
+            ++uniqueVertices;
+        }
+    }
+
+    statistics.ACMR = static_cast<float>( statistics.VerticesTransformed ) / static_cast<float>( triangleCount );
+    statistics.ATVR = static_cast<float>( statistics.VerticesTransformed ) / static_cast<float>( uniqueVertices );
+
+    return statistics;
+}
+
+MeshOptimizer::VertexFetchStatistics MeshOptimizer::AnalyzeVertexFetch( const std::vector<uint32_t>& indices, size_t vertexCount, size_t vertexSize )
+{
+    VertexFetchStatistics statistics;
+
+    if ( indices.empty() || vertexCount == 0 || vertexSize == 0 )
+    {
+        return statistics;
+    }
+
+    const size_t lineCount = ( vertexCount * vertexSize + gs_CacheLineSize - 1 ) / gs_CacheLineSize;
+    std::vector<uint32_t> timestamps( lineCount, 0 );
+    std::vector<bool> referenced( vertexCount, false );
+    uint32_t cacheTime = gs_FetchCacheLines + 1;
+    size_t uniqueVertices = 0;
+
+    for ( uint32_t index : indices )
+    {
+        if ( !referenced[index] )
+        {
+            referenced[index] = true;
+            ++uniqueVertices;
+        }
+
+        size_t firstLine = ( index * vertexSize ) / gs_CacheLineSize;
+        size_t lastLine = ( ( index + 1 ) * vertexSize - 1 ) / gs_CacheLineSize;
+        for ( size_t line = firstLine; line <= lastLine; ++line )
+        {
+            if ( cacheTime - timestamps[line] > gs_FetchCacheLines )
+            {
+                timestamps[line] = cacheTime++;
+                statistics.BytesFetched += static_cast<uint32_t>( gs_CacheLineSize );
+            }
+        }
+    }
+
+    statistics.OverfetchRatio = static_cast<float>( statistics.BytesFetched ) / static_cast<float>( uniqueVertices * vertexSize );
+
+    return statistics;
+}
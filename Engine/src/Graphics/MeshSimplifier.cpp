@@ -0,0 +1,445 @@
+#include <EnginePCH.h>
+
+#include <Graphics/MeshSimplifier.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace Graphics;
+
+// Quadric weight of the (virtual) planes that are placed perpendicular to border edges.
+static const double gs_BorderWeight = 10.0;
+
+static const uint32_t gs_InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+// A symmetric 4x4 matrix that is used to compute the
+// sum of squared distances to a set of planes.
+struct Quadric
+{
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+    double b0 = 0, b1 = 0, b2 = 0;
+    double c = 0;
+    // The total area of the triangles that contributed to this quadric.
+    double w = 0;
+
+    Quadric() = default;
+
+    Quadric( const glm::vec3& n, float d, double weight )
+    {
+        a00 = weight * n.x * n.x;
+        a01 = weight * n.x * n.y;
+        a02 = weight * n.x * n.z;
+        a11 = weight * n.y * n.y;
+        a12 = weight * n.y * n.z;
+        a22 = weight * n.z * n.z;
+        b0 = weight * n.x * d;
+        b1 = weight * n.y * d;
+        b2 = weight * n.z * d;
+        c = weight * d * d;
+    }
+
+    Quadric& operator+=( const Quadric& q )
+    {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02;
+        a11 += q.a11; a12 += q.a12; a22 += q.a22;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2;
+        c += q.c;
+        w += q.w;
+        return *this;
+    }
+
+    // Compute the (area weighted) mean squared distance of p to the planes of the quadric.
+    double Error( const glm::vec3& p ) const
+    {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a00 * x * x + a11 * y * y + a22 * z * z
+            + 2.0 * ( a01 * x * y + a02 * x * z + a12 * y * z )
+            + 2.0 * ( b0 * x + b1 * y + b2 * z )
+            + c;
+
+        e = std::max( e, 0.0 );
+
+        return w > 0.0 ? e / w : e;
+    }
+};
+
+enum class VertexKind : uint8_t
+{
+    Manifold,   // Interior vertex, can be collapsed onto any neighbor.
+    Border,     // Vertex on an open border, can only be collapsed along the border.
+    Locked,     // Seam or non-manifold vertex, can not be collapsed.
+};
+
+struct Collapse
+{
+    uint32_t From;
+    uint32_t To;
+    double Error;
+};
+
+static inline uint64_t EdgeKey( uint32_t a, uint32_t b )
+{
+    return ( static_cast<uint64_t>( a ) << 32 ) | b;
+}
+
+// Map all vertices with the same position to a single (canonical) vertex.
+static std::vector<uint32_t> BuildPositionRemap( const std::vector<Mesh::Vertex>& vertices )
+{
+    struct PositionHash
+    {
+        size_t operator()( const glm::vec3& p ) const
+        {
+            size_t seed = 0;
+            boost::hash_combine( seed, p.x );
+            boost::hash_combine( seed, p.y );
+            boost::hash_combine( seed, p.z );
+            return seed;
+        }
+    };
+
+    std::unordered_map<glm::vec3, uint32_t, PositionHash> positions;
+    positions.reserve( vertices.size() );
+
+    std::vector<uint32_t> remap( vertices.size() );
+    for ( uint32_t v = 0; v < vertices.size(); ++v )
+    {
+        remap[v] = positions.insert( std::make_pair( vertices[v].Position, v ) ).first->second;
+    }
+
+    return remap;
+}
+
+// Classify the vertices of the mesh and find the border edges.
+static void ClassifyVertices( const std::vector<uint32_t>& indices, const std::vector<uint32_t>& positionRemap, const std::vector<uint32_t>& wedgeCount,
+                              std::vector<VertexKind>& kinds, std::vector<uint32_t>& borderNext, std::vector<uint32_t>& borderPrev, std::vector<uint64_t>& borderEdges )
+{
+    const size_t vertexCount = positionRemap.size();
+
+    std::unordered_map<uint64_t, uint32_t> indexEdges;
+    std::unordered_set<uint64_t> positionEdges;
+    indexEdges.reserve( indices.size() );
+    positionEdges.reserve( indices.size() );
+
+    for ( size_t i = 0; i < indices.size(); i += 3 )
+    {
+        for ( int e = 0; e < 3; ++e )
+        {
+            uint32_t a = indices[i + e];
+            uint32_t b = indices[i + ( e + 1 ) % 3];
+            ++indexEdges[EdgeKey( a, b )];
+            positionEdges.insert( EdgeKey( positionRemap[a], positionRemap[b] ) );
+        }
+    }
+
+    kinds.assign( vertexCount, VertexKind::Manifold );
+    borderNext.assign( vertexCount, gs_InvalidIndex );
+    borderPrev.assign( vertexCount, gs_InvalidIndex );
+    borderEdges.clear();
+
+    std::vector<uint8_t> borderOutCount( vertexCount, 0 );
+    std::vector<uint8_t> borderInCount( vertexCount, 0 );
+
+    for ( const auto& edge : indexEdges )
+    {
+        uint32_t a = static_cast<uint32_t>( edge.first >> 32 );
+        uint32_t b = static_cast<uint32_t>( edge.first & 0xffffffff );
+
+        if ( edge.second > 1 )
+        {
+            // Non-manifold edge.
+            kinds[a] = kinds[b] = VertexKind::Locked;
+        }
+        else if ( indexEdges.find( EdgeKey( b, a ) ) == indexEdges.end() )
+        {
+            if ( positionEdges.find( EdgeKey( positionRemap[b], positionRemap[a] ) ) != positionEdges.end() )
+            {
+                // Attribute seam.
+                kinds[a] = kinds[b] = VertexKind::Locked;
+            }
+            else
+            {
+                // Open border.
+                borderNext[a] = b;
+                borderPrev[b] = a;
+                borderOutCount[a] = static_cast<uint8_t>( std::min( borderOutCount[a] + 1, 2 ) );
+                borderInCount[b] = static_cast<uint8_t>( std::min( borderInCount[b] + 1, 2 ) );
+                borderEdges.push_back( edge.first );
+            }
+        }
+    }
+
+    for ( size_t v = 0; v < vertexCount; ++v )
+    {
+        if ( kinds[v] == VertexKind::Locked || wedgeCount[positionRemap[v]] > 1 )
+        {
+            kinds[v] = VertexKind::Locked;
+        }
+        else if ( borderOutCount[v] == 1 && borderInCount[v] == 1 )
+        {
+            kinds[v] = VertexKind::Border;
+        }
+        else if ( borderOutCount[v] != 0 || borderInCount[v] != 0 )
+        {
+            // The vertex is shared by multiple borders.
+            kinds[v] = VertexKind::Locked;
+        }
+    }
+}
+
+// Returns true if collapsing from onto to flips the normal of any triangle.
+static bool CollapseFlipsTriangle( uint32_t from, uint32_t to, const std::vector<uint32_t>& indices, const std::vector<Mesh::Vertex>& vertices,
+                                   const std::vector<uint32_t>& triangleOffsets, const std::vector<uint32_t>& vertexTriangles )
+{
+    for ( uint32_t i = triangleOffsets[from]; i < triangleOffsets[from + 1]; ++i )
+    {
+        const uint32_t* triangle = &indices[vertexTriangles[i] * 3];
+        if ( triangle[0] == to || triangle[1] == to || triangle[2] == to )
+        {
+            // This triangle will be removed by the collapse.
+            continue;
+        }
+
+        glm::vec3 p[3];
+        glm::vec3 q[3];
+        for ( int j = 0; j < 3; ++j )
+        {
+            p[j] = vertices[triangle[j]].Position;
+            q[j] = vertices[triangle[j] == from ? to : triangle[j]].Position;
+        }
+
+        glm::vec3 n0 = glm::cross( p[1] - p[0], p[2] - p[0] );
+        glm::vec3 n1 = glm::cross( q[1] - q[0], q[2] - q[0] );
+
+        if ( glm::dot( n0, n1 ) <= 0.0f )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+float MeshSimplifier::Simplify( std::vector<uint32_t>& indices, const std::vector<Mesh::Vertex>& vertices, size_t targetIndexCount, float targetError )
+{
+    const size_t vertexCount = vertices.size();
+    if ( indices.size() <= targetIndexCount || vertexCount == 0 )
+    {
+        return 0.0f;
+    }
+
+    std::vector<uint32_t> positionRemap = BuildPositionRemap( vertices );
+
+    std::vector<uint32_t> wedgeCount( vertexCount, 0 );
+    for ( size_t v = 0; v < vertexCount; ++v )
+    {
+        ++wedgeCount[positionRemap[v]];
+    }
+
+    std::vector<VertexKind> kinds;
+    std::vector<uint32_t> borderNext;
+    std::vector<uint32_t> borderPrev;
+    std::vector<uint64_t> borderEdges;
+
+    ClassifyVertices( indices, positionRemap, wedgeCount, kinds, borderNext, borderPrev, borderEdges );
+
+    // Compute the quadrics for each (unique) position.
+    std::vector<Quadric> quadrics( vertexCount );
+    for ( size_t i = 0; i < indices.size(); i += 3 )
+    {
+        const glm::vec3& p0 = vertices[indices[i + 0]].Position;
+        const glm::vec3& p1 = vertices[indices[i + 1]].Position;
+        const glm::vec3& p2 = vertices[indices[i + 2]].Position;
+
+        glm::vec3 n = glm::cross( p1 - p0, p2 - p0 );
+        float area = glm::length( n );
+        if ( area > 0.0f )
+        {
+            n /= area;
+            Quadric q( n, -glm::dot( n, p0 ), area );
+            q.w = area;
+
+            quadrics[positionRemap[indices[i + 0]]] += q;
+            quadrics[positionRemap[indices[i + 1]]] += q;
+            quadrics[positionRemap[indices[i + 2]]] += q;
+        }
+    }
+
+    // Border edges get an additional plane (perpendicular to the triangle)
+    // to prevent the border from shrinking.
+    {
+        std::unordered_map<uint64_t, uint32_t> edgeTriangle;
+        edgeTriangle.reserve( indices.size() );
+        for ( size_t i = 0; i < indices.size(); i += 3 )
+        {
+            for ( int e = 0; e < 3; ++e )
+            {
+                edgeTriangle[EdgeKey( indices[i + e], indices[i + ( e + 1 ) % 3] )] = static_cast<uint32_t>( i );
+            }
+        }
+
+        for ( uint64_t edge : borderEdges )
+        {
+            uint32_t a = static_cast<uint32_t>( edge >> 32 );
+            uint32_t b = static_cast<uint32_t>( edge & 0xffffffff );
+            uint32_t t = edgeTriangle[edge];
+
+            const glm::vec3& p0 = vertices[indices[t + 0]].Position;
+            const glm::vec3& p1 = vertices[indices[t + 1]].Position;
+            const glm::vec3& p2 = vertices[indices[t + 2]].Position;
+
+            glm::vec3 edgeVector = vertices[b].Position - vertices[a].Position;
+            glm::vec3 n = glm::cross( edgeVector, glm::cross( p1 - p0, p2 - p0 ) );
+            float length = glm::length( n );
+            if ( length > 0.0f )
+            {
+                n /= length;
+                float edgeLength = glm::length( edgeVector );
+                Quadric q( n, -glm::dot( n, vertices[a].Position ), edgeLength * edgeLength * gs_BorderWeight );
+
+                quadrics[positionRemap[a]] += q;
+                quadrics[positionRemap[b]] += q;
+            }
+        }
+    }
+
+    const double maxError = static_cast<double>( targetError ) * static_cast<double>( targetError );
+    double resultError = 0.0;
+
+    std::vector<uint32_t> triangleOffsets( vertexCount + 1 );
+    std::vector<uint32_t> vertexTriangles;
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapseRemap( vertexCount );
+    std::vector<bool> locked( vertexCount );
+
+    while ( indices.size() > targetIndexCount )
+    {
+        const size_t triangleCount = indices.size() / 3;
+
+        // Build the vertex -> triangle adjacency.
+        std::fill( triangleOffsets.begin(), triangleOffsets.end(), 0 );
+        for ( uint32_t index : indices )
+        {
+            ++triangleOffsets[index + 1];
+        }
+        for ( size_t v = 0; v < vertexCount; ++v )
+        {
+            triangleOffsets[v + 1] += triangleOffsets[v];
+        }
+        vertexTriangles.resize( indices.size() );
+        {
+            std::vector<uint32_t> fill( triangleOffsets.begin(), triangleOffsets.end() - 1 );
+            for ( size_t t = 0; t < triangleCount; ++t )
+            {
+                for ( int i = 0; i < 3; ++i )
+                {
+                    vertexTriangles[fill[indices[t * 3 + i]]++] = static_cast<uint32_t>( t );
+                }
+            }
+        }
+
+        // Gather the collapse candidates.
+        collapses.clear();
+        auto addCollapse = [&]( uint32_t from, uint32_t to )
+        {
+            if ( kinds[from] == VertexKind::Manifold ||
+                 ( kinds[from] == VertexKind::Border && ( borderNext[from] == to || borderPrev[from] == to ) ) )
+            {
+                Quadric q = quadrics[positionRemap[from]];
+                q += quadrics[positionRemap[to]];
+                collapses.push_back( { from, to, q.Error( vertices[to].Position ) } );
+            }
+        };
+
+        for ( size_t i = 0; i < indices.size(); i += 3 )
+        {
+            for ( int e = 0; e < 3; ++e )
+            {
+                uint32_t a = indices[i + e];
+                uint32_t b = indices[i + ( e + 1 ) % 3];
+                addCollapse( a, b );
+                // Border edges only appear once so also consider the opposite direction.
+                if ( borderNext[a] == b )
+                {
+                    addCollapse( b, a );
+                }
+            }
+        }
+
+        std::sort( collapses.begin(), collapses.end(), []( const Collapse& a, const Collapse& b )
+        {
+            return a.Error < b.Error;
+        } );
+
+        // Apply as many collapses as possible. Each vertex can be involved in at most one collapse per pass.
+        const size_t trianglesToRemove = ( indices.size() - targetIndexCount + 2 ) / 3;
+        size_t trianglesRemoved = 0;
+        size_t collapsesApplied = 0;
+
+        for ( size_t v = 0; v < vertexCount; ++v )
+        {
+            collapseRemap[v] = static_cast<uint32_t>( v );
+        }
+        std::fill( locked.begin(), locked.end(), false );
+
+        for ( const Collapse& collapse : collapses )
+        {
+            if ( collapse.Error > maxError || trianglesRemoved >= trianglesToRemove )
+            {
+                break;
+            }
+
+            if ( locked[collapse.From] || locked[collapse.To] )
+            {
+                continue;
+            }
+
+            if ( CollapseFlipsTriangle( collapse.From, collapse.To, indices, vertices, triangleOffsets, vertexTriangles ) )
+            {
+                continue;
+            }
+
+            // Lock the vertices of all triangles that are affected by this collapse.
+            for ( uint32_t i = triangleOffsets[collapse.From]; i < triangleOffsets[collapse.From + 1]; ++i )
+            {
+                const uint32_t* triangle = &indices[vertexTriangles[i] * 3];
+                if ( triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To )
+                {
+                    ++trianglesRemoved;
+                }
+                locked[triangle[0]] = locked[triangle[1]] = locked[triangle[2]] = true;
+            }
+
+            collapseRemap[collapse.From] = collapse.To;
+            quadrics[positionRemap[collapse.To]] += quadrics[positionRemap[collapse.From]];
+            resultError = std::max( resultError, collapse.Error );
+            ++collapsesApplied;
+        }
+
+        if ( collapsesApplied == 0 )
+        {
+            break;
+        }
+
+        // Apply the collapses to the index buffer and remove degenerate triangles.
+        size_t writeIndex = 0;
+        for ( size_t i = 0; i < indices.size(); i += 3 )
+        {
+            uint32_t a = collapseRemap[indices[i + 0]];
+            uint32_t b = collapseRemap[indices[i + 1]];
+            uint32_t c = collapseRemap[indices[i + 2]];
+
+            if ( a != b && b != c && c != a )
+            {
+                indices[writeIndex++] = a;
+                indices[writeIndex++] = b;
+                indices[writeIndex++] = c;
+            }
+        }
+        indices.resize( writeIndex );
+
+        // Collapses change the borders of the mesh so the vertices must be reclassified.
+        ClassifyVertices( indices, positionRemap, wedgeCount, kinds, borderNext, borderPrev, borderEdges );
+    }
+
+    return static_cast<float>( std::sqrt( resultError ) );
+}
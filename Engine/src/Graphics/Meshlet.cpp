@@ -0,0 +1,334 @@
+#include <EnginePCH.h>
+
+#include <Graphics/Meshlet.h>
+#include <Graphics/Frustum.h>
+
+using namespace Graphics;
+
+// Used to validate the binary meshlet data.
+static const uint32_t gs_MeshletDataVersion = 2;
+
+// Used to mark vertices that are not (yet) part of the current meshlet.
+static const uint8_t gs_InvalidLocalIndex = 0xff;
+
+template<typename T>
+static void Write( std::ostream& stream, const T& value )
+{
+    stream.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+template<typename T>
+static void Write( std::ostream& stream, const std::vector<T>& values )
+{
+    Write( stream, static_cast<uint32_t>( values.size() ) );
+    if ( !values.empty() )
+    {
+        stream.write( reinterpret_cast<const char*>( values.data() ), sizeof( T ) * values.size() );
+    }
+}
+
+template<typename T>
+static bool Read( std::istream& stream, T& value )
+{
+    return static_cast<bool>( stream.read( reinterpret_cast<char*>( &value ), sizeof( T ) ) );
+}
+
+template<typename T>
+static bool Read( std::istream& stream, std::vector<T>& values )
+{
+    uint32_t size;
+    if ( !Read( stream, size ) )
+    {
+        return false;
+    }
+    values.resize( size );
+    if ( size > 0 )
+    {
+        return static_cast<bool>( stream.read( reinterpret_cast<char*>( values.data() ), sizeof( T ) * size ) );
+    }
+    return true;
+}
+
+MeshletData::MeshletData()
+    : m_MeshHash( 0 )
+{}
+
+void MeshletData::Build( const std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t maxVertices, uint32_t maxTriangles )
+{
+    assert( maxVertices > 2 && maxVertices < gs_InvalidLocalIndex );
+    assert( maxTriangles > 0 );
+
+    m_MeshHash = Mesh::ComputeHash( vertices, indices );
+
+    m_Meshlets.clear();
+    m_VertexIndices.clear();
+    m_PrimitiveIndices.clear();
+
+    const size_t triangleCount = indices.size() / 3;
+    if ( triangleCount == 0 )
+    {
+        return;
+    }
+
+    m_PrimitiveIndices.reserve( triangleCount * 3 );
+
+    // Maps mesh vertices to meshlet-local vertices.
+    std::vector<uint8_t> localIndex( vertices.size(), gs_InvalidLocalIndex );
+
+    Meshlet meshlet = {};
+
+    for ( size_t t = 0; t < triangleCount; ++t )
+    {
+        const uint32_t* triangle = &indices[t * 3];
+
+        uint32_t newVertices = 0;
+        for ( int i = 0; i < 3; ++i )
+        {
+            if ( localIndex[triangle[i]] == gs_InvalidLocalIndex )
+            {
+                ++newVertices;
+            }
+        }
+
+        // Start a new meshlet if the triangle does not fit in the current one.
+        if ( meshlet.VertexCount + newVertices > maxVertices || meshlet.TriangleCount + 1 > maxTriangles )
+        {
+            for ( uint32_t v = 0; v < meshlet.VertexCount; ++v )
+            {
+                localIndex[m_VertexIndices[meshlet.VertexOffset + v]] = gs_InvalidLocalIndex;
+            }
+
+            ComputeBounds( meshlet, vertices );
+            m_Meshlets.push_back( meshlet );
+
+            meshlet = {};
+            meshlet.VertexOffset = static_cast<uint32_t>( m_VertexIndices.size() );
+            meshlet.TriangleOffset = static_cast<uint32_t>( t );
+        }
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            uint8_t& local = localIndex[triangle[i]];
+            if ( local == gs_InvalidLocalIndex )
+            {
+                local = static_cast<uint8_t>( meshlet.VertexCount++ );
+                m_VertexIndices.push_back( triangle[i] );
+            }
+            m_PrimitiveIndices.push_back( local );
+        }
+
+        ++meshlet.TriangleCount;
+    }
+
+    ComputeBounds( meshlet, vertices );
+    m_Meshlets.push_back( meshlet );
+}
+
+void MeshletData::ComputeBounds( Meshlet& meshlet, const std::vector<Mesh::Vertex>& vertices ) const
+{
+    const uint32_t* vertexIndices = &m_VertexIndices[meshlet.VertexOffset];
+    const uint8_t* primitiveIndices = &m_PrimitiveIndices[meshlet.TriangleOffset * 3];
+
+    // Compute the bounding sphere (Ritter).
+    // Start with the pair of extreme points along the coordinate axes that are furthest apart.
+    uint32_t minIndex[3] = { 0, 0, 0 };
+    uint32_t maxIndex[3] = { 0, 0, 0 };
+    for ( uint32_t v = 1; v < meshlet.VertexCount; ++v )
+    {
+        const glm::vec3& p = vertices[vertexIndices[v]].Position;
+        for ( int axis = 0; axis < 3; ++axis )
+        {
+            if ( p[axis] < vertices[vertexIndices[minIndex[axis]]].Position[axis] ) minIndex[axis] = v;
+            if ( p[axis] > vertices[vertexIndices[maxIndex[axis]]].Position[axis] ) maxIndex[axis] = v;
+        }
+    }
+
+    int bestAxis = 0;
+    float bestDistance = -1.0f;
+    for ( int axis = 0; axis < 3; ++axis )
+    {
+        float d = glm::distance( vertices[vertexIndices[minIndex[axis]]].Position, vertices[vertexIndices[maxIndex[axis]]].Position );
+        if ( d > bestDistance )
+        {
+            bestDistance = d;
+            bestAxis = axis;
+        }
+    }
+
+    glm::vec3 center = ( vertices[vertexIndices[minIndex[bestAxis]]].Position + vertices[vertexIndices[maxIndex[bestAxis]]].Position ) * 0.5f;
+    float radius = bestDistance * 0.5f;
+
+    // Grow the sphere to include all points.
+    for ( uint32_t v = 0; v < meshlet.VertexCount; ++v )
+    {
+        const glm::vec3& p = vertices[vertexIndices[v]].Position;
+        float d = glm::distance( p, center );
+        if ( d > radius )
+        {
+            float newRadius = ( radius + d ) * 0.5f;
+            center += ( p - center ) * ( ( newRadius - radius ) / d );
+            radius = newRadius;
+        }
+    }
+
+    meshlet.Center = center;
+    meshlet.Radius = radius;
+
+    // Compute the normal cone.
+    std::vector<glm::vec3> normals;
+    normals.reserve( meshlet.TriangleCount );
+
+    glm::vec3 axis( 0 );
+    for ( uint32_t t = 0; t < meshlet.TriangleCount; ++t )
+    {
+        const glm::vec3& p0 = vertices[vertexIndices[primitiveIndices[t * 3 + 0]]].Position;
+        const glm::vec3& p1 = vertices[vertexIndices[primitiveIndices[t * 3 + 1]]].Position;
+        const glm::vec3& p2 = vertices[vertexIndices[primitiveIndices[t * 3 + 2]]].Position;
+
+        glm::vec3 n = glm::cross( p1 - p0, p2 - p0 );
+        float area = glm::length( n );
+        // Skip degenerate triangles.
+        if ( area > 0.0f )
+        {
+            n /= area;
+            normals.push_back( n );
+            axis += n;
+        }
+    }
+
+    float axisLength = glm::length( axis );
+    if ( normals.empty() || axisLength <= 0.0f )
+    {
+        // No usable normals. The meshlet can never be back face culled.
+        meshlet.ConeApex = center;
+        meshlet.ConeAxis = glm::vec3( 0, 0, 1 );
+        meshlet.ConeCutoff = 1.0f;
+        return;
+    }
+
+    axis /= axisLength;
+
+    float minDot = 1.0f;
+    for ( const glm::vec3& n : normals )
+    {
+        minDot = std::min( minDot, glm::dot( n, axis ) );
+    }
+
+    if ( minDot <= 0.0f )
+    {
+        // The normal cone is wider than a hemisphere.
+        meshlet.ConeApex = center;
+        meshlet.ConeAxis = axis;
+        meshlet.ConeCutoff = 1.0f;
+        return;
+    }
+
+    // Move the apex of the cone back along the axis until it is behind the planes of all triangles.
+    float maxT = 0.0f;
+    for ( uint32_t t = 0; t < meshlet.TriangleCount; ++t )
+    {
+        const glm::vec3& p0 = vertices[vertexIndices[primitiveIndices[t * 3 + 0]]].Position;
+        const glm::vec3& p1 = vertices[vertexIndices[primitiveIndices[t * 3 + 1]]].Position;
+        const glm::vec3& p2 = vertices[vertexIndices[primitiveIndices[t * 3 + 2]]].Position;
+
+        glm::vec3 n = glm::cross( p1 - p0, p2 - p0 );
+        float area = glm::length( n );
+        if ( area > 0.0f )
+        {
+            n /= area;
+            float dn = glm::dot( axis, n );
+            assert( dn > 0.0f );
+            maxT = std::max( maxT, glm::dot( center - p0, n ) / dn );
+        }
+    }
+
+    meshlet.ConeApex = center - axis * maxT;
+    meshlet.ConeAxis = axis;
+    // The cone is back facing if the angle between the view direction and
+    // the cone axis is less than 90 degrees minus the half-angle of the cone.
+    meshlet.ConeCutoff = std::sqrt( 1.0f - minDot * minDot );
+}
+
+bool MeshletData::IsValid( uint64_t meshHash ) const
+{
+    return m_MeshHash == meshHash;
+}
+
+MeshletCullingStatistics MeshletData::Cull( const Frustum& frustum, const glm::vec3& cameraPosition, std::vector<uint32_t>* visibleMeshlets, bool backfaceCulling ) const
+{
+    MeshletCullingStatistics statistics;
+
+    for ( size_t i = 0; i < m_Meshlets.size(); ++i )
+    {
+        const Meshlet& meshlet = m_Meshlets[i];
+
+        ++statistics.NumMeshlets;
+        statistics.NumTriangles += meshlet.TriangleCount;
+
+        if ( !frustum.IntersectsSphere( meshlet.Center, meshlet.Radius ) )
+        {
+            ++statistics.NumFrustumCulled;
+            statistics.NumTrianglesCulled += meshlet.TriangleCount;
+            continue;
+        }
+
+        if ( backfaceCulling )
+        {
+            glm::vec3 viewDirection = meshlet.ConeApex - cameraPosition;
+            float distance = glm::length( viewDirection );
+            if ( distance > 0.0f && glm::dot( viewDirection, meshlet.ConeAxis ) >= meshlet.ConeCutoff * distance )
+            {
+                ++statistics.NumBackfaceCulled;
+                statistics.NumTrianglesCulled += meshlet.TriangleCount;
+                continue;
+            }
+        }
+
+        if ( visibleMeshlets )
+        {
+            visibleMeshlets->push_back( static_cast<uint32_t>( i ) );
+        }
+    }
+
+    return statistics;
+}
+
+const std::vector<Meshlet>& MeshletData::GetMeshlets() const
+{
+    return m_Meshlets;
+}
+
+const std::vector<uint32_t>& MeshletData::GetVertexIndices() const
+{
+    return m_VertexIndices;
+}
+
+const std::vector<uint8_t>& MeshletData::GetPrimitiveIndices() const
+{
+    return m_PrimitiveIndices;
+}
+
+bool MeshletData::Save( std::ostream& stream ) const
+{
+    Write( stream, gs_MeshletDataVersion );
+    Write( stream, m_MeshHash );
+    Write( stream, m_Meshlets );
+    Write( stream, m_VertexIndices );
+    Write( stream, m_PrimitiveIndices );
+
+    return static_cast<bool>( stream );
+}
+
+bool MeshletData::Load( std::istream& stream )
+{
+    uint32_t version;
+    if ( !Read( stream, version ) || version != gs_MeshletDataVersion )
+    {
+        return false;
+    }
+
+    return Read( stream, m_MeshHash ) &&
+           Read( stream, m_Meshlets ) &&
+           Read( stream, m_VertexIndices ) &&
+           Read( stream, m_PrimitiveIndices );
+}
@@ -9,71 +9,193 @@
 #include <Common.h>
 #include <ProfilerVisitor.h>
 
+#include <LogManager.h>
+
+#include <iomanip>
+#include <set>
+#include <unordered_set>
+
 using namespace Graphics;
 using namespace std::chrono;
 
 static std::shared_ptr<Profiler> g_Profiler = nullptr;
 
-ProfileNode::ProfileNode( const std::wstring& name, uint32_t queryIndex, std::shared_ptr<Query> gpuQuery, std::shared_ptr<ProfileNode> parent )
+namespace Graphics
+{
+    struct ProfileEvent
+    {
+        enum class Type : uint32_t
+        {
+            Push,
+            Pop
+        };
+
+        Type EventType;
+        // The index of the marker (Push only).
+        uint32_t Index;
+        // The GPU query of the marker (UINT32_MAX if no command buffer was used).
+        uint32_t QueryIndex;
+        // The marker (Push only).
+        const wchar_t* Name;
+        uint64_t ID;
+        // The frame the marker was popped (Pop only).
+        uint64_t Frame;
+        high_resolution_clock::time_point Time;
+    };
+
+    // The events that are recorded by a single thread.
+    // The recording thread is the only producer and the aggregation
+    // (which is serialized by Profiler::m_AggregateMutex) is the only consumer.
+    struct ProfileEventBuffer
+    {
+        static const uint32_t Capacity = Profiler::EventBufferCapacity;
+
+        ProfileEvent Events[Capacity];
+
+        alignas( 64 ) std::atomic_uint32_t Head { 0 };
+        alignas( 64 ) std::atomic_uint32_t Tail { 0 };
+
+        // Set when the thread exits. The buffer is released after the remaining events have been aggregated.
+        std::atomic_bool IsRetired { false };
+
+        uint32_t ThreadID = GetCurrentThreadId();
+
+        // The profile nodes that are open on the thread (only accessed by the consumer).
+        struct OpenNode
+        {
+            std::shared_ptr<ProfileNode> Node;
+            high_resolution_clock::time_point StartTime;
+        };
+        std::vector<OpenNode> NodeStack;
+    };
+}
+
+// A marker that is open on the current thread.
+struct OpenMarker
+{
+    // The hash of the marker keys from the root to this marker.
+    uint64_t Path;
+    // The GPU marker if the marker was pushed with a command buffer.
+    uint32_t QueryIndex;
+    const std::wstring* GpuName;
+    // False if the profiler was paused when the marker was pushed.
+    bool IsRecorded;
+};
+
+struct ProfilerThreadState
+{
+    ProfilerThreadState();
+    ~ProfilerThreadState();
+
+    std::shared_ptr<ProfileEventBuffer> EventBuffer;
+    std::vector<OpenMarker> MarkerStack;
+};
+
+// The event buffers of all threads that have used a profiler marker.
+static std::mutex gs_EventBuffersMutex;
+static std::vector< std::shared_ptr<ProfileEventBuffer> > gs_EventBuffers;
+
+// The names of the threads (see Profiler::SetThreadName).
+static std::map<uint32_t, std::wstring> gs_ThreadNames;
+
+// Marker names that are interned at runtime.
+static std::mutex gs_InternedNamesMutex;
+static std::unordered_set<std::wstring> gs_InternedNames;
+
+ProfilerThreadState::ProfilerThreadState()
+    : EventBuffer( std::make_shared<ProfileEventBuffer>() )
+{
+    MarkerStack.reserve( 64 );
+
+    scoped_lock lock( gs_EventBuffersMutex );
+    gs_EventBuffers.push_back( EventBuffer );
+}
+
+ProfilerThreadState::~ProfilerThreadState()
+{
+    EventBuffer->IsRetired = true;
+}
+
+static ProfilerThreadState& GetThreadState()
+{
+    thread_local ProfilerThreadState threadState;
+    return threadState;
+}
+
+// The key of a marker in the children of its parent node.
+static uint64_t GetMarkerKey( const ProfileMarker& marker, uint32_t index )
+{
+    size_t key = static_cast<size_t>( marker.ID );
+    if ( index != Profiler::NoIndex )
+    {
+        boost::hash_combine( key, index );
+    }
+
+    return key;
+}
+
+static std::wstring GetMarkerName( const ProfileMarker& marker, uint32_t index )
+{
+    return index != Profiler::NoIndex ? marker.Name + std::to_wstring( index ) : marker.Name;
+}
+
+ProfileNode::ProfileNode( const std::wstring& name, uint64_t key, std::shared_ptr<ProfileNode> parent )
     : NameWStr( name )
     , Name( Core::ConvertString(name) )
     , ID( parent ? parent->ID : 0 )
     , IsSelected( false )
     , Parent( parent )
-    , QueryIndex( queryIndex )
-    , GpuQuery( gpuQuery )
+    , QueryIndex( UINT32_MAX )
     , HasGpuQueryResults( false )
     , CpuFrame( 0 )
     , GpuFrame( 0 )
+    , CpuStats( 1024, Core::StatisticMode::Window )
+    , GpuStats( 1024, Core::StatisticMode::Window )
+    , CpuFrameTimes{ { UINT64_MAX, 0.0 }, { UINT64_MAX, 0.0 } }
 {
-    boost::hash_combine( ID, name );
+    boost::hash_combine( ID, key );
 }
 
-std::shared_ptr<ProfileNode> ProfileNode::GetChild( const std::wstring& name )
+std::shared_ptr<ProfileNode> ProfileNode::GetChild( const ProfileMarker& marker, uint32_t index )
 {
-    auto iter = ChildrenMap.find( name );
+    uint64_t key = GetMarkerKey( marker, index );
+
+    auto iter = ChildrenMap.find( key );
     if ( iter == ChildrenMap.end() )
     {
-        std::shared_ptr<Query> gpuQuery;
-        uint32_t queryIndex;
-        std::tie( gpuQuery, queryIndex ) = g_Profiler->AddQuery();
-        std::shared_ptr<ProfileNode> child = std::make_shared<ProfileNode>( name, queryIndex, gpuQuery, shared_from_this() );
+        std::shared_ptr<ProfileNode> child = std::make_shared<ProfileNode>( GetMarkerName( marker, index ), key, shared_from_this() );
         Children.emplace_back( child );
-        iter = ChildrenMap.emplace( name, child ).first;
+        iter = ChildrenMap.emplace( key, child ).first;
     }
 
     return iter->second;
 }
 
-void ProfileNode::Start( std::shared_ptr<ComputeCommandBuffer> commandBuffer )
+std::string ProfileNode::GetPath() const
 {
-    StartTime = std::chrono::high_resolution_clock::now();
-    if ( commandBuffer )
+    std::string path = Name;
+    for ( auto parent = Parent.lock(); parent; parent = parent->Parent.lock() )
     {
-        commandBuffer->BeginQuery( GpuQuery, QueryIndex );
-        commandBuffer->BeginProfilingEvent( NameWStr );
+        path = parent->Name + "/" + path;
     }
+    return path;
 }
 
-void ProfileNode::Stop( std::shared_ptr<ComputeCommandBuffer> commandBuffer, uint64_t frame )
+double ProfileNode::GetCpuFrameTime( uint64_t frame ) const
 {
-    EndTime = std::chrono::high_resolution_clock::now();
-    CpuFrame = frame;
-
-    CpuStats.Sample( std::chrono::duration<double>( EndTime - StartTime ).count() );
-
-    if ( commandBuffer )
+    for ( const FrameTime& frameTime : CpuFrameTimes )
     {
-        commandBuffer->EndProfilingEvent( NameWStr );
-        commandBuffer->EndQuery( GpuQuery, QueryIndex );
-        HasGpuQueryResults = true;
-        GpuFrame = frame;
+        if ( frameTime.Frame == frame )
+        {
+            return frameTime.Time;
+        }
     }
+    return 0.0;
 }
 
 void ProfileNode::UpdateQueryResult( const std::vector<QueryResult>& results )
 {
-    if ( HasGpuQueryResults )
+    if ( HasGpuQueryResults && QueryIndex < results.size() )
     {
         GpuStats.Sample( results[QueryIndex].ElapsedTime );
         HasGpuQueryResults = false;
@@ -105,16 +227,39 @@ void ProfileNode::Accept( Core::ProfilerVisitor& visitor )
 Profiler::Profiler( std::shared_ptr<Device> device, uint32_t numProfilingMarkers )
     : m_Device( device )
     , m_NumQueryTimers( 0 )
-    , m_Paused( false )
     , m_CurrentFrame( 0 )
+    , m_StopAggregating( false )
+    , m_Paused( false )
+    , m_IsCapturingTimeline( false )
+    , m_TimelineStartFrame( 0 )
+    , m_TimelineEndFrame( 0 )
+    , m_TimelineStartCounter( 0 )
 { 
     m_GpuTimestampQuery = device->CreateQuery( QueryType::Timer, numProfilingMarkers );
-    m_RootNode = std::make_shared<ProfileNode>( L"Root", m_NumQueryTimers++, m_GpuTimestampQuery, nullptr );
-    m_CurrentNode = m_RootNode;
+    m_RootNode = std::make_shared<ProfileNode>( L"Root", 0, nullptr );
+    m_RootNode->QueryIndex = m_NumQueryTimers++;
+
+    m_AggregateThread = std::thread( &Profiler::AggregateEvents, this );
 }
 
 Profiler::~Profiler()
-{}
+{
+    {
+        std::lock_guard<std::mutex> lock( m_AggregateConditionMutex );
+        m_StopAggregating = true;
+    }
+    m_AggregateCondition.notify_one();
+
+    if ( m_AggregateThread.joinable() )
+    {
+        m_AggregateThread.join();
+    }
+
+    if ( m_TimelineTask.valid() )
+    {
+        m_TimelineTask.wait();
+    }
+}
 
 Profiler& Profiler::Get()
 {
@@ -132,6 +277,20 @@ void Profiler::Shutdown()
     g_Profiler.reset();
 }
 
+ProfileMarker Profiler::InternMarker( const std::wstring& name )
+{
+    scoped_lock lock( gs_InternedNamesMutex );
+
+    const std::wstring& internedName = *gs_InternedNames.insert( name ).first;
+    return ProfileMarker( internedName.c_str(), HashMarkerName( internedName.c_str() ) );
+}
+
+void Profiler::SetThreadName( const std::wstring& name )
+{
+    scoped_lock lock( gs_EventBuffersMutex );
+    gs_ThreadNames[GetCurrentThreadId()] = name;
+}
+
 void Profiler::SetPaused( bool paused )
 {
     m_Paused = paused;
@@ -152,36 +311,385 @@ uint64_t Profiler::GetCurrentFrame() const
     return m_CurrentFrame;
 }
 
+void Profiler::PushProfilingMarker( const ProfileMarker& marker, std::shared_ptr<ComputeCommandBuffer> commandBuffer )
+{
+    PushMarker( marker, NoIndex, commandBuffer.get() );
+}
+
+void Profiler::PushProfilingMarker( const ProfileMarker& marker, uint32_t index, std::shared_ptr<ComputeCommandBuffer> commandBuffer )
+{
+    PushMarker( marker, index, commandBuffer.get() );
+}
+
 void Profiler::PushProfilingMarker( const std::wstring& name, std::shared_ptr<ComputeCommandBuffer> commandBuffer )
 {
-    if ( !m_Paused )
-    {
-        scoped_lock lock( m_Mutex );
+    PushMarker( InternMarker( name ), NoIndex, commandBuffer.get() );
+}
+
+void Profiler::PushMarker( const ProfileMarker& marker, uint32_t index, ComputeCommandBuffer* commandBuffer )
+{
+    ProfilerThreadState& threadState = GetThreadState();
+
+    OpenMarker openMarker;
+    openMarker.Path = threadState.MarkerStack.empty() ? 0 : threadState.MarkerStack.back().Path;
+    openMarker.QueryIndex = UINT32_MAX;
+    openMarker.GpuName = nullptr;
+    openMarker.IsRecorded = !m_Paused;
 
-        m_CurrentNode = m_CurrentNode->GetChild( name );
-        m_CurrentNode->Start( commandBuffer );
+    if ( openMarker.IsRecorded )
+    {
+        size_t path = static_cast<size_t>( openMarker.Path );
+        boost::hash_combine( path, GetMarkerKey( marker, index ) );
+        openMarker.Path = path;
+
+        ProfileEvent event;
+        event.EventType = ProfileEvent::Type::Push;
+        event.Index = index;
+        event.Name = marker.Name;
+        event.ID = marker.ID;
+        event.Frame = 0;
+        event.Time = high_resolution_clock::now();
+
+        if ( commandBuffer )
+        {
+            const GpuMarker& gpuMarker = GetGpuMarker( openMarker.Path, marker, index );
+            openMarker.QueryIndex = gpuMarker.QueryIndex;
+            openMarker.GpuName = &gpuMarker.Name;
+
+            commandBuffer->BeginQuery( m_GpuTimestampQuery, gpuMarker.QueryIndex );
+            commandBuffer->BeginProfilingEvent( gpuMarker.Name );
+        }
+
+        event.QueryIndex = openMarker.QueryIndex;
+        RecordEvent( *threadState.EventBuffer, event );
     }
+
+    threadState.MarkerStack.push_back( openMarker );
 }
 
 void Profiler::PopProfilingMarker( std::shared_ptr<ComputeCommandBuffer> commandBuffer )
 {
-    if ( !m_Paused )
+    ProfilerThreadState& threadState = GetThreadState();
+    if ( threadState.MarkerStack.empty() )
+    {
+        return;
+    }
+
+    OpenMarker openMarker = threadState.MarkerStack.back();
+    threadState.MarkerStack.pop_back();
+
+    if ( !openMarker.IsRecorded )
+    {
+        return;
+    }
+
+    ProfileEvent event;
+    event.EventType = ProfileEvent::Type::Pop;
+    event.Index = NoIndex;
+    event.QueryIndex = UINT32_MAX;
+    event.Name = nullptr;
+    event.ID = 0;
+    event.Frame = m_CurrentFrame;
+    event.Time = high_resolution_clock::now();
+
+    if ( commandBuffer && openMarker.GpuName )
+    {
+        commandBuffer->EndProfilingEvent( *openMarker.GpuName );
+        commandBuffer->EndQuery( m_GpuTimestampQuery, openMarker.QueryIndex );
+        event.QueryIndex = openMarker.QueryIndex;
+    }
+
+    RecordEvent( *threadState.EventBuffer, event );
+}
+
+void Profiler::RecordEvent( ProfileEventBuffer& eventBuffer, const ProfileEvent& event )
+{
+    uint32_t head = eventBuffer.Head.load( std::memory_order_relaxed );
+    while ( head - eventBuffer.Tail.load( std::memory_order_acquire ) >= ProfileEventBuffer::Capacity )
+    {
+        // The aggregation thread can't keep up. Aggregate the events on this thread.
+        Flush();
+    }
+
+    eventBuffer.Events[head % ProfileEventBuffer::Capacity] = event;
+    eventBuffer.Head.store( head + 1, std::memory_order_release );
+}
+
+const Profiler::GpuMarker& Profiler::GetGpuMarker( uint64_t path, const ProfileMarker& marker, uint32_t index )
+{
+    scoped_lock lock( m_GpuMarkersMutex );
+
+    auto iter = m_GpuMarkers.find( path );
+    if ( iter == m_GpuMarkers.end() )
+    {
+        uint32_t queryIndex = m_NumQueryTimers++;
+        assert( queryIndex < m_GpuTimestampQuery->GetQueryCount() );
+
+        iter = m_GpuMarkers.emplace( path, GpuMarker { queryIndex, GetMarkerName( marker, index ) } ).first;
+    }
+
+    return iter->second;
+}
+
+void Profiler::Flush()
+{
+    scoped_lock aggregateLock( m_AggregateMutex );
+
+    std::vector< std::shared_ptr<ProfileEventBuffer> > eventBuffers;
+    {
+        scoped_lock lock( gs_EventBuffersMutex );
+        eventBuffers = gs_EventBuffers;
+    }
+
+    bool hasRetiredBuffers = false;
     {
         scoped_lock lock( m_Mutex );
+        for ( auto& eventBuffer : eventBuffers )
+        {
+            // Check before the events are processed so no events are lost when the thread exits in between.
+            bool isRetired = eventBuffer->IsRetired;
+            ProcessEvents( *eventBuffer );
+            hasRetiredBuffers |= isRetired;
+        }
+    }
 
-        m_CurrentNode->Stop( commandBuffer, m_CurrentFrame );
-        m_CurrentNode = m_CurrentNode->Parent.lock();
+    if ( hasRetiredBuffers )
+    {
+        scoped_lock lock( gs_EventBuffersMutex );
+        gs_EventBuffers.erase( std::remove_if( gs_EventBuffers.begin(), gs_EventBuffers.end(), [] ( const std::shared_ptr<ProfileEventBuffer>& eventBuffer )
+        {
+            return eventBuffer->IsRetired && eventBuffer->Head == eventBuffer->Tail;
+        } ), gs_EventBuffers.end() );
+    }
+}
 
-        m_CurrentNode = m_CurrentNode ? m_CurrentNode : m_RootNode;
+void Profiler::ProcessEvents( ProfileEventBuffer& eventBuffer )
+{
+    uint32_t tail = eventBuffer.Tail.load( std::memory_order_relaxed );
+    uint32_t head = eventBuffer.Head.load( std::memory_order_acquire );
 
-        assert( m_CurrentNode );
+    auto& nodeStack = eventBuffer.NodeStack;
+
+    for ( ; tail != head; ++tail )
+    {
+        const ProfileEvent& event = eventBuffer.Events[tail % ProfileEventBuffer::Capacity];
+
+        switch ( event.EventType )
+        {
+        case ProfileEvent::Type::Push:
+        {
+            std::shared_ptr<ProfileNode> parent = nodeStack.empty() ? m_RootNode : nodeStack.back().Node;
+            std::shared_ptr<ProfileNode> node = parent->GetChild( ProfileMarker( event.Name, event.ID ), event.Index );
+            node->StartTime = event.Time;
+            if ( event.QueryIndex != UINT32_MAX )
+            {
+                node->QueryIndex = event.QueryIndex;
+            }
+            // The start time is kept per thread since several threads can record the same node.
+            nodeStack.push_back( { node, event.Time } );
+        }
+        break;
+        case ProfileEvent::Type::Pop:
+            if ( !nodeStack.empty() )
+            {
+                std::shared_ptr<ProfileNode> node = nodeStack.back().Node;
+                high_resolution_clock::time_point startTime = nodeStack.back().StartTime;
+                nodeStack.pop_back();
+
+                double time = duration<double>( event.Time - startTime ).count();
+
+                node->EndTime = event.Time;
+                node->CpuFrame = event.Frame;
+                node->CpuStats.Sample( time );
+
+                if ( node->CpuFrameTimes[0].Frame != event.Frame )
+                {
+                    node->CpuFrameTimes[1] = node->CpuFrameTimes[0];
+                    node->CpuFrameTimes[0] = { event.Frame, 0.0 };
+                }
+                node->CpuFrameTimes[0].Time = std::max( node->CpuFrameTimes[0].Time, time );
+
+                if ( m_IsCapturingTimeline && event.Frame >= m_TimelineStartFrame && event.Frame < m_TimelineEndFrame )
+                {
+                    TimelineEvent timelineEvent;
+                    timelineEvent.Node = node;
+                    timelineEvent.ThreadID = eventBuffer.ThreadID;
+                    timelineEvent.Frame = event.Frame;
+                    timelineEvent.StartTime = duration<double, std::micro>( startTime - m_TimelineStartTime ).count();
+                    timelineEvent.Duration = duration<double, std::micro>( event.Time - startTime ).count();
+                    m_TimelineEvents.push_back( timelineEvent );
+                }
+
+                if ( event.QueryIndex != UINT32_MAX )
+                {
+                    node->HasGpuQueryResults = true;
+                    node->GpuFrame = event.Frame;
+                }
+            }
+            break;
+        }
+    }
+
+    eventBuffer.Tail.store( tail, std::memory_order_release );
+}
+
+void Profiler::AggregateEvents()
+{
+    std::unique_lock<std::mutex> lock( m_AggregateConditionMutex );
+    while ( !m_StopAggregating )
+    {
+        m_AggregateCondition.wait_for( lock, milliseconds( 2 ) );
+
+        lock.unlock();
+        Flush();
+        lock.lock();
     }
 }
 
 void Profiler::UpdateQueryResults( std::shared_ptr<ComputeCommandQueue> commandQueue )
 {
     m_QueryResults = std::move( m_GpuTimestampQuery->GetQueryResults( 0, std::min<uint64_t>( m_NumQueryTimers, m_GpuTimestampQuery->GetQueryCount() ), commandQueue ) );
+
+    // Make sure the nodes know which queries were used this frame.
+    Flush();
+
+    scoped_lock lock( m_Mutex );
+
+    if ( m_IsCapturingTimeline )
+    {
+        uint64_t gpuTimestamp, cpuCounter;
+        LARGE_INTEGER frequency;
+        if ( commandQueue && commandQueue->GetClockCalibration( gpuTimestamp, cpuCounter ) && QueryPerformanceFrequency( &frequency ) )
+        {
+            // The offset (in seconds) of the calibration from the start of the capture.
+            double gpuOffset = static_cast<int64_t>( cpuCounter - m_TimelineStartCounter ) / static_cast<double>( frequency.QuadPart );
+            CaptureGpuEvents( *m_RootNode, gpuTimestamp, static_cast<double>( commandQueue->GetGPUFrequency() ), gpuOffset );
+        }
+    }
+
     m_RootNode->UpdateQueryResult( m_QueryResults );
+
+    if ( m_IsCapturingTimeline && m_CurrentFrame >= m_TimelineEndFrame )
+    {
+        FinishTimeline();
+    }
+}
+
+void Profiler::CaptureGpuEvents( ProfileNode& node, int64_t gpuTimestamp, double gpuFrequency, double gpuOffset )
+{
+    if ( node.HasGpuQueryResults && node.QueryIndex < m_QueryResults.size() && m_QueryResults[node.QueryIndex].IsValid &&
+         node.GpuFrame >= m_TimelineStartFrame && node.GpuFrame < m_TimelineEndFrame )
+    {
+        const QueryResult& result = m_QueryResults[node.QueryIndex];
+
+        TimelineEvent timelineEvent;
+        timelineEvent.Node = node.shared_from_this();
+        timelineEvent.ThreadID = 0;
+        timelineEvent.Frame = node.GpuFrame;
+        timelineEvent.StartTime = ( static_cast<int64_t>( result.BeginTimestamp - gpuTimestamp ) / gpuFrequency + gpuOffset ) * 1e6;
+        timelineEvent.Duration = ( result.EndTimestamp - result.BeginTimestamp ) / gpuFrequency * 1e6;
+        m_TimelineEvents.push_back( timelineEvent );
+    }
+
+    for ( auto child : node.Children )
+    {
+        CaptureGpuEvents( *child, gpuTimestamp, gpuFrequency, gpuOffset );
+    }
+}
+
+void Profiler::CaptureTimeline( uint32_t numFrames, const std::wstring& fileName )
+{
+    scoped_lock lock( m_Mutex );
+
+    if ( m_IsCapturingTimeline || ( m_TimelineTask.valid() && m_TimelineTask.wait_for( seconds( 0 ) ) != std::future_status::ready ) )
+    {
+        LOG_WARNING( "A timeline is already being captured." );
+        return;
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter( &counter );
+    m_TimelineStartTime = high_resolution_clock::now();
+    m_TimelineStartCounter = counter.QuadPart;
+
+    // Start at the next frame so that only complete frames are captured.
+    m_TimelineStartFrame = m_CurrentFrame + 1;
+    m_TimelineEndFrame = m_TimelineStartFrame + numFrames;
+    m_TimelineFileName = fileName;
+    m_TimelineEvents.clear();
+    m_IsCapturingTimeline = true;
+}
+
+bool Profiler::IsCapturingTimeline() const
+{
+    return m_IsCapturingTimeline;
+}
+
+void Profiler::FinishTimeline()
+{
+    m_IsCapturingTimeline = false;
+
+    std::map<uint32_t, std::wstring> threadNames;
+    {
+        scoped_lock lock( gs_EventBuffersMutex );
+        threadNames = gs_ThreadNames;
+    }
+
+    // The nodes keep their names even if the profiling data is cleared in the meantime.
+    auto events = std::make_shared< std::vector<TimelineEvent> >( std::move( m_TimelineEvents ) );
+    m_TimelineEvents.clear();
+    std::wstring fileName = m_TimelineFileName;
+    uint64_t numFrames = m_TimelineEndFrame - m_TimelineStartFrame;
+
+    m_TimelineTask = std::async( std::launch::async, [events, threadNames, fileName, numFrames]()
+    {
+        std::ofstream file( fs::path( fileName ), std::ios::out | std::ios::trunc );
+        if ( !file.is_open() )
+        {
+            LOG_ERROR( "Failed to open timeline file ", fileName );
+            return false;
+        }
+
+        std::set<uint32_t> threadIDs;
+        for ( const TimelineEvent& event : *events )
+        {
+            threadIDs.insert( event.ThreadID );
+        }
+
+        // The CPU threads are shown in process 1 and the GPU queries in process 2.
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+        file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"GPU\"}},\n";
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"Direct Queue\"}}";
+
+        for ( uint32_t threadID : threadIDs )
+        {
+            auto iter = threadNames.find( threadID );
+            if ( threadID != 0 && iter != threadNames.end() )
+            {
+                file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadID << ",\"args\":{\"name\":\"" << Core::EscapeJSON( Core::ConvertString( iter->second ) ) << "\"}}";
+            }
+        }
+
+        file << std::fixed << std::setprecision( 3 );
+        for ( const TimelineEvent& event : *events )
+        {
+            file << ",\n{\"name\":\"" << Core::EscapeJSON( event.Node->Name ) << "\",\"cat\":\"" << ( event.ThreadID == 0 ? "GPU" : "CPU" )
+                 << "\",\"ph\":\"X\",\"pid\":" << ( event.ThreadID == 0 ? 2 : 1 ) << ",\"tid\":" << event.ThreadID
+                 << ",\"ts\":" << event.StartTime << ",\"dur\":" << event.Duration << ",\"args\":{\"frame\":" << event.Frame << "}}";
+        }
+
+        file << "\n]}\n";
+        file.close();
+
+        LOG_INFO( "Timeline of ", numFrames, " frames (", events->size(), " events) saved to ", fileName );
+        return true;
+    } );
+}
+
+std::unique_lock<std::mutex> Profiler::Lock()
+{
+    return std::unique_lock<std::mutex>( m_Mutex );
 }
 
 std::shared_ptr<ProfileNode> Profiler::GetRootProfileMarker()
@@ -193,19 +701,13 @@ void Profiler::ClearAllProfilingData()
 {
     scoped_lock lock(m_Mutex);
     m_RootNode->DeleteChildren();
-    m_CurrentNode = m_RootNode;
 }
 
 void Profiler::Accept( Core::ProfilerVisitor& visitor )
 {
+    Flush();
+
+    scoped_lock lock( m_Mutex );
     visitor.Visit( *this );
     m_RootNode->Accept( visitor );
 }
-
-std::tuple< std::shared_ptr<Query>, uint32_t> Profiler::AddQuery()
-{
-    uint32_t queryIndex = m_NumQueryTimers++;
-    assert( queryIndex < m_GpuTimestampQuery->GetQueryCount() );
-
-    return std::make_tuple( m_GpuTimestampQuery, queryIndex );
-}
@@ -0,0 +1,293 @@
+#include <EnginePCH.h>
+
+#include <Graphics/ResourceRegistry.h>
+
+#include <Common.h>
+#include <LogManager.h>
+
+using namespace Graphics;
+using namespace std::chrono;
+
+// The group of the resources that are created on this thread.
+static thread_local std::wstring gs_ResourceGroup;
+
+const char* Graphics::GetResourceCategoryName( ResourceCategory category )
+{
+    switch ( category )
+    {
+    case ResourceCategory::Buffer:
+        return "Buffer";
+    case ResourceCategory::Texture:
+        return "Texture";
+    case ResourceCategory::RenderTarget:
+        return "Render Target";
+    case ResourceCategory::DepthStencil:
+        return "Depth Stencil";
+    case ResourceCategory::UploadBuffer:
+        return "Upload Buffer";
+    case ResourceCategory::ReadbackBuffer:
+        return "Readback Buffer";
+    default:
+        return "Unknown";
+    }
+}
+
+ResourceRegistry::ScopedGroup::ScopedGroup( const std::wstring& group )
+    : m_PreviousGroup( gs_ResourceGroup )
+{
+    gs_ResourceGroup = group;
+}
+
+ResourceRegistry::ScopedGroup::~ScopedGroup()
+{
+    gs_ResourceGroup = m_PreviousGroup;
+}
+
+ResourceRegistry::ResourceRegistry()
+    : m_NextID( InvalidID + 1 )
+    , m_NumAllocationsAdded( 0 )
+    , m_NumAllocationsRemoved( 0 )
+{}
+
+void ResourceRegistry::Add( ResourceMemoryUsage& usage, uint64_t size )
+{
+    ++usage.NumResources;
+    usage.Size += size;
+    usage.PeakSize = std::max( usage.PeakSize, usage.Size );
+}
+
+void ResourceRegistry::Remove( ResourceMemoryUsage& usage, uint64_t size )
+{
+    // An allocation is only removed from the usage it was added to.
+    assert( usage.NumResources > 0 && usage.Size >= size );
+
+    --usage.NumResources;
+    usage.Size -= size;
+}
+
+uint64_t ResourceRegistry::AddAllocation( ResourceCategory category, uint64_t size, const std::wstring& name )
+{
+    scoped_lock lock( m_Mutex );
+
+    ResourceAllocation allocation;
+    allocation.ID = m_NextID++;
+    allocation.Name = name;
+    allocation.Group = gs_ResourceGroup;
+    allocation.Category = category;
+    allocation.Size = size;
+    allocation.CreationTime = steady_clock::now();
+
+    Add( m_TotalUsage, size );
+    Add( m_CategoryUsage[static_cast<size_t>( category )], size );
+    Add( m_GroupUsage[allocation.Group], size );
+    ++m_NumAllocationsAdded;
+
+    m_Allocations.emplace( allocation.ID, allocation );
+
+    return allocation.ID;
+}
+
+void ResourceRegistry::UpdateAllocation( uint64_t id, ResourceCategory category, uint64_t size )
+{
+    scoped_lock lock( m_Mutex );
+
+    auto iter = m_Allocations.find( id );
+    if ( iter == m_Allocations.end() )
+    {
+        return;
+    }
+
+    ResourceAllocation& allocation = iter->second;
+
+    Remove( m_TotalUsage, allocation.Size );
+    Remove( m_CategoryUsage[static_cast<size_t>( allocation.Category )], allocation.Size );
+    Remove( m_GroupUsage[allocation.Group], allocation.Size );
+
+    allocation.Category = category;
+    allocation.Size = size;
+    allocation.CreationTime = steady_clock::now();
+
+    Add( m_TotalUsage, size );
+    Add( m_CategoryUsage[static_cast<size_t>( category )], size );
+    Add( m_GroupUsage[allocation.Group], size );
+}
+
+void ResourceRegistry::SetName( uint64_t id, const std::wstring& name )
+{
+    scoped_lock lock( m_Mutex );
+
+    auto iter = m_Allocations.find( id );
+    if ( iter != m_Allocations.end() )
+    {
+        iter->second.Name = name;
+    }
+}
+
+void ResourceRegistry::RemoveAllocation( uint64_t id )
+{
+    scoped_lock lock( m_Mutex );
+
+    auto iter = m_Allocations.find( id );
+    if ( iter == m_Allocations.end() )
+    {
+        return;
+    }
+
+    ResourceAllocation& allocation = iter->second;
+    allocation.Lifetime = duration<double>( steady_clock::now() - allocation.CreationTime ).count();
+
+    Remove( m_TotalUsage, allocation.Size );
+    Remove( m_CategoryUsage[static_cast<size_t>( allocation.Category )], allocation.Size );
+    Remove( m_GroupUsage[allocation.Group], allocation.Size );
+    ++m_NumAllocationsRemoved;
+
+    if ( m_ReleasedAllocations.size() >= MaxReleasedAllocations )
+    {
+        m_ReleasedAllocations.pop_front();
+    }
+    m_ReleasedAllocations.push_back( std::move( allocation ) );
+
+    m_Allocations.erase( iter );
+}
+
+std::vector<ResourceAllocation> ResourceRegistry::GetAllocations() const
+{
+    std::vector<ResourceAllocation> allocations;
+    {
+        scoped_lock lock( m_Mutex );
+
+        allocations.reserve( m_Allocations.size() );
+        for ( auto& allocation : m_Allocations )
+        {
+            allocations.push_back( allocation.second );
+        }
+    }
+
+    std::sort( allocations.begin(), allocations.end(), []( const ResourceAllocation& a, const ResourceAllocation& b )
+    {
+        return a.ID < b.ID;
+    } );
+
+    return allocations;
+}
+
+std::vector<ResourceAllocation> ResourceRegistry::GetReleasedAllocations() const
+{
+    scoped_lock lock( m_Mutex );
+    return std::vector<ResourceAllocation>( m_ReleasedAllocations.begin(), m_ReleasedAllocations.end() );
+}
+
+ResourceMemoryUsage ResourceRegistry::GetTotalUsage() const
+{
+    scoped_lock lock( m_Mutex );
+    return m_TotalUsage;
+}
+
+ResourceMemoryUsage ResourceRegistry::GetCategoryUsage( ResourceCategory category ) const
+{
+    scoped_lock lock( m_Mutex );
+    return m_CategoryUsage[static_cast<size_t>( category )];
+}
+
+std::map<std::wstring, ResourceMemoryUsage> ResourceRegistry::GetGroupUsage() const
+{
+    scoped_lock lock( m_Mutex );
+    return m_GroupUsage;
+}
+
+uint64_t ResourceRegistry::GetNumAllocationsAdded() const
+{
+    scoped_lock lock( m_Mutex );
+    return m_NumAllocationsAdded;
+}
+
+uint64_t ResourceRegistry::GetNumAllocationsRemoved() const
+{
+    scoped_lock lock( m_Mutex );
+    return m_NumAllocationsRemoved;
+}
+
+static void WriteUsage( std::ostream& file, const ResourceMemoryUsage& usage )
+{
+    file << "{ \"numResources\": " << usage.NumResources << ", \"size\": " << usage.Size << ", \"peakSize\": " << usage.PeakSize << " }";
+}
+
+static void WriteAllocation( std::ostream& file, const ResourceAllocation& allocation, steady_clock::time_point now, bool isReleased )
+{
+    // Live resources report their age.
+    double lifetime = isReleased ? allocation.Lifetime : duration<double>( now - allocation.CreationTime ).count();
+
+    file << "{ \"id\": " << allocation.ID
+         << ", \"name\": \"" << Core::EscapeJSON( Core::ConvertString( allocation.Name ) ) << "\""
+         << ", \"group\": \"" << Core::EscapeJSON( Core::ConvertString( allocation.Group ) ) << "\""
+         << ", \"category\": \"" << GetResourceCategoryName( allocation.Category ) << "\""
+         << ", \"size\": " << allocation.Size
+         << ", \"lifetime\": " << lifetime << " }";
+}
+
+bool ResourceRegistry::Save( const std::wstring& fileName ) const
+{
+    std::ofstream file( fs::path( fileName ), std::ios::out | std::ios::trunc );
+    if ( !file.is_open() )
+    {
+        LOG_ERROR( "Failed to open resource memory report for writing: ", fileName );
+        return false;
+    }
+
+    std::vector<ResourceAllocation> allocations = GetAllocations();
+    std::vector<ResourceAllocation> releasedAllocations = GetReleasedAllocations();
+    std::map<std::wstring, ResourceMemoryUsage> groupUsage = GetGroupUsage();
+    steady_clock::time_point now = steady_clock::now();
+
+    file << "{\n  \"version\": 1,\n  \"allocationsAdded\": " << GetNumAllocationsAdded() << ",\n  \"allocationsRemoved\": " << GetNumAllocationsRemoved();
+    file << ",\n  \"total\": ";
+    WriteUsage( file, GetTotalUsage() );
+
+    file << ",\n  \"categories\": {";
+    const char* separator = "\n";
+    for ( size_t i = 0; i < static_cast<size_t>( ResourceCategory::NumCategories ); ++i )
+    {
+        ResourceCategory category = static_cast<ResourceCategory>( i );
+        file << separator << "    \"" << GetResourceCategoryName( category ) << "\": ";
+        WriteUsage( file, GetCategoryUsage( category ) );
+        separator = ",\n";
+    }
+
+    file << "\n  },\n  \"groups\": {";
+    separator = "\n";
+    for ( auto& group : groupUsage )
+    {
+        file << separator << "    \"" << Core::EscapeJSON( Core::ConvertString( group.first ) ) << "\": ";
+        WriteUsage( file, group.second );
+        separator = ",\n";
+    }
+
+    file << "\n  },\n  \"allocations\": [";
+    separator = "\n";
+    for ( const ResourceAllocation& allocation : allocations )
+    {
+        file << separator << "    ";
+        WriteAllocation( file, allocation, now, false );
+        separator = ",\n";
+    }
+
+    file << "\n  ],\n  \"released\": [";
+    separator = "\n";
+    for ( const ResourceAllocation& allocation : releasedAllocations )
+    {
+        file << separator << "    ";
+        WriteAllocation( file, allocation, now, true );
+        separator = ",\n";
+    }
+    file << "\n  ]\n}\n";
+
+    return file.good();
+}
+
+std::wstring ResourceRegistry::SaveReport( const std::wstring& directory, const std::wstring& label ) const
+{
+    fs::path fileName = fs::path( directory ) / ( Core::ConvertString( Core::GetTimestampString() ) + L" " + label + L" Resource Memory.json" );
+
+    fs::create_directories( directory );
+    return Save( fileName.wstring() ) ? fileName.wstring() : std::wstring();
+}
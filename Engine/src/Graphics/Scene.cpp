@@ -1,6 +1,7 @@
 #include <EnginePCH.h>
 
 #include <Graphics/Scene.h>
+#include <Graphics/SceneMeshList.h>
 
 using namespace Graphics;
 
@@ -8,3 +9,25 @@ void Scene::OnLoadingProgress( Core::ProgressEventArgs& e )
 {
     LoadingProgress( e );
 }
+
+const SceneMeshList& Scene::GetMeshList( uint64_t frameCounter )
+{
+    if ( !m_MeshList )
+    {
+        m_MeshList = std::make_shared<SceneMeshList>();
+    }
+
+    if ( m_MeshListFrame != frameCounter )
+    {
+        m_MeshList->Update( *this );
+        m_MeshList->BeginFrame( frameCounter );
+        m_MeshListFrame = frameCounter;
+    }
+
+    return *m_MeshList;
+}
+
+const SceneMeshList* Scene::GetMeshList() const
+{
+    return m_MeshList.get();
+}
@@ -0,0 +1,478 @@
+#include <EnginePCH.h>
+
+#include <Graphics/SceneMeshList.h>
+#include <Graphics/Scene.h>
+#include <Graphics/SceneNode.h>
+#include <Graphics/TransformHierarchy.h>
+#include <Graphics/Mesh.h>
+#include <Graphics/Frustum.h>
+#include <Graphics/Ray.h>
+#include <Graphics/GraphicsCommandBuffer.h>
+
+#include <SceneVisitor.h>
+#include <TaskScheduler.h>
+
+#include <xmmintrin.h>
+
+using namespace Graphics;
+
+// Lists with fewer meshes are processed on a single thread.
+// This must be a multiple of 4 (the SIMD width).
+static const uint32_t gs_MinMeshesPerThread = 4096;
+
+namespace
+{
+    // Collects the (scene node, mesh) pairs of a scene.
+    class MeshListBuilder : public Core::SceneVisitor
+    {
+    public:
+        MeshListBuilder( std::vector<SceneMeshList::Entry>& entries, std::vector<SceneNode*>& objectNodes )
+            : m_Entries( entries )
+            , m_ObjectNodes( objectNodes )
+            , m_CurrentNode( nullptr )
+        {}
+
+        virtual void Visit( Scene& scene ) override
+        {}
+
+        virtual void Visit( SceneNode& node ) override
+        {
+            m_CurrentNode = &node;
+        }
+
+        virtual void Visit( Mesh& mesh ) override
+        {
+            // The meshes of a scene node are visited one after the other.
+            if ( m_ObjectNodes.empty() || m_ObjectNodes.back() != m_CurrentNode )
+            {
+                m_ObjectNodes.push_back( m_CurrentNode );
+            }
+
+            uint32_t objectIndex = static_cast<uint32_t>( m_ObjectNodes.size() - 1 );
+            SceneMeshList::Entry entry = { m_CurrentNode, &mesh, glm::vec3( 0 ), glm::vec3( 0 ), objectIndex };
+            m_Entries.push_back( entry );
+        }
+
+    private:
+        std::vector<SceneMeshList::Entry>& m_Entries;
+        std::vector<SceneNode*>& m_ObjectNodes;
+        SceneNode* m_CurrentNode;
+    };
+
+    // Run a function for ranges of (at least gs_MinMeshesPerThread) items on the task scheduler.
+    // The function also receives the index of the chunk (less than the concurrency of the task scheduler).
+    void ParallelFor( const ProfileMarker& marker, uint32_t count, const std::function<void( uint32_t, uint32_t, uint32_t )>& func )
+    {
+        uint32_t numChunks = std::max( 1u, std::min( Core::TaskScheduler::Get().GetConcurrency(), count / gs_MinMeshesPerThread ) );
+        // Round the chunk size up to a multiple of 4.
+        uint32_t chunkSize = ( ( count + numChunks - 1 ) / numChunks + 3 ) & ~3u;
+
+        Core::TaskGroup group;
+        for ( uint32_t chunk = 1; chunk < numChunks; ++chunk )
+        {
+            uint32_t first = std::min( chunk * chunkSize, count );
+            uint32_t last = std::min( first + chunkSize, count );
+            group.Run( marker, [&func, chunk, first, last]()
+            {
+                func( chunk, first, last );
+            } );
+        }
+
+        // The first chunk is processed on the calling thread.
+        func( 0, 0, std::min( chunkSize, count ) );
+
+        group.Wait();
+    }
+}
+
+SceneMeshList::SceneMeshList()
+    : m_IsMeshBVHValid( false )
+    , m_StructureVersion( 0 )
+    , m_TransformVersion( 0 )
+    , m_Frame( 0 )
+    , m_ObjectBufferFrame( std::numeric_limits<uint64_t>::max() )
+    , m_ObjectBufferAddress( 0 )
+{}
+
+void SceneMeshList::Build( Scene& scene )
+{
+    m_Entries.clear();
+    m_ObjectNodes.clear();
+    m_TransformObjects.clear();
+
+    {
+        scoped_lock lock( m_MeshBVHMutex );
+        m_IsMeshBVHValid = false;
+    }
+
+    {
+        scoped_lock lock( m_ObjectBufferMutex );
+        m_ObjectBufferFrame = std::numeric_limits<uint64_t>::max();
+    }
+
+    // The structure version is read before the scene is visited, so changes 
+    // to the scene while it is visited cause another rebuild.
+    std::shared_ptr<SceneNode> rootNode = scene.GetRootNode();
+    m_Transforms = rootNode ? rootNode->GetTransformHierarchy() : nullptr;
+    m_StructureVersion = m_Transforms ? m_Transforms->GetStructureVersion() : 0;
+    m_TransformVersion = 0;
+    if ( m_Transforms )
+    {
+        // Only the transforms that change after the list is built have to be refreshed.
+        std::vector<uint32_t> changedTransforms;
+        m_TransformVersion = m_Transforms->GetChangedTransforms( std::numeric_limits<uint64_t>::max(), changedTransforms );
+    }
+
+    MeshListBuilder builder( m_Entries, m_ObjectNodes );
+    scene.Accept( builder );
+
+    // The world transforms (and their inverse transpose) are cached 
+    // by the transform hierarchy, so this is just a copy.
+    m_ObjectData.resize( m_ObjectNodes.size() );
+    for ( size_t i = 0; i < m_ObjectNodes.size(); ++i )
+    {
+        const SceneNode* node = m_ObjectNodes[i];
+        m_ObjectData[i].World = node ? node->GetWorldTransform() : glm::mat4( 1 );
+        m_ObjectData[i].InverseTransposeWorld = node ? node->GetInverseTransposeWorldTransform() : glm::mat4( 1 );
+
+        // Only the nodes in the hierarchy of the scene are refreshed when they move.
+        if ( node && node->GetTransformHierarchy() == m_Transforms )
+        {
+            const uint32_t transform = node->GetTransformIndex();
+            if ( transform >= m_TransformObjects.size() )
+            {
+                m_TransformObjects.resize( transform + 1, UINT32_MAX );
+            }
+            m_TransformObjects[transform] = static_cast<uint32_t>( i );
+        }
+    }
+
+    m_ObjectFirstEntry.assign( m_ObjectNodes.size() + 1, 0 );
+    for ( const Entry& entry : m_Entries )
+    {
+        ++m_ObjectFirstEntry[entry.ObjectIndex + 1];
+    }
+    for ( size_t i = 1; i < m_ObjectFirstEntry.size(); ++i )
+    {
+        m_ObjectFirstEntry[i] += m_ObjectFirstEntry[i - 1];
+    }
+
+    const uint32_t numMeshes = static_cast<uint32_t>( m_Entries.size() );
+    const uint32_t paddedSize = ( numMeshes + 3 ) & ~3u;
+
+    // The padding is never visible.
+    m_CenterX.assign( paddedSize, 0.0f );
+    m_CenterY.assign( paddedSize, 0.0f );
+    m_CenterZ.assign( paddedSize, 0.0f );
+    m_Radius.assign( paddedSize, -std::numeric_limits<float>::max() );
+
+    ParallelFor( PROFILE_MARKER( "Update Bounds" ), numMeshes, [this]( uint32_t, uint32_t first, uint32_t last )
+    {
+        UpdateBounds( first, last );
+    } );
+
+    scoped_lock lock( m_StatisticsMutex );
+    m_CullingStatistics = CullingStatistics();
+}
+
+void SceneMeshList::Update( Scene& scene )
+{
+    std::shared_ptr<SceneNode> rootNode = scene.GetRootNode();
+    std::shared_ptr<TransformHierarchy> transforms = rootNode ? rootNode->GetTransformHierarchy() : nullptr;
+
+    if ( !transforms || transforms != m_Transforms || transforms->GetStructureVersion() != m_StructureVersion )
+    {
+        Build( scene );
+        return;
+    }
+
+    m_ChangedTransforms.clear();
+    m_TransformVersion = transforms->GetChangedTransforms( m_TransformVersion, m_ChangedTransforms );
+
+    bool boundsChanged = false;
+    for ( uint32_t transform : m_ChangedTransforms )
+    {
+        // Scene nodes without meshes are ignored.
+        if ( transform < m_TransformObjects.size() && m_TransformObjects[transform] != UINT32_MAX )
+        {
+            UpdateObject( m_TransformObjects[transform] );
+            boundsChanged = true;
+        }
+    }
+
+    if ( boundsChanged )
+    {
+        scoped_lock lock( m_MeshBVHMutex );
+        m_IsMeshBVHValid = false;
+    }
+}
+
+void SceneMeshList::UpdateObject( uint32_t object )
+{
+    const SceneNode* node = m_ObjectNodes[object];
+    m_ObjectData[object].World = node->GetWorldTransform();
+    m_ObjectData[object].InverseTransposeWorld = node->GetInverseTransposeWorldTransform();
+
+    UpdateBounds( m_ObjectFirstEntry[object], m_ObjectFirstEntry[object + 1] );
+}
+
+void SceneMeshList::UpdateBounds( uint32_t first, uint32_t last )
+{
+    for ( uint32_t i = first; i < last; ++i )
+    {
+        Entry& entry = m_Entries[i];
+        const Mesh& mesh = *entry.Mesh;
+
+        if ( !entry.Node || !mesh.HasBoundingVolumes() )
+        {
+            // Meshes without bounding volumes are always visible.
+            m_Radius[i] = std::numeric_limits<float>::max();
+            entry.AABBMin = glm::vec3( -std::numeric_limits<float>::max() );
+            entry.AABBMax = glm::vec3( std::numeric_limits<float>::max() );
+            continue;
+        }
+
+        glm::mat4 worldTransform = entry.Node->GetWorldTransform();
+
+        const glm::vec4& sphere = mesh.GetBoundingSphere();
+        glm::vec3 center = glm::vec3( worldTransform * glm::vec4( glm::vec3( sphere ), 1.0f ) );
+        // Use the largest scale of the world transform to scale the radius.
+        float scale = glm::sqrt( glm::max( glm::length2( glm::vec3( worldTransform[0] ) ), glm::max( glm::length2( glm::vec3( worldTransform[1] ) ), glm::length2( glm::vec3( worldTransform[2] ) ) ) ) );
+
+        m_CenterX[i] = center.x;
+        m_CenterY[i] = center.y;
+        m_CenterZ[i] = center.z;
+        m_Radius[i] = sphere.w * scale;
+
+        // Transform the bounding box (Arvo, "Transforming Axis-Aligned Bounding Boxes", Graphics Gems, 1990).
+        const glm::vec3& aabbMin = mesh.GetAABBMin();
+        const glm::vec3& aabbMax = mesh.GetAABBMax();
+        glm::vec3 worldMin( worldTransform[3] );
+        glm::vec3 worldMax( worldTransform[3] );
+        for ( int j = 0; j < 3; ++j )
+        {
+            glm::vec3 a = glm::vec3( worldTransform[j] ) * aabbMin[j];
+            glm::vec3 b = glm::vec3( worldTransform[j] ) * aabbMax[j];
+            worldMin += glm::min( a, b );
+            worldMax += glm::max( a, b );
+        }
+
+        entry.AABBMin = worldMin;
+        entry.AABBMax = worldMax;
+    }
+}
+
+uint32_t SceneMeshList::Cull( const Frustum& frustum, std::vector<uint32_t>& visibleMeshes ) const
+{
+    const uint32_t numMeshes = static_cast<uint32_t>( m_Entries.size() );
+
+    visibleMeshes.clear();
+
+    if ( numMeshes < gs_MinMeshesPerThread * 2 )
+    {
+        Cull( frustum, 0, numMeshes, visibleMeshes );
+    }
+    else
+    {
+        // Each thread culls a range of the list, the results are concatenated in order.
+        std::vector< std::vector<uint32_t> > visibleChunks( Core::TaskScheduler::Get().GetConcurrency() );
+        ParallelFor( PROFILE_MARKER( "Cull Meshes" ), numMeshes, [this, &frustum, &visibleChunks]( uint32_t chunk, uint32_t first, uint32_t last )
+        {
+            Cull( frustum, first, last, visibleChunks[chunk] );
+        } );
+
+        for ( auto& visibleChunk : visibleChunks )
+        {
+            visibleMeshes.insert( visibleMeshes.end(), visibleChunk.begin(), visibleChunk.end() );
+        }
+    }
+
+    const uint32_t numVisibleMeshes = static_cast<uint32_t>( visibleMeshes.size() );
+
+    scoped_lock lock( m_StatisticsMutex );
+    ++m_CullingStatistics.NumCulls;
+    m_CullingStatistics.NumMeshes += numMeshes;
+    m_CullingStatistics.NumVisibleMeshes += numVisibleMeshes;
+
+    return numVisibleMeshes;
+}
+
+void SceneMeshList::Cull( const Frustum& frustum, uint32_t first, uint32_t last, std::vector<uint32_t>& visibleMeshes ) const
+{
+    __m128 planeX[Frustum::NumPlanes];
+    __m128 planeY[Frustum::NumPlanes];
+    __m128 planeZ[Frustum::NumPlanes];
+    __m128 planeW[Frustum::NumPlanes];
+
+    for ( int p = 0; p < Frustum::NumPlanes; ++p )
+    {
+        const glm::vec4& plane = frustum.GetPlane( static_cast<Frustum::Plane>( p ) );
+        planeX[p] = _mm_set1_ps( plane.x );
+        planeY[p] = _mm_set1_ps( plane.y );
+        planeZ[p] = _mm_set1_ps( plane.z );
+        planeW[p] = _mm_set1_ps( plane.w );
+    }
+
+    // first is always a multiple of 4 and the arrays are padded to a multiple of 4.
+    assert( ( first & 3 ) == 0 );
+
+    for ( uint32_t i = first; i < last; i += 4 )
+    {
+        __m128 centerX = _mm_loadu_ps( &m_CenterX[i] );
+        __m128 centerY = _mm_loadu_ps( &m_CenterY[i] );
+        __m128 centerZ = _mm_loadu_ps( &m_CenterZ[i] );
+        __m128 negRadius = _mm_sub_ps( _mm_setzero_ps(), _mm_loadu_ps( &m_Radius[i] ) );
+
+        // A sphere is outside the frustum if it is completely behind any of the planes.
+        __m128 inside = _mm_cmpge_ps( negRadius, negRadius );
+        for ( int p = 0; p < Frustum::NumPlanes; ++p )
+        {
+            __m128 distance = _mm_add_ps( _mm_add_ps( _mm_mul_ps( planeX[p], centerX ), _mm_mul_ps( planeY[p], centerY ) ),
+                                          _mm_add_ps( _mm_mul_ps( planeZ[p], centerZ ), planeW[p] ) );
+            inside = _mm_and_ps( inside, _mm_cmpge_ps( distance, negRadius ) );
+        }
+
+        int mask = _mm_movemask_ps( inside );
+        for ( uint32_t j = 0; mask != 0 && j < 4 && i + j < last; ++j, mask >>= 1 )
+        {
+            // The bounding box is usually tighter than the sphere.
+            const Entry& entry = m_Entries[i + j];
+            if ( ( mask & 1 ) && frustum.IntersectsAABB( entry.AABBMin, entry.AABBMax ) )
+            {
+                visibleMeshes.push_back( i + j );
+            }
+        }
+    }
+}
+
+uint32_t SceneMeshList::GetNumMeshes() const
+{
+    return static_cast<uint32_t>( m_Entries.size() );
+}
+
+const SceneMeshList::Entry& SceneMeshList::GetEntry( uint32_t index ) const
+{
+    return m_Entries[index];
+}
+
+bool SceneMeshList::Raycast( const Ray& ray, RaycastHit& hit, float maxDistance ) const
+{
+    {
+        scoped_lock lock( m_MeshBVHMutex );
+        if ( !m_IsMeshBVHValid )
+        {
+            std::vector<glm::vec4> spheres;
+            m_MeshBVHEntries.clear();
+            for ( uint32_t i = 0; i < m_Entries.size(); ++i )
+            {
+                const Entry& entry = m_Entries[i];
+                // Meshes without bounding volumes have an infinite bounding sphere.
+                if ( entry.Node && entry.Mesh->HasBVH() && m_Radius[i] < std::numeric_limits<float>::max() )
+                {
+                    spheres.push_back( glm::vec4( m_CenterX[i], m_CenterY[i], m_CenterZ[i], m_Radius[i] ) );
+                    m_MeshBVHEntries.push_back( i );
+                }
+            }
+
+            m_MeshBVH.BuildSpheres( spheres );
+            m_IsMeshBVHValid = true;
+        }
+    }
+
+    uint32_t triangle = BVH::InvalidPrimitive;
+
+    BVH::Hit meshHit = m_MeshBVH.Intersect( ray, maxDistance, [&]( uint32_t primitive, const Ray& worldRay, float maxMeshDistance )
+    {
+        const Entry& entry = m_Entries[m_MeshBVHEntries[primitive]];
+        glm::mat4 worldToObject = glm::transpose( m_ObjectData[entry.ObjectIndex].InverseTransposeWorld );
+
+        // The direction is not normalized so the distance along the 
+        // object space ray is the same as the distance along the world space ray.
+        Ray objectRay( glm::vec3( worldToObject * glm::vec4( worldRay.m_Origin, 1 ) ), glm::vec3( worldToObject * glm::vec4( worldRay.m_Direction, 0 ) ) );
+        BVH::Hit triangleHit = entry.Mesh->GetBVH()->Intersect( objectRay, maxMeshDistance );
+        if ( triangleHit.Primitive != BVH::InvalidPrimitive )
+        {
+            triangle = triangleHit.Primitive;
+        }
+
+        return triangleHit.Distance;
+    } );
+
+    if ( meshHit.Primitive == BVH::InvalidPrimitive )
+    {
+        return false;
+    }
+
+    const Entry& entry = m_Entries[m_MeshBVHEntries[meshHit.Primitive]];
+    hit.Node = entry.Node;
+    hit.Mesh = entry.Mesh;
+    hit.Triangle = triangle;
+    hit.Distance = meshHit.Distance;
+    hit.Point = ray.GetPointOnRay( meshHit.Distance );
+
+    return true;
+}
+
+const std::vector<SceneMeshList::ObjectData>& SceneMeshList::GetObjectData() const
+{
+    return m_ObjectData;
+}
+
+SceneMeshList::CullingStatistics SceneMeshList::GetCullingStatistics() const
+{
+    scoped_lock lock( m_StatisticsMutex );
+    return m_CullingStatistics;
+}
+
+void SceneMeshList::BeginFrame( uint64_t frameCounter )
+{
+    {
+        scoped_lock lock( m_ObjectBufferMutex );
+        m_Frame = frameCounter;
+    }
+
+    scoped_lock lock( m_StatisticsMutex );
+    m_LastDrawStatistics = m_DrawStatistics;
+    m_DrawStatistics = DrawStatistics();
+}
+
+bool SceneMeshList::UploadObjectData( GraphicsCommandBuffer& commandBuffer, uint64_t& gpuAddress ) const
+{
+    scoped_lock lock( m_ObjectBufferMutex );
+
+    bool upload = m_ObjectBufferFrame != m_Frame;
+    if ( upload )
+    {
+        // Object buffers that don't fit in a page of the upload heap get their own upload buffer.
+        m_ObjectBufferAddress = commandBuffer.UploadDynamicBuffer( m_ObjectData );
+        m_ObjectBufferFrame = m_Frame;
+    }
+
+    gpuAddress = m_ObjectBufferAddress;
+
+    return upload;
+}
+
+void SceneMeshList::AddDrawStatistics( const DrawStatistics& drawStatistics ) const
+{
+    scoped_lock lock( m_StatisticsMutex );
+    m_DrawStatistics.NumDraws += drawStatistics.NumDraws;
+    m_DrawStatistics.NumObjectBinds += drawStatistics.NumObjectBinds;
+    m_DrawStatistics.NumObjectBindsAvoided += drawStatistics.NumObjectBindsAvoided;
+    m_DrawStatistics.NumMaterialBinds += drawStatistics.NumMaterialBinds;
+    m_DrawStatistics.NumMaterialBindsAvoided += drawStatistics.NumMaterialBindsAvoided;
+    m_DrawStatistics.NumBufferBinds += drawStatistics.NumBufferBinds;
+    m_DrawStatistics.NumBufferBindsAvoided += drawStatistics.NumBufferBindsAvoided;
+    m_DrawStatistics.NumInstancedDraws += drawStatistics.NumInstancedDraws;
+    m_DrawStatistics.NumMergedDraws += drawStatistics.NumMergedDraws;
+    m_DrawStatistics.NumObjectBufferUploads += drawStatistics.NumObjectBufferUploads;
+    m_DrawStatistics.NumObjectBufferReuses += drawStatistics.NumObjectBufferReuses;
+    m_DrawStatistics.NumMeshletsCulled += drawStatistics.NumMeshletsCulled;
+    m_DrawStatistics.NumMeshletTrianglesCulled += drawStatistics.NumMeshletTrianglesCulled;
+}
+
+SceneMeshList::DrawStatistics SceneMeshList::GetDrawStatistics() const
+{
+    scoped_lock lock( m_StatisticsMutex );
+    return m_LastDrawStatistics;
+}
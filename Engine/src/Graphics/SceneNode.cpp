@@ -4,20 +4,29 @@
 #include <SceneVisitor.h>
 #include <Graphics/Mesh.h>
 #include <Graphics/SceneNode.h>
+#include <Graphics/TransformHierarchy.h>
 
 using namespace Graphics;
 
 SceneNode::SceneNode( const glm::mat4& localTransform )
-    : m_LocalTransform( localTransform )
-    , m_Name( "SceneNode" )
+    : m_Name( "SceneNode" )
+    , m_Transforms( std::make_shared<TransformHierarchy>() )
 {
-    m_InverseTransform = glm::inverse( m_LocalTransform );
+    m_TransformIndex = m_Transforms->Allocate( this, TransformHierarchy::InvalidIndex, localTransform );
 }
 
 SceneNode::~SceneNode()
 {
+    // Children that are still referenced elsewhere become root nodes.
+    for ( auto child : m_Children )
+    {
+        m_Transforms->SetParent( child->m_TransformIndex, TransformHierarchy::InvalidIndex );
+    }
+
     // Delete children.
     m_Children.clear();
+
+    m_Transforms->Free( m_TransformIndex );
 }
 
 const std::string& SceneNode::GetName() const
@@ -32,23 +41,22 @@ void  SceneNode::SetName( const std::string& name )
 
 glm::mat4 SceneNode::GetLocalTransform() const
 {
-    return m_LocalTransform;
+    return m_Transforms->GetLocalTransform( m_TransformIndex );
 }
 
 void SceneNode::SetLocalTransform( const glm::mat4& localTransform )
 {
-    m_LocalTransform = localTransform;
-    m_InverseTransform = glm::inverse( localTransform );
+    m_Transforms->SetLocalTransform( m_TransformIndex, localTransform );
 }
 
 glm::mat4 SceneNode::GetInverseLocalTransform() const
 {
-    return m_InverseTransform;
+    return glm::inverse( GetLocalTransform() );
 }
 
 glm::mat4 SceneNode::GetWorldTransform() const
 {
-    return GetParentWorldTransform() * m_LocalTransform;
+    return m_Transforms->GetWorldTransform( m_TransformIndex );
 }
 
 void SceneNode::SetWorldTransform( const glm::mat4& worldTransform )
@@ -59,20 +67,58 @@ void SceneNode::SetWorldTransform( const glm::mat4& worldTransform )
 
 glm::mat4 SceneNode::GetInverseWorldTransform() const
 {
-    return glm::inverse( GetWorldTransform() );
+    return glm::transpose( GetInverseTransposeWorldTransform() );
+}
+
+glm::mat4 SceneNode::GetInverseTransposeWorldTransform() const
+{
+    return m_Transforms->GetInverseTransposeWorldTransform( m_TransformIndex );
+}
+
+std::shared_ptr<SceneNode> SceneNode::GetParent() const
+{
+    return m_pParentNode.lock();
+}
+
+std::shared_ptr<TransformHierarchy> SceneNode::GetTransformHierarchy() const
+{
+    return m_Transforms;
+}
+
+uint32_t SceneNode::GetTransformIndex() const
+{
+    return m_TransformIndex;
 }
 
 glm::mat4 SceneNode::GetParentWorldTransform() const
 {
     glm::mat4 parentTransform( 1.0f );
-    if ( std::shared_ptr<SceneNode> parent = m_pParentNode.lock() )
+    uint32_t parent = m_Transforms->GetParent( m_TransformIndex );
+    if ( parent != TransformHierarchy::InvalidIndex )
     {
-        parentTransform = parent->GetWorldTransform();
+        parentTransform = m_Transforms->GetWorldTransform( parent );
     }
 
     return parentTransform;
 }
 
+void SceneNode::MoveTransforms( std::shared_ptr<TransformHierarchy> transforms, const SceneNode* parent )
+{
+    glm::mat4 localTransform = GetLocalTransform();
+
+    // Releasing the transform can compact the hierarchy which changes 
+    // the indices of the other nodes (including the parent).
+    m_Transforms->Free( m_TransformIndex );
+
+    m_Transforms = transforms;
+    m_TransformIndex = m_Transforms->Allocate( this, parent ? parent->m_TransformIndex : TransformHierarchy::InvalidIndex, localTransform );
+
+    for ( auto child : m_Children )
+    {
+        child->MoveTransforms( transforms, this );
+    }
+}
+
 void SceneNode::AddChild( std::shared_ptr<SceneNode> pNode )
 {
     if ( pNode )
@@ -82,6 +128,9 @@ void SceneNode::AddChild( std::shared_ptr<SceneNode> pNode )
         {
             glm::mat4 worldTransform = pNode->GetWorldTransform();
             pNode->m_pParentNode = shared_from_this();
+            // The transforms of the child (and its children) are appended to this node's hierarchy
+            // so they are stored after the transform of this node.
+            pNode->MoveTransforms( m_Transforms, this );
             glm::mat4 localTransform = GetInverseWorldTransform() * worldTransform;
             pNode->SetLocalTransform( localTransform );
             m_Children.push_back( pNode );
@@ -100,7 +149,8 @@ void SceneNode::RemoveChild( std::shared_ptr<SceneNode> pNode )
         NodeList::iterator iter = std::find( m_Children.begin(), m_Children.end(), pNode );
         if ( iter != m_Children.end() )
         {
-            pNode->SetParent( std::weak_ptr<SceneNode>() );
+            // The removed node keeps its world transform.
+            glm::mat4 worldTransform = pNode->GetWorldTransform();
 
             m_Children.erase( iter );
 
@@ -110,6 +160,11 @@ void SceneNode::RemoveChild( std::shared_ptr<SceneNode> pNode )
             {
                 m_ChildrenByName.erase( iter2 );
             }
+
+            // Detached nodes get their own transform hierarchy.
+            pNode->m_pParentNode.reset();
+            pNode->MoveTransforms( std::make_shared<TransformHierarchy>(), nullptr );
+            pNode->SetLocalTransform( worldTransform );
         }
         else
         {
@@ -138,11 +193,8 @@ void SceneNode::SetParent( std::weak_ptr<SceneNode> wpNode )
     }
     else if ( parent = m_pParentNode.lock() )
     {
-        // Setting parent to NULL.. remove from current parent and reset parent node.
-        glm::mat4 worldTransform = GetWorldTransform();
+        // Setting parent to NULL.. remove from current parent (which also resets the parent node).
         parent->RemoveChild( shared_from_this() );
-        m_pParentNode.reset();
-        SetLocalTransform( worldTransform );
     }
 }
 
@@ -153,6 +205,7 @@ void SceneNode::AddMesh( std::shared_ptr<Mesh> mesh )
     if ( iter == m_Meshes.end() )
     {
         m_Meshes.push_back( mesh );
+        m_Transforms->InvalidateStructure();
     }
 }
 
@@ -163,6 +216,7 @@ void SceneNode::RemoveMesh( std::shared_ptr<Mesh> mesh )
     if ( iter != m_Meshes.end() )
     {
         m_Meshes.erase( iter );
+        m_Transforms->InvalidateStructure();
     }
 }
 
@@ -0,0 +1,254 @@
+#include <EnginePCH.h>
+
+#include <Graphics/TransformHierarchy.h>
+#include <Graphics/SceneNode.h>
+
+using namespace Graphics;
+
+// Don't bother compacting small hierarchies.
+static const uint32_t gs_MinCompactSize = 1024;
+
+TransformHierarchy::TransformHierarchy()
+    : m_NumFree( 0 )
+    , m_FirstDirty( 0 )
+    , m_IsDirty( false )
+    , m_Version( 0 )
+    , m_StructureVersion( 0 )
+{}
+
+uint32_t TransformHierarchy::Allocate( SceneNode* node, uint32_t parent, const glm::mat4& localTransform )
+{
+    scoped_lock lock( m_Mutex );
+    assert( parent == InvalidIndex || parent < m_Nodes.size() );
+
+    uint32_t index = static_cast<uint32_t>( m_Nodes.size() );
+
+    m_Nodes.push_back( node );
+    m_Parents.push_back( parent );
+    m_LocalTransforms.push_back( localTransform );
+    m_WorldTransforms.push_back( localTransform );
+    m_InverseTransposeWorldTransforms.push_back( glm::mat4( 1 ) );
+    m_Dirty.push_back( 0 );
+    m_Versions.push_back( 0 );
+
+    SetDirty( index );
+    ++m_StructureVersion;
+
+    return index;
+}
+
+void TransformHierarchy::Free( uint32_t index )
+{
+    scoped_lock lock( m_Mutex );
+    assert( index < m_Nodes.size() && m_Nodes[index] );
+
+    m_Nodes[index] = nullptr;
+    m_Parents[index] = InvalidIndex;
+    ++m_NumFree;
+    ++m_StructureVersion;
+
+    if ( m_NumFree >= gs_MinCompactSize && m_NumFree > GetNumLiveTransforms() )
+    {
+        Compact();
+    }
+}
+
+void TransformHierarchy::SetParent( uint32_t index, uint32_t parent )
+{
+    scoped_lock lock( m_Mutex );
+    assert( parent == InvalidIndex || parent < index );
+
+    m_Parents[index] = parent;
+    SetDirty( index );
+    ++m_StructureVersion;
+}
+
+uint32_t TransformHierarchy::GetParent( uint32_t index ) const
+{
+    scoped_lock lock( m_Mutex );
+    return m_Parents[index];
+}
+
+glm::mat4 TransformHierarchy::GetLocalTransform( uint32_t index ) const
+{
+    scoped_lock lock( m_Mutex );
+    return m_LocalTransforms[index];
+}
+
+void TransformHierarchy::SetLocalTransform( uint32_t index, const glm::mat4& localTransform )
+{
+    scoped_lock lock( m_Mutex );
+    m_LocalTransforms[index] = localTransform;
+    SetDirty( index );
+}
+
+glm::mat4 TransformHierarchy::GetWorldTransform( uint32_t index )
+{
+    scoped_lock lock( m_Mutex );
+    UpdateTransforms();
+    return m_WorldTransforms[index];
+}
+
+glm::mat4 TransformHierarchy::GetInverseTransposeWorldTransform( uint32_t index )
+{
+    scoped_lock lock( m_Mutex );
+    UpdateTransforms();
+    return m_InverseTransposeWorldTransforms[index];
+}
+
+void TransformHierarchy::Update()
+{
+    if ( !m_IsDirty )
+    {
+        return;
+    }
+
+    scoped_lock lock( m_Mutex );
+    UpdateTransforms();
+}
+
+void TransformHierarchy::UpdateTransforms()
+{
+    if ( !m_IsDirty )
+    {
+        return;
+    }
+
+    const uint32_t numTransforms = static_cast<uint32_t>( m_Nodes.size() );
+    ++m_Version;
+
+    // Parents are always stored before their children so a parent's world transform
+    // (and dirty flag) is always up-to-date before its children are visited.
+    for ( uint32_t i = m_FirstDirty; i < numTransforms; ++i )
+    {
+        const uint32_t parent = m_Parents[i];
+        if ( m_Dirty[i] || ( parent != InvalidIndex && m_Dirty[parent] ) )
+        {
+            m_WorldTransforms[i] = parent != InvalidIndex ? m_WorldTransforms[parent] * m_LocalTransforms[i] : m_LocalTransforms[i];
+            m_InverseTransposeWorldTransforms[i] = glm::inverseTranspose( m_WorldTransforms[i] );
+            m_Dirty[i] = 1;
+            m_Versions[i] = m_Version;
+        }
+    }
+
+    std::fill( m_Dirty.begin() + m_FirstDirty, m_Dirty.end(), 0 );
+
+    m_FirstDirty = numTransforms;
+    m_IsDirty = false;
+}
+
+bool TransformHierarchy::IsDirty() const
+{
+    return m_IsDirty;
+}
+
+uint64_t TransformHierarchy::GetChangedTransforms( uint64_t version, std::vector<uint32_t>& changedTransforms )
+{
+    scoped_lock lock( m_Mutex );
+    UpdateTransforms();
+
+    // The transforms are only scanned if any of them changed after the version.
+    if ( version != m_Version )
+    {
+        const uint32_t numTransforms = static_cast<uint32_t>( m_Nodes.size() );
+        for ( uint32_t i = 0; i < numTransforms; ++i )
+        {
+            if ( m_Versions[i] > version && m_Nodes[i] )
+            {
+                changedTransforms.push_back( i );
+            }
+        }
+    }
+
+    return m_Version;
+}
+
+uint64_t TransformHierarchy::GetStructureVersion() const
+{
+    scoped_lock lock( m_Mutex );
+    return m_StructureVersion;
+}
+
+void TransformHierarchy::InvalidateStructure()
+{
+    scoped_lock lock( m_Mutex );
+    ++m_StructureVersion;
+}
+
+uint32_t TransformHierarchy::GetNumTransforms() const
+{
+    scoped_lock lock( m_Mutex );
+    return GetNumLiveTransforms();
+}
+
+uint32_t TransformHierarchy::GetNumLiveTransforms() const
+{
+    return static_cast<uint32_t>( m_Nodes.size() ) - m_NumFree;
+}
+
+void TransformHierarchy::Compact()
+{
+    const uint32_t numTransforms = static_cast<uint32_t>( m_Nodes.size() );
+
+    std::vector<uint32_t> remap( numTransforms, InvalidIndex );
+    uint32_t numLive = 0;
+
+    for ( uint32_t i = 0; i < numTransforms; ++i )
+    {
+        if ( !m_Nodes[i] )
+        {
+            continue;
+        }
+
+        remap[i] = numLive;
+
+        // The relative order of the transforms does not change so parents
+        // are still stored before their children.
+        const uint32_t parent = m_Parents[i];
+        m_Nodes[numLive] = m_Nodes[i];
+        m_Parents[numLive] = parent != InvalidIndex ? remap[parent] : InvalidIndex;
+        m_LocalTransforms[numLive] = m_LocalTransforms[i];
+        m_WorldTransforms[numLive] = m_WorldTransforms[i];
+        m_InverseTransposeWorldTransforms[numLive] = m_InverseTransposeWorldTransforms[i];
+        m_Dirty[numLive] = m_Dirty[i];
+        m_Versions[numLive] = m_Versions[i];
+
+        // Transforms whose parent has been released become root transforms.
+        if ( parent != InvalidIndex && remap[parent] == InvalidIndex )
+        {
+            m_Dirty[numLive] = 1;
+        }
+
+        m_Nodes[numLive]->m_TransformIndex = numLive;
+
+        ++numLive;
+    }
+
+    m_Nodes.resize( numLive );
+    m_Parents.resize( numLive );
+    m_LocalTransforms.resize( numLive );
+    m_WorldTransforms.resize( numLive );
+    m_InverseTransposeWorldTransforms.resize( numLive );
+    m_Dirty.resize( numLive );
+    m_Versions.resize( numLive );
+
+    m_NumFree = 0;
+    ++m_StructureVersion;
+    m_FirstDirty = numLive;
+    for ( uint32_t i = 0; i < numLive; ++i )
+    {
+        if ( m_Dirty[i] )
+        {
+            m_FirstDirty = i;
+            m_IsDirty = true;
+            break;
+        }
+    }
+}
+
+void TransformHierarchy::SetDirty( uint32_t index )
+{
+    m_Dirty[index] = 1;
+    m_FirstDirty = std::min( m_FirstDirty, index );
+    m_IsDirty = true;
+}
@@ -301,6 +301,7 @@ void Window::OnUpdate( Core::UpdateEventArgs& e )
 void Window::OnPreRender( Core::RenderEventArgs& e )
 {
     Core::RenderEventArgs renderArgs( *this, e.ElapsedTime, e.TotalTime, e.FrameCounter, e.Camera, e.GraphicsCommandBuffer );
+    renderArgs.Frame = e.Frame;
     PreRender( renderArgs );
 }
 
@@ -308,6 +309,7 @@ void Window::OnPreRender( Core::RenderEventArgs& e )
 void Window::OnRender( Core::RenderEventArgs& e )
 {
     Core::RenderEventArgs renderArgs( *this, e.ElapsedTime, e.TotalTime, e.FrameCounter, e.Camera, e.GraphicsCommandBuffer );
+    renderArgs.Frame = e.Frame;
     Render( renderArgs );
 }
 
@@ -315,6 +317,7 @@ void Window::OnRender( Core::RenderEventArgs& e )
 void Window::OnPostRender( Core::RenderEventArgs& e )
 {
     Core::RenderEventArgs renderArgs( *this, e.ElapsedTime, e.TotalTime, e.FrameCounter, e.Camera, e.GraphicsCommandBuffer );
+    renderArgs.Frame = e.Frame;
     PostRender( renderArgs );
 }
 
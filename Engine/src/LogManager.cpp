@@ -4,39 +4,215 @@
 #include <LogStream.h>
 #include <Common.h>
 #include <EngineDefines.h>
-#include <ThreadSafeQueue.h>
+#include <LockFreeQueue.h>
+#include <Graphics/Profiler.h>
 
 using namespace Core;
+using namespace std::chrono;
 
 using LogStreamList = std::vector< std::shared_ptr<LogStream> >;
 
-struct LogMessage
+// Messages that were written are flushed at least this often.
+static const milliseconds gs_FlushInterval( 250 );
+
+// The messages that are logged by a single thread.
+// The logging thread is the only producer and the log thread is the only consumer.
+struct LogBuffer
 {
-    LogLevel m_LogLevel;
-    std::wstring m_Message;
+    // Every thread that logs can use up to Capacity * sizeof( LogMessage ) (256 KB)
+    // for queued messages. Messages are dropped while the buffer is full.
+    static const uint32_t Capacity = 1024;
+
+    SPSCQueue<LogMessage> Messages { Capacity };
+
+    // Set when the thread exits. The buffer is released after the remaining messages have been written.
+    std::atomic_bool IsRetired { false };
+};
+
+struct LogThreadState
+{
+    LogThreadState();
+    ~LogThreadState();
+
+    std::shared_ptr<LogBuffer> Buffer;
 };
 
 static LogStreamList gs_LogStreams;
-static ThreadSafeQueue<LogMessage> gs_MessageQueue;
 static std::mutex gs_LogStreamsMutex;
+
+// The log buffers of all threads that have logged a message.
+static std::vector< std::shared_ptr<LogBuffer> > gs_LogBuffers;
+static std::mutex gs_LogBuffersMutex;
+
+// Can be negative for a moment because a message is counted after it was pushed.
+static std::atomic_int64_t gs_NumPendingMessages = 0;
+static std::atomic_uint64_t gs_NumDroppedMessages = 0;
+static std::atomic_uint64_t gs_NumWakeups = 0;
+// Wakes up the log thread.
+static Detail::QueueWaiter gs_MessageWaiter;
+
 static std::atomic_bool g_ProcessMessages = true;
 static std::thread g_MessageThread;
 
+LogThreadState::LogThreadState()
+    : Buffer( std::make_shared<LogBuffer>() )
+{
+    scoped_lock lock( gs_LogBuffersMutex );
+    gs_LogBuffers.push_back( Buffer );
+}
+
+LogThreadState::~LogThreadState()
+{
+    Buffer->IsRetired = true;
+}
+
+static LogBuffer& GetLogBuffer()
+{
+    thread_local LogThreadState threadState;
+    return *threadState.Buffer;
+}
+
+// Pop the messages of all threads in the order they were logged.
+static void PopMessages( std::vector< std::shared_ptr<LogBuffer> >& logBuffers, std::vector<LogMessage>& messages )
+{
+    {
+        scoped_lock lock( gs_LogBuffersMutex );
+        logBuffers = gs_LogBuffers;
+    }
+
+    int64_t numMessages = 0;
+    for ( auto& logBuffer : logBuffers )
+    {
+        LogMessage message;
+        while ( logBuffer->Messages.TryPop( message ) )
+        {
+            messages.push_back( std::move( message ) );
+            ++numMessages;
+        }
+    }
+    gs_NumPendingMessages -= numMessages;
+
+    // Release the buffers of the threads that have exited.
+    {
+        scoped_lock lock( gs_LogBuffersMutex );
+        gs_LogBuffers.erase( std::remove_if( gs_LogBuffers.begin(), gs_LogBuffers.end(), [] ( const std::shared_ptr<LogBuffer>& logBuffer )
+        {
+            return logBuffer->IsRetired && logBuffer->Messages.Empty();
+        } ), gs_LogBuffers.end() );
+    }
+    logBuffers.clear();
+
+    // Messages of the same thread are already in order (the sort is stable).
+    std::stable_sort( messages.begin(), messages.end(), []( const LogMessage& a, const LogMessage& b )
+    {
+        return a.GetTime() < b.GetTime();
+    } );
+}
+
+// Write a batch of messages to all log streams.
+// Consecutive messages of the same level are written to a stream at once.
+static void WriteMessages( const std::vector<LogMessage>& messages, std::wstring& text )
+{
+    scoped_lock lock( gs_LogStreamsMutex );
+
+    size_t first = 0;
+    while ( first < messages.size() )
+    {
+        LogLevel level = messages[first].GetLevel();
+
+        text.clear();
+        size_t last = first;
+        for ( ; last < messages.size() && messages[last].GetLevel() == level; ++last )
+        {
+            messages[last].Format( text );
+            text += L"\n";
+        }
+
+        for ( auto& log : gs_LogStreams )
+        {
+            log->Write( level, text );
+        }
+
+        first = last;
+    }
+}
+
+static void FlushStreams()
+{
+    scoped_lock lock( gs_LogStreamsMutex );
+    for ( auto& log : gs_LogStreams )
+    {
+        log->Flush();
+    }
+}
+
 void ProcessMessagesFunc()
 {
-    while ( g_ProcessMessages )
+    Graphics::Profiler::SetThreadName( L"Log" );
+
+    std::vector< std::shared_ptr<LogBuffer> > logBuffers;
+    std::vector<LogMessage> messages;
+    std::wstring text;
+
+    uint64_t numReportedDroppedMessages = 0;
+    bool isFlushed = true;
+    auto flushTime = steady_clock::now();
+
+    while ( true )
     {
-        LogMessage msg;
-        while ( gs_MessageQueue.TryPop( msg ) )
+        // Messages that were logged before Shutdown are still written.
+        bool stop = !g_ProcessMessages;
+
+        PopMessages( logBuffers, messages );
+
+        uint64_t numDroppedMessages = gs_NumDroppedMessages;
+        if ( numDroppedMessages != numReportedDroppedMessages )
         {
-            scoped_lock lock( gs_LogStreamsMutex );
-            for ( auto log : gs_LogStreams )
+            messages.emplace_back( LogMessage( LogLevel::Warning, "LogManager: ", numDroppedMessages - numReportedDroppedMessages, " messages were dropped because a log buffer was full." ) );
+            numReportedDroppedMessages = numDroppedMessages;
+        }
+
+        bool hasErrors = false;
+        if ( !messages.empty() )
+        {
+            hasErrors = std::any_of( messages.begin(), messages.end(), []( const LogMessage& message )
+            {
+                return message.GetLevel() == LogLevel::Error;
+            } );
+
+            WriteMessages( messages, text );
+            messages.clear();
+
+            if ( isFlushed )
             {
-                log->Write( msg.m_LogLevel, msg.m_Message );
+                isFlushed = false;
+                flushTime = steady_clock::now() + gs_FlushInterval;
             }
         }
 
-        std::this_thread::yield();
+        // Errors are flushed right away in case the application is about to crash.
+        if ( !isFlushed && ( stop || hasErrors || steady_clock::now() >= flushTime ) )
+        {
+            FlushStreams();
+            isFlushed = true;
+        }
+
+        if ( stop )
+        {
+            break;
+        }
+
+        // Sleep until a message is logged. Only wake up for the flush when something was written.
+        auto hasMessages = []() { return gs_NumPendingMessages > 0 || !g_ProcessMessages; };
+        if ( isFlushed )
+        {
+            gs_MessageWaiter.Wait( hasMessages );
+        }
+        else
+        {
+            gs_MessageWaiter.WaitFor( hasMessages, flushTime - steady_clock::now() );
+        }
+        ++gs_NumWakeups;
     }
 }
 
@@ -64,6 +240,7 @@ void LogManager::UnregisterLogStream( std::shared_ptr<LogStream> logStream )
 void LogManager::Shutdown()
 {
     g_ProcessMessages = false;
+    gs_MessageWaiter.Notify();
     if ( g_MessageThread.joinable() )
     {
         g_MessageThread.join();
@@ -72,19 +249,34 @@ void LogManager::Shutdown()
     UnregisterAllStreams();
 }
 
+uint64_t LogManager::GetNumDroppedMessages()
+{
+    return gs_NumDroppedMessages;
+}
+
+uint64_t LogManager::GetNumWakeups()
+{
+    return gs_NumWakeups;
+}
+
 void LogManager::UnregisterAllStreams()
 {
     scoped_lock lock( gs_LogStreamsMutex );
     gs_LogStreams.clear();
 }
 
-void LogManager::Log( LogLevel level, const std::wstring& message )
+void LogManager::Log( LogMessage&& message )
 {
-    std::wstring msg = message + L"\n";
-    gs_MessageQueue.Push( { level, msg } );
-}
+    if ( !GetLogBuffer().Messages.TryPush( std::move( message ) ) )
+    {
+        gs_NumDroppedMessages.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
 
-void LogManager::Log( LogLevel level, const std::string& message )
-{
-    Log( level, ConvertString( message ) );
+    // The log thread does not go to sleep while there are pending messages.
+    // Only the message that makes the count positive has to wake it up.
+    if ( gs_NumPendingMessages.fetch_add( 1 ) <= 0 )
+    {
+        gs_MessageWaiter.Notify();
+    }
 }
@@ -22,6 +22,14 @@ void LogStreamFile::Write( LogLevel level, const std::wstring& message )
     if ( m_ofs.is_open() )
     {
         m_ofs << message;
+    }
+}
+
+void LogStreamFile::Flush()
+{
+    scoped_lock lock( m_FileMutex );
+    if ( m_ofs.is_open() )
+    {
         m_ofs.flush();
     }
 }
@@ -0,0 +1,336 @@
+#include <EnginePCH.h>
+
+#include <TaskScheduler.h>
+#include <WorkStealingDeque.h>
+
+using namespace Core;
+
+// The number of times a worker looks for tasks before it goes to sleep.
+static const uint32_t gs_NumSpins = 64;
+
+static std::shared_ptr<TaskScheduler> gs_TaskScheduler;
+
+// The scheduler and index of the worker that is running on this thread.
+static thread_local TaskScheduler* gs_CurrentScheduler = nullptr;
+static thread_local uint32_t gs_CurrentWorkerIndex = TaskScheduler::NoWorker;
+
+struct TaskScheduler::Task
+{
+    Task( const Graphics::ProfileMarker& marker, std::function<void()> function, TaskPriority priority, TaskGroup* group )
+        : Marker( marker )
+        , Function( std::move( function ) )
+        , Priority( priority )
+        , Group( group )
+    {}
+
+    Graphics::ProfileMarker Marker;
+    std::function<void()> Function;
+    TaskPriority Priority;
+    TaskGroup* Group;
+};
+
+struct TaskScheduler::Worker
+{
+    std::thread Thread;
+    WorkStealingDeque<Task*> Tasks[NumPriorities];
+    // The state of the random number generator that picks the first worker to steal from.
+    uint32_t RandomState;
+};
+
+TaskScheduler::TaskScheduler( uint32_t numWorkers )
+    : m_NumSubmittedTasks( 0 )
+    , m_NumQueuedTasks( 0 )
+    , m_NumSleepingWorkers( 0 )
+    , m_Stop( false )
+    , m_NumTasks( 0 )
+    , m_NumStolenTasks( 0 )
+    , m_NumSleeps( 0 )
+{
+    if ( numWorkers == 0 )
+    {
+        numWorkers = std::max( std::thread::hardware_concurrency(), 2u ) - 1;
+    }
+
+    // All deques must exist before the first worker starts stealing.
+    m_Workers.reserve( numWorkers );
+    for ( uint32_t i = 0; i < numWorkers; ++i )
+    {
+        m_Workers.push_back( std::make_unique<Worker>() );
+        m_Workers.back()->RandomState = 2654435761u * ( i + 1 );
+    }
+
+    for ( uint32_t i = 0; i < numWorkers; ++i )
+    {
+        m_Workers[i]->Thread = std::thread( &TaskScheduler::WorkerThread, this, i );
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        scoped_lock lock( m_SleepMutex );
+        m_Stop = true;
+    }
+    m_WakeCondition.notify_all();
+
+    for ( auto& worker : m_Workers )
+    {
+        if ( worker->Thread.joinable() )
+        {
+            worker->Thread.join();
+        }
+    }
+}
+
+TaskScheduler& TaskScheduler::Get()
+{
+    assert( gs_TaskScheduler );
+    return *gs_TaskScheduler;
+}
+
+void TaskScheduler::Init( uint32_t numWorkers )
+{
+    gs_TaskScheduler = std::make_shared<TaskScheduler>( numWorkers );
+}
+
+void TaskScheduler::Shutdown()
+{
+    gs_TaskScheduler.reset();
+}
+
+uint32_t TaskScheduler::GetNumWorkers() const
+{
+    return static_cast<uint32_t>( m_Workers.size() );
+}
+
+uint32_t TaskScheduler::GetConcurrency() const
+{
+    return GetNumWorkers() + 1;
+}
+
+uint32_t TaskScheduler::GetWorkerIndex() const
+{
+    return gs_CurrentScheduler == this ? gs_CurrentWorkerIndex : NoWorker;
+}
+
+TaskScheduler::Statistics TaskScheduler::GetStatistics() const
+{
+    Statistics statistics;
+    statistics.NumTasks = m_NumTasks.load( std::memory_order_relaxed );
+    statistics.NumStolenTasks = m_NumStolenTasks.load( std::memory_order_relaxed );
+    statistics.NumSleeps = m_NumSleeps.load( std::memory_order_relaxed );
+
+    return statistics;
+}
+
+void TaskScheduler::Submit( Task* task )
+{
+    uint32_t priority = static_cast<uint32_t>( task->Priority );
+    uint32_t workerIndex = GetWorkerIndex();
+    if ( workerIndex != NoWorker )
+    {
+        m_Workers[workerIndex]->Tasks[priority].Push( task );
+    }
+    else
+    {
+        scoped_lock lock( m_SubmittedTasksMutex );
+        m_SubmittedTasks[priority].push_back( task );
+        ++m_NumSubmittedTasks;
+    }
+
+    // A worker that is about to sleep either sees the new task or
+    // is already waiting when it is notified (see WorkerThread).
+    ++m_NumQueuedTasks;
+    if ( m_NumSleepingWorkers > 0 )
+    {
+        scoped_lock lock( m_SleepMutex );
+        m_WakeCondition.notify_one();
+    }
+}
+
+TaskScheduler::Task* TaskScheduler::FindTask( uint32_t workerIndex )
+{
+    const uint32_t numWorkers = GetNumWorkers();
+
+    // Pick a random worker to start stealing from so the thieves don't all pick the same victim.
+    uint32_t firstVictim = 0;
+    if ( numWorkers > 0 )
+    {
+        thread_local uint32_t randomState = 0x9E3779B9u;
+        uint32_t& state = workerIndex != NoWorker ? m_Workers[workerIndex]->RandomState : randomState;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        firstVictim = state % numWorkers;
+    }
+
+    Task* task = nullptr;
+    for ( uint32_t priority = 0; priority < NumPriorities; ++priority )
+    {
+        // Own tasks first.
+        if ( workerIndex != NoWorker && m_Workers[workerIndex]->Tasks[priority].Pop( task ) )
+        {
+            --m_NumQueuedTasks;
+            return task;
+        }
+
+        if ( m_NumSubmittedTasks > 0 )
+        {
+            scoped_lock lock( m_SubmittedTasksMutex );
+            std::deque<Task*>& submittedTasks = m_SubmittedTasks[priority];
+            if ( !submittedTasks.empty() )
+            {
+                task = submittedTasks.front();
+                submittedTasks.pop_front();
+                --m_NumSubmittedTasks;
+                --m_NumQueuedTasks;
+                return task;
+            }
+        }
+
+        for ( uint32_t i = 0; i < numWorkers; ++i )
+        {
+            uint32_t victim = ( firstVictim + i ) % numWorkers;
+            if ( victim != workerIndex && m_Workers[victim]->Tasks[priority].Steal( task ) )
+            {
+                --m_NumQueuedTasks;
+                m_NumStolenTasks.fetch_add( 1, std::memory_order_relaxed );
+                return task;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void TaskScheduler::Execute( Task* task )
+{
+    {
+#if defined(PROFILE)
+        Graphics::ScopedProfileMarker profileMarker( task->Marker );
+#endif
+        task->Function();
+    }
+
+    TaskGroup* group = task->Group;
+    delete task;
+
+    m_NumTasks.fetch_add( 1, std::memory_order_relaxed );
+    group->Finish();
+}
+
+bool TaskScheduler::ExecuteTask()
+{
+    Task* task = FindTask( GetWorkerIndex() );
+    if ( task )
+    {
+        Execute( task );
+        return true;
+    }
+
+    return false;
+}
+
+void TaskScheduler::WorkerThread( uint32_t workerIndex )
+{
+    gs_CurrentScheduler = this;
+    gs_CurrentWorkerIndex = workerIndex;
+
+    Graphics::Profiler::SetThreadName( L"Worker " + std::to_wstring( workerIndex ) );
+
+    while ( true )
+    {
+        Task* task = FindTask( workerIndex );
+        for ( uint32_t spin = 0; !task && spin < gs_NumSpins && m_NumQueuedTasks > 0; ++spin )
+        {
+            // There are tasks but another thread took the one we tried to steal.
+            std::this_thread::yield();
+            task = FindTask( workerIndex );
+        }
+
+        if ( task )
+        {
+            Execute( task );
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( m_SleepMutex );
+        if ( m_Stop && m_NumQueuedTasks == 0 )
+        {
+            break;
+        }
+
+        ++m_NumSleepingWorkers;
+        m_NumSleeps.fetch_add( 1, std::memory_order_relaxed );
+        m_WakeCondition.wait( lock, [this]()
+        {
+            return m_Stop || m_NumQueuedTasks > 0;
+        } );
+        --m_NumSleepingWorkers;
+    }
+
+    gs_CurrentScheduler = nullptr;
+    gs_CurrentWorkerIndex = NoWorker;
+}
+
+TaskGroup::TaskGroup( TaskScheduler& scheduler )
+    : m_Scheduler( scheduler )
+    , m_NumPendingTasks( 0 )
+{}
+
+TaskGroup::~TaskGroup()
+{
+    Wait();
+}
+
+void TaskGroup::Run( const Graphics::ProfileMarker& marker, std::function<void()> function, TaskPriority priority )
+{
+    ++m_NumPendingTasks;
+    m_Scheduler.Submit( new TaskScheduler::Task( marker, std::move( function ), priority, this ) );
+}
+
+void TaskGroup::Run( std::function<void()> function, TaskPriority priority )
+{
+    Run( PROFILE_MARKER( "Task" ), std::move( function ), priority );
+}
+
+void TaskGroup::Wait()
+{
+    while ( m_NumPendingTasks > 0 )
+    {
+        if ( !m_Scheduler.ExecuteTask() )
+        {
+            // The remaining tasks are running on other threads.
+            std::unique_lock<std::mutex> lock( m_Mutex );
+            m_Condition.wait_for( lock, std::chrono::microseconds( 100 ), [this]()
+            {
+                return m_NumPendingTasks == 0;
+            } );
+        }
+    }
+
+    // Don't return while the last task is still notifying.
+    scoped_lock lock( m_Mutex );
+}
+
+bool TaskGroup::IsDone() const
+{
+    return m_NumPendingTasks == 0;
+}
+
+void TaskGroup::Finish()
+{
+    uint32_t numPendingTasks = m_NumPendingTasks.load();
+    while ( numPendingTasks > 1 )
+    {
+        if ( m_NumPendingTasks.compare_exchange_weak( numPendingTasks, numPendingTasks - 1 ) )
+        {
+            return;
+        }
+    }
+
+    // This may be the last task.
+    scoped_lock lock( m_Mutex );
+    --m_NumPendingTasks;
+    m_Condition.notify_all();
+}
@@ -3,12 +3,16 @@
 #include "AbstractPass.h"
 #include "ConstantBuffers.h"
 
+#include <Graphics/DrawList.h>
+#include <Graphics/SceneMeshList.h>
+
 namespace Graphics
 {
     class Camera;
     class Material;
     class GraphicsCommandBuffer;
     class GraphicsPipelineState;
+    class ShaderSignature;
 }
 
 // Base pass provides implementations for functions used by most passes.
@@ -17,6 +21,9 @@ class BasePass : public AbstractPass
 public:
     typedef AbstractPass base;
 
+    // The draw statistics are accumulated per frame by the mesh list of the scene.
+    using DrawStatistics = Graphics::SceneMeshList::DrawStatistics;
+
     BasePass( std::shared_ptr<Graphics::Scene> scene, std::shared_ptr<Graphics::GraphicsPipelineState> pipeline, bool bUseMaterials = true, uint32_t instanceCount = 1, uint32_t firstInstance = 0 );
     virtual ~BasePass();
 
@@ -30,9 +37,59 @@ public:
     virtual void Visit( Graphics::SceneNode& node ) override;
     virtual void Visit( Graphics::Mesh& mesh ) override;
 
+    // Passes can override this function to only render meshes with a specific material.
+    virtual bool IsRendered( const Graphics::Material& material ) const;
+
+    // The material is only bound if it is not already bound.
     void BindMaterial( std::shared_ptr<Graphics::Material> pMaterial );
 
+    // Render the mesh using the level of detail that matches the 
+    // current camera and the world transform of the current scene node.
+    // The vertex and index buffers are only bound if they are not already bound.
+    void RenderMesh( Graphics::Mesh& mesh );
+
+    // Only render the meshes that are inside the view frustum of the camera (enabled by default).
+    // Frustum culling is only used for passes that render a single instance of each mesh.
+    void SetFrustumCulling( bool frustumCulling );
+    bool GetFrustumCulling() const;
+
+    // The number of meshes that were tested and the number of meshes that were
+    // visible the last time this pass was rendered.
+    uint32_t GetNumMeshes() const;
+    uint32_t GetNumVisibleMeshes() const;
+
+    // Only draw the meshlets of the visible meshes that are inside the view frustum 
+    // and that are not back facing (enabled by default). Meshlet culling is only 
+    // used if frustum culling is enabled and for draws of LOD 0 that are not instanced.
+    void SetMeshletCulling( bool meshletCulling );
+    bool GetMeshletCulling() const;
+
+    // Merge draws of the same mesh and material into a single instanced draw (enabled by default).
+    // Automatic instancing is only used if the pipeline state reads the per-object
+    // data from the object buffer (see UsesObjectBuffer).
+    void SetAutomaticInstancing( bool automaticInstancing );
+    bool GetAutomaticInstancing() const;
+
+    // Returns true if the root signature of the pipeline state has the per-view 
+    // constant buffer (b11), the instance parameters (b10), the object buffer (t33)
+    // and the instance objects (t34). Otherwise the per-object constant buffer (b0) is used.
+    bool UsesObjectBuffer() const;
+
 protected:
+    // Sort the meshes by their state and render them.
+    // If cull is false, all the meshes in the mesh list are rendered.
+    void RenderDrawList( const Graphics::SceneMeshList& meshList, bool cull );
+    // Render the sorted draw list using the shared object buffer.
+    void RenderDrawBatches( const Graphics::SceneMeshList& meshList );
+    // Draw a level of detail of the mesh (and bind the vertex and index buffers if needed).
+    // If the scene node of the mesh is specified, the meshlets of the mesh are culled (see SetMeshletCulling).
+    void DrawMesh( Graphics::Mesh& mesh, uint32_t lod, uint32_t instanceCount, uint32_t firstInstance, const Graphics::SceneNode* node = nullptr );
+    // Bind the view and projection matrices of the current camera.
+    void BindPerView();
+    // Upload the object data of the mesh list (once per frame) and bind it.
+    void BindObjectBuffer( const Graphics::SceneMeshList& meshList );
+    // Only binds the instance parameters if they changed.
+    void BindInstanceParams( uint32_t firstInstance );
 
     Core::RenderEventArgs* m_pRenderEventArgs;
 
@@ -42,13 +99,60 @@ protected:
     // Pointer to the graphics command buffer. 
     // Only valid during rendering.
     std::shared_ptr<Graphics::GraphicsCommandBuffer> m_GraphicsCommandBuffer;
+    // The world transform of the scene node that is currently being visited.
+    glm::mat4 m_WorldTransform;
 
     // The scene to render.
     std::shared_ptr< Graphics::Scene > m_Scene;
+    // The mesh list of the scene for the frame that is rendered.
+    // Only valid during rendering.
+    const Graphics::SceneMeshList* m_MeshList;
+    // The draw statistics of the pass. These are added to the 
+    // statistics of the mesh list after the pass is rendered.
+    DrawStatistics m_DrawStatistics;
     // The pipeline state that should be used to render this pass.
     std::shared_ptr< Graphics::GraphicsPipelineState > m_Pipeline;
 
     bool m_UseMaterials;
     uint32_t m_InstanceCount;
     uint32_t m_FirstInstance;
+
+    bool m_FrustumCulling;
+    // Indices into the mesh list of the scene.
+    std::vector<uint32_t> m_VisibleMeshes;
+    uint32_t m_NumMeshes;
+    uint32_t m_NumVisibleMeshes;
+
+    bool m_MeshletCulling;
+    // Only valid during rendering.
+    bool m_CullMeshlets;
+    std::vector<uint32_t> m_VisibleMeshlets;
+
+    Graphics::DrawList m_DrawList;
+
+    // The currently bound state. Only valid during rendering.
+    const Graphics::Material* m_BoundMaterial;
+    const Graphics::Mesh* m_BoundMesh;
+
+    // Draws in the draw list that are rendered with a single (instanced) draw call.
+    struct DrawBatch
+    {
+        uint32_t FirstDraw;
+        uint32_t NumDraws;
+        uint32_t FirstInstance;
+    };
+
+    bool m_AutomaticInstancing;
+    std::vector<DrawBatch> m_DrawBatches;
+    // The index of the object data of every instance of the draws in the pass.
+    std::vector<uint32_t> m_InstanceObjects;
+    // The root parameter indices of the per-view constant buffer, instance parameters,
+    // object buffer and instance objects in the shader signature of the pipeline 
+    // (or -1 if the pipeline does not use the object buffer).
+    std::shared_ptr<Graphics::ShaderSignature> m_ObjectBufferSignature;
+    int32_t m_PerViewSlot;
+    int32_t m_InstanceParamsSlot;
+    int32_t m_ObjectsSlot;
+    int32_t m_InstanceObjectsSlot;
+    InstanceParamsCB m_BoundInstanceParams;
 };
\ No newline at end of file
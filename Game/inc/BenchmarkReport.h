@@ -0,0 +1,137 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file BenchmarkReport.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Machine-readable (JSON) benchmark reports and a statistical comparison
+ *  of two reports to detect performance regressions.
+ */
+
+
+#include <ProfilerVisitor.h>
+#include <Statistic.h>
+
+/**
+ * Collects the statistics of all profiler markers with recent profiling data.
+ * The report is written to a JSON file together with metadata about the run
+ * (technique, resolution, number of lights) and the system it was run on.
+ */
+class BenchmarkReport : public Core::ProfilerVisitor
+{
+public:
+    // Statistics of a marker. All times are in milliseconds.
+    struct MarkerStatistics
+    {
+        uint32_t NumSamples = 0;
+        double Mean = 0.0;
+        double StandardDeviation = 0.0;
+        double Min = 0.0;
+        double Max = 0.0;
+        double P50 = 0.0;
+        double P95 = 0.0;
+        double P99 = 0.0;
+        double P999 = 0.0;
+        // The (most recent) samples that are used for significance testing.
+        std::vector<double> Samples;
+    };
+
+    // Markers are identified by their path in the profiler tree (for example, "Root/Frame/Opaque Pass").
+    using MarkerMap = std::map<std::string, MarkerStatistics>;
+    using StringMap = std::map<std::string, std::string>;
+    using MetricMap = std::map<std::string, double>;
+
+    BenchmarkReport();
+
+    virtual void Visit( Graphics::Profiler& profiler ) override;
+    virtual void Visit( Graphics::ProfileNode& profileMarker ) override;
+
+    // Add a key/value pair that describes the run (for example, "technique").
+    void SetMetadata( const std::string& key, const std::string& value );
+    const StringMap& GetMetadata() const;
+
+    // Query the CPU, memory and operating system of this machine.
+    void AddSystemInformation();
+    const StringMap& GetSystemInformation() const;
+
+    // Add a metric of the run that is not a profiler marker (for example, the light index list fill ratio).
+    void SetMetric( const std::string& key, double value );
+    const MetricMap& GetMetrics() const;
+
+    const MarkerMap& GetCpuMarkers() const;
+    const MarkerMap& GetGpuMarkers() const;
+
+    bool Save( const fs::path& fileName ) const;
+    bool Load( const fs::path& fileName );
+
+private:
+    static MarkerStatistics GetMarkerStatistics( const Core::Statistic<double>& stat );
+
+    StringMap m_Metadata;
+    StringMap m_SystemInformation;
+    MetricMap m_Metrics;
+
+    MarkerMap m_CpuMarkers;
+    MarkerMap m_GpuMarkers;
+
+    // The profiling frame when stats are captured.
+    uint64_t m_Frame;
+};
+
+// The result of comparing a marker of two benchmark reports.
+struct BenchmarkComparison
+{
+    std::string Name;
+    bool IsGpu = false;
+    double BaselineMedian = 0.0;
+    double CandidateMedian = 0.0;
+    // The relative change of the median in percent (positive is slower).
+    double Change = 0.0;
+    // The two-sided p-value of the Mann-Whitney U test.
+    double PValue = 1.0;
+    // The median increased by more than the threshold and the difference is significant.
+    bool IsRegression = false;
+};
+
+/**
+ * Two-sided Mann-Whitney U test (normal approximation with tie correction).
+ * @returns The probability that the samples a and b are drawn from the same distribution.
+ */
+double MannWhitneyU( const std::vector<double>& a, const std::vector<double>& b );
+
+/**
+ * Compare the markers that occur in both reports.
+ * @param threshold The relative increase of the median (in percent) that is considered a regression.
+ * @param significance The p-value below which a difference is considered significant.
+ */
+std::vector<BenchmarkComparison> CompareBenchmarkReports( const BenchmarkReport& baseline, const BenchmarkReport& candidate, double threshold, double significance = 0.05 );
+
+/**
+ * Load two benchmark reports, compare them and log the markers that regressed.
+ * @returns The exit code of the --compare-reports command line argument
+ * (0 if nothing regressed, 1 if a marker regressed and -1 if a report could not be loaded).
+ */
+int CompareBenchmarkReportFiles( const fs::path& baselineFileName, const fs::path& candidateFileName, double threshold );
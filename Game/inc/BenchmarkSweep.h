@@ -0,0 +1,141 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file BenchmarkSweep.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Automated benchmark sweeps over light counts, resolutions, cluster
+ *  block sizes and rendering techniques along a scripted camera path.
+ */
+
+
+#include <Statistic.h>
+
+// A camera pose on the scripted camera path of a benchmark.
+struct BenchmarkCameraPose
+{
+    glm::vec3 Position = glm::vec3( 0 );
+    glm::quat Rotation;
+
+    template<class Archive>
+    void serialize( Archive& ar, const unsigned int version )
+    {
+        ar & BOOST_SERIALIZATION_NVP( Position );
+        ar & BOOST_SERIALIZATION_NVP( Rotation );
+    }
+};
+
+/**
+ * The settings of a benchmark sweep (stored in the configuration file).
+ * Every combination of light count, resolution, cluster block size and 
+ * technique is measured while the camera follows the camera path.
+ * An empty list uses the current setting of the application.
+ */
+struct BenchmarkSettings
+{
+    // The total number of (point and spot) lights.
+    std::vector<uint32_t> LightCounts;
+    std::vector<glm::uvec2> Resolutions;
+    // The size (in pixels) of a cluster in screen space.
+    std::vector<uint32_t> ClusterBlockSizes;
+    // The names of the rendering techniques (for example, "Clustered (Optimized)").
+    std::vector<std::string> Techniques;
+    // The camera is interpolated between the poses of the path. 
+    std::vector<BenchmarkCameraPose> CameraPath;
+    // The number of frames that are rendered (but not measured) after the settings change.
+    uint32_t WarmupFrames = 60;
+    // The number of frames that are measured. The camera path is traversed once in this many frames.
+    uint32_t MeasureFrames = 300;
+
+    template<class Archive>
+    void serialize( Archive& ar, const unsigned int version )
+    {
+        ar & BOOST_SERIALIZATION_NVP( LightCounts );
+        ar & BOOST_SERIALIZATION_NVP( Resolutions );
+        ar & BOOST_SERIALIZATION_NVP( ClusterBlockSizes );
+        ar & BOOST_SERIALIZATION_NVP( Techniques );
+        ar & BOOST_SERIALIZATION_NVP( CameraPath );
+        ar & BOOST_SERIALIZATION_NVP( WarmupFrames );
+        ar & BOOST_SERIALIZATION_NVP( MeasureFrames );
+    }
+};
+
+/**
+ * Enumerates the steps of a benchmark sweep and keeps track of the frame
+ * times of every step. The application applies the settings of each step,
+ * renders the warmup and measured frames and writes a report when a step
+ * is done (see UpdateBenchmarkSweep in main.cpp).
+ */
+class BenchmarkSweep
+{
+public:
+    struct Step
+    {
+        uint32_t NumLights = 0;
+        glm::uvec2 Resolution = glm::uvec2( 0 );
+        uint32_t ClusterBlockSize = 0;
+        std::string Technique;
+    };
+
+    /**
+     * @param settings The lists of settings to sweep.
+     * @param defaults The settings to use for empty lists.
+     * @param defaultCameraPose The camera pose to use if the camera path is empty.
+     */
+    BenchmarkSweep( const BenchmarkSettings& settings, const Step& defaults, const BenchmarkCameraPose& defaultCameraPose );
+
+    const BenchmarkSettings& GetSettings() const;
+    const std::vector<Step>& GetSteps() const;
+
+    // The camera pose for a measured frame in the range [0, MeasureFrames).
+    BenchmarkCameraPose GetCameraPose( uint32_t frame ) const;
+
+    // Record the frame time (in seconds) of a measured frame of the current step.
+    void AddFrameTime( double frameTime );
+    // Finish the current step. The frame times are added to the summary.
+    void FinishStep( const std::wstring& reportFileName );
+
+    // Write a CSV file with the frame times of all steps.
+    bool SaveSummary( const fs::path& fileName ) const;
+
+private:
+    struct StepResult
+    {
+        Step Parameters;
+        uint32_t NumFrames;
+        double Mean;
+        double P50;
+        double P95;
+        double P99;
+        std::wstring ReportFileName;
+    };
+
+    BenchmarkSettings m_Settings;
+    std::vector<Step> m_Steps;
+    std::vector<StepResult> m_Results;
+
+    Core::Statistic<double> m_FrameTimes;
+};
@@ -4,6 +4,9 @@
 #include <Graphics/SpotLight.h>
 #include <Graphics/DirectionalLight.h>
 
+#include "LightGenerator.h"
+#include "BenchmarkSweep.h"
+
 class ConfigurationSettings
 {
 public:
@@ -27,6 +30,10 @@ public:
     glm::quat   CameraRotation;
     float       CameraPivotDistance;
 
+    // If not empty, the lights are stored in a binary light set file instead of
+    // the configuration file. The path is relative to the configuration file.
+    std::wstring LightsFileName;
+
     // Lights
     std::vector<Graphics::PointLight> PointLights;
     std::vector<Graphics::SpotLight> SpotLights;
@@ -42,15 +49,33 @@ public:
     uint32_t        NumPointLights;
     uint32_t        NumSpotLights;
     uint32_t        NumDirectionalLights;
+    // The same seed always generates the same lights.
+    uint32_t        LightsSeed;
+    LightDistribution LightsDistribution;
+    // The number of hotspots of the clustered distribution.
+    uint32_t        NumLightClusters;
+    // The standard deviation of the lights around a hotspot (relative to the light bounds).
+    float           LightClusterRadius;
 
     float           LoadingProgressTotal;
 
+    // The maximum screen space error (in pixels) of the levels of detail
+    // of the meshes in the scene. 0 (the default) disables level of detail selection.
+    float           LODPixelError;
+
+    // The settings of the --benchmark command line argument.
+    BenchmarkSettings Benchmark;
+
     bool Load( const std::wstring& fileName );
     // Reload configuration settings from previously loaded file.
     bool Reload();
     bool Save( const std::wstring& fileName = L"" );
+    // Save a snapshot of the current settings on a background thread.
+    // The returned future becomes ready once the file has been replaced.
+    std::future<bool> SaveAsync( const std::wstring& fileName = L"" );
 
     std::vector<fs::path> GetAbsoluteSearchPaths() const;
+    fs::path GetAbsoluteLightsFilePath() const;
 
 protected:
 
@@ -67,4 +92,4 @@ private:
 
 #include "ConfigurationSettings.inl"
 
-BOOST_CLASS_VERSION( ConfigurationSettings, 5 );
\ No newline at end of file
+BOOST_CLASS_VERSION( ConfigurationSettings, 9 );
\ No newline at end of file
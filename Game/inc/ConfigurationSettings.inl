@@ -29,9 +29,19 @@ void ConfigurationSettings::serialize( Archive& ar, const unsigned int version )
     ar & BOOST_SERIALIZATION_NVP( CameraPosition );
     ar & BOOST_SERIALIZATION_NVP( CameraRotation );
     ar & BOOST_SERIALIZATION_NVP( CameraPivotDistance );
-    ar & BOOST_SERIALIZATION_NVP( PointLights );
-    ar & BOOST_SERIALIZATION_NVP( SpotLights );
-    ar & BOOST_SERIALIZATION_NVP( DirectionalLights );
+
+    if ( version > 5 )
+    {
+        ar & BOOST_SERIALIZATION_NVP( LightsFileName );
+    }
+
+    // Lights that are stored in a light set file are not stored in the configuration file.
+    if ( LightsFileName.empty() )
+    {
+        ar & BOOST_SERIALIZATION_NVP( PointLights );
+        ar & BOOST_SERIALIZATION_NVP( SpotLights );
+        ar & BOOST_SERIALIZATION_NVP( DirectionalLights );
+    }
 
     // Light generation properties.
     ar & BOOST_SERIALIZATION_NVP( LightsMinBounds );
@@ -48,4 +58,22 @@ void ConfigurationSettings::serialize( Archive& ar, const unsigned int version )
     {
         ar & BOOST_SERIALIZATION_NVP( LoadingProgressTotal );
     }
+
+    if ( version > 6 )
+    {
+        ar & BOOST_SERIALIZATION_NVP( LightsSeed );
+        ar & BOOST_SERIALIZATION_NVP( LightsDistribution );
+        ar & BOOST_SERIALIZATION_NVP( NumLightClusters );
+        ar & BOOST_SERIALIZATION_NVP( LightClusterRadius );
+    }
+
+    if ( version > 7 )
+    {
+        ar & BOOST_SERIALIZATION_NVP( Benchmark );
+    }
+
+    if ( version > 8 )
+    {
+        ar & BOOST_SERIALIZATION_NVP( LODPixelError );
+    }
 }
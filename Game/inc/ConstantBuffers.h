@@ -42,6 +42,22 @@ struct alignas( 16 ) PerObjectCB
     glm::mat4 InverseTransposeModelView;
 };
 
+// The view and projection matrices of a pass.
+// The per-object data of the scene meshes is stored in a
+// structured buffer that is shared by all passes (see BasePass).
+struct alignas( 16 ) PerViewCB
+{
+    glm::mat4 View;
+    glm::mat4 InverseView;
+    glm::mat4 Projection;
+    glm::mat4 ViewProjection;
+};
+
+struct alignas( 4 ) InstanceParamsCB
+{
+    uint32_t FirstInstance;     // The index of the first instance of the draw in the instance buffer.
+};
+
 struct alignas(4) LightCountsCB
 {
     uint32_t NumPointLights;
@@ -0,0 +1,131 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file FramePacingMonitor.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Frame time histogram and hitch detection. When a frame takes much longer than the
+ *  median frame time, the profiler markers of that frame are compared to their own
+ *  distribution to find the cause of the hitch.
+ */
+
+
+#include <ProfilerVisitor.h>
+#include <Statistic.h>
+
+#include <array>
+#include <deque>
+
+/**
+ * Keeps a histogram of the frame times and detects hitches: frames that take more than
+ * HitchThreshold times the median frame time. When a hitch is detected, the profiler
+ * markers that were recorded in the hitch frame are captured and ranked by how much
+ * they exceeded their own 95th percentile.
+ * Frame times must be added on the thread that pushes the profiler markers of the frame
+ * (the update thread) after the frame has finished.
+ */
+class FramePacingMonitor : public Core::ProfilerVisitor
+{
+public:
+    // The histogram has 1 ms bins. The last bin also counts all longer frames.
+    static const uint32_t NumHistogramBins = 100;
+    static constexpr double HistogramBinWidth = 1.0;
+    // No hitches are detected until the median frame time is known.
+    static const uint32_t MinFrames = 30;
+
+    // A profiler marker in a hitch frame. All times are in milliseconds.
+    struct HitchMarker
+    {
+        std::string Name;
+        double Time = 0.0;
+        double P50 = 0.0;
+        double P95 = 0.0;
+        // Time - P95 (negative if the marker did not exceed its 95th percentile).
+        double Excess = 0.0;
+        // The excess that is not explained by the excess of the child markers.
+        double SelfExcess = 0.0;
+    };
+
+    struct Hitch
+    {
+        uint64_t Frame = 0;
+        // Frame times are in milliseconds.
+        double FrameTime = 0.0;
+        double MedianFrameTime = 0.0;
+        // The markers that exceeded their 95th percentile come first, ordered by SelfExcess.
+        std::vector<HitchMarker> Markers;
+    };
+
+    using Histogram = std::array<uint64_t, NumHistogramBins>;
+
+    /**
+     * @param hitchThreshold A frame is a hitch if it takes more than hitchThreshold times the median frame time.
+     * @param maxHitches The number of hitches that are kept. Older hitches are discarded.
+     */
+    FramePacingMonitor( double hitchThreshold = 2.0, uint32_t maxHitches = 256 );
+
+    void SetHitchThreshold( double hitchThreshold );
+    double GetHitchThreshold() const;
+
+    /**
+     * Add the frame time (in seconds) of a frame.
+     * @returns true if the frame is a hitch.
+     */
+    bool AddFrame( uint64_t frame, double frameTime );
+
+    void Reset();
+
+    const Histogram& GetHistogram() const;
+    const Core::Statistic<double>& GetFrameTimes() const;
+    const std::deque<Hitch>& GetHitches() const;
+    uint64_t GetNumFrames() const;
+    // The number of hitches since the last reset (including discarded hitches).
+    uint64_t GetNumHitches() const;
+
+    // Write the histogram and the hitches to a JSON file.
+    bool SaveHitches( const fs::path& fileName ) const;
+    // Write the hitches to a file in the directory that is named after the current time 
+    // and the label (for example, the rendering technique).
+    // Returns the name of the file or an empty path if the file could not be written.
+    fs::path SaveHitchReport( const fs::path& directory, const std::string& label ) const;
+
+    virtual void Visit( Graphics::Profiler& profiler ) override;
+    virtual void Visit( Graphics::ProfileNode& profileMarker ) override;
+
+private:
+    double m_HitchThreshold;
+    uint32_t m_MaxHitches;
+
+    Histogram m_Histogram;
+    // Frame times (in seconds) used to compute the median.
+    Core::Statistic<double> m_FrameTimes;
+    uint64_t m_NumFrames;
+    uint64_t m_NumHitches;
+
+    std::deque<Hitch> m_Hitches;
+    // The hitch that is captured while visiting the profiler.
+    Hitch* m_CurrentHitch;
+};
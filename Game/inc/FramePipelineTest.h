@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file FramePipelineTest.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Exercise the frame pipeline with frames in flight without a device.
+ */
+
+
+
+/**
+ * Runs the update and render stages of Core::FramePipeline on separate threads
+ * (like ApplicationDX12 does with a latency greater than 0) without a device
+ * or a window and checks that:
+ * - Frames are rendered in the order they were updated.
+ * - The update stage never runs more than "latency" frames ahead.
+ * - Deferred functions run in frame order before the frame is rendered.
+ * - Every frame context is released exactly once, also when the latency changes.
+ * - Release functions can use the pipeline (they don't run while it is locked).
+ * - Closing the pipeline wakes up the update stage and renders the updated frames.
+ */
+class FramePipelineTest
+{
+public:
+    /**
+     * @param numFrames The number of frames that are run with every latency.
+     * @param maxLatency The latency is tested from 0 to maxLatency.
+     */
+    FramePipelineTest( uint32_t numFrames = 1000, uint32_t maxLatency = 3 );
+
+    // @returns true if all checks passed.
+    bool Run();
+
+private:
+    bool RunLatency( uint32_t latency, uint32_t newLatency );
+    bool RunClose();
+
+    uint32_t m_NumFrames;
+    uint32_t m_MaxLatency;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <SceneVisitor.h>
+
+namespace Graphics
+{
+    class Camera;
+}
+
+/**
+ * Visits all meshes in the scene and selects the level of detail
+ * of each mesh for the camera to count the number of triangles 
+ * that are submitted with and without levels of detail.
+ */
+class LODStatisticsVisitor : public Core::SceneVisitor
+{
+public:
+    LODStatisticsVisitor( const Graphics::Camera& camera, float maxPixelError );
+
+    virtual void Visit( Graphics::Scene& scene ) override;
+    virtual void Visit( Graphics::SceneNode& node ) override;
+    virtual void Visit( Graphics::Mesh& mesh ) override;
+
+    // The number of triangles when all meshes are rendered at LOD 0.
+    uint64_t GetNumTriangles() const;
+    // The number of triangles of the selected levels of detail.
+    uint64_t GetNumLODTriangles() const;
+
+private:
+    const Graphics::Camera& m_Camera;
+    float m_MaxPixelError;
+
+    // The world transform of the node that is currently visited.
+    glm::mat4 m_WorldTransform;
+
+    uint64_t m_NumTriangles;
+    uint64_t m_NumLODTriangles;
+};
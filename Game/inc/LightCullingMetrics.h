@@ -0,0 +1,149 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file LightCullingMetrics.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Statistics of the light culling pipelines (light counts per tile or cluster,
+ *  light index list usage, overflows and BVH traversal) and a registry that collects them.
+ */
+
+
+#include <Statistic.h>
+
+#include <array>
+
+/**
+ * The light culling statistics of a single frame.
+ * Cells are the tiles of the light grid (Forward+) or the unique clusters (clustered shading).
+ */
+struct LightCullingStatistics
+{
+    // The histogram bins are powers of two: bin 0 counts the cells without lights,
+    // bin i counts the cells with [2^(i-1), 2^i) lights and the last bin also counts
+    // all cells with more lights.
+    static const uint32_t NumHistogramBins = 13;
+
+    // The number of cells that lights were assigned to.
+    uint32_t NumCells = 0;
+    // The number of cells in the light grid.
+    uint32_t MaxCells = 0;
+    // The number of light indices that were written to the light index lists.
+    uint32_t NumPointLightIndices = 0;
+    uint32_t NumSpotLightIndices = 0;
+    // The number of light indices that fit in a light index list.
+    uint32_t LightIndexListCapacity = 0;
+    // Lights that were dropped because they did not fit in the (group shared) light list of a cell.
+    uint32_t NumOverflowedLights = 0;
+    // Lights that were dropped from the light lists for transparent geometry (Forward+ only).
+    uint32_t NumOverflowedTransparentLights = 0;
+    // BVH nodes whose child nodes were tested (only the optimized clustered technique uses a BVH).
+    uint32_t NumBVHNodesVisited = 0;
+    uint32_t MaxLightsPerCell = 0;
+    // The number of cells per number of lights in the cell.
+    std::array<uint32_t, NumHistogramBins> LightsPerCell = {};
+
+    // The average number of light indices per cell.
+    double GetAverageLightsPerCell() const;
+    // The usage of the fullest light index list. Light indices are lost if the fill ratio is more than 1.
+    double GetFillRatio() const;
+
+    static uint32_t GetHistogramBin( uint32_t numLights );
+    // A label for a histogram bin (for example "4-7").
+    static std::string GetHistogramBinName( uint32_t bin );
+};
+
+/**
+ * Collects the light culling statistics of the rendering techniques.
+ * Statistics are published per source (the name of the technique that produced them).
+ * The GUI and the exporters read the statistics from the registry so they do not
+ * depend on how the statistics are gathered (read back from the GPU or computed on the CPU).
+ */
+class LightCullingMetrics
+{
+public:
+    // The counters in the light culling statistics buffer that is written by the light culling shaders.
+    // These must match the LIGHT_CULLING_STATS_* indices in Include/Functions.hlsli.
+    enum Counter : uint32_t
+    {
+        NumCells,
+        NumPointLightIndices,
+        NumSpotLightIndices,
+        NumOverflowedLights,
+        NumOverflowedTransparentLights,
+        NumBVHNodesVisited,
+        MaxLightsPerCell,
+        Histogram,
+        NumCounters = Histogram + LightCullingStatistics::NumHistogramBins
+    };
+
+    // Metrics of a source that are tracked over time.
+    struct SourceMetrics
+    {
+        SourceMetrics( uint32_t numSamples );
+
+        LightCullingStatistics Latest;
+        uint64_t NumFrames;
+        // The sum of the histograms of all frames.
+        std::array<uint64_t, LightCullingStatistics::NumHistogramBins> LightsPerCell;
+
+        Core::Statistic<double> NumCells;
+        Core::Statistic<double> AverageLightsPerCell;
+        Core::Statistic<double> MaxLightsPerCell;
+        Core::Statistic<double> FillRatio;
+        Core::Statistic<double> NumOverflowedLights;
+        Core::Statistic<double> NumOverflowedTransparentLights;
+        Core::Statistic<double> NumBVHNodesVisited;
+    };
+
+    using SourceMap = std::map<std::string, SourceMetrics>;
+
+    /**
+     * @param numSamples The number of frames that are used to compute the statistics of the metrics.
+     */
+    LightCullingMetrics( uint32_t numSamples = 256 );
+
+    // Unpack the light culling statistics buffer (NumCounters values).
+    static LightCullingStatistics Unpack( const uint32_t* counters, uint32_t maxCells, uint32_t lightIndexListCapacity );
+
+    // Publish the statistics of a frame.
+    void Publish( const std::string& source, const LightCullingStatistics& stats );
+    void Reset();
+
+    // A copy of the metrics of all sources.
+    SourceMap GetSources() const;
+
+    // Write the metrics of all sources in the format of the profiler CSV files.
+    void WriteCSV( std::ostream& file ) const;
+    // Write the metrics and histograms of all sources to a JSON file.
+    bool Save( const fs::path& fileName ) const;
+
+private:
+    uint32_t m_NumSamples;
+    SourceMap m_Sources;
+
+    mutable std::mutex m_Mutex;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file LightGenerator.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Generate lights in parallel with reproducible spatial distributions.
+ */
+
+
+#include <Philox.h>
+
+namespace Graphics
+{
+    class SceneMeshList;
+}
+
+class ConfigurationSettings;
+
+enum class LightDistribution : uint32_t
+{
+    Uniform,        // Uniformly distributed in the light bounds.
+    PoissonDisk,    // Uniformly distributed in the light bounds but never closer to each other than a minimum distance.
+    Clustered,      // Normally distributed around a number of randomly placed hotspots.
+    Surface,        // Uniformly distributed on the surfaces of the scene meshes.
+    NumDistributions
+};
+
+/**
+ * Generates the properties of lights using a counter-based random number
+ * generator. The random numbers of a light only depend on the seed, the
+ * stream and the index of the light so lights are generated on multiple
+ * threads and the same seed always produces the same lights, regardless
+ * of the number of threads.
+ */
+class LightGenerator
+{
+public:
+    // Lights of different types use different streams so they don't share random numbers.
+    static const uint32_t PointLightStream = 0;
+    static const uint32_t SpotLightStream = 1;
+    static const uint32_t DirectionalLightStream = 2;
+
+    struct Sample
+    {
+        glm::vec4 PositionWS;
+        glm::vec4 DirectionWS;
+        float SpotAngle;
+        float Range;
+        // Hue (in degrees) and saturation of the color of the light (the value is always 1).
+        float Hue;
+        float Saturation;
+    };
+
+    // Called for every light that is generated. The function is called on multiple threads.
+    using SampleFunction = std::function<void( uint32_t index, const Sample& sample )>;
+
+    /**
+     * Create a generator for the light generation properties (seed, distribution,
+     * bounds, ranges, etc.) of the configuration.
+     * @param meshList The meshes that are used for the Surface distribution.
+     * If there are no meshes (with triangles), lights are distributed uniformly.
+     */
+    LightGenerator( const ConfigurationSettings& config, const Graphics::SceneMeshList* meshList = nullptr );
+
+    void Generate( uint32_t numLights, uint32_t stream, const SampleFunction& sampleFunction ) const;
+
+    LightDistribution GetDistribution() const;
+
+private:
+    Sample GenerateSample( uint32_t index, uint32_t stream, const std::vector<glm::vec3>& poissonDiskPositions ) const;
+
+    /**
+     * Dart throwing on a grid of cells that are small enough to contain at most one light.
+     * Cells are processed in 27 phases so that cells that are processed at the same time
+     * (on different threads) are too far apart to influence each other.
+     * @returns fewer positions than requested if the bounds are too small.
+     */
+    std::vector<glm::vec3> GeneratePoissonDisk( uint32_t numLights, uint32_t stream ) const;
+
+    // Build the cumulative distribution of the (world space) triangle areas of the meshes.
+    void BuildSurfaceDistribution( const Graphics::SceneMeshList& meshList );
+    void SampleSurface( const glm::vec4& u, glm::vec3& position, glm::vec3& normal ) const;
+
+    Core::Philox m_Random;
+    LightDistribution m_Distribution;
+
+    glm::vec3 m_MinBounds;
+    glm::vec3 m_MaxBounds;
+    float m_MinSpotAngle;
+    float m_MaxSpotAngle;
+    float m_MinRange;
+    float m_MaxRange;
+
+    std::vector<glm::vec3> m_ClusterCenters;
+    // The standard deviation of the lights around a cluster center.
+    glm::vec3 m_ClusterRadius;
+
+    // The distance lights are moved away from the surface.
+    float m_SurfaceOffset;
+    const Graphics::SceneMeshList* m_MeshList;
+    // The cumulative surface area of the mesh list entries.
+    std::vector<double> m_EntryCDF;
+    // The first triangle of every entry in the triangle distribution.
+    std::vector<uint32_t> m_EntryTriangles;
+    // The cumulative surface area of the triangles (per entry).
+    std::vector<float> m_TriangleCDF;
+};
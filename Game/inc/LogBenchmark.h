@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file LogBenchmark.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Measure the cost of logging a message and the wakeups of the idle log thread.
+ */
+
+
+
+/**
+ * Measures how long LOG_INFO takes on the calling thread (the log thread
+ * formats and writes the messages later) for different kinds of arguments, and
+ * counts how often the log thread wakes up while the application is idle.
+ * Messages are logged in batches that fit in the log buffer of the thread so
+ * that no messages are dropped.
+ */
+class LogBenchmark
+{
+public:
+    enum class Message
+    {
+        Literal,        // A string literal and a number.
+        LocalBuffer,    // A local character array (copied into the message).
+        String,         // A std::wstring (copied into the message).
+        NumMessages
+    };
+
+    struct Result
+    {
+        LogBenchmark::Message Message;
+        // Nanoseconds per LOG_INFO.
+        double Median;
+        double Min;
+        // Messages that were dropped because the log buffer was full (should be 0).
+        uint64_t NumDroppedMessages;
+    };
+
+    /**
+     * @param numMessages The number of messages that are logged in every iteration.
+     * @param numIterations The number of times every kind of message is measured.
+     * @param idleTime The time (in seconds) the log thread is left idle.
+     */
+    LogBenchmark( uint32_t numMessages = 1024, uint32_t numIterations = 5, double idleTime = 2.0 );
+
+    void Run();
+
+    const std::vector<Result>& GetResults() const;
+    // The number of times the log thread woke up while nothing was logged.
+    uint64_t GetNumIdleWakeups() const;
+
+    // Write the results to a CSV file.
+    bool Save( const fs::path& fileName ) const;
+
+    static const char* GetMessageName( Message message );
+
+private:
+    // @returns The time in nanoseconds per message.
+    double RunMessage( Message message ) const;
+
+    uint32_t m_NumMessages;
+    uint32_t m_NumIterations;
+    double m_IdleTime;
+    std::vector<Result> m_Results;
+    uint64_t m_NumIdleWakeups;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <SceneVisitor.h>
+#include <Graphics/Meshlet.h>
+
+namespace Graphics
+{
+    class Camera;
+}
+
+/**
+ * Visits all meshes in the scene and culls their meshlets against the
+ * view frustum of the camera (and against the meshlet normal cones) to 
+ * gather statistics on the number of triangles that can be culled for
+ * the current camera pose.
+ */
+class MeshletCullingVisitor : public Core::SceneVisitor
+{
+public:
+    MeshletCullingVisitor( const Graphics::Camera& camera );
+
+    virtual void Visit( Graphics::Scene& scene ) override;
+    virtual void Visit( Graphics::SceneNode& node ) override;
+    virtual void Visit( Graphics::Mesh& mesh ) override;
+
+    const Graphics::MeshletCullingStatistics& GetStatistics() const;
+
+private:
+    glm::mat4 m_ViewProjection;
+    glm::vec3 m_CameraPosition;
+
+    // The world transform of the node that is currently visited.
+    glm::mat4 m_WorldTransform;
+
+    Graphics::MeshletCullingStatistics m_Statistics;
+};
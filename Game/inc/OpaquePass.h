@@ -11,7 +11,7 @@ public:
     OpaquePass( std::shared_ptr<Graphics::Scene> scene, std::shared_ptr<Graphics::GraphicsPipelineState> pipeline, bool bUseMaterials = true, uint32_t instanceCount = 1, uint32_t firstInstance = 0 );
     virtual ~OpaquePass();
 
-    virtual void Visit( Graphics::Mesh& mesh );
+    virtual bool IsRendered( const Graphics::Material& material ) const override;
 protected:
 
 private:
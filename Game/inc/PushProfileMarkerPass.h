@@ -2,6 +2,8 @@
 
 #include "AbstractPass.h"
 
+#include <Graphics/Profiler.h>
+
 class PushProfileMarkerPass : public AbstractPass
 {
 public:
@@ -12,5 +14,6 @@ public:
 
 private:
 
-    std::wstring m_ProfilerMarker;
+    // The marker is interned once so pushing it doesn't hash the name every frame.
+    Graphics::ProfileMarker m_ProfilerMarker;
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file QueueBenchmark.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Measure the throughput of the thread safe queues under contention.
+ */
+
+
+
+#include <Statistic.h>
+
+/**
+ * Pushes values into a queue from 1 to 64 producer threads and pops them on a
+ * single consumer thread (like the log and streaming queues of the engine) and
+ * measures how many values per second go through every kind of queue.
+ */
+class QueueBenchmark
+{
+public:
+    enum class Backend
+    {
+        Mutex,              // Core::BoundedQueue (a std::queue protected by a mutex).
+        ThreadSafeQueue,    // Core::ThreadSafeQueue (unbounded, the consumer polls with TryPop).
+        MPMC,               // Core::MPMCQueue.
+        SPSC,               // Core::SPSCQueue (only with a single producer).
+        NumBackends
+    };
+
+    struct Result
+    {
+        QueueBenchmark::Backend Backend;
+        uint32_t NumProducers;
+        // In milliseconds.
+        double Median;
+        double Min;
+        // Millions of values per second (based on the median).
+        double Throughput;
+    };
+
+    /**
+     * @param numItems The number of values that go through the queue in every iteration.
+     * @param numIterations The number of times every queue is measured with every number of producers.
+     * @param capacity The capacity of the bounded queues.
+     */
+    QueueBenchmark( uint32_t numItems = 1u << 20, uint32_t numIterations = 10, size_t capacity = 1024 );
+
+    void Run();
+
+    const std::vector<Result>& GetResults() const;
+
+    // Write the results to a CSV file.
+    bool Save( const fs::path& fileName ) const;
+
+    static const char* GetBackendName( Backend backend );
+
+private:
+    // @returns The time in milliseconds.
+    double RunBackend( Backend backend, uint32_t numProducers ) const;
+
+    uint32_t m_NumItems;
+    uint32_t m_NumIterations;
+    size_t m_Capacity;
+    std::vector<Result> m_Results;
+};
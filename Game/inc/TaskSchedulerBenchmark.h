@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+ *  Copyright(c) 2015 Jeremiah van Oosten
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files(the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions :
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/**
+ *  @file TaskSchedulerBenchmark.h
+ *  @date October 18, 2026
+ *  @author jeremiah
+ *
+ *  @brief Compare the task scheduler to std::async and OpenMP on engine workloads.
+ */
+
+
+#include <Statistic.h>
+
+/**
+ * Runs CPU workloads that are representative for the engine (light generation,
+ * frustum culling and an unbalanced per-mesh workload) with different ways of
+ * running loops in parallel and measures how long every workload takes.
+ */
+class TaskSchedulerBenchmark
+{
+public:
+    enum class Backend
+    {
+        Serial,         // A single thread (the baseline for the speedup).
+        Async,          // One std::async task per hardware thread.
+        OpenMP,         // #pragma omp parallel for with dynamic scheduling (skipped if OpenMP is not enabled).
+        TaskScheduler,  // Core::ParallelFor.
+        NumBackends
+    };
+
+    // All times are in milliseconds.
+    struct Result
+    {
+        std::string Workload;
+        TaskSchedulerBenchmark::Backend Backend;
+        double Mean;
+        double Median;
+        double Min;
+        // Serial median / median.
+        double Speedup;
+    };
+
+    /**
+     * @param numItems The number of items (lights, spheres, meshes) of every workload.
+     * @param numIterations The number of times every workload is run with every backend.
+     */
+    TaskSchedulerBenchmark( uint32_t numItems = 1u << 20, uint32_t numIterations = 20 );
+
+    void Run();
+
+    const std::vector<Result>& GetResults() const;
+
+    // Write the results to a CSV file.
+    bool Save( const fs::path& fileName ) const;
+
+    static const char* GetBackendName( Backend backend );
+
+private:
+    using Workload = std::function<void( uint32_t first, uint32_t last )>;
+
+    // The grain size is used by the OpenMP and task scheduler backends (0 to let the task scheduler choose).
+    void RunWorkload( const std::string& name, uint32_t count, uint32_t grainSize, const Workload& workload );
+    static void RunBackend( Backend backend, uint32_t count, uint32_t grainSize, const Workload& workload );
+
+    uint32_t m_NumItems;
+    uint32_t m_NumIterations;
+    std::vector<Result> m_Results;
+};
@@ -1,13 +1,19 @@
 #include <GamePCH.h>
 
 #include <Graphics/Camera.h>
+#include <Graphics/Frustum.h>
 #include <Graphics/Scene.h>
+#include <Graphics/SceneMeshList.h>
 #include <Graphics/SceneNode.h>
 #include <Graphics/Mesh.h>
+#include <Graphics/MeshLOD.h>
+#include <Graphics/Meshlet.h>
 #include <Graphics/Material.h>
 #include <Graphics/GraphicsPipelineState.h>
+#include <Graphics/RasterizerState.h>
 #include <Graphics/GraphicsCommandBuffer.h>
 #include <Graphics/ShaderParameter.h>
+#include <Graphics/ShaderSignature.h>
 #include <Graphics/Texture.h>
 
 #include <ConstantBuffers.h>
@@ -16,12 +22,36 @@
 
 using namespace Graphics;
 
+// The shader registers of the object buffer arguments (see RootSignatures.hlsli).
+static const uint32_t gs_PerViewRegister = 11;
+static const uint32_t gs_InstanceParamsRegister = 10;
+static const uint32_t gs_ObjectsRegister = 33;
+static const uint32_t gs_InstanceObjectsRegister = 34;
+
+// The object data must match the ObjectData structure in the shaders.
+static_assert( sizeof( SceneMeshList::ObjectData ) == 128, "The size of the object data must match the ObjectData struct in Structures.hlsli." );
+
 BasePass::BasePass( std::shared_ptr<Graphics::Scene> scene, std::shared_ptr<Graphics::GraphicsPipelineState> pipeline, bool bUseMaterials, uint32_t instanceCount, uint32_t firstInstance )
     : m_Scene( scene )
+    , m_MeshList( nullptr )
     , m_Pipeline( pipeline )
     , m_UseMaterials( bUseMaterials )
     , m_InstanceCount( instanceCount )
     , m_FirstInstance( firstInstance )
+    , m_WorldTransform( 1 )
+    , m_FrustumCulling( true )
+    , m_NumMeshes( 0 )
+    , m_NumVisibleMeshes( 0 )
+    , m_MeshletCulling( true )
+    , m_CullMeshlets( false )
+    , m_BoundMaterial( nullptr )
+    , m_BoundMesh( nullptr )
+    , m_AutomaticInstancing( true )
+    , m_PerViewSlot( -1 )
+    , m_InstanceParamsSlot( -1 )
+    , m_ObjectsSlot( -1 )
+    , m_InstanceObjectsSlot( -1 )
+    , m_BoundInstanceParams{ 0 }
 {
 }
 
@@ -34,15 +64,73 @@ void BasePass::PreRender( Core::RenderEventArgs& e )
     m_pRenderEventArgs = &e;
     m_Camera = e.Camera;
     m_GraphicsCommandBuffer = e.GraphicsCommandBuffer;
+    m_BoundMaterial = nullptr;
+    m_BoundMesh = nullptr;
+    m_CullMeshlets = false;
+    m_DrawStatistics = DrawStatistics();
+    // The mesh list is (re)built at most once per frame and keeps the draw statistics of the frame.
+    m_MeshList = m_Scene ? &m_Scene->GetMeshList( e.FrameCounter ) : nullptr;
+
     if ( m_GraphicsCommandBuffer && m_Pipeline )
     {
         m_GraphicsCommandBuffer->BindGraphicsPipelineState( m_Pipeline );
+
+        std::shared_ptr<ShaderSignature> shaderSignature = m_Pipeline->GetShaderSignature();
+        if ( shaderSignature != m_ObjectBufferSignature )
+        {
+            m_ObjectBufferSignature = shaderSignature;
+            m_PerViewSlot = -1;
+            m_InstanceParamsSlot = -1;
+            m_ObjectsSlot = -1;
+            m_InstanceObjectsSlot = -1;
+
+            for ( uint32_t i = 0; shaderSignature && i < shaderSignature->GetNumParameters(); ++i )
+            {
+                const ShaderParameter& parameter = shaderSignature->GetParameter( i );
+                const int32_t slot = static_cast<int32_t>( i );
+                switch ( parameter.GetType() )
+                {
+                case ParameterType::ConstantBuffer:
+                    if ( parameter.GetBaseRegister() == gs_PerViewRegister ) m_PerViewSlot = slot;
+                    break;
+                case ParameterType::Constants:
+                    if ( parameter.GetBaseRegister() == gs_InstanceParamsRegister ) m_InstanceParamsSlot = slot;
+                    break;
+                case ParameterType::Buffer:
+                    if ( parameter.GetBaseRegister() == gs_ObjectsRegister ) m_ObjectsSlot = slot;
+                    else if ( parameter.GetBaseRegister() == gs_InstanceObjectsRegister ) m_InstanceObjectsSlot = slot;
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        // The instance parameters are only bound if they change.
+        if ( UsesObjectBuffer() )
+        {
+            m_BoundInstanceParams = { 0 };
+            m_GraphicsCommandBuffer->BindGraphics32BitConstants( m_InstanceParamsSlot, m_BoundInstanceParams );
+        }
     }
 }
 
 void BasePass::Render( Core::RenderEventArgs& e )
 {
-    if ( m_Scene )
+    if ( !m_MeshList )
+    {
+        return;
+    }
+
+    if ( m_Camera && ( UsesObjectBuffer() || m_FrustumCulling ) )
+    {
+        // Instanced meshes are positioned by the instance data, 
+        // so the bounding volumes of the meshes can't be used.
+        bool cull = m_FrustumCulling && m_InstanceCount == 1;
+
+        RenderDrawList( *m_MeshList, cull );
+    }
+    else
     {
         m_Scene->Accept( *this );
     }
@@ -50,9 +138,263 @@ void BasePass::Render( Core::RenderEventArgs& e )
 
 void BasePass::PostRender( Core::RenderEventArgs& e )
 {
+    if ( m_MeshList )
+    {
+        m_MeshList->AddDrawStatistics( m_DrawStatistics );
+    }
+
+    m_MeshList = nullptr;
     m_pRenderEventArgs = nullptr;
     m_Camera = nullptr;
     m_GraphicsCommandBuffer = nullptr;
+    m_BoundMaterial = nullptr;
+    m_BoundMesh = nullptr;
+    m_CullMeshlets = false;
+}
+
+bool BasePass::UsesObjectBuffer() const
+{
+    return m_PerViewSlot >= 0 && m_InstanceParamsSlot >= 0 && m_ObjectsSlot >= 0 && m_InstanceObjectsSlot >= 0;
+}
+
+void BasePass::RenderDrawList( const SceneMeshList& meshList, bool cull )
+{
+    m_NumMeshes = meshList.GetNumMeshes();
+    if ( cull )
+    {
+        Frustum frustum( m_Camera->GetProjectionMatrix() * m_Camera->GetViewMatrix() );
+        m_NumVisibleMeshes = meshList.Cull( frustum, m_VisibleMeshes );
+    }
+    else
+    {
+        m_VisibleMeshes.resize( m_NumMeshes );
+        for ( uint32_t i = 0; i < m_NumMeshes; ++i )
+        {
+            m_VisibleMeshes[i] = i;
+        }
+        m_NumVisibleMeshes = m_NumMeshes;
+    }
+
+    m_CullMeshlets = cull && m_MeshletCulling;
+
+    Visit( *m_Scene );
+
+    glm::vec3 cameraPosition = m_Camera->GetTranslation();
+
+    m_DrawList.Clear();
+    for ( uint32_t index : m_VisibleMeshes )
+    {
+        const SceneMeshList::Entry& entry = meshList.GetEntry( index );
+        Material* material = entry.Mesh->GetMaterial().get();
+
+        if ( material && IsRendered( *material ) )
+        {
+            uint32_t lod = 0;
+            std::shared_ptr<const MeshLODData> lods = entry.Mesh->GetLODs();
+            if ( lods )
+            {
+                lod = lods->SelectLOD( *m_Camera, entry.Node->GetWorldTransform(), m_pRenderEventArgs->LODPixelError );
+            }
+
+            // Passes that don't use materials (depth only) are only sorted by mesh and depth.
+            DrawList::Draw draw = { entry.Node, entry.Mesh, m_UseMaterials ? material : nullptr, lod, entry.ObjectIndex };
+            float depth = glm::distance( cameraPosition, ( entry.AABBMin + entry.AABBMax ) * 0.5f );
+
+            m_DrawList.Add( draw, depth );
+        }
+    }
+
+    m_DrawList.Sort();
+
+    if ( UsesObjectBuffer() )
+    {
+        RenderDrawBatches( meshList );
+        return;
+    }
+
+    // The pipeline uses the per-object constant buffer.
+    DrawStatistics& stats = m_DrawStatistics;
+    SceneNode* currentNode = nullptr;
+
+    for ( uint32_t i = 0; i < m_DrawList.GetNumDraws(); ++i )
+    {
+        const DrawList::Draw& draw = m_DrawList.GetDraw( i );
+
+        if ( draw.Node != currentNode )
+        {
+            currentNode = draw.Node;
+            Visit( *currentNode );
+            ++stats.NumObjectBinds;
+        }
+        else
+        {
+            ++stats.NumObjectBindsAvoided;
+        }
+
+        BindMaterial( draw.Mesh->GetMaterial() );
+        DrawMesh( *draw.Mesh, draw.LOD, m_InstanceCount, m_FirstInstance, draw.Node );
+    }
+}
+
+void BasePass::RenderDrawBatches( const SceneMeshList& meshList )
+{
+    DrawStatistics& stats = m_DrawStatistics;
+    const uint32_t numDraws = m_DrawList.GetNumDraws();
+
+    // Draws of the same mesh, material and level of detail are adjacent in the 
+    // sorted draw list (except for draws that are sorted back to front).
+    m_DrawBatches.clear();
+    m_InstanceObjects.clear();
+    for ( uint32_t first = 0; first < numDraws; )
+    {
+        const DrawList::Draw& draw = m_DrawList.GetDraw( first );
+
+        uint32_t last = first + 1;
+        while ( m_AutomaticInstancing && last < numDraws )
+        {
+            const DrawList::Draw& next = m_DrawList.GetDraw( last );
+            if ( next.Mesh != draw.Mesh || next.Material != draw.Material || next.LOD != draw.LOD )
+            {
+                break;
+            }
+            ++last;
+        }
+
+        DrawBatch batch = { first, last - first, static_cast<uint32_t>( m_InstanceObjects.size() ) };
+        if ( batch.NumDraws > 1 )
+        {
+            for ( uint32_t i = first; i < last; ++i )
+            {
+                m_InstanceObjects.push_back( m_DrawList.GetDraw( i ).ObjectIndex );
+            }
+
+            ++stats.NumInstancedDraws;
+            stats.NumMergedDraws += batch.NumDraws - 1;
+        }
+        else
+        {
+            // All the instances of a single draw use the object data of the draw.
+            m_InstanceObjects.insert( m_InstanceObjects.end(), m_InstanceCount, draw.ObjectIndex );
+        }
+        m_DrawBatches.push_back( batch );
+
+        first = last;
+    }
+
+    if ( m_DrawBatches.empty() )
+    {
+        return;
+    }
+
+    BindPerView();
+    BindObjectBuffer( meshList );
+    m_GraphicsCommandBuffer->BindGraphicsDynamicStructuredBuffer( m_InstanceObjectsSlot, m_InstanceObjects );
+
+    for ( const DrawBatch& batch : m_DrawBatches )
+    {
+        const DrawList::Draw& draw = m_DrawList.GetDraw( batch.FirstDraw );
+
+        BindInstanceParams( batch.FirstInstance );
+        BindMaterial( draw.Mesh->GetMaterial() );
+
+        if ( batch.NumDraws > 1 )
+        {
+            DrawMesh( *draw.Mesh, draw.LOD, batch.NumDraws, batch.FirstInstance );
+        }
+        else
+        {
+            DrawMesh( *draw.Mesh, draw.LOD, m_InstanceCount, m_FirstInstance, draw.Node );
+        }
+    }
+}
+
+void BasePass::BindPerView()
+{
+    PerViewCB perViewData;
+    perViewData.View = m_Camera->GetViewMatrix();
+    perViewData.InverseView = m_Camera->GetInverseViewMatrix();
+    perViewData.Projection = m_Camera->GetProjectionMatrix();
+    perViewData.ViewProjection = perViewData.Projection * perViewData.View;
+
+    m_GraphicsCommandBuffer->BindGraphicsDynamicConstantBuffer( m_PerViewSlot, perViewData );
+}
+
+void BasePass::BindObjectBuffer( const SceneMeshList& meshList )
+{
+    DrawStatistics& stats = m_DrawStatistics;
+
+    uint64_t gpuAddress = 0;
+    if ( meshList.UploadObjectData( *m_GraphicsCommandBuffer, gpuAddress ) )
+    {
+        ++stats.NumObjectBufferUploads;
+    }
+    else
+    {
+        ++stats.NumObjectBufferReuses;
+    }
+
+    m_GraphicsCommandBuffer->BindGraphicsDynamicBuffer( m_ObjectsSlot, gpuAddress );
+}
+
+void BasePass::BindInstanceParams( uint32_t firstInstance )
+{
+    if ( firstInstance != m_BoundInstanceParams.FirstInstance )
+    {
+        m_BoundInstanceParams.FirstInstance = firstInstance;
+        m_GraphicsCommandBuffer->BindGraphics32BitConstants( m_InstanceParamsSlot, m_BoundInstanceParams );
+    }
+}
+
+void BasePass::DrawMesh( Graphics::Mesh& mesh, uint32_t lod, uint32_t instanceCount, uint32_t firstInstance, const Graphics::SceneNode* node )
+{
+    DrawStatistics& stats = m_DrawStatistics;
+
+    // Meshlets are only built for LOD 0.
+    std::shared_ptr<const MeshletData> meshlets = mesh.GetMeshlets();
+    bool cullMeshlets = m_CullMeshlets && node && meshlets && lod == 0 && instanceCount == 1 && !meshlets->GetMeshlets().empty();
+
+    if ( cullMeshlets )
+    {
+        // Cull the meshlets in object space.
+        glm::mat4 worldTransform = node->GetWorldTransform();
+        Frustum frustum( m_Camera->GetProjectionMatrix() * m_Camera->GetViewMatrix() * worldTransform );
+        glm::vec3 cameraPosition = glm::vec3( node->GetInverseWorldTransform() * glm::vec4( m_Camera->GetTranslation(), 1.0f ) );
+        // Meshes that are rendered without back face culling (transparent meshes) can't be cone culled.
+        bool backfaceCulling = m_Pipeline->GetRasterizerState().GetCullMode() == CullMode::Back;
+
+        m_VisibleMeshlets.clear();
+        MeshletCullingStatistics meshletStats = meshlets->Cull( frustum, cameraPosition, &m_VisibleMeshlets, backfaceCulling );
+        stats.NumMeshletsCulled += meshletStats.NumFrustumCulled + meshletStats.NumBackfaceCulled;
+        stats.NumMeshletTrianglesCulled += meshletStats.NumTrianglesCulled;
+
+        if ( m_VisibleMeshlets.empty() )
+        {
+            return;
+        }
+    }
+
+    if ( &mesh != m_BoundMesh )
+    {
+        mesh.BindBuffers( *m_pRenderEventArgs );
+        m_BoundMesh = &mesh;
+        ++stats.NumBufferBinds;
+    }
+    else
+    {
+        ++stats.NumBufferBindsAvoided;
+    }
+
+    // SV_InstanceID does not include the first instance, the shader 
+    // reads the first instance from the instance parameters.
+    if ( cullMeshlets )
+    {
+        mesh.DrawMeshlets( *m_pRenderEventArgs, m_VisibleMeshlets, instanceCount, firstInstance );
+    }
+    else
+    {
+        mesh.DrawLOD( *m_pRenderEventArgs, lod, instanceCount, firstInstance );
+    }
+    ++stats.NumDraws;
 }
 
 // Inherited from Visitor
@@ -63,17 +405,19 @@ void BasePass::Visit( Graphics::Scene& scene )
 
 void BasePass::Visit( Graphics::SceneNode& node )
 {
+    m_WorldTransform = node.GetWorldTransform();
+
     if ( m_Camera && m_GraphicsCommandBuffer )
     {
         PerObjectCB perObjectData;
         // Update the constant buffer data for the node.
-        perObjectData.Model = node.GetWorldTransform();
+        perObjectData.Model = m_WorldTransform;
         perObjectData.View = m_Camera->GetViewMatrix();
         perObjectData.InverseView = m_Camera->GetInverseViewMatrix();
         perObjectData.Projection = m_Camera->GetProjectionMatrix();
         perObjectData.ModelView = perObjectData.View * perObjectData.Model;
         perObjectData.ModelViewProjection = perObjectData.Projection * perObjectData.ModelView;
-        perObjectData.InverseTransposeModel = glm::inverseTranspose( perObjectData.Model );
+        perObjectData.InverseTransposeModel = node.GetInverseTransposeWorldTransform();
         perObjectData.InverseTransposeModelView = perObjectData.View * perObjectData.InverseTransposeModel;
 
         m_GraphicsCommandBuffer->BindGraphicsDynamicConstantBuffer( 0, perObjectData );
@@ -84,11 +428,69 @@ void BasePass::Visit( Graphics::Mesh& mesh )
 {
     std::shared_ptr<Graphics::Material> pMaterial = mesh.GetMaterial();
 
-    if ( pMaterial )
+    if ( pMaterial && IsRendered( *pMaterial ) )
     {
         BindMaterial( pMaterial );
-        mesh.Render( *m_pRenderEventArgs, m_InstanceCount, m_FirstInstance );
+        RenderMesh( mesh );
+    }
+}
+
+bool BasePass::IsRendered( const Graphics::Material& material ) const
+{
+    return true;
+}
+
+void BasePass::RenderMesh( Graphics::Mesh& mesh )
+{
+    std::shared_ptr<const MeshLODData> lods = mesh.GetLODs();
+
+    uint32_t lod = 0;
+    if ( lods && m_Camera )
+    {
+        lod = lods->SelectLOD( *m_Camera, m_WorldTransform, m_pRenderEventArgs->LODPixelError );
     }
+
+    DrawMesh( mesh, lod, m_InstanceCount, m_FirstInstance );
+}
+
+void BasePass::SetFrustumCulling( bool frustumCulling )
+{
+    m_FrustumCulling = frustumCulling;
+}
+
+bool BasePass::GetFrustumCulling() const
+{
+    return m_FrustumCulling;
+}
+
+uint32_t BasePass::GetNumMeshes() const
+{
+    return m_NumMeshes;
+}
+
+uint32_t BasePass::GetNumVisibleMeshes() const
+{
+    return m_NumVisibleMeshes;
+}
+
+void BasePass::SetMeshletCulling( bool meshletCulling )
+{
+    m_MeshletCulling = meshletCulling;
+}
+
+bool BasePass::GetMeshletCulling() const
+{
+    return m_MeshletCulling;
+}
+
+void BasePass::SetAutomaticInstancing( bool automaticInstancing )
+{
+    m_AutomaticInstancing = automaticInstancing;
+}
+
+bool BasePass::GetAutomaticInstancing() const
+{
+    return m_AutomaticInstancing;
 }
 
 void BasePass::BindMaterial( std::shared_ptr<Graphics::Material> pMaterial )
@@ -97,6 +499,14 @@ void BasePass::BindMaterial( std::shared_ptr<Graphics::Material> pMaterial )
     {
         assert( m_GraphicsCommandBuffer );
 
+        if ( pMaterial.get() == m_BoundMaterial )
+        {
+            ++m_DrawStatistics.NumMaterialBindsAvoided;
+            return;
+        }
+        m_BoundMaterial = pMaterial.get();
+        ++m_DrawStatistics.NumMaterialBinds;
+
         const uint32_t numTextures = static_cast<uint32_t>( Material::TextureType::NumTypes );
         std::shared_ptr<Resource> textureArguments[numTextures];
         for ( uint32_t i = 0; i < numTextures; ++i )
@@ -0,0 +1,690 @@
+#include <GamePCH.h>
+
+#include <BenchmarkReport.h>
+
+#include <Graphics/Profiler.h>
+#include <LogManager.h>
+
+#include <iomanip>
+
+using namespace Graphics;
+
+namespace
+{
+    // A minimal JSON reader for the reports that are written by BenchmarkReport::Save.
+    struct JSONValue
+    {
+        enum class ValueType
+        {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object,
+        };
+
+        ValueType Type = ValueType::Null;
+        bool Bool = false;
+        double Number = 0.0;
+        std::string String;
+        // Elements of an array or the values of an object.
+        std::vector<JSONValue> Values;
+        // The keys of an object.
+        std::vector<std::string> Keys;
+
+        const JSONValue* Find( const std::string& key ) const
+        {
+            for ( size_t i = 0; i < Keys.size(); ++i )
+            {
+                if ( Keys[i] == key )
+                {
+                    return &Values[i];
+                }
+            }
+            return nullptr;
+        }
+
+        double GetNumber( const std::string& key ) const
+        {
+            const JSONValue* value = Find( key );
+            return ( value && value->Type == ValueType::Number ) ? value->Number : 0.0;
+        }
+    };
+
+    class JSONReader
+    {
+    public:
+        JSONReader( const std::string& text )
+            : m_Pos( text.c_str() )
+            , m_End( text.c_str() + text.size() )
+        {}
+
+        bool Parse( JSONValue& value )
+        {
+            if ( !ParseValue( value ) )
+            {
+                return false;
+            }
+
+            SkipWhitespace();
+            return m_Pos == m_End;
+        }
+
+    private:
+        void SkipWhitespace()
+        {
+            while ( m_Pos < m_End && std::isspace( static_cast<unsigned char>( *m_Pos ) ) )
+            {
+                ++m_Pos;
+            }
+        }
+
+        bool Consume( char c )
+        {
+            SkipWhitespace();
+            if ( m_Pos < m_End && *m_Pos == c )
+            {
+                ++m_Pos;
+                return true;
+            }
+            return false;
+        }
+
+        bool ConsumeLiteral( const char* literal )
+        {
+            size_t length = strlen( literal );
+            if ( static_cast<size_t>( m_End - m_Pos ) >= length && strncmp( m_Pos, literal, length ) == 0 )
+            {
+                m_Pos += length;
+                return true;
+            }
+            return false;
+        }
+
+        bool ParseString( std::string& string )
+        {
+            if ( !Consume( '"' ) )
+            {
+                return false;
+            }
+
+            while ( m_Pos < m_End && *m_Pos != '"' )
+            {
+                char c = *m_Pos++;
+                if ( c != '\\' )
+                {
+                    string += c;
+                    continue;
+                }
+
+                if ( m_Pos == m_End )
+                {
+                    return false;
+                }
+
+                switch ( *m_Pos++ )
+                {
+                case '"':  string += '"';  break;
+                case '\\': string += '\\'; break;
+                case '/':  string += '/';  break;
+                case 'b':  string += '\b'; break;
+                case 'f':  string += '\f'; break;
+                case 'n':  string += '\n'; break;
+                case 'r':  string += '\r'; break;
+                case 't':  string += '\t'; break;
+                case 'u':
+                {
+                    if ( m_End - m_Pos < 4 )
+                    {
+                        return false;
+                    }
+                    uint32_t codePoint = std::stoul( std::string( m_Pos, 4 ), nullptr, 16 );
+                    m_Pos += 4;
+                    string += Core::ConvertString( std::wstring( 1, static_cast<wchar_t>( codePoint ) ) );
+                }
+                break;
+                default:
+                    return false;
+                }
+            }
+
+            return Consume( '"' );
+        }
+
+        bool ParseValue( JSONValue& value )
+        {
+            SkipWhitespace();
+            if ( m_Pos == m_End )
+            {
+                return false;
+            }
+
+            switch ( *m_Pos )
+            {
+            case '{':
+            {
+                ++m_Pos;
+                value.Type = JSONValue::ValueType::Object;
+                if ( Consume( '}' ) )
+                {
+                    return true;
+                }
+                do
+                {
+                    std::string key;
+                    if ( !ParseString( key ) || !Consume( ':' ) )
+                    {
+                        return false;
+                    }
+                    value.Keys.push_back( key );
+                    value.Values.emplace_back();
+                    if ( !ParseValue( value.Values.back() ) )
+                    {
+                        return false;
+                    }
+                } while ( Consume( ',' ) );
+                return Consume( '}' );
+            }
+            case '[':
+            {
+                ++m_Pos;
+                value.Type = JSONValue::ValueType::Array;
+                if ( Consume( ']' ) )
+                {
+                    return true;
+                }
+                do
+                {
+                    value.Values.emplace_back();
+                    if ( !ParseValue( value.Values.back() ) )
+                    {
+                        return false;
+                    }
+                } while ( Consume( ',' ) );
+                return Consume( ']' );
+            }
+            case '"':
+                value.Type = JSONValue::ValueType::String;
+                return ParseString( value.String );
+            case 't':
+                value.Type = JSONValue::ValueType::Bool;
+                value.Bool = true;
+                return ConsumeLiteral( "true" );
+            case 'f':
+                value.Type = JSONValue::ValueType::Bool;
+                return ConsumeLiteral( "false" );
+            case 'n':
+                return ConsumeLiteral( "null" );
+            default:
+            {
+                char* end = nullptr;
+                value.Type = JSONValue::ValueType::Number;
+                value.Number = std::strtod( m_Pos, &end );
+                if ( end == m_Pos )
+                {
+                    return false;
+                }
+                m_Pos = end;
+                return true;
+            }
+            }
+        }
+
+        const char* m_Pos;
+        const char* m_End;
+    };
+
+    void WriteStringMap( std::ostream& file, const BenchmarkReport::StringMap& strings )
+    {
+        file << "{";
+        const char* separator = "\n";
+        for ( auto& entry : strings )
+        {
+            file << separator << "    \"" << Core::EscapeJSON( entry.first ) << "\": \"" << Core::EscapeJSON( entry.second ) << "\"";
+            separator = ",\n";
+        }
+        file << "\n  }";
+    }
+
+    void WriteMetrics( std::ostream& file, const BenchmarkReport::MetricMap& metrics )
+    {
+        file << "{";
+        const char* separator = "\n";
+        for ( auto& entry : metrics )
+        {
+            file << separator << "    \"" << Core::EscapeJSON( entry.first ) << "\": " << entry.second;
+            separator = ",\n";
+        }
+        file << "\n  }";
+    }
+
+    void WriteMarkers( std::ostream& file, const BenchmarkReport::MarkerMap& markers )
+    {
+        file << "{";
+        const char* separator = "\n";
+        for ( auto& marker : markers )
+        {
+            const BenchmarkReport::MarkerStatistics& stats = marker.second;
+
+            file << separator << "    \"" << Core::EscapeJSON( marker.first ) << "\": {"
+                << "\"numSamples\": " << stats.NumSamples
+                << ", \"mean\": " << stats.Mean
+                << ", \"stddev\": " << stats.StandardDeviation
+                << ", \"min\": " << stats.Min
+                << ", \"max\": " << stats.Max
+                << ", \"p50\": " << stats.P50
+                << ", \"p95\": " << stats.P95
+                << ", \"p99\": " << stats.P99
+                << ", \"p99.9\": " << stats.P999
+                << ", \"samples\": [";
+
+            for ( size_t i = 0; i < stats.Samples.size(); ++i )
+            {
+                file << ( i > 0 ? ", " : "" ) << stats.Samples[i];
+            }
+
+            file << "]}";
+            separator = ",\n";
+        }
+        file << "\n  }";
+    }
+
+    void ReadStringMap( const JSONValue* object, BenchmarkReport::StringMap& strings )
+    {
+        if ( !object )
+        {
+            return;
+        }
+
+        for ( size_t i = 0; i < object->Keys.size(); ++i )
+        {
+            strings[object->Keys[i]] = object->Values[i].String;
+        }
+    }
+
+    void ReadMetrics( const JSONValue* object, BenchmarkReport::MetricMap& metrics )
+    {
+        if ( !object )
+        {
+            return;
+        }
+
+        for ( size_t i = 0; i < object->Keys.size(); ++i )
+        {
+            metrics[object->Keys[i]] = object->Values[i].Number;
+        }
+    }
+
+    void ReadMarkers( const JSONValue* object, BenchmarkReport::MarkerMap& markers )
+    {
+        if ( !object )
+        {
+            return;
+        }
+
+        for ( size_t i = 0; i < object->Keys.size(); ++i )
+        {
+            const JSONValue& value = object->Values[i];
+            BenchmarkReport::MarkerStatistics& stats = markers[object->Keys[i]];
+
+            stats.NumSamples = static_cast<uint32_t>( value.GetNumber( "numSamples" ) );
+            stats.Mean = value.GetNumber( "mean" );
+            stats.StandardDeviation = value.GetNumber( "stddev" );
+            stats.Min = value.GetNumber( "min" );
+            stats.Max = value.GetNumber( "max" );
+            stats.P50 = value.GetNumber( "p50" );
+            stats.P95 = value.GetNumber( "p95" );
+            stats.P99 = value.GetNumber( "p99" );
+            stats.P999 = value.GetNumber( "p99.9" );
+
+            if ( const JSONValue* samples = value.Find( "samples" ) )
+            {
+                for ( const JSONValue& sample : samples->Values )
+                {
+                    stats.Samples.push_back( sample.Number );
+                }
+            }
+        }
+    }
+
+    double Median( std::vector<double> samples )
+    {
+        if ( samples.empty() )
+        {
+            return 0.0;
+        }
+
+        size_t middle = samples.size() / 2;
+        std::nth_element( samples.begin(), samples.begin() + middle, samples.end() );
+        double median = samples[middle];
+        if ( samples.size() % 2 == 0 )
+        {
+            median = ( median + *std::max_element( samples.begin(), samples.begin() + middle ) ) * 0.5;
+        }
+        return median;
+    }
+
+    void CompareMarkers( const BenchmarkReport::MarkerMap& baseline, const BenchmarkReport::MarkerMap& candidate, bool isGpu,
+                         double threshold, double significance, std::vector<BenchmarkComparison>& comparisons )
+    {
+        for ( auto& marker : baseline )
+        {
+            auto iter = candidate.find( marker.first );
+            if ( iter == candidate.end() )
+            {
+                continue;
+            }
+
+            const BenchmarkReport::MarkerStatistics& baselineStats = marker.second;
+            const BenchmarkReport::MarkerStatistics& candidateStats = iter->second;
+
+            BenchmarkComparison comparison;
+            comparison.Name = marker.first;
+            comparison.IsGpu = isGpu;
+            comparison.BaselineMedian = baselineStats.Samples.empty() ? baselineStats.P50 : Median( baselineStats.Samples );
+            comparison.CandidateMedian = candidateStats.Samples.empty() ? candidateStats.P50 : Median( candidateStats.Samples );
+            if ( comparison.BaselineMedian > 0.0 )
+            {
+                comparison.Change = ( comparison.CandidateMedian - comparison.BaselineMedian ) / comparison.BaselineMedian * 100.0;
+            }
+            comparison.PValue = MannWhitneyU( baselineStats.Samples, candidateStats.Samples );
+            comparison.IsRegression = comparison.Change > threshold && comparison.PValue < significance;
+
+            comparisons.push_back( comparison );
+        }
+    }
+}
+
+BenchmarkReport::BenchmarkReport()
+    : m_Frame( 0 )
+{}
+
+void BenchmarkReport::Visit( Profiler& profiler )
+{
+    // Check the current frame so we can restrict the report to
+    // markers with "recent" profiling data.
+    m_Frame = profiler.GetCurrentFrame();
+}
+
+void BenchmarkReport::Visit( ProfileNode& profileMarker )
+{
+    // Only report markers of the current technique (see PrintProfileDataVisitor).
+    if ( m_Frame - profileMarker.CpuFrame < 100 && profileMarker.CpuStats.GetNumSamples() > 0 )
+    {
+        m_CpuMarkers[profileMarker.GetPath()] = GetMarkerStatistics( profileMarker.CpuStats );
+    }
+
+    if ( m_Frame - profileMarker.GpuFrame < 100 && profileMarker.GpuStats.GetNumSamples() > 0 )
+    {
+        m_GpuMarkers[profileMarker.GetPath()] = GetMarkerStatistics( profileMarker.GpuStats );
+    }
+}
+
+BenchmarkReport::MarkerStatistics BenchmarkReport::GetMarkerStatistics( const Core::Statistic<double>& stat )
+{
+    // Profiling data is in seconds. n * 1000 to convert to milliseconds.
+    MarkerStatistics stats;
+    stats.NumSamples = stat.GetNumSamples();
+    stats.Mean = stat.GetAverage() * 1000.0;
+    stats.StandardDeviation = stat.GetStandardDeviation() * 1000.0;
+    stats.Min = stat.GetMin() * 1000.0;
+    stats.Max = stat.GetMax() * 1000.0;
+    stats.P50 = stat.GetPercentile( 50.0 ) * 1000.0;
+    stats.P95 = stat.GetPercentile( 95.0 ) * 1000.0;
+    stats.P99 = stat.GetPercentile( 99.0 ) * 1000.0;
+    stats.P999 = stat.GetPercentile( 99.9 ) * 1000.0;
+
+    const double* pData;
+    uint32_t maxSamples;
+    uint32_t offset;
+
+    std::tie( pData, maxSamples, offset ) = stat.GetSamples();
+
+    // Until the ring buffer is full, the samples start at the beginning of the array.
+    uint32_t numSamples = std::min( stats.NumSamples, maxSamples );
+    uint32_t first = stats.NumSamples < maxSamples ? 0 : offset;
+
+    stats.Samples.reserve( numSamples );
+    for ( uint32_t i = 0; i < numSamples; ++i )
+    {
+        stats.Samples.push_back( pData[( first + i ) % maxSamples] * 1000.0 );
+    }
+
+    return stats;
+}
+
+void BenchmarkReport::SetMetadata( const std::string& key, const std::string& value )
+{
+    m_Metadata[key] = value;
+}
+
+const BenchmarkReport::StringMap& BenchmarkReport::GetMetadata() const
+{
+    return m_Metadata;
+}
+
+void BenchmarkReport::AddSystemInformation()
+{
+    char processorName[256] = {};
+    DWORD size = sizeof( processorName );
+    if ( RegGetValueA( HKEY_LOCAL_MACHINE, "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", "ProcessorNameString", RRF_RT_REG_SZ, nullptr, processorName, &size ) == ERROR_SUCCESS )
+    {
+        m_SystemInformation["cpu"] = processorName;
+    }
+
+    m_SystemInformation["logicalProcessors"] = std::to_string( std::thread::hardware_concurrency() );
+
+    MEMORYSTATUSEX memoryStatus = { sizeof( MEMORYSTATUSEX ) };
+    if ( GlobalMemoryStatusEx( &memoryStatus ) )
+    {
+        m_SystemInformation["physicalMemoryMB"] = std::to_string( memoryStatus.ullTotalPhys / ( 1024 * 1024 ) );
+    }
+
+#if defined(_WIN64)
+    m_SystemInformation["platform"] = "x64";
+#elif defined(_WIN32)
+    m_SystemInformation["platform"] = "x86";
+#endif
+
+#if defined(_DEBUG)
+    m_SystemInformation["configuration"] = "Debug";
+#else
+    m_SystemInformation["configuration"] = "Release";
+#endif
+
+    m_SystemInformation["buildDate"] = __DATE__ " " __TIME__;
+}
+
+const BenchmarkReport::StringMap& BenchmarkReport::GetSystemInformation() const
+{
+    return m_SystemInformation;
+}
+
+void BenchmarkReport::SetMetric( const std::string& key, double value )
+{
+    m_Metrics[key] = value;
+}
+
+const BenchmarkReport::MetricMap& BenchmarkReport::GetMetrics() const
+{
+    return m_Metrics;
+}
+
+const BenchmarkReport::MarkerMap& BenchmarkReport::GetCpuMarkers() const
+{
+    return m_CpuMarkers;
+}
+
+const BenchmarkReport::MarkerMap& BenchmarkReport::GetGpuMarkers() const
+{
+    return m_GpuMarkers;
+}
+
+bool BenchmarkReport::Save( const fs::path& fileName ) const
+{
+    std::ofstream file( fileName, std::ios::out );
+    if ( !file.is_open() )
+    {
+        LOG_ERROR( "Failed to open benchmark report for writing: ", fileName.wstring() );
+        return false;
+    }
+
+    file << std::setprecision( 9 );
+    file << "{\n  \"version\": 1,\n  \"metadata\": ";
+    WriteStringMap( file, m_Metadata );
+    file << ",\n  \"system\": ";
+    WriteStringMap( file, m_SystemInformation );
+    file << ",\n  \"metrics\": ";
+    WriteMetrics( file, m_Metrics );
+    file << ",\n  \"cpu\": ";
+    WriteMarkers( file, m_CpuMarkers );
+    file << ",\n  \"gpu\": ";
+    WriteMarkers( file, m_GpuMarkers );
+    file << "\n}\n";
+
+    return file.good();
+}
+
+bool BenchmarkReport::Load( const fs::path& fileName )
+{
+    std::ifstream file( fileName, std::ios::in );
+    if ( !file.is_open() )
+    {
+        LOG_ERROR( "Failed to open benchmark report: ", fileName.wstring() );
+        return false;
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string text = stream.str();
+
+    JSONValue report;
+    JSONReader reader( text );
+    if ( !reader.Parse( report ) || report.Type != JSONValue::ValueType::Object )
+    {
+        LOG_ERROR( "Failed to parse benchmark report: ", fileName.wstring() );
+        return false;
+    }
+
+    m_Metadata.clear();
+    m_SystemInformation.clear();
+    m_Metrics.clear();
+    m_CpuMarkers.clear();
+    m_GpuMarkers.clear();
+
+    ReadStringMap( report.Find( "metadata" ), m_Metadata );
+    ReadStringMap( report.Find( "system" ), m_SystemInformation );
+    ReadMetrics( report.Find( "metrics" ), m_Metrics );
+    ReadMarkers( report.Find( "cpu" ), m_CpuMarkers );
+    ReadMarkers( report.Find( "gpu" ), m_GpuMarkers );
+
+    return true;
+}
+
+double MannWhitneyU( const std::vector<double>& a, const std::vector<double>& b )
+{
+    const size_t n1 = a.size();
+    const size_t n2 = b.size();
+    if ( n1 == 0 || n2 == 0 )
+    {
+        return 1.0;
+    }
+
+    // Rank the combined samples (ties get the average rank).
+    std::vector< std::pair<double, bool> > samples;
+    samples.reserve( n1 + n2 );
+    for ( double sample : a )
+    {
+        samples.emplace_back( sample, true );
+    }
+    for ( double sample : b )
+    {
+        samples.emplace_back( sample, false );
+    }
+    std::sort( samples.begin(), samples.end(), []( const auto& lhs, const auto& rhs ) { return lhs.first < rhs.first; } );
+
+    const double n = static_cast<double>( n1 + n2 );
+    double rankSumA = 0.0;
+    double tieCorrection = 0.0;
+    for ( size_t i = 0; i < samples.size(); )
+    {
+        size_t j = i;
+        while ( j < samples.size() && samples[j].first == samples[i].first )
+        {
+            ++j;
+        }
+
+        // Ranks are 1-based.
+        double rank = ( i + 1 + j ) * 0.5;
+        double numTies = static_cast<double>( j - i );
+        tieCorrection += numTies * numTies * numTies - numTies;
+
+        for ( size_t k = i; k < j; ++k )
+        {
+            if ( samples[k].second )
+            {
+                rankSumA += rank;
+            }
+        }
+
+        i = j;
+    }
+
+    const double u = rankSumA - n1 * ( n1 + 1 ) * 0.5;
+    const double mean = n1 * n2 * 0.5;
+    const double variance = n1 * n2 / 12.0 * ( ( n + 1.0 ) - tieCorrection / ( n * ( n - 1.0 ) ) );
+    if ( variance <= 0.0 )
+    {
+        return 1.0;
+    }
+
+    // Continuity corrected z-score.
+    double z = std::max( 0.0, std::abs( u - mean ) - 0.5 ) / std::sqrt( variance );
+
+    return std::erfc( z / std::sqrt( 2.0 ) );
+}
+
+std::vector<BenchmarkComparison> CompareBenchmarkReports( const BenchmarkReport& baseline, const BenchmarkReport& candidate, double threshold, double significance )
+{
+    std::vector<BenchmarkComparison> comparisons;
+
+    CompareMarkers( baseline.GetCpuMarkers(), candidate.GetCpuMarkers(), false, threshold, significance, comparisons );
+    CompareMarkers( baseline.GetGpuMarkers(), candidate.GetGpuMarkers(), true, threshold, significance, comparisons );
+
+    return comparisons;
+}
+
+int CompareBenchmarkReportFiles( const fs::path& baselineFileName, const fs::path& candidateFileName, double threshold )
+{
+    BenchmarkReport baseline;
+    BenchmarkReport candidate;
+    if ( !baseline.Load( baselineFileName ) || !candidate.Load( candidateFileName ) )
+    {
+        return -1;
+    }
+
+    LOG_INFO( "Comparing ", candidateFileName.wstring(), " to ", baselineFileName.wstring(), " (threshold ", threshold, "%)" );
+
+    uint32_t numRegressions = 0;
+    for ( const BenchmarkComparison& comparison : CompareBenchmarkReports( baseline, candidate, threshold ) )
+    {
+        char line[512];
+        sprintf_s( line, "%s %s (%s): %.3f ms -> %.3f ms (%+.1f%%, p = %.4f)", comparison.IsRegression ? "REGRESSION" : "ok        ",
+                   comparison.Name.c_str(), comparison.IsGpu ? "GPU" : "CPU", comparison.BaselineMedian, comparison.CandidateMedian, comparison.Change, comparison.PValue );
+
+        if ( comparison.IsRegression )
+        {
+            LOG_WARNING( line );
+            ++numRegressions;
+        }
+        else
+        {
+            LOG_INFO( line );
+        }
+    }
+
+    LOG_INFO( numRegressions, " regression(s) found." );
+
+    return numRegressions > 0 ? 1 : 0;
+}
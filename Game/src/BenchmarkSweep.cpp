@@ -0,0 +1,138 @@
+#include <GamePCH.h>
+
+#include <BenchmarkSweep.h>
+
+#include <LogManager.h>
+
+BenchmarkSweep::BenchmarkSweep( const BenchmarkSettings& settings, const Step& defaults, const BenchmarkCameraPose& defaultCameraPose )
+    : m_Settings( settings )
+    , m_FrameTimes( std::max( settings.MeasureFrames, 1u ), Core::StatisticMode::Window )
+{
+    if ( m_Settings.LightCounts.empty() )
+    {
+        m_Settings.LightCounts.push_back( defaults.NumLights );
+    }
+    if ( m_Settings.Resolutions.empty() )
+    {
+        m_Settings.Resolutions.push_back( defaults.Resolution );
+    }
+    if ( m_Settings.ClusterBlockSizes.empty() )
+    {
+        m_Settings.ClusterBlockSizes.push_back( defaults.ClusterBlockSize );
+    }
+    if ( m_Settings.Techniques.empty() )
+    {
+        m_Settings.Techniques.push_back( defaults.Technique );
+    }
+    if ( m_Settings.CameraPath.empty() )
+    {
+        m_Settings.CameraPath.push_back( defaultCameraPose );
+    }
+    m_Settings.MeasureFrames = std::max( m_Settings.MeasureFrames, 1u );
+
+    // Changing the number of lights is the most expensive, followed by
+    // changing the resolution so those change the least often.
+    for ( uint32_t numLights : m_Settings.LightCounts )
+    {
+        for ( const glm::uvec2& resolution : m_Settings.Resolutions )
+        {
+            for ( uint32_t clusterBlockSize : m_Settings.ClusterBlockSizes )
+            {
+                for ( const std::string& technique : m_Settings.Techniques )
+                {
+                    Step step;
+                    step.NumLights = numLights;
+                    step.Resolution = glm::max( resolution, glm::uvec2( 1 ) );
+                    step.ClusterBlockSize = std::max( clusterBlockSize, 1u );
+                    step.Technique = technique;
+
+                    m_Steps.push_back( step );
+                }
+            }
+        }
+    }
+}
+
+const BenchmarkSettings& BenchmarkSweep::GetSettings() const
+{
+    return m_Settings;
+}
+
+const std::vector<BenchmarkSweep::Step>& BenchmarkSweep::GetSteps() const
+{
+    return m_Steps;
+}
+
+BenchmarkCameraPose BenchmarkSweep::GetCameraPose( uint32_t frame ) const
+{
+    const std::vector<BenchmarkCameraPose>& path = m_Settings.CameraPath;
+    if ( path.size() == 1 || m_Settings.MeasureFrames < 2 )
+    {
+        return path.front();
+    }
+
+    // Traverse the path at a constant number of frames per segment.
+    float t = std::min( frame, m_Settings.MeasureFrames - 1 ) / static_cast<float>( m_Settings.MeasureFrames - 1 ) * ( path.size() - 1 );
+    size_t segment = std::min( static_cast<size_t>( t ), path.size() - 2 );
+    float f = t - segment;
+
+    BenchmarkCameraPose pose;
+    pose.Position = glm::mix( path[segment].Position, path[segment + 1].Position, f );
+    pose.Rotation = glm::slerp( path[segment].Rotation, path[segment + 1].Rotation, f );
+
+    return pose;
+}
+
+void BenchmarkSweep::AddFrameTime( double frameTime )
+{
+    m_FrameTimes.Sample( frameTime );
+}
+
+void BenchmarkSweep::FinishStep( const std::wstring& reportFileName )
+{
+    size_t stepIndex = m_Results.size();
+    if ( stepIndex >= m_Steps.size() )
+    {
+        LOG_WARNING( "All benchmark steps are already finished." );
+        return;
+    }
+
+    // Frame times are in seconds. n * 1000 to convert to milliseconds.
+    StepResult result;
+    result.Parameters = m_Steps[stepIndex];
+    result.NumFrames = m_FrameTimes.GetNumSamples();
+    result.Mean = m_FrameTimes.GetAverage() * 1000.0;
+    result.P50 = m_FrameTimes.GetPercentile( 50.0 ) * 1000.0;
+    result.P95 = m_FrameTimes.GetPercentile( 95.0 ) * 1000.0;
+    result.P99 = m_FrameTimes.GetPercentile( 99.0 ) * 1000.0;
+    result.ReportFileName = reportFileName;
+
+    LOG_INFO( "Benchmark step ", stepIndex + 1, "/", m_Steps.size(), " [", result.Parameters.Technique, ", ", result.Parameters.NumLights, " lights, ",
+              result.Parameters.Resolution.x, "x", result.Parameters.Resolution.y, ", block size ", result.Parameters.ClusterBlockSize, "]: ",
+              result.Mean, " ms (P99 ", result.P99, " ms)" );
+
+    m_Results.push_back( result );
+
+    m_FrameTimes = Core::Statistic<double>( m_Settings.MeasureFrames, Core::StatisticMode::Window );
+}
+
+bool BenchmarkSweep::SaveSummary( const fs::path& fileName ) const
+{
+    std::ofstream file( fileName, std::ios::out );
+    if ( !file.is_open() )
+    {
+        LOG_ERROR( "Failed to open benchmark summary for writing: ", fileName.wstring() );
+        return false;
+    }
+
+    file << "Technique, Lights, Width, Height, Cluster Block Size, Frames, Mean (ms), P50 (ms), P95 (ms), P99 (ms), Report" << std::endl;
+    for ( const StepResult& result : m_Results )
+    {
+        file << "\"" << result.Parameters.Technique << "\", " << result.Parameters.NumLights << ", "
+             << result.Parameters.Resolution.x << ", " << result.Parameters.Resolution.y << ", " << result.Parameters.ClusterBlockSize << ", "
+             << result.NumFrames << ", " << result.Mean << ", " << result.P50 << ", " << result.P95 << ", " << result.P99 << ", "
+             << "\"" << Core::ConvertString( result.ReportFileName ) << "\"" << std::endl;
+    }
+
+    return file.good();
+}
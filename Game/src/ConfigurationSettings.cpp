@@ -2,6 +2,9 @@
 
 #include <ConfigurationSettings.h>
 
+#include <Graphics/LightSet.h>
+#include <LogManager.h>
+
 using boost::serialization::make_nvp;
 
 ConfigurationSettings::ConfigurationSettings()
@@ -25,7 +28,12 @@ ConfigurationSettings::ConfigurationSettings()
     , NumPointLights( 50 )
     , NumSpotLights( 10 )
     , NumDirectionalLights( 1 )
+    , LightsSeed( 0 )
+    , LightsDistribution( LightDistribution::Uniform )
+    , NumLightClusters( 16 )
+    , LightClusterRadius( 0.05f )
     , LoadingProgressTotal( 100.0f )
+    , LODPixelError( 0.0f )
 {
     // Must contain at least 1 (default) light.
     PointLights.resize( 1 );
@@ -39,10 +47,27 @@ bool ConfigurationSettings::Load( const std::wstring& fileName )
     if ( configInputStream.is_open() )
     {
         m_Filename = fileName;
+        // Configuration files that were saved before light set files were
+        // introduced store the lights in the configuration file.
+        LightsFileName.clear();
 
         boost::archive::xml_iarchive ia( configInputStream );
         ia >> make_nvp( "ConfigurationSettings", *this );
 
+        if ( !LightsFileName.empty() )
+        {
+            Graphics::LightSet lightSet;
+            if ( !lightSet.Open( GetAbsoluteLightsFilePath() ) )
+            {
+                LOG_ERROR( "Failed to load light set ", GetAbsoluteLightsFilePath() );
+                return false;
+            }
+
+            lightSet.GetPointLights( PointLights );
+            lightSet.GetSpotLights( SpotLights );
+            lightSet.GetDirectionalLights( DirectionalLights );
+        }
+
         return true;
     }
 
@@ -66,16 +91,57 @@ bool ConfigurationSettings::Save( const std::wstring& fileName )
         m_Filename = fileName;
     }
 
-    std::ofstream configOutputStream( m_Filename, std::ios::out );
-    if ( configOutputStream.is_open() )
+    if ( !LightsFileName.empty() && !Graphics::LightSet::Save( GetAbsoluteLightsFilePath(), PointLights, SpotLights, DirectionalLights ) )
     {
+        LOG_ERROR( "Failed to save light set ", GetAbsoluteLightsFilePath() );
+        return false;
+    }
+
+    // Write to a temporary file first so that an interrupted save never
+    // leaves a truncated configuration file behind.
+    fs::path filePath( m_Filename );
+    fs::path tempPath( filePath );
+    tempPath += L".tmp";
+
+    {
+        std::ofstream configOutputStream( tempPath, std::ios::out );
+        if ( !configOutputStream.is_open() )
+        {
+            return false;
+        }
+
         boost::archive::xml_oarchive oa( configOutputStream );
         oa << make_nvp( "ConfigurationSettings", *this );
+    }
 
-        return true;
+    std::error_code ec;
+    fs::rename( tempPath, filePath, ec );
+    if ( ec )
+    {
+        LOG_ERROR( "Failed to replace ", filePath, ": ", ec.message() );
+        fs::remove( tempPath, ec );
+        return false;
     }
 
-    return false;
+    return true;
+}
+
+std::future<bool> ConfigurationSettings::SaveAsync( const std::wstring& fileName )
+{
+    if ( !fileName.empty() )
+    {
+        m_Filename = fileName;
+    }
+
+    // The lights are plain structs so copying the settings is a bulk copy
+    // that is cheap compared to serializing them. The background thread only
+    // ever sees the snapshot so the settings can be modified while saving.
+    auto snapshot = std::make_shared<ConfigurationSettings>( *this );
+
+    return std::async( std::launch::async, [snapshot]()
+    {
+        return snapshot->Save();
+    } );
 }
 
 std::vector<fs::path> ConfigurationSettings::GetAbsoluteSearchPaths() const
@@ -91,3 +157,8 @@ std::vector<fs::path> ConfigurationSettings::GetAbsoluteSearchPaths() const
 
     return absolutePaths;
 }
+
+fs::path ConfigurationSettings::GetAbsoluteLightsFilePath() const
+{
+    return fs::path( m_Filename ).parent_path() / LightsFileName;
+}
@@ -0,0 +1,231 @@
+#include <GamePCH.h>
+
+#include <FramePacingMonitor.h>
+
+#include <Graphics/Profiler.h>
+#include <LogManager.h>
+
+#include <iomanip>
+
+using namespace Graphics;
+
+namespace
+{
+    void WriteHitchMarker( std::ostream& file, const FramePacingMonitor::HitchMarker& marker )
+    {
+        file << "{ \"name\": \"" << Core::EscapeJSON( marker.Name ) << "\", \"time\": " << marker.Time
+             << ", \"p50\": " << marker.P50 << ", \"p95\": " << marker.P95
+             << ", \"excess\": " << marker.Excess << ", \"selfExcess\": " << marker.SelfExcess << " }";
+    }
+}
+
+FramePacingMonitor::FramePacingMonitor( double hitchThreshold, uint32_t maxHitches )
+    : m_HitchThreshold( hitchThreshold )
+    , m_MaxHitches( std::max( maxHitches, 1u ) )
+    , m_FrameTimes( 1024, Core::StatisticMode::Window )
+    , m_CurrentHitch( nullptr )
+{
+    Reset();
+}
+
+void FramePacingMonitor::SetHitchThreshold( double hitchThreshold )
+{
+    m_HitchThreshold = std::max( hitchThreshold, 1.0 );
+}
+
+double FramePacingMonitor::GetHitchThreshold() const
+{
+    return m_HitchThreshold;
+}
+
+bool FramePacingMonitor::AddFrame( uint64_t frame, double frameTime )
+{
+    // Frame times are in seconds. n * 1000 to convert to milliseconds.
+    double frameTimeMS = frameTime * 1000.0;
+    uint32_t bin = static_cast<uint32_t>( std::max( 0.0, frameTimeMS / HistogramBinWidth ) );
+    ++m_Histogram[std::min( bin, NumHistogramBins - 1 )];
+    ++m_NumFrames;
+
+    // The median does not include the current frame so a hitch can't raise its own threshold.
+    double median = m_FrameTimes.GetPercentile( 50.0 );
+    bool isHitch = m_FrameTimes.GetNumSamples() >= MinFrames && frameTime > median * m_HitchThreshold;
+
+    m_FrameTimes.Sample( frameTime );
+
+    if ( !isHitch )
+    {
+        return false;
+    }
+
+    ++m_NumHitches;
+    if ( m_Hitches.size() >= m_MaxHitches )
+    {
+        m_Hitches.pop_front();
+    }
+
+    m_Hitches.emplace_back();
+    Hitch& hitch = m_Hitches.back();
+    hitch.Frame = frame;
+    hitch.FrameTime = frameTimeMS;
+    hitch.MedianFrameTime = median * 1000.0;
+
+    m_CurrentHitch = &hitch;
+    Profiler::Get().Accept( *this );
+    m_CurrentHitch = nullptr;
+
+    // The excess of a marker includes the excess of its children.
+    // Subtract the excess of the children to find the markers that caused the hitch.
+    std::map<std::string, size_t> markerIndices;
+    for ( size_t i = 0; i < hitch.Markers.size(); ++i )
+    {
+        HitchMarker& marker = hitch.Markers[i];
+        marker.SelfExcess = std::max( marker.Excess, 0.0 );
+        markerIndices[marker.Name] = i;
+    }
+    for ( const HitchMarker& marker : hitch.Markers )
+    {
+        auto parent = markerIndices.find( marker.Name.substr( 0, marker.Name.find_last_of( '/' ) ) );
+        if ( parent != markerIndices.end() && parent->second != markerIndices[marker.Name] )
+        {
+            HitchMarker& parentMarker = hitch.Markers[parent->second];
+            parentMarker.SelfExcess = std::max( parentMarker.SelfExcess - std::max( marker.Excess, 0.0 ), 0.0 );
+        }
+    }
+
+    std::stable_sort( hitch.Markers.begin(), hitch.Markers.end(), []( const HitchMarker& a, const HitchMarker& b )
+    {
+        bool aExceeded = a.Excess > 0.0;
+        bool bExceeded = b.Excess > 0.0;
+        if ( aExceeded != bExceeded )
+        {
+            return aExceeded;
+        }
+        return aExceeded ? a.SelfExcess > b.SelfExcess : a.Time > b.Time;
+    } );
+
+    if ( !hitch.Markers.empty() && hitch.Markers.front().Excess > 0.0 )
+    {
+        const HitchMarker& cause = hitch.Markers.front();
+        LOG_WARNING( "Hitch in frame ", hitch.Frame, ": ", hitch.FrameTime, " ms (median ", hitch.MedianFrameTime, " ms). ",
+                     cause.Name, " took ", cause.Time, " ms (P95 ", cause.P95, " ms)." );
+    }
+    else
+    {
+        LOG_WARNING( "Hitch in frame ", hitch.Frame, ": ", hitch.FrameTime, " ms (median ", hitch.MedianFrameTime, " ms)." );
+    }
+
+    return true;
+}
+
+void FramePacingMonitor::Reset()
+{
+    m_Histogram.fill( 0 );
+    m_FrameTimes.Reset();
+    m_NumFrames = 0;
+    m_NumHitches = 0;
+    m_Hitches.clear();
+}
+
+const FramePacingMonitor::Histogram& FramePacingMonitor::GetHistogram() const
+{
+    return m_Histogram;
+}
+
+const Core::Statistic<double>& FramePacingMonitor::GetFrameTimes() const
+{
+    return m_FrameTimes;
+}
+
+const std::deque<FramePacingMonitor::Hitch>& FramePacingMonitor::GetHitches() const
+{
+    return m_Hitches;
+}
+
+uint64_t FramePacingMonitor::GetNumFrames() const
+{
+    return m_NumFrames;
+}
+
+uint64_t FramePacingMonitor::GetNumHitches() const
+{
+    return m_NumHitches;
+}
+
+void FramePacingMonitor::Visit( Profiler& profiler )
+{}
+
+void FramePacingMonitor::Visit( ProfileNode& profileMarker )
+{
+    if ( !m_CurrentHitch )
+    {
+        return;
+    }
+
+    double time = profileMarker.GetCpuFrameTime( m_CurrentHitch->Frame );
+    if ( time <= 0.0 )
+    {
+        return;
+    }
+
+    // Profiling data is in seconds. n * 1000 to convert to milliseconds.
+    HitchMarker marker;
+    marker.Name = profileMarker.GetPath();
+    marker.Time = time * 1000.0;
+    marker.P50 = profileMarker.CpuStats.GetPercentile( 50.0 ) * 1000.0;
+    marker.P95 = profileMarker.CpuStats.GetPercentile( 95.0 ) * 1000.0;
+    // Markers that are (almost) never recorded don't have a meaningful distribution.
+    // They are likely to cause a hitch (for example, resizing the window) so all of their time is excess.
+    marker.Excess = profileMarker.CpuStats.GetNumSamples() < MinFrames ? marker.Time : marker.Time - marker.P95;
+
+    m_CurrentHitch->Markers.push_back( marker );
+}
+
+bool FramePacingMonitor::SaveHitches( const fs::path& fileName ) const
+{
+    std::ofstream file( fileName, std::ios::out );
+    if ( !file.is_open() )
+    {
+        LOG_ERROR( "Failed to open hitch report for writing: ", fileName.wstring() );
+        return false;
+    }
+
+    file << std::setprecision( 9 );
+    file << "{\n  \"version\": 1,\n  \"hitchThreshold\": " << m_HitchThreshold << ",\n  \"numFrames\": " << m_NumFrames
+         << ",\n  \"numHitches\": " << m_NumHitches << ",\n  \"histogram\": { \"binWidth\": " << HistogramBinWidth << ", \"bins\": [";
+
+    const char* separator = "";
+    for ( uint64_t count : m_Histogram )
+    {
+        file << separator << count;
+        separator = ", ";
+    }
+    file << "] },\n  \"hitches\": [";
+
+    separator = "\n";
+    for ( const Hitch& hitch : m_Hitches )
+    {
+        file << separator << "    {\n      \"frame\": " << hitch.Frame << ",\n      \"frameTime\": " << hitch.FrameTime
+             << ",\n      \"medianFrameTime\": " << hitch.MedianFrameTime << ",\n      \"markers\": [";
+
+        const char* markerSeparator = "\n";
+        for ( const HitchMarker& marker : hitch.Markers )
+        {
+            file << markerSeparator << "        ";
+            WriteHitchMarker( file, marker );
+            markerSeparator = ",\n";
+        }
+        file << "\n      ]\n    }";
+        separator = ",\n";
+    }
+    file << "\n  ]\n}\n";
+
+    return file.good();
+}
+
+fs::path FramePacingMonitor::SaveHitchReport( const fs::path& directory, const std::string& label ) const
+{
+    fs::path fileName = directory / ( Core::GetTimestampString() + " [" + label + "] Hitches.json" );
+
+    fs::create_directories( directory );
+    return SaveHitches( fileName ) ? fileName : fs::path();
+}
@@ -0,0 +1,181 @@
+#include <GamePCH.h>
+
+#include <FramePipelineTest.h>
+
+#include <FramePipeline.h>
+#include <LogManager.h>
+
+using namespace Core;
+
+FramePipelineTest::FramePipelineTest( uint32_t numFrames, uint32_t maxLatency )
+    : m_NumFrames( std::max( numFrames, 2u ) )
+    , m_MaxLatency( maxLatency )
+{}
+
+bool FramePipelineTest::Run()
+{
+    LOG_INFO( "Frame pipeline test: ", m_NumFrames, " frames, latency 0 to ", m_MaxLatency, "." );
+
+    bool passed = true;
+    for ( uint32_t latency = 0; latency <= m_MaxLatency; ++latency )
+    {
+        // Change the latency halfway to resize the ring of frame contexts while frames are in flight.
+        passed = RunLatency( latency, ( latency + 1 ) % ( m_MaxLatency + 1 ) ) && passed;
+    }
+    passed = RunClose() && passed;
+
+    if ( passed )
+    {
+        LOG_INFO( "Frame pipeline test passed." );
+    }
+    else
+    {
+        LOG_ERROR( "Frame pipeline test failed." );
+    }
+
+    return passed;
+}
+
+bool FramePipelineTest::RunLatency( uint32_t latency, uint32_t newLatency )
+{
+    std::atomic_uint32_t numErrors( 0 );
+    auto check = [&numErrors, latency]( bool condition, const char* message )
+    {
+        if ( !condition && numErrors++ == 0 )
+        {
+            LOG_ERROR( "Frame pipeline test (latency ", latency, "): ", message );
+        }
+    };
+
+    std::atomic_uint64_t numRendered( 0 );
+    std::atomic_uint64_t numDeferred( 0 );
+    std::atomic_uint64_t numReleased( 0 );
+    FramePipeline::Statistics statistics;
+
+    {
+        FramePipeline pipeline( latency );
+
+        auto renderFrame = [&]()
+        {
+            // Runs the deferred functions of the frame.
+            FrameContext* frame = pipeline.BeginRender();
+            if ( !frame )
+            {
+                return false;
+            }
+
+            check( frame->GetFrameCounter() == numRendered, "A frame was rendered out of order." );
+            std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+            ++numRendered;
+
+            pipeline.EndRender( frame );
+            return true;
+        };
+
+        // Like ApplicationDX12, frames are only rendered on a separate thread if the latency is greater than 0.
+        std::thread renderThread;
+        if ( latency > 0 )
+        {
+            renderThread = std::thread( [&]()
+            {
+                while ( renderFrame() )
+                {}
+            } );
+        }
+
+        const uint32_t maxLatency = std::max( latency, newLatency );
+        for ( uint64_t i = 0; i < m_NumFrames; ++i )
+        {
+            if ( i == m_NumFrames / 2 )
+            {
+                pipeline.SetLatency( newLatency );
+            }
+
+            FrameContext* frame = pipeline.BeginUpdate();
+            if ( !frame )
+            {
+                check( false, "The pipeline was closed." );
+                break;
+            }
+
+            check( frame->GetFrameCounter() == i, "A frame was updated out of order." );
+            check( i - numRendered <= maxLatency, "The update stage ran too far ahead of the render stage." );
+
+            frame->Defer( [&, i]()
+            {
+                check( numRendered == i, "A deferred function ran out of order." );
+                ++numDeferred;
+            } );
+
+            // The frame contexts are released when the latency changes. Using
+            // the pipeline here would deadlock if the pipeline was locked.
+            frame->OnRelease( [&]()
+            {
+                pipeline.GetLatency();
+                ++numReleased;
+            } );
+
+            pipeline.EndUpdate( frame );
+
+            if ( !renderThread.joinable() )
+            {
+                renderFrame();
+            }
+        }
+
+        // The render thread renders the frames that were already updated and exits.
+        pipeline.Close();
+        if ( renderThread.joinable() )
+        {
+            renderThread.join();
+        }
+
+        statistics = pipeline.GetStatistics();
+    }
+
+    check( numRendered == m_NumFrames, "Not every frame was rendered." );
+    check( numDeferred == m_NumFrames, "Not every deferred function ran." );
+    check( numReleased == m_NumFrames, "Not every frame context was released exactly once." );
+
+    LOG_INFO( "Latency ", latency, " (", newLatency, " after ", m_NumFrames / 2, " frames): update stage waited ",
+              statistics.UpdateWaitTime * 1000.0, " ms, render stage waited ", statistics.RenderWaitTime * 1000.0, " ms." );
+
+    return numErrors == 0;
+}
+
+bool FramePipelineTest::RunClose()
+{
+    FramePipeline pipeline( 1 );
+
+    // Fill the ring of frame contexts so the next update has to wait for the render stage.
+    for ( uint32_t i = 0; i < pipeline.GetNumFrameContexts(); ++i )
+    {
+        pipeline.EndUpdate( pipeline.BeginUpdate() );
+    }
+
+    std::atomic_bool closed( false );
+    std::thread updateThread( [&]()
+    {
+        closed = pipeline.BeginUpdate() == nullptr;
+    } );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    pipeline.Close();
+    updateThread.join();
+
+    // The frames that were updated before the pipeline was closed are still rendered.
+    uint32_t numRendered = 0;
+    while ( FrameContext* frame = pipeline.BeginRender() )
+    {
+        pipeline.EndRender( frame );
+        ++numRendered;
+    }
+
+    bool passed = closed && numRendered == pipeline.GetNumFrameContexts();
+    if ( !passed )
+    {
+        LOG_ERROR( "Frame pipeline test: closing the pipeline did not wake up the update stage or did not render the updated frames." );
+    }
+
+    return passed;
+}
@@ -0,0 +1,48 @@
+#include <GamePCH.h>
+
+#include <LODStatisticsVisitor.h>
+
+#include <Graphics/Camera.h>
+#include <Graphics/Mesh.h>
+#include <Graphics/MeshLOD.h>
+#include <Graphics/SceneNode.h>
+
+using namespace Graphics;
+
+LODStatisticsVisitor::LODStatisticsVisitor( const Graphics::Camera& camera, float maxPixelError )
+    : m_Camera( camera )
+    , m_MaxPixelError( maxPixelError )
+    , m_WorldTransform( 1.0f )
+    , m_NumTriangles( 0 )
+    , m_NumLODTriangles( 0 )
+{}
+
+void LODStatisticsVisitor::Visit( Graphics::Scene& scene )
+{}
+
+void LODStatisticsVisitor::Visit( Graphics::SceneNode& node )
+{
+    m_WorldTransform = node.GetWorldTransform();
+}
+
+void LODStatisticsVisitor::Visit( Graphics::Mesh& mesh )
+{
+    std::shared_ptr<const MeshLODData> lods = mesh.GetLODs();
+    if ( lods )
+    {
+        uint32_t lod = lods->SelectLOD( m_Camera, m_WorldTransform, m_MaxPixelError );
+
+        m_NumTriangles += lods->GetLOD( 0 ).IndexCount / 3;
+        m_NumLODTriangles += lods->GetLOD( lod ).IndexCount / 3;
+    }
+}
+
+uint64_t LODStatisticsVisitor::GetNumTriangles() const
+{
+    return m_NumTriangles;
+}
+
+uint64_t LODStatisticsVisitor::GetNumLODTriangles() const
+{
+    return m_NumLODTriangles;
+}
@@ -0,0 +1,227 @@
+#include <GamePCH.h>
+
+#include <LightCullingMetrics.h>
+
+#include <LogManager.h>
+
+#include <iomanip>
+
+namespace
+{
+    void WriteCSVMetric( std::ostream& file, const std::string& name, const Core::Statistic<double>& stat )
+    {
+        const double* pData;
+        uint32_t maxSamples;
+        uint32_t offset;
+
+        std::tie( pData, maxSamples, offset ) = stat.GetSamples();
+
+        // Until the ring buffer is full, the samples start at the beginning of the array.
+        uint32_t numSamples = std::min( stat.GetNumSamples(), maxSamples );
+        uint32_t first = stat.GetNumSamples() < maxSamples ? 0 : offset;
+
+        // The first entry is the current average (see PrintProfileDataVisitor).
+        file << name << ", " << stat.GetAverage();
+        for ( uint32_t i = 0; i < numSamples; ++i )
+        {
+            file << ", " << pData[( first + i ) % maxSamples];
+        }
+        file << std::endl;
+    }
+
+    void WriteJSONMetric( std::ostream& file, const char* name, const Core::Statistic<double>& stat )
+    {
+        file << "      \"" << name << "\": { \"mean\": " << stat.GetAverage() << ", \"min\": " << stat.GetMin() << ", \"max\": " << stat.GetMax()
+             << ", \"p50\": " << stat.GetPercentile( 50.0 ) << ", \"p95\": " << stat.GetPercentile( 95.0 ) << " },\n";
+    }
+}
+
+double LightCullingStatistics::GetAverageLightsPerCell() const
+{
+    return NumCells > 0 ? static_cast<double>( NumPointLightIndices + NumSpotLightIndices ) / NumCells : 0.0;
+}
+
+double LightCullingStatistics::GetFillRatio() const
+{
+    return LightIndexListCapacity > 0 ? static_cast<double>( std::max( NumPointLightIndices, NumSpotLightIndices ) ) / LightIndexListCapacity : 0.0;
+}
+
+uint32_t LightCullingStatistics::GetHistogramBin( uint32_t numLights )
+{
+    uint32_t bin = 0;
+    while ( numLights > 0 && bin < NumHistogramBins - 1 )
+    {
+        numLights >>= 1;
+        ++bin;
+    }
+    return bin;
+}
+
+std::string LightCullingStatistics::GetHistogramBinName( uint32_t bin )
+{
+    if ( bin == 0 )
+    {
+        return "0";
+    }
+    if ( bin >= NumHistogramBins - 1 )
+    {
+        return std::to_string( 1u << ( NumHistogramBins - 2 ) ) + "+";
+    }
+    if ( bin == 1 )
+    {
+        return "1";
+    }
+
+    return std::to_string( 1u << ( bin - 1 ) ) + "-" + std::to_string( ( 1u << bin ) - 1 );
+}
+
+LightCullingMetrics::SourceMetrics::SourceMetrics( uint32_t numSamples )
+    : NumFrames( 0 )
+    , NumCells( numSamples, Core::StatisticMode::Window )
+    , AverageLightsPerCell( numSamples, Core::StatisticMode::Window )
+    , MaxLightsPerCell( numSamples, Core::StatisticMode::Window )
+    , FillRatio( numSamples, Core::StatisticMode::Window )
+    , NumOverflowedLights( numSamples, Core::StatisticMode::Window )
+    , NumOverflowedTransparentLights( numSamples, Core::StatisticMode::Window )
+    , NumBVHNodesVisited( numSamples, Core::StatisticMode::Window )
+{
+    LightsPerCell.fill( 0 );
+}
+
+LightCullingMetrics::LightCullingMetrics( uint32_t numSamples )
+    : m_NumSamples( std::max( numSamples, 1u ) )
+{}
+
+LightCullingStatistics LightCullingMetrics::Unpack( const uint32_t* counters, uint32_t maxCells, uint32_t lightIndexListCapacity )
+{
+    LightCullingStatistics stats;
+    stats.NumCells = counters[NumCells];
+    stats.MaxCells = maxCells;
+    stats.NumPointLightIndices = counters[NumPointLightIndices];
+    stats.NumSpotLightIndices = counters[NumSpotLightIndices];
+    stats.LightIndexListCapacity = lightIndexListCapacity;
+    stats.NumOverflowedLights = counters[NumOverflowedLights];
+    stats.NumOverflowedTransparentLights = counters[NumOverflowedTransparentLights];
+    stats.NumBVHNodesVisited = counters[NumBVHNodesVisited];
+    stats.MaxLightsPerCell = counters[MaxLightsPerCell];
+    for ( uint32_t i = 0; i < LightCullingStatistics::NumHistogramBins; ++i )
+    {
+        stats.LightsPerCell[i] = counters[Histogram + i];
+    }
+
+    return stats;
+}
+
+void LightCullingMetrics::Publish( const std::string& source, const LightCullingStatistics& stats )
+{
+    scoped_lock lock( m_Mutex );
+
+    auto iter = m_Sources.find( source );
+    if ( iter == m_Sources.end() )
+    {
+        iter = m_Sources.emplace( source, SourceMetrics( m_NumSamples ) ).first;
+    }
+
+    SourceMetrics& metrics = iter->second;
+
+    // Lights that are dropped cause lighting artifacts. Only warn when a source starts overflowing.
+    if ( stats.NumOverflowedLights > 0 && ( metrics.NumOverflowedLights.GetNumSamples() == 0 || metrics.NumOverflowedLights.GetMax() <= 0.0 ) )
+    {
+        LOG_WARNING( source, ": ", stats.NumOverflowedLights, " lights did not fit in the light lists (max. ", stats.MaxLightsPerCell, " lights per cell)." );
+    }
+    if ( stats.NumOverflowedTransparentLights > 0 && ( metrics.NumOverflowedTransparentLights.GetNumSamples() == 0 || metrics.NumOverflowedTransparentLights.GetMax() <= 0.0 ) )
+    {
+        LOG_WARNING( source, ": ", stats.NumOverflowedTransparentLights, " lights did not fit in the transparent light lists." );
+    }
+
+    metrics.Latest = stats;
+    ++metrics.NumFrames;
+    for ( uint32_t i = 0; i < LightCullingStatistics::NumHistogramBins; ++i )
+    {
+        metrics.LightsPerCell[i] += stats.LightsPerCell[i];
+    }
+
+    metrics.NumCells.Sample( stats.NumCells );
+    metrics.AverageLightsPerCell.Sample( stats.GetAverageLightsPerCell() );
+    metrics.MaxLightsPerCell.Sample( stats.MaxLightsPerCell );
+    metrics.FillRatio.Sample( stats.GetFillRatio() );
+    metrics.NumOverflowedLights.Sample( stats.NumOverflowedLights );
+    metrics.NumOverflowedTransparentLights.Sample( stats.NumOverflowedTransparentLights );
+    metrics.NumBVHNodesVisited.Sample( stats.NumBVHNodesVisited );
+}
+
+void LightCullingMetrics::Reset()
+{
+    scoped_lock lock( m_Mutex );
+    m_Sources.clear();
+}
+
+LightCullingMetrics::SourceMap LightCullingMetrics::GetSources() const
+{
+    scoped_lock lock( m_Mutex );
+    return m_Sources;
+}
+
+void LightCullingMetrics::WriteCSV( std::ostream& file ) const
+{
+    scoped_lock lock( m_Mutex );
+
+    for ( auto& source : m_Sources )
+    {
+        const SourceMetrics& metrics = source.second;
+        WriteCSVMetric( file, source.first + " Cells", metrics.NumCells );
+        WriteCSVMetric( file, source.first + " Lights per Cell", metrics.AverageLightsPerCell );
+        WriteCSVMetric( file, source.first + " Max Lights per Cell", metrics.MaxLightsPerCell );
+        WriteCSVMetric( file, source.first + " Fill Ratio", metrics.FillRatio );
+        WriteCSVMetric( file, source.first + " Overflowed Lights", metrics.NumOverflowedLights );
+        WriteCSVMetric( file, source.first + " Overflowed Transparent Lights", metrics.NumOverflowedTransparentLights );
+        WriteCSVMetric( file, source.first + " BVH Nodes Visited", metrics.NumBVHNodesVisited );
+    }
+}
+
+bool LightCullingMetrics::Save( const fs::path& fileName ) const
+{
+    std::ofstream file( fileName, std::ios::out );
+    if ( !file.is_open() )
+    {
+        LOG_ERROR( "Failed to open light culling metrics for writing: ", fileName.wstring() );
+        return false;
+    }
+
+    scoped_lock lock( m_Mutex );
+
+    file << std::setprecision( 9 );
+    file << "{\n  \"version\": 2,\n  \"sources\": {";
+
+    const char* separator = "\n";
+    for ( auto& source : m_Sources )
+    {
+        const SourceMetrics& metrics = source.second;
+        const LightCullingStatistics& latest = metrics.Latest;
+
+        file << separator << "    \"" << Core::EscapeJSON( source.first ) << "\": {\n";
+        file << "      \"numFrames\": " << metrics.NumFrames << ",\n";
+        file << "      \"maxCells\": " << latest.MaxCells << ",\n";
+        file << "      \"lightIndexListCapacity\": " << latest.LightIndexListCapacity << ",\n";
+        WriteJSONMetric( file, "cells", metrics.NumCells );
+        WriteJSONMetric( file, "lightsPerCell", metrics.AverageLightsPerCell );
+        WriteJSONMetric( file, "maxLightsPerCell", metrics.MaxLightsPerCell );
+        WriteJSONMetric( file, "fillRatio", metrics.FillRatio );
+        WriteJSONMetric( file, "overflowedLights", metrics.NumOverflowedLights );
+        WriteJSONMetric( file, "overflowedTransparentLights", metrics.NumOverflowedTransparentLights );
+        WriteJSONMetric( file, "bvhNodesVisited", metrics.NumBVHNodesVisited );
+
+        file << "      \"lightsPerCellHistogram\": [";
+        const char* binSeparator = "";
+        for ( uint32_t i = 0; i < LightCullingStatistics::NumHistogramBins; ++i )
+        {
+            file << binSeparator << "{ \"bin\": \"" << LightCullingStatistics::GetHistogramBinName( i ) << "\", \"cells\": " << metrics.LightsPerCell[i] << " }";
+            binSeparator = ", ";
+        }
+        file << "]\n    }";
+        separator = ",\n";
+    }
+    file << "\n  }\n}\n";
+
+    return file.good();
+}
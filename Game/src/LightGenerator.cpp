@@ -0,0 +1,400 @@
+#include <GamePCH.h>
+
+#include <LightGenerator.h>
+#include <ConfigurationSettings.h>
+
+#include <Graphics/BVH.h>
+#include <Graphics/Mesh.h>
+#include <Graphics/SceneMeshList.h>
+#include <LogManager.h>
+#include <TaskScheduler.h>
+
+using namespace Graphics;
+
+// The random numbers that are used for lights, cluster centers and Poisson disk
+// candidates are taken from different parts of the counter space.
+static const uint32_t gs_LightCounter = 0;
+static const uint32_t gs_ClusterCounter = 1;
+static const uint32_t gs_PoissonDiskCounter = 2;
+static const uint32_t gs_PoissonDiskOrderCounter = 3;
+
+// The number of lights (or Poisson disk cells) that is generated by a single task.
+static const uint32_t gs_LightsPerTask = 4096;
+
+// The fraction of the volume of the bounds that is covered by spheres with a diameter
+// of the Poisson disk distance. Random sequential placement saturates at about 0.38.
+static const float gs_PoissonDiskCoverage = 0.2f;
+// The maximum number of darts that are thrown at each cell.
+static const uint32_t gs_MaxPoissonDiskTrials = 16;
+// Limit the memory used by the Poisson disk grid.
+static const uint64_t gs_MaxPoissonDiskCells = 1ull << 28;
+// Marks an empty cell.
+static const uint16_t gs_EmptyCell = UINT16_MAX;
+
+static glm::vec3 UniformSphere( float u, float v )
+{
+    float z = 1.0f - 2.0f * u;
+    float r = glm::sqrt( glm::max( 0.0f, 1.0f - z * z ) );
+    float phi = glm::two_pi<float>() * v;
+    return glm::vec3( r * glm::cos( phi ), r * glm::sin( phi ), z );
+}
+
+// Box-Muller transform of 4 uniform random numbers to 4 normally distributed random numbers.
+static glm::vec4 Normal4( const glm::vec4& u )
+{
+    float r0 = glm::sqrt( -2.0f * glm::log( 1.0f - u.x ) );
+    float r1 = glm::sqrt( -2.0f * glm::log( 1.0f - u.z ) );
+    float phi0 = glm::two_pi<float>() * u.y;
+    float phi1 = glm::two_pi<float>() * u.w;
+    return glm::vec4( r0 * glm::cos( phi0 ), r0 * glm::sin( phi0 ), r1 * glm::cos( phi1 ), r1 * glm::sin( phi1 ) );
+}
+
+LightGenerator::LightGenerator( const ConfigurationSettings& config, const SceneMeshList* meshList )
+    : m_Random( config.LightsSeed )
+    , m_Distribution( config.LightsDistribution )
+    , m_MinBounds( config.LightsMinBounds )
+    , m_MaxBounds( config.LightsMaxBounds )
+    , m_MinSpotAngle( config.MinSpotAngle )
+    , m_MaxSpotAngle( config.MaxSpotAngle )
+    , m_MinRange( config.MinRange )
+    , m_MaxRange( config.MaxRange )
+    , m_ClusterRadius( config.LightClusterRadius * ( config.LightsMaxBounds - config.LightsMinBounds ) )
+    , m_SurfaceOffset( 0.001f * glm::length( config.LightsMaxBounds - config.LightsMinBounds ) )
+    , m_MeshList( meshList )
+{
+    if ( m_Distribution == LightDistribution::Clustered )
+    {
+        m_ClusterCenters.resize( std::max( 1u, config.NumLightClusters ) );
+        for ( uint32_t i = 0; i < m_ClusterCenters.size(); ++i )
+        {
+            glm::vec4 u = m_Random.Uniform4( i, 0, 0, gs_ClusterCounter );
+            m_ClusterCenters[i] = glm::mix( m_MinBounds, m_MaxBounds, glm::vec3( u ) );
+        }
+    }
+    else if ( m_Distribution == LightDistribution::Surface )
+    {
+        if ( m_MeshList )
+        {
+            BuildSurfaceDistribution( *m_MeshList );
+        }
+
+        if ( m_EntryCDF.empty() )
+        {
+            LOG_WARNING( "The scene has no surfaces to place lights on. Lights are distributed uniformly." );
+            m_Distribution = LightDistribution::Uniform;
+        }
+    }
+}
+
+LightDistribution LightGenerator::GetDistribution() const
+{
+    return m_Distribution;
+}
+
+void LightGenerator::Generate( uint32_t numLights, uint32_t stream, const SampleFunction& sampleFunction ) const
+{
+    std::vector<glm::vec3> poissonDiskPositions;
+    if ( m_Distribution == LightDistribution::PoissonDisk )
+    {
+        poissonDiskPositions = GeneratePoissonDisk( numLights, stream );
+    }
+
+    Core::ParallelFor( PROFILE_MARKER( "Generate Lights" ), 0, numLights, gs_LightsPerTask, [&]( uint32_t first, uint32_t last )
+    {
+        for ( uint32_t i = first; i < last; ++i )
+        {
+            sampleFunction( i, GenerateSample( i, stream, poissonDiskPositions ) );
+        }
+    } );
+}
+
+LightGenerator::Sample LightGenerator::GenerateSample( uint32_t index, uint32_t stream, const std::vector<glm::vec3>& poissonDiskPositions ) const
+{
+    glm::vec4 u0 = m_Random.Uniform4( index, stream, 0, gs_LightCounter );
+    glm::vec4 u1 = m_Random.Uniform4( index, stream, 1, gs_LightCounter );
+    glm::vec4 u2 = m_Random.Uniform4( index, stream, 2, gs_LightCounter );
+
+    Sample sample;
+    glm::vec3 position = glm::mix( m_MinBounds, m_MaxBounds, glm::vec3( u0 ) );
+    glm::vec3 direction = UniformSphere( u1.x, u1.y );
+
+    switch ( m_Distribution )
+    {
+    case LightDistribution::PoissonDisk:
+        // Lights that didn't fit in the bounds are distributed uniformly.
+        if ( index < poissonDiskPositions.size() )
+        {
+            position = poissonDiskPositions[index];
+        }
+        break;
+    case LightDistribution::Clustered:
+        {
+            uint32_t cluster = std::min( static_cast<uint32_t>( u0.w * m_ClusterCenters.size() ), static_cast<uint32_t>( m_ClusterCenters.size() - 1 ) );
+            glm::vec4 n = Normal4( m_Random.Uniform4( index, stream, 3, gs_LightCounter ) );
+            position = glm::clamp( m_ClusterCenters[cluster] + glm::vec3( n ) * m_ClusterRadius, m_MinBounds, m_MaxBounds );
+        }
+        break;
+    case LightDistribution::Surface:
+        {
+            glm::vec3 normal;
+            SampleSurface( u0, position, normal );
+            position += normal * m_SurfaceOffset;
+            // Lights point away from the surface.
+            if ( glm::dot( direction, normal ) < 0.0f )
+            {
+                direction = -direction;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    sample.PositionWS = glm::vec4( position, 1.0f );
+    sample.DirectionWS = glm::vec4( direction, 0.0f );
+    sample.SpotAngle = glm::mix( m_MinSpotAngle, m_MaxSpotAngle, u1.z );
+    sample.Range = glm::mix( m_MinRange, m_MaxRange, u1.w );
+    sample.Hue = u2.x * 360.0f;
+    sample.Saturation = u2.y;
+
+    return sample;
+}
+
+std::vector<glm::vec3> LightGenerator::GeneratePoissonDisk( uint32_t numLights, uint32_t stream ) const
+{
+    std::vector<glm::vec3> positions;
+
+    glm::vec3 extent = m_MaxBounds - m_MinBounds;
+    float volume = extent.x * extent.y * extent.z;
+    if ( numLights == 0 || volume <= 0.0f )
+    {
+        return positions;
+    }
+
+    // The minimum distance between lights so that the requested number of lights fits in the bounds.
+    float radius = glm::pow( 6.0f * gs_PoissonDiskCoverage * volume / ( glm::pi<float>() * numLights ), 1.0f / 3.0f );
+    // A cell with a diagonal equal to the radius can contain at most one light.
+    float cellSize = radius / glm::sqrt( 3.0f );
+    int numCellsX = std::max( 1, static_cast<int>( glm::ceil( extent.x / cellSize ) ) );
+    int numCellsY = std::max( 1, static_cast<int>( glm::ceil( extent.y / cellSize ) ) );
+    int numCellsZ = std::max( 1, static_cast<int>( glm::ceil( extent.z / cellSize ) ) );
+    uint64_t totalCells = static_cast<uint64_t>( numCellsX ) * numCellsY * numCellsZ;
+    if ( totalCells > gs_MaxPoissonDiskCells )
+    {
+        LOG_WARNING( "Too many lights for a Poisson disk distribution. Lights are distributed uniformly." );
+        return positions;
+    }
+
+    // The position of the light in each cell is stored relative to the cell (16 bits per component).
+    using CellOffset = std::array<uint16_t, 3>;
+    std::vector<CellOffset> cells( totalCells, CellOffset{ gs_EmptyCell, gs_EmptyCell, gs_EmptyCell } );
+
+    auto GetCellIndex = [&]( int x, int y, int z )
+    {
+        return ( static_cast<uint64_t>( z ) * numCellsY + y ) * numCellsX + x;
+    };
+
+    auto GetPosition = [&]( int x, int y, int z, const CellOffset& offset )
+    {
+        return m_MinBounds + glm::vec3( x + offset[0] / 65535.0f, y + offset[1] / 65535.0f, z + offset[2] / 65535.0f ) * cellSize;
+    };
+
+    // Cells within 2 cells of each other can contain lights that are closer than the radius.
+    // Cells of the same phase are 3 cells apart so they can be processed in parallel.
+    int numPhaseCellsX = ( numCellsX + 2 ) / 3;
+    int numPhaseCellsY = ( numCellsY + 2 ) / 3;
+    int numPhaseCellsZ = ( numCellsZ + 2 ) / 3;
+    uint32_t numCellsPerPhase = static_cast<uint32_t>( numPhaseCellsX * numPhaseCellsY * numPhaseCellsZ );
+    std::atomic<uint32_t> numPositions( 0 );
+
+    for ( uint32_t trial = 0; trial < gs_MaxPoissonDiskTrials && numPositions < numLights; ++trial )
+    {
+        for ( int phase = 0; phase < 27; ++phase )
+        {
+            Core::ParallelFor( PROFILE_MARKER( "Poisson Disk Phase" ), 0, numCellsPerPhase, gs_LightsPerTask, [&]( uint32_t first, uint32_t last )
+            {
+                uint32_t numAccepted = 0;
+                for ( uint32_t i = first; i < last; ++i )
+                {
+                    int x = phase % 3 + 3 * static_cast<int>( i % numPhaseCellsX );
+                    int y = ( phase / 3 ) % 3 + 3 * static_cast<int>( ( i / numPhaseCellsX ) % numPhaseCellsY );
+                    int z = phase / 9 + 3 * static_cast<int>( i / ( numPhaseCellsX * numPhaseCellsY ) );
+                    if ( x >= numCellsX || y >= numCellsY || z >= numCellsZ )
+                    {
+                        continue;
+                    }
+
+                    uint64_t cellIndex = GetCellIndex( x, y, z );
+                    if ( cells[cellIndex][0] != gs_EmptyCell )
+                    {
+                        continue;
+                    }
+
+                    Core::Philox::Counter r = m_Random( { static_cast<uint32_t>( cellIndex ), static_cast<uint32_t>( cellIndex >> 32 ), ( trial << 16 ) | stream, gs_PoissonDiskCounter } );
+                    // Keep the offset below the empty cell marker.
+                    CellOffset offset = { static_cast<uint16_t>( ( r[0] >> 16 ) % gs_EmptyCell ), static_cast<uint16_t>( ( r[1] >> 16 ) % gs_EmptyCell ), static_cast<uint16_t>( ( r[2] >> 16 ) % gs_EmptyCell ) };
+                    glm::vec3 position = GetPosition( x, y, z, offset );
+
+                    bool accept = true;
+                    for ( int nz = std::max( z - 2, 0 ); accept && nz <= std::min( z + 2, numCellsZ - 1 ); ++nz )
+                    {
+                        for ( int ny = std::max( y - 2, 0 ); accept && ny <= std::min( y + 2, numCellsY - 1 ); ++ny )
+                        {
+                            for ( int nx = std::max( x - 2, 0 ); accept && nx <= std::min( x + 2, numCellsX - 1 ); ++nx )
+                            {
+                                const CellOffset& neighborOffset = cells[GetCellIndex( nx, ny, nz )];
+                                if ( neighborOffset[0] != gs_EmptyCell )
+                                {
+                                    glm::vec3 d = position - GetPosition( nx, ny, nz, neighborOffset );
+                                    accept = glm::dot( d, d ) >= radius * radius;
+                                }
+                            }
+                        }
+                    }
+
+                    if ( accept )
+                    {
+                        cells[cellIndex] = offset;
+                        ++numAccepted;
+                    }
+                }
+                numPositions += numAccepted;
+            } );
+        }
+    }
+
+    // Select the lights from the occupied cells in a random (but reproducible) order.
+    std::vector< std::pair<uint64_t, uint64_t> > order;
+    order.reserve( numPositions );
+    for ( uint64_t cellIndex = 0; cellIndex < totalCells; ++cellIndex )
+    {
+        if ( cells[cellIndex][0] != gs_EmptyCell )
+        {
+            Core::Philox::Counter r = m_Random( { static_cast<uint32_t>( cellIndex ), static_cast<uint32_t>( cellIndex >> 32 ), stream, gs_PoissonDiskOrderCounter } );
+            order.emplace_back( ( static_cast<uint64_t>( r[0] ) << 32 ) | r[1], cellIndex );
+        }
+    }
+
+    size_t count = std::min<size_t>( numLights, order.size() );
+    std::partial_sort( order.begin(), order.begin() + count, order.end() );
+
+    positions.resize( count );
+    for ( size_t i = 0; i < count; ++i )
+    {
+        uint64_t cellIndex = order[i].second;
+        int x = static_cast<int>( cellIndex % numCellsX );
+        int y = static_cast<int>( ( cellIndex / numCellsX ) % numCellsY );
+        int z = static_cast<int>( cellIndex / ( static_cast<uint64_t>( numCellsX ) * numCellsY ) );
+        positions[i] = GetPosition( x, y, z, cells[cellIndex] );
+    }
+
+    if ( count < numLights )
+    {
+        LOG_WARNING( "Only ", count, " of ", numLights, " lights fit in the Poisson disk distribution. The remaining lights are distributed uniformly." );
+    }
+
+    return positions;
+}
+
+void LightGenerator::BuildSurfaceDistribution( const SceneMeshList& meshList )
+{
+    uint32_t numEntries = meshList.GetNumMeshes();
+    const std::vector<SceneMeshList::ObjectData>& objectData = meshList.GetObjectData();
+
+    // The triangle hierarchies of the meshes are built on first use.
+    Core::ParallelFor( PROFILE_MARKER( "Build Mesh BVHs" ), 0, numEntries, 1, [&]( uint32_t first, uint32_t last )
+    {
+        for ( uint32_t i = first; i < last; ++i )
+        {
+            meshList.GetEntry( i ).Mesh->GetBVH();
+        }
+    } );
+
+    // Allocate the triangles of every entry in the triangle distribution.
+    m_EntryTriangles.resize( numEntries + 1 );
+    uint32_t numTriangles = 0;
+    for ( uint32_t i = 0; i < numEntries; ++i )
+    {
+        m_EntryTriangles[i] = numTriangles;
+
+        std::shared_ptr<const BVH> bvh = meshList.GetEntry( i ).Mesh->GetBVH();
+        if ( bvh && bvh->GetPrimitiveType() == BVH::PrimitiveType::Triangles )
+        {
+            numTriangles += bvh->GetNumPrimitives();
+        }
+    }
+    m_EntryTriangles[numEntries] = numTriangles;
+    m_TriangleCDF.resize( numTriangles );
+
+    std::vector<double> entryAreas( numEntries, 0.0 );
+
+    // The meshes have very different numbers of triangles so every mesh is a separate task.
+    Core::ParallelFor( PROFILE_MARKER( "Triangle Areas" ), 0, numEntries, 1, [&]( uint32_t first, uint32_t last )
+    {
+        for ( uint32_t i = first; i < last; ++i )
+        {
+            const SceneMeshList::Entry& entry = meshList.GetEntry( i );
+            std::shared_ptr<const BVH> bvh = entry.Mesh->GetBVH();
+            if ( m_EntryTriangles[i] == m_EntryTriangles[i + 1] )
+            {
+                continue;
+            }
+
+            const glm::mat4& world = objectData[entry.ObjectIndex].World;
+            float* triangleCDF = &m_TriangleCDF[m_EntryTriangles[i]];
+            double area = 0.0;
+            for ( uint32_t t = 0; t < bvh->GetNumPrimitives(); ++t )
+            {
+                glm::vec3 v0, v1, v2;
+                bvh->GetTriangle( t, v0, v1, v2 );
+                v0 = glm::vec3( world * glm::vec4( v0, 1 ) );
+                v1 = glm::vec3( world * glm::vec4( v1, 1 ) );
+                v2 = glm::vec3( world * glm::vec4( v2, 1 ) );
+
+                area += 0.5 * glm::length( glm::cross( v1 - v0, v2 - v0 ) );
+                triangleCDF[t] = static_cast<float>( area );
+            }
+            entryAreas[i] = area;
+        }
+    } );
+
+    double totalArea = 0.0;
+    m_EntryCDF.resize( numEntries );
+    for ( uint32_t i = 0; i < numEntries; ++i )
+    {
+        totalArea += entryAreas[i];
+        m_EntryCDF[i] = totalArea;
+    }
+
+    if ( totalArea <= 0.0 )
+    {
+        m_EntryCDF.clear();
+        m_TriangleCDF.clear();
+    }
+}
+
+void LightGenerator::SampleSurface( const glm::vec4& u, glm::vec3& position, glm::vec3& normal ) const
+{
+    // Select an entry and a triangle proportional to the surface area.
+    uint32_t entryIndex = static_cast<uint32_t>( std::upper_bound( m_EntryCDF.begin(), m_EntryCDF.end(), u.x * m_EntryCDF.back() ) - m_EntryCDF.begin() );
+    entryIndex = std::min( entryIndex, static_cast<uint32_t>( m_EntryCDF.size() - 1 ) );
+
+    auto firstTriangle = m_TriangleCDF.begin() + m_EntryTriangles[entryIndex];
+    auto lastTriangle = m_TriangleCDF.begin() + m_EntryTriangles[entryIndex + 1];
+    uint32_t triangle = static_cast<uint32_t>( std::upper_bound( firstTriangle, lastTriangle, u.y * *( lastTriangle - 1 ) ) - firstTriangle );
+    triangle = std::min( triangle, static_cast<uint32_t>( lastTriangle - firstTriangle - 1 ) );
+
+    const SceneMeshList::Entry& entry = m_MeshList->GetEntry( entryIndex );
+    const glm::mat4& world = m_MeshList->GetObjectData()[entry.ObjectIndex].World;
+
+    glm::vec3 v0, v1, v2;
+    entry.Mesh->GetBVH()->GetTriangle( triangle, v0, v1, v2 );
+    v0 = glm::vec3( world * glm::vec4( v0, 1 ) );
+    v1 = glm::vec3( world * glm::vec4( v1, 1 ) );
+    v2 = glm::vec3( world * glm::vec4( v2, 1 ) );
+
+    // Uniformly distributed point on the triangle.
+    float su = glm::sqrt( u.z );
+    position = v0 * ( 1.0f - su ) + v1 * ( su * ( 1.0f - u.w ) ) + v2 * ( su * u.w );
+    normal = glm::normalize( glm::cross( v1 - v0, v2 - v0 ) );
+}
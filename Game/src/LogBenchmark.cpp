@@ -0,0 +1,150 @@
+#include <GamePCH.h>
+
+#include <LogBenchmark.h>
+
+#include <LogManager.h>
+
+#include <iomanip>
+
+using namespace std::chrono;
+
+// The number of messages that are logged before the log thread gets time to write them
+// (the log buffer of a thread holds 1024 messages).
+static const uint32_t gs_MessagesPerBatch = 256;
+// The time the log thread gets to write a batch of messages.
+static const milliseconds gs_BatchInterval( 20 );
+// Streams are flushed 250 ms after a write. Wait for that before measuring the idle log thread.
+static const milliseconds gs_FlushTime( 500 );
+
+LogBenchmark::LogBenchmark( uint32_t numMessages, uint32_t numIterations, double idleTime )
+    : m_NumMessages( std::max( numMessages, 1u ) )
+    , m_NumIterations( std::max( numIterations, 1u ) )
+    , m_IdleTime( std::max( idleTime, 0.0 ) )
+    , m_NumIdleWakeups( 0 )
+{}
+
+const char* LogBenchmark::GetMessageName( Message message )
+{
+    switch ( message )
+    {
+    case Message::Literal:
+        return "Literal";
+    case Message::LocalBuffer:
+        return "Local Buffer";
+    case Message::String:
+        return "String";
+    default:
+        return "Unknown";
+    }
+}
+
+void LogBenchmark::Run()
+{
+    m_Results.clear();
+
+    LOG_INFO( "Log benchmark: ", m_NumMessages, " messages, ", m_NumIterations, " iterations." );
+
+    for ( uint32_t i = 0; i < static_cast<uint32_t>( Message::NumMessages ); ++i )
+    {
+        Message message = static_cast<Message>( i );
+        uint64_t numDroppedMessages = Core::LogManager::GetNumDroppedMessages();
+
+        Core::Statistic<double> times( m_NumIterations, Core::StatisticMode::Window );
+        for ( uint32_t iteration = 0; iteration < m_NumIterations; ++iteration )
+        {
+            times.Sample( RunMessage( message ) );
+        }
+
+        Result result;
+        result.Message = message;
+        result.Median = times.GetPercentile( 50.0 );
+        result.Min = times.GetMin();
+        result.NumDroppedMessages = Core::LogManager::GetNumDroppedMessages() - numDroppedMessages;
+
+        LOG_INFO( GetMessageName( message ), ": ", result.Median, " ns per message (min. ", result.Min, " ns, ", result.NumDroppedMessages, " dropped)" );
+
+        m_Results.push_back( result );
+    }
+
+    // Nothing is logged while the log thread is idle.
+    std::this_thread::sleep_for( gs_FlushTime );
+    uint64_t numWakeups = Core::LogManager::GetNumWakeups();
+    std::this_thread::sleep_for( duration<double>( m_IdleTime ) );
+    m_NumIdleWakeups = Core::LogManager::GetNumWakeups() - numWakeups;
+
+    LOG_INFO( "Log thread woke up ", m_NumIdleWakeups, " times in ", m_IdleTime, " seconds without messages." );
+}
+
+double LogBenchmark::RunMessage( Message message ) const
+{
+    const char buffer[32] = "Local buffer";
+    const std::wstring name = L"std::wstring message";
+
+    double time = 0.0;
+    for ( uint32_t first = 0; first < m_NumMessages; first += gs_MessagesPerBatch )
+    {
+        const uint32_t last = std::min( first + gs_MessagesPerBatch, m_NumMessages );
+
+        // Let the log thread write the previous batch.
+        std::this_thread::sleep_for( gs_BatchInterval );
+        auto startTime = high_resolution_clock::now();
+
+        switch ( message )
+        {
+        case Message::Literal:
+            for ( uint32_t i = first; i < last; ++i )
+            {
+                LOG_INFO( "Log benchmark message ", i );
+            }
+            break;
+        case Message::LocalBuffer:
+            for ( uint32_t i = first; i < last; ++i )
+            {
+                LOG_INFO( buffer, " ", i );
+            }
+            break;
+        case Message::String:
+            for ( uint32_t i = first; i < last; ++i )
+            {
+                LOG_INFO( name, " ", i );
+            }
+            break;
+        default:
+            break;
+        }
+
+        time += duration<double, std::nano>( high_resolution_clock::now() - startTime ).count();
+    }
+
+    return time / m_NumMessages;
+}
+
+const std::vector<LogBenchmark::Result>& LogBenchmark::GetResults() const
+{
+    return m_Results;
+}
+
+uint64_t LogBenchmark::GetNumIdleWakeups() const
+{
+    return m_NumIdleWakeups;
+}
+
+bool LogBenchmark::Save( const fs::path& fileName ) const
+{
+    std::ofstream file( fileName, std::ios::out );
+    if ( !file.is_open() )
+    {
+        LOG_ERROR( "Failed to open log benchmark for writing: ", fileName.wstring() );
+        return false;
+    }
+
+    file << std::setprecision( 9 );
+    file << "Message, Median (ns), Min (ns), Dropped" << std::endl;
+    for ( const Result& result : m_Results )
+    {
+        file << GetMessageName( result.Message ) << ", " << result.Median << ", " << result.Min << ", " << result.NumDroppedMessages << std::endl;
+    }
+    file << "Idle wakeups (" << m_IdleTime << " s), " << m_NumIdleWakeups << std::endl;
+
+    return file.good();
+}
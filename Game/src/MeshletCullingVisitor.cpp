@@ -0,0 +1,47 @@
+#include <GamePCH.h>
+
+#include <MeshletCullingVisitor.h>
+
+#include <Graphics/Camera.h>
+#include <Graphics/Frustum.h>
+#include <Graphics/Material.h>
+#include <Graphics/Mesh.h>
+#include <Graphics/SceneNode.h>
+
+using namespace Graphics;
+
+MeshletCullingVisitor::MeshletCullingVisitor( const Graphics::Camera& camera )
+    : m_ViewProjection( camera.GetProjectionMatrix() * camera.GetViewMatrix() )
+    , m_CameraPosition( camera.GetInverseViewMatrix()[3] )
+    , m_WorldTransform( 1.0f )
+{}
+
+void MeshletCullingVisitor::Visit( Graphics::Scene& scene )
+{}
+
+void MeshletCullingVisitor::Visit( Graphics::SceneNode& node )
+{
+    m_WorldTransform = node.GetWorldTransform();
+}
+
+void MeshletCullingVisitor::Visit( Graphics::Mesh& mesh )
+{
+    std::shared_ptr<const MeshletData> meshlets = mesh.GetMeshlets();
+    if ( meshlets )
+    {
+        // Cull the meshlets in object space.
+        Frustum frustum( m_ViewProjection * m_WorldTransform );
+        glm::vec3 cameraPosition = glm::vec3( glm::inverse( m_WorldTransform ) * glm::vec4( m_CameraPosition, 1.0f ) );
+
+        // Transparent meshes are rendered without back face culling.
+        std::shared_ptr<Material> material = mesh.GetMaterial();
+        bool backfaceCulling = !material || !material->IsTransparent();
+
+        m_Statistics += meshlets->Cull( frustum, cameraPosition, nullptr, backfaceCulling );
+    }
+}
+
+const Graphics::MeshletCullingStatistics& MeshletCullingVisitor::GetStatistics() const
+{
+    return m_Statistics;
+}
@@ -12,12 +12,7 @@ OpaquePass::OpaquePass( std::shared_ptr<Graphics::Scene> scene, std::shared_ptr<
 OpaquePass::~OpaquePass()
 {}
 
-void OpaquePass::Visit( Graphics::Mesh& mesh )
+bool OpaquePass::IsRendered( const Graphics::Material& material ) const
 {
-    std::shared_ptr<Graphics::Material> pMaterial = mesh.GetMaterial();
-    if ( pMaterial && !pMaterial->IsTransparent() )
-    {
-        BindMaterial( pMaterial );
-        mesh.Render( *m_pRenderEventArgs, m_InstanceCount, m_FirstInstance );
-    }
-}
+    return !material.IsTransparent();
+}
\ No newline at end of file
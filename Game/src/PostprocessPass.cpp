@@ -12,7 +12,10 @@ PostprocessPass::PostprocessPass( std::shared_ptr<Graphics::Scene> scene, std::s
     : BasePass( scene, pipeline, bUseMaterial )
     , m_ProjectionMatrix( projectionMatrix )
     , m_Texture( texture )
-{}
+{
+    // The full screen quad is not rendered from the point of view of the camera.
+    SetFrustumCulling( false );
+}
 
 void PostprocessPass::Render( Core::RenderEventArgs& e )
 {
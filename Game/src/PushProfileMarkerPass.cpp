@@ -8,7 +8,7 @@
 using namespace Graphics;
 
 PushProfileMarkerPass::PushProfileMarkerPass( const std::wstring& profileMarker )
-    : m_ProfilerMarker( profileMarker )
+    : m_ProfilerMarker( Profiler::InternMarker( profileMarker ) )
 {}
 
 PushProfileMarkerPass::~PushProfileMarkerPass()
@@ -0,0 +1,200 @@
+#include <GamePCH.h>
+
+#include <QueueBenchmark.h>
+
+#include <BoundedQueue.h>
+#include <LockFreeQueue.h>
+#include <LogManager.h>
+#include <ThreadSafeQueue.h>
+
+#include <iomanip>
+
+using namespace std::chrono;
+
+static const uint32_t gs_MaxProducers = 64;
+
+namespace
+{
+    // Push the values [0, numItems) from numProducers threads and pop them on this thread.
+    // @returns The time in milliseconds.
+    template<typename PushFunc, typename PopFunc>
+    double Produce( uint32_t numProducers, uint32_t numItems, PushFunc push, PopFunc pop )
+    {
+        std::atomic_bool start( false );
+
+        // Start all producers before the clock starts.
+        std::vector<std::thread> producers;
+        for ( uint32_t producer = 0; producer < numProducers; ++producer )
+        {
+            producers.emplace_back( [&, producer]()
+            {
+                uint32_t first = static_cast<uint32_t>( static_cast<uint64_t>( numItems ) * producer / numProducers );
+                uint32_t last = static_cast<uint32_t>( static_cast<uint64_t>( numItems ) * ( producer + 1 ) / numProducers );
+
+                while ( !start )
+                {
+                    std::this_thread::yield();
+                }
+
+                for ( uint32_t i = first; i < last; ++i )
+                {
+                    push( i );
+                }
+            } );
+        }
+
+        auto startTime = high_resolution_clock::now();
+        start = true;
+
+        uint64_t sum = 0;
+        for ( uint32_t i = 0; i < numItems; ++i )
+        {
+            sum += pop();
+        }
+
+        double time = duration<double, std::milli>( high_resolution_clock::now() - startTime ).count();
+
+        for ( auto& producer : producers )
+        {
+            producer.join();
+        }
+
+        // Every value must be popped exactly once.
+        assert( sum == static_cast<uint64_t>( numItems ) * ( numItems - 1 ) / 2 );
+
+        return time;
+    }
+}
+
+QueueBenchmark::QueueBenchmark( uint32_t numItems, uint32_t numIterations, size_t capacity )
+    : m_NumItems( std::max( numItems, 1u ) )
+    , m_NumIterations( std::max( numIterations, 1u ) )
+    , m_Capacity( std::max<size_t>( capacity, 2 ) )
+{}
+
+const char* QueueBenchmark::GetBackendName( Backend backend )
+{
+    switch ( backend )
+    {
+    case Backend::Mutex:
+        return "Mutex";
+    case Backend::ThreadSafeQueue:
+        return "ThreadSafeQueue";
+    case Backend::MPMC:
+        return "MPMC";
+    case Backend::SPSC:
+        return "SPSC";
+    default:
+        return "Unknown";
+    }
+}
+
+void QueueBenchmark::Run()
+{
+    m_Results.clear();
+
+    LOG_INFO( "Queue benchmark: ", m_NumItems, " values, capacity ", m_Capacity, ", ", std::thread::hardware_concurrency(), " hardware threads." );
+
+    for ( uint32_t numProducers = 1; numProducers <= gs_MaxProducers; numProducers *= 2 )
+    {
+        for ( uint32_t i = 0; i < static_cast<uint32_t>( Backend::NumBackends ); ++i )
+        {
+            Backend backend = static_cast<Backend>( i );
+            if ( backend == Backend::SPSC && numProducers > 1 )
+            {
+                continue;
+            }
+
+            // Warm up the caches and the allocator.
+            RunBackend( backend, numProducers );
+
+            Core::Statistic<double> times( m_NumIterations, Core::StatisticMode::Window );
+            for ( uint32_t iteration = 0; iteration < m_NumIterations; ++iteration )
+            {
+                times.Sample( RunBackend( backend, numProducers ) );
+            }
+
+            Result result;
+            result.Backend = backend;
+            result.NumProducers = numProducers;
+            result.Median = times.GetPercentile( 50.0 );
+            result.Min = times.GetMin();
+            result.Throughput = result.Median > 0.0 ? m_NumItems / ( result.Median * 1000.0 ) : 0.0;
+
+            LOG_INFO( GetBackendName( backend ), " (", numProducers, " producers): ", result.Median, " ms (", result.Throughput, " M values/s)" );
+
+            m_Results.push_back( result );
+        }
+    }
+}
+
+double QueueBenchmark::RunBackend( Backend backend, uint32_t numProducers ) const
+{
+    switch ( backend )
+    {
+    case Backend::Mutex:
+    {
+        Core::BoundedQueue<uint32_t> queue( m_Capacity );
+        return Produce( numProducers, m_NumItems,
+                        [&]( uint32_t value ) { queue.Push( value ); },
+                        [&]() { uint32_t value = 0; queue.Pop( value ); return value; } );
+    }
+    case Backend::ThreadSafeQueue:
+    {
+        Core::ThreadSafeQueue<uint32_t> queue( m_Capacity );
+        return Produce( numProducers, m_NumItems,
+                        [&]( uint32_t value ) { queue.Push( value ); },
+                        [&]()
+                        {
+                            // This is how the engine drains its message queues.
+                            uint32_t value = 0;
+                            while ( !queue.TryPop( value ) )
+                            {
+                                std::this_thread::yield();
+                            }
+                            return value;
+                        } );
+    }
+    case Backend::MPMC:
+    {
+        Core::MPMCQueue<uint32_t> queue( m_Capacity );
+        return Produce( numProducers, m_NumItems,
+                        [&]( uint32_t value ) { queue.Push( value ); },
+                        [&]() { uint32_t value = 0; queue.Pop( value ); return value; } );
+    }
+    case Backend::SPSC:
+    {
+        Core::SPSCQueue<uint32_t> queue( m_Capacity );
+        return Produce( 1, m_NumItems,
+                        [&]( uint32_t value ) { queue.Push( value ); },
+                        [&]() { uint32_t value = 0; queue.Pop( value ); return value; } );
+    }
+    default:
+        return 0.0;
+    }
+}
+
+const std::vector<QueueBenchmark::Result>& QueueBenchmark::GetResults() const
+{
+    return m_Results;
+}
+
+bool QueueBenchmark::Save( const fs::path& fileName ) const
+{
+    std::ofstream file( fileName, std::ios::out );
+    if ( !file.is_open() )
+    {
+        LOG_ERROR( "Failed to open queue benchmark for writing: ", fileName.wstring() );
+        return false;
+    }
+
+    file << std::setprecision( 9 );
+    file << "Queue, Producers, Median (ms), Min (ms), Throughput (M values/s)" << std::endl;
+    for ( const Result& result : m_Results )
+    {
+        file << GetBackendName( result.Backend ) << ", " << result.NumProducers << ", " << result.Median << ", "
+             << result.Min << ", " << result.Throughput << std::endl;
+    }
+
+    return file.good();
+}
@@ -0,0 +1,245 @@
+#include <GamePCH.h>
+
+#include <TaskSchedulerBenchmark.h>
+
+#include <Graphics/Frustum.h>
+#include <Graphics/Profiler.h>
+#include <LogManager.h>
+#include <Philox.h>
+#include <TaskScheduler.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <iomanip>
+
+using namespace std::chrono;
+
+// The meshes of the unbalanced workload have between 1 and gs_MaxTrianglesPerMesh triangles.
+static const uint32_t gs_MaxTrianglesPerMesh = 4096;
+
+TaskSchedulerBenchmark::TaskSchedulerBenchmark( uint32_t numItems, uint32_t numIterations )
+    : m_NumItems( std::max( numItems, 1u ) )
+    , m_NumIterations( std::max( numIterations, 1u ) )
+{}
+
+const char* TaskSchedulerBenchmark::GetBackendName( Backend backend )
+{
+    switch ( backend )
+    {
+    case Backend::Serial:
+        return "Serial";
+    case Backend::Async:
+        return "std::async";
+    case Backend::OpenMP:
+        return "OpenMP";
+    case Backend::TaskScheduler:
+        return "Task Scheduler";
+    default:
+        return "Unknown";
+    }
+}
+
+void TaskSchedulerBenchmark::Run()
+{
+    m_Results.clear();
+
+    LOG_INFO( "Task scheduler benchmark: ", Core::TaskScheduler::Get().GetNumWorkers(), " workers, ", std::thread::hardware_concurrency(), " hardware threads." );
+#if !defined(_OPENMP)
+    LOG_WARNING( "OpenMP is not enabled. The OpenMP backend is skipped." );
+#endif
+
+    const Core::Philox random( 0x5EED );
+
+    // Light generation: cheap and uniform work per item (see LightGenerator).
+    {
+        std::vector<glm::vec4> positions( m_NumItems );
+        std::vector<glm::vec4> colors( m_NumItems );
+
+        RunWorkload( "Light Generation", m_NumItems, 4096, [&]( uint32_t first, uint32_t last )
+        {
+            for ( uint32_t i = first; i < last; ++i )
+            {
+                glm::vec4 u = random.Uniform4( i );
+                glm::vec4 v = random.Uniform4( i, 1 );
+                positions[i] = glm::vec4( glm::mix( glm::vec3( -100.0f ), glm::vec3( 100.0f ), glm::vec3( u ) ), glm::mix( 1.0f, 10.0f, u.w ) );
+
+                float hue = glm::two_pi<float>() * v.x;
+                colors[i] = glm::vec4( glm::vec3( glm::cos( hue ), glm::cos( hue - 2.0944f ), glm::cos( hue + 2.0944f ) ) * 0.5f + 0.5f, 1.0f );
+            }
+        } );
+    }
+
+    // Frustum culling: memory bound work per item (see SceneMeshList::Cull).
+    {
+        std::vector<glm::vec4> spheres( m_NumItems );
+        for ( uint32_t i = 0; i < m_NumItems; ++i )
+        {
+            glm::vec4 u = random.Uniform4( i, 2 );
+            spheres[i] = glm::vec4( glm::mix( glm::vec3( -100.0f ), glm::vec3( 100.0f ), glm::vec3( u ) ), u.w );
+        }
+
+        const Graphics::Frustum frustum( glm::perspective( glm::radians( 45.0f ), 16.0f / 9.0f, 0.1f, 100.0f ) );
+
+        std::vector<uint8_t> visible( m_NumItems );
+
+        RunWorkload( "Frustum Culling", m_NumItems, 4096, [&]( uint32_t first, uint32_t last )
+        {
+            for ( uint32_t i = first; i < last; ++i )
+            {
+                const glm::vec4& sphere = spheres[i];
+                visible[i] = frustum.IntersectsSphere( glm::vec3( sphere ), sphere.w ) ? 1 : 0;
+            }
+        } );
+    }
+
+    // Surface areas of meshes: very different amounts of work per item (see LightGenerator::BuildSurfaceDistribution).
+    {
+        const uint32_t numMeshes = std::max( m_NumItems / 64, 1u );
+        std::vector<uint32_t> numTriangles( numMeshes );
+        for ( uint32_t i = 0; i < numMeshes; ++i )
+        {
+            // Most meshes are small, a few are large.
+            float u = random.Uniform4( i, 3 ).x;
+            numTriangles[i] = 1 + static_cast<uint32_t>( u * u * u * u * ( gs_MaxTrianglesPerMesh - 1 ) );
+        }
+
+        std::vector<double> areas( numMeshes );
+
+        RunWorkload( "Mesh Surface Area", numMeshes, 1, [&]( uint32_t first, uint32_t last )
+        {
+            for ( uint32_t i = first; i < last; ++i )
+            {
+                double area = 0.0;
+                for ( uint32_t t = 0; t < numTriangles[i]; ++t )
+                {
+                    float angle = static_cast<float>( t );
+                    glm::vec3 v0( glm::cos( angle ), glm::sin( angle ), 0.0f );
+                    glm::vec3 v1( glm::cos( angle + 1.0f ), 0.0f, glm::sin( angle + 1.0f ) );
+                    glm::vec3 v2( 0.0f, glm::cos( angle + 2.0f ), glm::sin( angle + 2.0f ) );
+                    area += 0.5 * glm::length( glm::cross( v1 - v0, v2 - v0 ) );
+                }
+                areas[i] = area;
+            }
+        } );
+    }
+}
+
+void TaskSchedulerBenchmark::RunWorkload( const std::string& name, uint32_t count, uint32_t grainSize, const Workload& workload )
+{
+    double serialMedian = 0.0;
+
+    for ( uint32_t i = 0; i < static_cast<uint32_t>( Backend::NumBackends ); ++i )
+    {
+        Backend backend = static_cast<Backend>( i );
+#if !defined(_OPENMP)
+        if ( backend == Backend::OpenMP )
+        {
+            continue;
+        }
+#endif
+
+        // Warm up the caches and the threads.
+        RunBackend( backend, count, grainSize, workload );
+
+        Core::Statistic<double> times( m_NumIterations, Core::StatisticMode::Window );
+        for ( uint32_t iteration = 0; iteration < m_NumIterations; ++iteration )
+        {
+            auto startTime = high_resolution_clock::now();
+            RunBackend( backend, count, grainSize, workload );
+            times.Sample( duration<double, std::milli>( high_resolution_clock::now() - startTime ).count() );
+        }
+
+        Result result;
+        result.Workload = name;
+        result.Backend = backend;
+        result.Mean = times.GetAverage();
+        result.Median = times.GetPercentile( 50.0 );
+        result.Min = times.GetMin();
+
+        if ( backend == Backend::Serial )
+        {
+            serialMedian = result.Median;
+        }
+        result.Speedup = result.Median > 0.0 ? serialMedian / result.Median : 0.0;
+
+        LOG_INFO( name, " (", GetBackendName( backend ), "): ", result.Median, " ms (", result.Speedup, "x)" );
+
+        m_Results.push_back( result );
+    }
+}
+
+void TaskSchedulerBenchmark::RunBackend( Backend backend, uint32_t count, uint32_t grainSize, const Workload& workload )
+{
+    switch ( backend )
+    {
+    case Backend::Serial:
+        workload( 0, count );
+        break;
+    case Backend::Async:
+    {
+        // This is how the engine ran parallel loops before it had a task scheduler.
+        uint32_t numChunks = std::max( 1u, std::min( std::thread::hardware_concurrency(), count ) );
+
+        std::vector< std::future<void> > tasks;
+        for ( uint32_t chunk = 1; chunk < numChunks; ++chunk )
+        {
+            uint32_t first = static_cast<uint32_t>( static_cast<uint64_t>( count ) * chunk / numChunks );
+            uint32_t last = static_cast<uint32_t>( static_cast<uint64_t>( count ) * ( chunk + 1 ) / numChunks );
+            tasks.push_back( std::async( std::launch::async, workload, first, last ) );
+        }
+
+        workload( 0, static_cast<uint32_t>( static_cast<uint64_t>( count ) / numChunks ) );
+
+        for ( auto& task : tasks )
+        {
+            task.wait();
+        }
+        break;
+    }
+    case Backend::OpenMP:
+    {
+#if defined(_OPENMP)
+        int chunkSize = static_cast<int>( grainSize > 0 ? grainSize : std::max( 1u, count / ( omp_get_max_threads() * 8 ) ) );
+        int numChunks = ( static_cast<int>( count ) + chunkSize - 1 ) / chunkSize;
+
+#pragma omp parallel for schedule( dynamic )
+        for ( int chunk = 0; chunk < numChunks; ++chunk )
+        {
+            uint32_t first = static_cast<uint32_t>( chunk * chunkSize );
+            workload( first, std::min( first + chunkSize, count ) );
+        }
+#endif
+        break;
+    }
+    case Backend::TaskScheduler:
+        Core::ParallelFor( PROFILE_MARKER( "Task Scheduler Benchmark" ), 0, count, grainSize, workload );
+        break;
+    }
+}
+
+const std::vector<TaskSchedulerBenchmark::Result>& TaskSchedulerBenchmark::GetResults() const
+{
+    return m_Results;
+}
+
+bool TaskSchedulerBenchmark::Save( const fs::path& fileName ) const
+{
+    std::ofstream file( fileName, std::ios::out );
+    if ( !file.is_open() )
+    {
+        LOG_ERROR( "Failed to open task scheduler benchmark for writing: ", fileName.wstring() );
+        return false;
+    }
+
+    file << std::setprecision( 9 );
+    file << "Workload, Backend, Mean (ms), Median (ms), Min (ms), Speedup" << std::endl;
+    for ( const Result& result : m_Results )
+    {
+        file << result.Workload << ", " << GetBackendName( result.Backend ) << ", " << result.Mean << ", "
+             << result.Median << ", " << result.Min << ", " << result.Speedup << std::endl;
+    }
+
+    return file.good();
+}
@@ -7,17 +7,15 @@
 
 TransparentPass::TransparentPass( std::shared_ptr<Graphics::Scene> scene, std::shared_ptr<Graphics::GraphicsPipelineState> pipeline, bool bUseMaterials, uint32_t instanceCount, uint32_t firstInstance )
     : base( scene, pipeline, bUseMaterials, instanceCount, firstInstance )
-{}
+{
+    // Transparent geometry must be rendered back to front.
+    m_DrawList.SetSortOrder( Graphics::DrawList::SortOrder::BackToFront );
+}
 
 TransparentPass::~TransparentPass()
 {}
 
-void TransparentPass::Visit( Graphics::Mesh& mesh )
+bool TransparentPass::IsRendered( const Graphics::Material& material ) const
 {
-    std::shared_ptr<Graphics::Material> pMaterial = mesh.GetMaterial();
-    if ( pMaterial && pMaterial->IsTransparent() )
-    {
-        BindMaterial( pMaterial );
-        mesh.Render( *m_pRenderEventArgs, m_InstanceCount, m_FirstInstance );
-    }
-}
+    return material.IsTransparent();
+}
\ No newline at end of file
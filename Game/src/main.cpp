@@ -45,6 +45,15 @@
 #include <LightsPass.h>
 #include <PostprocessPass.h>
 #include <PrintProfileDataVisitor.h>
+#include <BenchmarkReport.h>
+#include <FramePacingMonitor.h>
+#include <FramePipelineTest.h>
+#include <LightCullingMetrics.h>
+#include <MeshletCullingVisitor.h>
+#include <LODStatisticsVisitor.h>
+#include <LogBenchmark.h>
+#include <QueueBenchmark.h>
+#include <TaskSchedulerBenchmark.h>
 
 #include <Graphics/DX12/ApplicationDX12.h>
 
@@ -70,6 +79,13 @@ const char* RenderTechniqueName[] = {
 
 RenderingTechnique g_RenderingTechnique = RenderingTechnique::Clustered_Optimized;
 
+const char* LightDistributionName[] = {
+    "Uniform",
+    "Poisson Disk",
+    "Clustered",
+    "Surface"
+};
+
 using RenderDeviceList = std::vector<std::shared_ptr<Graphics::Device>>;
 
 ApplicationDX12 g_Application;
@@ -103,6 +119,9 @@ bool g_Animate = false;
 std::future<bool> g_LoadingTask;
 std::atomic_bool g_IsLoading = true;
 
+// The configuration is saved on a background thread (see SaveConfig).
+std::future<bool> g_SaveConfigTask;
+
 // Render target for the depth prepass.
 std::shared_ptr<RenderTarget> g_DepthOnlyRenderTarget;
 
@@ -136,6 +155,26 @@ std::shared_ptr<StructuredBuffer> g_SpotLightIndexList_Cluster;
 std::shared_ptr<StructuredBuffer> g_PointLightGrid_Cluster;
 std::shared_ptr<StructuredBuffer> g_SpotLightGrid_Cluster;
 
+// Statistics that are written by the light culling compute shaders (see LightCullingMetrics::Counter).
+std::shared_ptr<StructuredBuffer> g_LightCullingStats;
+// The light culling statistics are copied to a readback buffer and read
+// a few frames later so reading the statistics does not stall the GPU.
+struct LightCullingStatsReadback
+{
+    std::shared_ptr<ReadbackBuffer> Buffer;
+    // Signaled when the frame that copied the statistics has finished.
+    std::shared_ptr<Fence> RenderFence;
+    std::string Source;
+    uint32_t MaxCells = 0;
+    uint32_t LightIndexListCapacity = 0;
+    bool IsPending = false;
+};
+const uint32_t NumLightCullingStatsReadbacks = 3;
+LightCullingStatsReadback g_LightCullingStatsReadbacks[NumLightCullingStatsReadbacks];
+uint32_t g_LightCullingStatsReadbackIndex = 0;
+// The light culling statistics of all techniques (see ShowStatistics).
+LightCullingMetrics g_LightCullingMetrics;
+
 // Cluster gird buffer for storing a flag for each grid cell that contains a sample.
 // This buffer stores a single 32-bit flag (0 for no sample, 1 for a sample)
 // for each grid cell. For a 1080p resolution with a 64x64 cell size, the grid will 
@@ -292,6 +331,22 @@ bool g_RenderDebugTexture = false;
 bool g_RenderDebugClusters = false;
 bool g_InvertY = false; // Invert the Y on controller input.
 
+// The maximum screen space error (in pixels) that is allowed when selecting the
+// level of detail of the meshes in the scene. 0 always renders the full detail meshes.
+// Level of detail selection is enabled by the configuration file (or the UI).
+float g_LODPixelError = 0.0f;
+
+// The scene that is loaded from the configuration file.
+std::shared_ptr<Scene> g_Scene;
+
+// The scene is streamed in the background. These timings (in seconds)
+// are measured from the moment the assets started loading.
+static std::chrono::high_resolution_clock::time_point g_LoadingStartTime;
+static float g_TimeToFirstFrame = -1.0f;
+// All meshes and textures that are visible from the initial camera position are loaded.
+static float g_TimeToInteractive = -1.0f;
+static float g_TimeToComplete = -1.0f;
+
 // Some scenes for rendering lights and stuff...
 std::shared_ptr<Scene> g_Sphere;
 std::shared_ptr<Scene> g_Cone;
@@ -306,6 +361,7 @@ static bool g_ShowProfiler = false;
 static bool g_ShowGenerateLights = false;
 static bool g_ShowLightsHierarchy = false;
 static bool g_ShowOptionsWindow = false;
+static bool g_ShowResourceMemory = false;
 static bool g_ShowNotification = false;
 static std::string g_NotificationText;
 static std::chrono::high_resolution_clock::time_point g_NotificationTimer;
@@ -316,6 +372,12 @@ PointLight* g_SelectedPointLight;
 SpotLight* g_SelectedSpotLight;
 DirectionalLight* g_SelectedDirLight;
 
+// The bounding spheres of the point lights followed by the spot lights.
+// Used to pick lights with the mouse (Ctrl + left mouse button).
+BVH g_LightBVH;
+// Set when the lights are modified on the CPU (the spheres are compared with the lights in UpdateLightBVH).
+bool g_LightBVHDirty = true;
+
 // The previously used view matrix.
 // The view matrix can be frozen so that the
 // AABB of the occupied clusters can be visualized.
@@ -355,19 +417,36 @@ void OnWindowClose( WindowCloseEventArgs& e );
 void OnKeyPressed( KeyEventArgs& e );
 void OnKeyReleased( KeyEventArgs& e );
 void OnMouseWheel( MouseWheelEventArgs& e );
+void OnMouseButtonPressed( MouseButtonEventArgs& e );
 void OnUpdate( UpdateEventArgs& e );
 void OnPreRender( RenderEventArgs& e );
 void OnRender( RenderEventArgs& e );
 void OnPostRender( RenderEventArgs& e );
 void OnResize( ResizeEventArgs& e );
 void OnGUI( RenderEventArgs& e );
-void OnLoadingProgress( ProgressEventArgs& e );
 
 bool LoadAssets();
+void UpdateSceneStreaming();
+// Report the result of a background save of the configuration file.
+void UpdateSaveConfig();
+
+// Show the distribution of the samples (in milliseconds).
+template<typename T>
+void ShowPercentiles( const Core::Statistic<T>& stats )
+{
+    ImGui::Text( "Min: %.3f Avg: %.3f (SD %.3f) Max: %.3f ms", stats.GetMin() * 1000.0, stats.GetAverage() * 1000.0, stats.GetStandardDeviation() * 1000.0, stats.GetMax() * 1000.0 );
+    ImGui::Text( "P50: %.3f P95: %.3f P99: %.3f P99.9: %.3f ms", stats.GetPercentile( 50.0 ) * 1000.0, stats.GetPercentile( 95.0 ) * 1000.0, stats.GetPercentile( 99.0 ) * 1000.0, stats.GetPercentile( 99.9 ) * 1000.0 );
+}
 
 // GUI functions
 void ShowStatistics( bool& bShowWindow );
+// Show the frame time histogram and the most recent hitches.
+void ShowFramePacing();
 void ShowOptionsWindow( bool& bShowWindow );
+// Show the memory that is used by the resources of the render device.
+void ShowResourceMemory( bool& bShowWindow );
+// Write the resource memory report of the render device to a JSON file.
+void SaveResourceMemoryReport();
 
 // Generate light structured buffers.
 void CreateLightBuffers();
@@ -380,8 +459,53 @@ void ReadbackDirLights( void* dstBuffer, std::shared_ptr<CopyCommandBuffer> comm
 // Focus the camera on the currently selected light.
 void FocusCurrentLight();
 
+// Keep the bounding spheres of the lights in sync with the lights.
+void UpdateLightBVH( const glm::mat4& rotationMatrix );
+// Select the closest light under a point on the screen.
+void PickLight( const glm::vec2& screenPoint );
+
+// Capture a timeline of the profiler markers (see Profiler::CaptureTimeline).
+void CaptureTimeline( uint32_t numFrames = 10 );
+// Detects frames that take much longer than the median frame time (see ShowStatistics).
+FramePacingMonitor g_FramePacingMonitor;
+// Write the detected hitches to a JSON file for offline analysis.
+void SaveHitches();
+// Copy the light culling statistics of the current frame to a readback buffer.
+void ReadbackLightCullingStats( std::shared_ptr<ComputeCommandBuffer> commandBuffer, const std::string& source, uint32_t maxCells, uint32_t lightIndexListCapacity );
+// Publish the light culling statistics of a frame that has finished on the GPU.
+void PublishLightCullingStats( LightCullingStatsReadback& readback, bool wait );
+void ShowLightCullingMetrics();
+// Set with the --capture-timeline command line argument.
+// The capture starts when the scene has been loaded.
+uint32_t g_CaptureTimelineFrames = 0;
+
+// Write a JSON report with the statistics of the profiler markers.
+bool SaveBenchmarkReport( const fs::path& fileName );
+void ClearProfilingData();
+void SetRenderingTechnique( RenderingTechnique technique );
+void UpdateClusterGrid();
+
+// Set with the --benchmark command line argument.
+// The steps of the sweep are run when the scene has been loaded (see UpdateBenchmarkSweep).
+std::unique_ptr<BenchmarkSweep> g_BenchmarkSweep;
+// The folder that the benchmark reports are written to.
+fs::path g_BenchmarkDirectory;
+uint32_t g_BenchmarkStep = 0;
+uint32_t g_BenchmarkFrame = 0;
+// Apply the settings of the current step, move the camera along the camera path and 
+// write a report when the step is done. The application stops after the last step.
+void UpdateBenchmarkSweep( UpdateEventArgs& e );
+
+// Only run the light culling and light assignment stages of the rendering techniques.
+// Set with the --culling-only command line argument or when benchmarking on the WARP adapter.
+bool g_CullingOnly = false;
+// Add a pass that shades the scene (the pass is disabled if g_CullingOnly is set).
+std::shared_ptr<RenderPass> ShadingPass( std::shared_ptr<RenderPass> pass );
+
+// Create a light generator for the light generation properties of the configuration.
+LightGenerator CreateLightGenerator();
 template<typename LightType>
-std::vector<LightType> GenerateLights( uint32_t numLights );
+std::vector<LightType> GenerateLights( const LightGenerator& generator, uint32_t numLights, uint32_t stream );
 void GenerateLights();
 
 // A function to randomly generate colors.
@@ -442,6 +566,16 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
     LPWSTR* commandLineArguments = CommandLineToArgvW( GetCommandLineW(), &numArgs );
 
     std::wstring configFileName = L"../Conf/DefaultConfiguration.3dgep";
+    bool convertLights = false;
+    std::wstring baselineReportFileName;
+    std::wstring candidateReportFileName;
+    // The increase of the median (in percent) that is considered a regression.
+    double regressionThreshold = 5.0;
+    bool runBenchmark = false;
+    bool runTaskBenchmark = false;
+    bool runQueueBenchmark = false;
+    bool runFramePipelineTest = false;
+    bool runLogBenchmark = false;
     // Parse command line arguments.
     for ( int i = 0; i < numArgs; i++ )
     {
@@ -449,6 +583,102 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
         {
             configFileName = commandLineArguments[++i];
         }
+        else if ( wcscmp( commandLineArguments[i], L"--convert-lights" ) == 0 )
+        {
+            convertLights = true;
+        }
+        else if ( wcscmp( commandLineArguments[i], L"--capture-timeline" ) == 0 && i + 1 < numArgs )
+        {
+            g_CaptureTimelineFrames = static_cast<uint32_t>( _wtoi( commandLineArguments[++i] ) );
+        }
+        else if ( wcscmp( commandLineArguments[i], L"--compare-reports" ) == 0 && i + 2 < numArgs )
+        {
+            baselineReportFileName = commandLineArguments[++i];
+            candidateReportFileName = commandLineArguments[++i];
+        }
+        else if ( wcscmp( commandLineArguments[i], L"--threshold" ) == 0 && i + 1 < numArgs )
+        {
+            regressionThreshold = _wtof( commandLineArguments[++i] );
+        }
+        else if ( wcscmp( commandLineArguments[i], L"--benchmark" ) == 0 )
+        {
+            runBenchmark = true;
+        }
+        else if ( wcscmp( commandLineArguments[i], L"--culling-only" ) == 0 )
+        {
+            g_CullingOnly = true;
+        }
+        else if ( wcscmp( commandLineArguments[i], L"--task-benchmark" ) == 0 )
+        {
+            runTaskBenchmark = true;
+        }
+        else if ( wcscmp( commandLineArguments[i], L"--queue-benchmark" ) == 0 )
+        {
+            runQueueBenchmark = true;
+        }
+        else if ( wcscmp( commandLineArguments[i], L"--frame-pipeline-test" ) == 0 )
+        {
+            runFramePipelineTest = true;
+        }
+        else if ( wcscmp( commandLineArguments[i], L"--log-benchmark" ) == 0 )
+        {
+            runLogBenchmark = true;
+        }
+    }
+
+    // Compare two benchmark reports and exit (see Conf/CompareReports_Win10_Rel_x64.bat).
+    if ( !baselineReportFileName.empty() )
+    {
+        int exitCode = CompareBenchmarkReportFiles( baselineReportFileName, candidateReportFileName, regressionThreshold );
+
+        LogManager::Shutdown();
+        return exitCode;
+    }
+
+    // Measure the throughput of the thread safe queues and exit (see Conf/QueueBenchmark_Win10_Rel_x64.bat).
+    if ( runQueueBenchmark )
+    {
+        QueueBenchmark queueBenchmark;
+        queueBenchmark.Run();
+
+        fs::path fileName = fs::path( L"../Perf/Queue Benchmark.csv" );
+        fs::create_directories( fileName.parent_path() );
+        bool saved = queueBenchmark.Save( fileName );
+        if ( saved )
+        {
+            LOG_INFO( "Queue benchmark saved to ", fileName.wstring() );
+        }
+
+        LogManager::Shutdown();
+        return saved ? 0 : -1;
+    }
+
+    // Measure the cost of logging a message and the wakeups of the idle log thread and exit (see Conf/LogBenchmark_Win10_Rel_x64.bat).
+    if ( runLogBenchmark )
+    {
+        LogBenchmark logBenchmark;
+        logBenchmark.Run();
+
+        fs::path fileName = fs::path( L"../Perf/Log Benchmark.csv" );
+        fs::create_directories( fileName.parent_path() );
+        bool saved = logBenchmark.Save( fileName );
+        if ( saved )
+        {
+            LOG_INFO( "Log benchmark saved to ", fileName.wstring() );
+        }
+
+        LogManager::Shutdown();
+        return saved ? 0 : -1;
+    }
+
+    // Run the frame pipeline with frames in flight (without a device) and exit (see Conf/FramePipelineTest_Win10_Rel_x64.bat).
+    if ( runFramePipelineTest )
+    {
+        FramePipelineTest framePipelineTest;
+        bool passed = framePipelineTest.Run();
+
+        LogManager::Shutdown();
+        return passed ? 0 : -1;
     }
 
     if ( !g_Config.Load( configFileName ) )
@@ -463,11 +693,56 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
 
 //    g_Config.Save( configFileName );
 
+    // Move the lights from the configuration file to a light set file
+    // next to the configuration file and exit (see Conf/ConvertLights_Win10_Rel_x64.bat).
+    if ( convertLights )
+    {
+        if ( g_Config.LightsFileName.empty() )
+        {
+            g_Config.LightsFileName = fs::path( configFileName ).filename().replace_extension( "lights" ).wstring();
+        }
+
+        bool converted = g_Config.Save();
+        if ( converted )
+        {
+            LOG_INFO( "Converted lights of ", configFileName, " to ", g_Config.GetAbsoluteLightsFilePath() );
+        }
+
+        LogManager::Shutdown();
+        return converted ? 0 : -1;
+    }
+
+    // Sweep the benchmark settings of the configuration file (see Conf/Benchmark_Win10_Rel_x64.bat).
+    if ( runBenchmark )
+    {
+        BenchmarkSweep::Step defaults;
+        defaults.NumLights = static_cast<uint32_t>( g_Config.PointLights.size() + g_Config.SpotLights.size() );
+        defaults.Resolution = glm::uvec2( g_Config.WindowWidth, g_Config.WindowHeight );
+        defaults.ClusterBlockSize = g_ClusterGridBlockSize;
+        defaults.Technique = RenderTechniqueName[(int)g_RenderingTechnique];
+
+        BenchmarkCameraPose cameraPose;
+        cameraPose.Position = g_Config.CameraPosition;
+        cameraPose.Rotation = g_Config.CameraRotation;
+
+        g_BenchmarkSweep = std::make_unique<BenchmarkSweep>( g_Config.Benchmark, defaults, cameraPose );
+
+        g_BenchmarkDirectory = fs::path( L"../Perf" ) / ( ConvertString( GetTimestampString() ) + L" " + fs::path( configFileName ).stem().wstring() + L" Benchmark" );
+        fs::create_directories( g_BenchmarkDirectory );
+
+        LOG_INFO( "Running ", g_BenchmarkSweep->GetSteps().size(), " benchmark steps. Reports are written to ", g_BenchmarkDirectory.wstring() );
+
+        // Start with the resolution of the first step.
+        g_Config.WindowWidth = static_cast<uint16_t>( g_BenchmarkSweep->GetSteps().front().Resolution.x );
+        g_Config.WindowHeight = static_cast<uint16_t>( g_BenchmarkSweep->GetSteps().front().Resolution.y );
+    }
+
     g_Application.SetAssetSearchPaths( g_Config.GetAbsoluteSearchPaths() );
     g_Application.SetLoadingProgressTotal( g_Config.LoadingProgressTotal );
 
     g_WindowWidth = g_Config.WindowWidth;
     g_WindowHeight = g_Config.WindowHeight;
+    g_LODPixelError = g_Config.LODPixelError;
 
     // Setup the window title for the render window.
     std::string windowName = "Volume Tiled Forward Rendering ";
@@ -502,6 +777,13 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
     {
         LogManager::LogWarning( "Using Warp Adapter." );
         adapter = g_Application.GetWarpAdapter();
+
+        // Shading the scene in software takes too long to benchmark.
+        if ( g_BenchmarkSweep )
+        {
+            LogManager::LogWarning( "Benchmarking the light culling and light assignment stages only." );
+            g_CullingOnly = true;
+        }
     }
     else
     {
@@ -517,9 +799,33 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
     TextureFormat colorFormat( Graphics::TextureComponents::RGBA, TextureType::UnsignedNormalized, multiSampleCount, 8, 8, 8, 8, 0, 0 );
     TextureFormat depthFormat( Graphics::TextureComponents::DepthStencil, TextureType::UnsignedNormalized, multiSampleCount, 0, 0, 0, 0, 24, 8 );
     //TextureFormat depthFormat( Graphics::TextureComponents::Depth, TextureType::Float, 1, 0, 0, 0, 0, 32, 0 );
-    g_RenderWindow = g_Application.CreateWindow( g_RenderDevice, windowName, g_WindowWidth, g_WindowHeight, false, g_Config.VSync, colorFormat, depthFormat );
+    // Benchmarks are not limited by the refresh rate of the display.
+    bool vSync = g_Config.VSync && !g_BenchmarkSweep;
+    g_RenderWindow = g_Application.CreateWindow( g_RenderDevice, windowName, g_WindowWidth, g_WindowHeight, false, vSync, colorFormat, depthFormat );
     
     Profiler::Init( g_RenderDevice, 2048 );
+    TaskScheduler::Init();
+
+    // Compare the task scheduler with std::async and OpenMP and exit.
+    if ( runTaskBenchmark )
+    {
+        TaskSchedulerBenchmark taskBenchmark;
+        taskBenchmark.Run();
+
+        fs::path fileName = fs::path( L"../Perf" ) / ( fs::path( configFileName ).stem().wstring() + L" Task Scheduler Benchmark.csv" );
+        fs::create_directories( fileName.parent_path() );
+        bool saved = taskBenchmark.Save( fileName );
+        if ( saved )
+        {
+            LOG_INFO( "Task scheduler benchmark saved to ", fileName.wstring() );
+        }
+
+        TaskScheduler::Shutdown();
+        Profiler::Shutdown();
+        LogManager::Shutdown();
+        return saved ? 0 : -1;
+    }
+
     GUI::Init( g_RenderDevice, g_RenderWindow );
 
     // Create a texture for debugging the light culling compute shader.
@@ -527,16 +833,20 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
                                                   TextureType::UnsignedNormalized,
                                                   1,
                                                   8, 8, 8, 8, 0, 0 );
-    g_LightCullingDebugTexture = g_RenderDevice->CreateTexture2D( g_WindowWidth, g_WindowHeight, 1, lightCullingDebugTextureFormat );
-    g_LightCullingDebugTexture->SetName( L"Light Culling Debug Texture" );
-
     // Create a texture for debugging clusters.
     TextureFormat clusterAssignmentDebugTextureFormat( TextureComponents::RGBA,
                                                        TextureType::UnsignedNormalized,
                                                        multiSampleCount,
                                                        8, 8, 8, 8, 0, 0 );
-    g_ClusterSamplesDebugTexture = g_RenderDevice->CreateTexture2D( g_WindowWidth, g_WindowHeight, 1, clusterAssignmentDebugTextureFormat );
-    g_ClusterSamplesDebugTexture->SetName( L"Cluster Samples Debug Texture" );
+    {
+        ResourceRegistry::ScopedGroup resourceGroup( L"Debug" );
+
+        g_LightCullingDebugTexture = g_RenderDevice->CreateTexture2D( g_WindowWidth, g_WindowHeight, 1, lightCullingDebugTextureFormat );
+        g_LightCullingDebugTexture->SetName( L"Light Culling Debug Texture" );
+
+        g_ClusterSamplesDebugTexture = g_RenderDevice->CreateTexture2D( g_WindowWidth, g_WindowHeight, 1, clusterAssignmentDebugTextureFormat );
+        g_ClusterSamplesDebugTexture->SetName( L"Cluster Samples Debug Texture" );
+    }
 
     CreateLightBuffers();
 
@@ -650,6 +960,7 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
 
     // Attach events
     g_RenderWindow->MouseWheel += &OnMouseWheel;
+    g_RenderWindow->MouseButtonPressed += &OnMouseButtonPressed;
     g_RenderWindow->Update += &OnUpdate;
     g_RenderWindow->PreRender += &OnPreRender;
     g_RenderWindow->Render += &OnRender;
@@ -659,14 +970,25 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
     g_RenderWindow->KeyReleased += &OnKeyReleased;
     g_RenderWindow->Close += &OnWindowClose;
     
-    g_RenderWindow->ShowWindow();
+    // Benchmarks run without user input so the window is not shown.
+    if ( !g_BenchmarkSweep )
+    {
+        g_RenderWindow->ShowWindow();
+    }
 
     // Start async loading task
+    g_LoadingStartTime = std::chrono::high_resolution_clock::now();
     g_LoadingTask = std::async( std::launch::async, &LoadAssets );
     //g_Application.BeginGraphicsAnalysis();
     //LoadAssets();
     //g_Application.EndGraphicsAnalysis();
 
+    // The update and render handlers share the camera, the scene and the ImGui context
+    // so the render stage of a frame must finish before the next frame is updated.
+    // Frames in flight are tested with --frame-pipeline-test. The render thread is 
+    // started and stopped by the application when the latency is changed at runtime.
+    g_Application.GetFramePipeline().SetLatency( 0 );
+
     // Run the application.
     uint32_t result = g_Application.Run();
 
@@ -674,6 +996,19 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
     // If that happens, we need to wait for the task to complete before releasing all the resources.
     g_LoadingTask.get();
 
+    // Don't exit while the configuration file is being written.
+    if ( g_SaveConfigTask.valid() )
+    {
+        g_SaveConfigTask.wait();
+    }
+
+    // Wait for the scene streaming threads to finish.
+    if ( g_Scene )
+    {
+        g_Scene->StopStreaming();
+    }
+
+    TaskScheduler::Shutdown();
     Profiler::Shutdown();
     GUI::Shutdown();
     LogManager::Shutdown();
@@ -683,11 +1018,6 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine
     return result;
 }
 
-void OnLoadingProgress( ProgressEventArgs& e )
-{
-    g_Application.IncrementLoadingProgress();
-}
-
 bool LoadAssets()
 {
     DepthMode depthFuncEqual( true, DepthWrite::Enable, CompareFunction::Equal );
@@ -715,16 +1045,22 @@ bool LoadAssets()
     auto commandQueue = g_RenderDevice->GetComputeQueue();
     auto commandBuffer = commandQueue->GetComputeCommandBuffer();
 
+    // The scene is streamed in the background while the rest of the assets are loaded.
+    // Assets that are visible from the initial camera position are streamed first.
+    Camera streamingCamera;
+    streamingCamera.SetTranslate( g_Config.CameraPosition );
+    streamingCamera.SetRotate( g_Config.CameraRotation );
+    streamingCamera.SetProjection( 45.0f, g_WindowWidth / (float)g_WindowHeight, 0.1f, 1000.0f );
+
     auto scene = g_RenderDevice->CreateScene();
-    scene->LoadingProgress += &OnLoadingProgress;
-    LogManager::LogInfo( L"Loading Scene: ", g_Config.SceneFileName );
-    if ( !scene->LoadFromFile( commandBuffer, g_Config.SceneFileName ) )
+    LogManager::LogInfo( L"Streaming Scene: ", g_Config.SceneFileName );
+    if ( !scene->StreamFromFile( g_Config.SceneFileName, glm::scale( glm::vec3( g_Config.SceneScaleFactor ) ), streamingCamera ) )
     {
         LOG_ERROR( "Unable to load scene file." );
         return false;
     }
 
-    scene->GetRootNode()->SetLocalTransform( glm::scale( glm::vec3( g_Config.SceneScaleFactor ) ) );
+    g_Scene = scene;
 
     g_Application.IncrementLoadingProgress();
 
@@ -771,6 +1107,16 @@ bool LoadAssets()
 
     g_Application.IncrementLoadingProgress();
 
+    // Create a structured buffer for the light culling statistics.
+    g_LightCullingStats = g_RenderDevice->CreateStructuredBuffer( commandBuffer, LightCullingMetrics::NumCounters, sizeof( uint32_t ) );
+    g_LightCullingStats->SetName( L"Light Culling Statistics" );
+
+    for ( LightCullingStatsReadback& readback : g_LightCullingStatsReadbacks )
+    {
+        readback.Buffer = g_RenderDevice->CreateReadbackBuffer( LightCullingMetrics::NumCounters * sizeof( uint32_t ) );
+        readback.Buffer->SetName( L"Light Culling Statistics (Readback)" );
+    }
+
     // Load a texture for visualizing light counts.
     auto lightCountHeatMap = g_RenderDevice->CreateTexture( commandBuffer, L"../Assets/textures/LightCountHeatMap.psd" );
     lightCountHeatMap->SetName( L"Light Count Heat Map" );
@@ -1222,10 +1568,10 @@ bool LoadAssets()
         .AddPass( depthPrepass )
         .AddPass( std::make_shared<PushProfileMarkerPass>( L"Main Render" ) )
         .AddPass( std::make_shared<PushProfileMarkerPass>( L"Opaque Pass" ) )
-        .AddPass( std::make_shared<OpaquePass>( scene, g_ForwardOpaquePSO ) )
+        .AddPass( ShadingPass( std::make_shared<OpaquePass>( scene, g_ForwardOpaquePSO ) ) )
         .AddPass( std::make_shared<PopProfileMarkerPass>() ) // Pop "Opaque Pass" marker.
         .AddPass( std::make_shared<PushProfileMarkerPass>( L"Transparent Pass" ) )
-        .AddPass( std::make_shared<TransparentPass>( scene, g_ForwardTransparentPSO ) )
+        .AddPass( ShadingPass( std::make_shared<TransparentPass>( scene, g_ForwardTransparentPSO ) ) )
         .AddPass( std::make_shared<PopProfileMarkerPass>() ) // Pop "Transparent Pass" marker.
         .AddPass( std::make_shared<PopProfileMarkerPass>() ) // Pop "Main Render" marker.
         .AddPass( std::make_shared<PopProfileMarkerPass>() ) // Pop "Forward Rendering" marker.
@@ -1270,6 +1616,7 @@ bool LoadAssets()
                     e.GraphicsCommandBuffer->ClearResourceUInt( g_SpotLightIndexCounter[i] );
                     e.GraphicsCommandBuffer->ClearResourceUInt( g_SpotLightGrid[i] );
                 }
+                e.GraphicsCommandBuffer->ClearResourceUInt( g_LightCullingStats );
 
                 e.GraphicsCommandBuffer->BindComputePipelineState( cullLightsPipelineState );
 
@@ -1287,8 +1634,14 @@ bool LoadAssets()
                 e.GraphicsCommandBuffer->BindComputeShaderArguments( 3, 13, { g_SpotLightIndexList[0], g_SpotLightIndexList[1] } );
                 e.GraphicsCommandBuffer->BindComputeShaderArguments( 3, 15, { g_PointLightGrid[0], g_PointLightGrid[1] } );
                 e.GraphicsCommandBuffer->BindComputeShaderArguments( 3, 17, { g_SpotLightGrid[0], g_SpotLightGrid[1] } );
+                e.GraphicsCommandBuffer->BindComputeShaderArguments( 3, 19, { g_LightCullingStats } );
 
                 e.GraphicsCommandBuffer->Dispatch( dispatchParams.NumThreadGroups );
+
+                // The transparent light index lists are the largest (see CullLights_CS.hlsl).
+                ReadbackLightCullingStats( e.GraphicsCommandBuffer, RenderTechniqueName[(int)g_RenderingTechnique],
+                                           dispatchParams.NumThreadGroups.x * dispatchParams.NumThreadGroups.y,
+                                           static_cast<uint32_t>( g_PointLightIndexList[1]->GetNumElements() ) );
             }
         } ) )
         .AddPass( std::make_shared<PopProfileMarkerPass>() ) // Pop "Light Culling" profiling marker.
@@ -1313,7 +1666,7 @@ bool LoadAssets()
                 e.GraphicsCommandBuffer->BindGraphicsShaderArguments( 3, 13, { g_PointLightGrid[0], g_SpotLightGrid[0] } );
             }
         } ) )
-        .AddPass( std::make_shared<OpaquePass>( scene, g_ForwardPlusOpaquePSO ) )
+        .AddPass( ShadingPass( std::make_shared<OpaquePass>( scene, g_ForwardPlusOpaquePSO ) ) )
         .AddPass( std::make_shared<PopProfileMarkerPass>() ) // Pop "Opaque Pass" profiling marker.
 #pragma endregion
 
@@ -1336,7 +1689,7 @@ bool LoadAssets()
                 e.GraphicsCommandBuffer->BindGraphicsShaderArguments( 3, 13, { g_PointLightGrid[1], g_SpotLightGrid[1] } );
             }
         } ) )
-        .AddPass( std::make_shared<TransparentPass>( scene, g_ForwardPlusTransparentPSO ) )
+        .AddPass( ShadingPass( std::make_shared<TransparentPass>( scene, g_ForwardPlusTransparentPSO ) ) )
         .AddPass( std::make_shared<PopProfileMarkerPass>() ) // Pop "Transparent Pass" profiling marker.
 #pragma endregion
         .AddPass( g_DebugLightsPass )
@@ -1417,10 +1770,10 @@ bool LoadAssets()
                 switch ( g_RenderingTechnique )
                 {
                 case RenderingTechnique::Clustered:
-                    Profiler::Get().PushProfilingMarker( L"No Optimization", e.GraphicsCommandBuffer );
+                    Profiler::Get().PushProfilingMarker( PROFILE_MARKER( "No Optimization" ), e.GraphicsCommandBuffer );
                     break;
                 case RenderingTechnique::Clustered_Optimized:
-                    Profiler::Get().PushProfilingMarker( L"BVH", e.GraphicsCommandBuffer );
+                    Profiler::Get().PushProfilingMarker( PROFILE_MARKER( "BVH" ), e.GraphicsCommandBuffer );
                     break;
                 }
 
@@ -1429,6 +1782,7 @@ bool LoadAssets()
                 e.GraphicsCommandBuffer->ClearResourceUInt( g_SpotLightIndexCounter_Cluster );
                 e.GraphicsCommandBuffer->ClearResourceUInt( g_PointLightGrid_Cluster );
                 e.GraphicsCommandBuffer->ClearResourceUInt( g_SpotLightGrid_Cluster );
+                e.GraphicsCommandBuffer->ClearResourceUInt( g_LightCullingStats );
 
                 LightCountsCB lightCounts;
                 lightCounts.NumPointLights = static_cast<uint32_t>( g_Config.PointLights.size() );
@@ -1451,6 +1805,7 @@ bool LoadAssets()
                     e.GraphicsCommandBuffer->BindComputeShaderArguments( 1, 4, { g_PointLightIndexCounter_Cluster, g_SpotLightIndexCounter_Cluster } );
                     e.GraphicsCommandBuffer->BindComputeShaderArguments( 1, 6, { g_PointLightGrid_Cluster, g_SpotLightGrid_Cluster } );
                     e.GraphicsCommandBuffer->BindComputeShaderArguments( 1, 8, { g_PointLightIndexList_Cluster, g_SpotLightIndexList_Cluster } );
+                    e.GraphicsCommandBuffer->BindComputeShaderArguments( 1, 10, { g_LightCullingStats } );
                     break;
                 case RenderingTechnique::Clustered_Optimized:
                     e.GraphicsCommandBuffer->BindComputePipelineState( g_AssignLightsToClustersBVHPSO );
@@ -1464,6 +1819,7 @@ bool LoadAssets()
                     e.GraphicsCommandBuffer->BindComputeShaderArguments( 2, 8, { g_PointLightIndexCounter_Cluster, g_SpotLightIndexCounter_Cluster } );
                     e.GraphicsCommandBuffer->BindComputeShaderArguments( 2, 10, { g_PointLightGrid_Cluster, g_SpotLightGrid_Cluster } );
                     e.GraphicsCommandBuffer->BindComputeShaderArguments( 2, 12, { g_PointLightIndexList_Cluster, g_SpotLightIndexList_Cluster } );
+                    e.GraphicsCommandBuffer->BindComputeShaderArguments( 2, 14, { g_LightCullingStats } );
                     break;
                 }
 
@@ -1471,6 +1827,10 @@ bool LoadAssets()
                 // in the FindUniqueClusters compute shader.
                 e.GraphicsCommandBuffer->ExecuteIndirect( g_AssignLightToClustersCommandSignature, g_AssignLightsToClustersArgumentBuffer );
 
+                ReadbackLightCullingStats( e.GraphicsCommandBuffer, RenderTechniqueName[(int)g_RenderingTechnique],
+                                           g_ClusterDataCB.GridDim.x * g_ClusterDataCB.GridDim.y * g_ClusterDataCB.GridDim.z,
+                                           static_cast<uint32_t>( g_PointLightIndexList_Cluster->GetNumElements() ) );
+
                 switch ( g_RenderingTechnique )
                 {
                 case RenderingTechnique::Clustered:
@@ -1504,10 +1864,10 @@ bool LoadAssets()
                 e.GraphicsCommandBuffer->BindGraphics32BitConstants( 4, g_ClusterDataCB );
             }
         } ) )
-        .AddPass( std::make_shared<OpaquePass>( scene, g_ClusteredOpaquePSO ) )
+        .AddPass( ShadingPass( std::make_shared<OpaquePass>( scene, g_ClusteredOpaquePSO ) ) )
         .AddPass( std::make_shared<PopProfileMarkerPass>() ) // Pop "Opaque Pass" profiling marker.
         .AddPass( std::make_shared<PushProfileMarkerPass>( L"Transparent Pass" ) )
-        .AddPass( std::make_shared<TransparentPass>( scene, g_ClusteredTransparentPSO ) )
+        .AddPass( ShadingPass( std::make_shared<TransparentPass>( scene, g_ClusteredTransparentPSO ) ) )
         .AddPass( std::make_shared<PopProfileMarkerPass>() ) // Pop "Transparent Pass" profiling marker.
         .AddPass( g_DebugClustersPass )
         .AddPass( g_DebugLightsPass )
@@ -1552,7 +1912,7 @@ void MergeSort( std::shared_ptr<ComputeCommandBuffer> commandBuffer,
 
     while ( numChunks > 1 )
     {
-        ScopedProfileMarker passProfileMaker( std::wstring( L"Pass " ) + std::to_wstring( ++pass ), commandBuffer );
+        ScopedProfileMarker passProfileMaker( PROFILE_MARKER( "Pass " ), ++pass, commandBuffer );
 
         sortParams.NumElements = totalValues;
         sortParams.ChunkSize = chunkSize;
@@ -1695,6 +2055,28 @@ void OnUpdate( UpdateEventArgs& e )
         rotationMatrix = glm::rotate( glm::mat4( 1 ), fRotation, glm::vec3( 0, 1, 0 ) );
     }
 
+    if ( !g_IsLoading )
+    {
+        UpdateSceneStreaming();
+
+        if ( g_CaptureTimelineFrames > 0 )
+        {
+            CaptureTimeline( g_CaptureTimelineFrames );
+            g_CaptureTimelineFrames = 0;
+        }
+
+        UpdateBenchmarkSweep( e );
+
+        // The elapsed time is the duration of the previous frame.
+        if ( e.FrameCounter > 0 )
+        {
+            g_FramePacingMonitor.AddFrame( e.FrameCounter - 1, e.ElapsedTime );
+        }
+    }
+
+    UpdateSaveConfig();
+    UpdateLightBVH( rotationMatrix );
+
     // Compute view space light properties.
     glm::mat4 viewMatrix = g_Camera->GetViewMatrix();
 
@@ -1710,7 +2092,7 @@ void OnUpdate( UpdateEventArgs& e )
         lightCounts.NumDirectionalLights = static_cast<uint32_t>( g_Config.DirectionalLights.size() );
 
         {
-            ScopedProfileMarker updateLightsProfilingMarker( L"Update Lights", commandBuffer );
+            ScopedProfileMarker updateLightsProfilingMarker( PROFILE_MARKER( "Update Lights" ), commandBuffer );
 
             commandBuffer->BindComputePipelineState( g_UpdateLightsPSO );
 
@@ -1730,7 +2112,7 @@ void OnUpdate( UpdateEventArgs& e )
         if ( g_RenderingTechnique == RenderingTechnique::Clustered_Optimized )
         {
             {
-                ScopedProfileMarker computeLightsAABB( L"Reduce Lights AABB", commandBuffer );
+                ScopedProfileMarker computeLightsAABB( PROFILE_MARKER( "Reduce Lights AABB" ), commandBuffer );
 
                 commandBuffer->BindComputePipelineState( g_ReduceLightsAABB1PSO );
 
@@ -1755,7 +2137,7 @@ void OnUpdate( UpdateEventArgs& e )
                 commandBuffer->BindComputeShaderArguments( 3, 0, { g_PointLightsBuffer, g_SpotLightsBuffer, g_LightsAABB } );
 
                 {
-                    ScopedProfileMarker firstPass( L"First Pass", commandBuffer );
+                    ScopedProfileMarker firstPass( PROFILE_MARKER( "First Pass" ), commandBuffer );
 
                     // Dispatch the first pass.
                     commandBuffer->Dispatch( numThreadGroups );
@@ -1769,14 +2151,14 @@ void OnUpdate( UpdateEventArgs& e )
                 commandBuffer->BindCompute32BitConstants( 1, dispatchParams );
 
                 {
-                    ScopedProfileMarker secondPass( L"Second Pass", commandBuffer );
+                    ScopedProfileMarker secondPass( PROFILE_MARKER( "Second Pass" ), commandBuffer );
 
                     // Dispatch 2nd pass.
                     commandBuffer->Dispatch( 1 );
                 }
             }
             {
-                ScopedProfileMarker computeMortonCodes( L"Compute Morton Codes", commandBuffer );
+                ScopedProfileMarker computeMortonCodes( PROFILE_MARKER( "Compute Morton Codes" ), commandBuffer );
 
                 commandBuffer->BindComputePipelineState( g_ComputeLightMortonCodesPSO );
 
@@ -1790,7 +2172,7 @@ void OnUpdate( UpdateEventArgs& e )
                 commandBuffer->Dispatch( numThreadGroups );
             }
             {
-                ScopedProfileMarker sortByMortonCode( L"Sort Morton Codes", commandBuffer );
+                ScopedProfileMarker sortByMortonCode( PROFILE_MARKER( "Sort Morton Codes" ), commandBuffer );
 
                 // The size of a single chunk that keys will be sorted into.
                 uint32_t chunkSize = SORT_NUM_THREADS_PER_THREAD_GROUP;
@@ -1810,7 +2192,7 @@ void OnUpdate( UpdateEventArgs& e )
                     commandBuffer->BindComputeShaderArguments( 1, 2, { g_PointLightMortonCodes_OUT, g_PointLightIndices_OUT } );
 
                     {
-                        ScopedProfileMarker sortPointLights( L"Radix Sort (Point Lights)", commandBuffer );
+                        ScopedProfileMarker sortPointLights( PROFILE_MARKER( "Radix Sort (Point Lights)" ), commandBuffer );
 
                         uint32_t numThreadGroups = static_cast<uint32_t>( glm::ceil( sortParams.NumElements / (float)SORT_NUM_THREADS_PER_THREAD_GROUP ) );
 
@@ -1832,7 +2214,7 @@ void OnUpdate( UpdateEventArgs& e )
                     commandBuffer->BindComputeShaderArguments( 1, 2, { g_SpotLightMortonCodes_OUT, g_SpotLightIndices_OUT } );
 
                     {
-                        ScopedProfileMarker sortSpotLights( L"Radix Sort (Spot Lights)", commandBuffer );
+                        ScopedProfileMarker sortSpotLights( PROFILE_MARKER( "Radix Sort (Spot Lights)" ), commandBuffer );
 
                         uint32_t numThreadGroups = static_cast<uint32_t>( glm::ceil( sortParams.NumElements / (float)SORT_NUM_THREADS_PER_THREAD_GROUP ) );
 
@@ -1847,7 +2229,7 @@ void OnUpdate( UpdateEventArgs& e )
                 //// Merge sort the radix sorted blocks from the previous step.
                 if ( lightCounts.NumPointLights > 0 )
                 {
-                    ScopedProfileMarker mergeSortPointLights( L"Merge Sort (Point Lights)", commandBuffer );
+                    ScopedProfileMarker mergeSortPointLights( PROFILE_MARKER( "Merge Sort (Point Lights)" ), commandBuffer );
 
                     MergeSort( commandBuffer,
                                g_PointLightMortonCodes, g_PointLightIndices,
@@ -1857,7 +2239,7 @@ void OnUpdate( UpdateEventArgs& e )
                 // Merge sort the radix sorted blocks from the previous step.
                 if ( lightCounts.NumSpotLights > 0 )
                 {
-                    ScopedProfileMarker mergeSortPointLights( L"Merge Sort (Spot Lights)", commandBuffer );
+                    ScopedProfileMarker mergeSortPointLights( PROFILE_MARKER( "Merge Sort (Spot Lights)" ), commandBuffer );
 
                     MergeSort( commandBuffer,
                                g_SpotLightMortonCodes, g_SpotLightIndices,
@@ -1866,7 +2248,7 @@ void OnUpdate( UpdateEventArgs& e )
                 }
             }
             {
-                ScopedProfileMarker buildBVH( L"Build Light BVH", commandBuffer );
+                ScopedProfileMarker buildBVH( PROFILE_MARKER( "Build Light BVH" ), commandBuffer );
 
                 commandBuffer->ClearResourceFloat( g_PointLightBVH );
                 commandBuffer->ClearResourceFloat( g_SpotLightBVH );
@@ -1888,7 +2270,7 @@ void OnUpdate( UpdateEventArgs& e )
                 uint32_t numThreadGroups = static_cast<uint32_t>( glm::ceil( maxLeaves / (float)BVH_NUM_THREADS ) );
 
                 {
-                    ScopedProfileMarker buildBottomBVH( L"Build Bottom BVH", commandBuffer );
+                    ScopedProfileMarker buildBottomBVH( PROFILE_MARKER( "Build Bottom BVH" ), commandBuffer );
 
                     commandBuffer->Dispatch( numThreadGroups );
                 }
@@ -1912,7 +2294,7 @@ void OnUpdate( UpdateEventArgs& e )
                         numThreadGroups = static_cast<uint32_t>( glm::ceil( numChildNodes / (float)BVH_NUM_THREADS ) );
 
                         {
-                            ScopedProfileMarker buildBVHBottom( std::wstring( L"Build BVH Level " ) + std::to_wstring( level ), commandBuffer );
+                            ScopedProfileMarker buildBVHBottom( PROFILE_MARKER( "Build BVH Level " ), level, commandBuffer );
                             commandBuffer->Dispatch( numThreadGroups );
                         }
                     }
@@ -1920,13 +2302,20 @@ void OnUpdate( UpdateEventArgs& e )
             }
         }
 
-        commandQueue->Submit( commandBuffer );
+        // Submit the light update when the render stage of this frame begins so it
+        // stays after the commands of the previous frame and before those of this frame.
+        e.Frame->Defer( [commandQueue, commandBuffer]()
+        {
+            commandQueue->Submit( commandBuffer );
+        } );
     }
 }
 
 // Compute the view frustums for the light clipping grid.
 void ComputeGridFrustums()
 {
+    ResourceRegistry::ScopedGroup resourceGroup( L"Forward+" );
+
     auto commandQueue = g_RenderDevice->GetComputeQueue();
     auto commandBuffer = commandQueue->GetComputeCommandBuffer();
 
@@ -1992,6 +2381,8 @@ void ComputeGridFrustums()
 
 void UpdateClusterGrid()
 {
+    ResourceRegistry::ScopedGroup resourceGroup( L"Clustered" );
+
     // The half-angle of the field of view in the Y-direction.
     float fieldOfViewY = glm::radians( g_Camera->GetFOV() * 0.5f );
     float zNear = g_Camera->GetNearClipPlane();
@@ -2139,9 +2530,16 @@ void OnRender( RenderEventArgs& e )
 
     e.Camera = g_Camera;
     e.GraphicsCommandBuffer = commandBuffer;
+    e.LODPixelError = g_LODPixelError;
+
+    // Publish the light culling statistics of the previous frames that have finished (oldest first).
+    for ( uint32_t i = 0; i < NumLightCullingStatsReadbacks; ++i )
+    {
+        PublishLightCullingStats( g_LightCullingStatsReadbacks[( g_LightCullingStatsReadbackIndex + i ) % NumLightCullingStatsReadbacks], false );
+    }
 
     {
-        Profiler::Get().PushProfilingMarker( _W(__FUNCTION__), commandBuffer);
+        Profiler::Get().PushProfilingMarker( PROFILE_MARKER( __FUNCTION__ ), commandBuffer);
         if ( g_IsLoading )
         {
             g_LoadingScreenTechnique.Render( e );
@@ -2181,6 +2579,14 @@ void OnRender( RenderEventArgs& e )
     }
 
     g_RenderFence = commandQueue->Submit( commandBuffer );
+
+    // Light culling statistics that were copied in this frame can be read when the frame has finished.
+    LightCullingStatsReadback& readback = g_LightCullingStatsReadbacks[g_LightCullingStatsReadbackIndex];
+    if ( readback.IsPending && !readback.RenderFence )
+    {
+        readback.RenderFence = g_RenderFence;
+        g_LightCullingStatsReadbackIndex = ( g_LightCullingStatsReadbackIndex + 1 ) % NumLightCullingStatsReadbacks;
+    }
 }
 
 void OnPostRender( RenderEventArgs& e )
@@ -2207,15 +2613,81 @@ void Notify( const std::string& notificationText, float notificationDuration = 5
     g_ShowNotification = true;
 }
 
+// Add the streamed assets to the scene and record the streaming timings.
+void UpdateSceneStreaming()
+{
+    if ( !g_Scene )
+    {
+        return;
+    }
+
+    g_Scene->ApplyStreamedAssets();
+
+    std::chrono::duration<float> loadingTime = std::chrono::high_resolution_clock::now() - g_LoadingStartTime;
+    SceneStreamingStatistics streamingStats = g_Scene->GetStreamingStatistics();
+
+    if ( g_TimeToFirstFrame < 0.0f )
+    {
+        g_TimeToFirstFrame = loadingTime.count();
+        LOG_INFO( "Time to first frame: ", g_TimeToFirstFrame, " seconds." );
+    }
+
+    if ( g_TimeToInteractive < 0.0f && streamingStats.IsHierarchyLoaded && streamingStats.NumVisibleAssetsLoaded == streamingStats.NumVisibleAssets )
+    {
+        g_TimeToInteractive = loadingTime.count();
+        LOG_INFO( "Time to interactive: ", g_TimeToInteractive, " seconds." );
+
+        char notificationText[255];
+        sprintf_s( notificationText, "Visible assets loaded in %.2f seconds.", g_TimeToInteractive );
+        Notify( notificationText );
+    }
+
+    if ( g_TimeToComplete < 0.0f && streamingStats.IsComplete )
+    {
+        g_TimeToComplete = loadingTime.count();
+        LOG_INFO( "Time to complete: ", g_TimeToComplete, " seconds." );
+    }
+}
+
 void SaveConfig()
 {
+    if ( g_SaveConfigTask.valid() )
+    {
+        Notify( "Config file is already being saved." );
+        return;
+    }
+
     Notify( "Saving config file...", FLT_MAX );
 
     g_Config.CameraPosition = g_Camera->GetTranslation();
     g_Config.CameraRotation = g_Camera->GetRotation();
-    g_Config.Save();
+    g_Config.LODPixelError = g_LODPixelError;
 
-    Notify( "Config file saved." );
+    HighResolutionTimer timer;
+    timer.Tick();
+
+    // Only taking the snapshot happens on this thread.
+    // Serializing the snapshot and replacing the file is done in the background.
+    g_SaveConfigTask = g_Config.SaveAsync();
+
+    timer.Tick();
+    LogManager::LogInfo( "Config snapshot taken in ", timer.ElapsedSeconds() * 1000.0, " ms." );
+}
+
+void UpdateSaveConfig()
+{
+    if ( g_SaveConfigTask.valid() && g_SaveConfigTask.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready )
+    {
+        // Notify is not thread safe so the result is reported on the update thread.
+        if ( g_SaveConfigTask.get() )
+        {
+            Notify( "Config file saved." );
+        }
+        else
+        {
+            Notify( "Failed to save config file." );
+        }
+    }
 }
 
 void FocusCurrentLight()
@@ -2247,6 +2719,113 @@ void FocusCurrentLight()
 
 }
 
+glm::vec4 GetLightBoundingSphere( const PointLight& light )
+{
+    return glm::vec4( glm::vec3( light.m_PositionWS ), light.m_Range );
+}
+
+// The smallest sphere that contains the cone of the spot light (see DebugLights_VS.hlsl).
+glm::vec4 GetLightBoundingSphere( const SpotLight& light )
+{
+    glm::vec3 position( light.m_PositionWS );
+    glm::vec3 direction = glm::normalize( glm::vec3( light.m_DirectionWS ) );
+    float angle = glm::radians( light.m_SpotlightAngle );
+
+    if ( angle > glm::quarter_pi<float>() )
+    {
+        // The sphere is centered on the base of the cone.
+        return glm::vec4( position + direction * light.m_Range, light.m_Range * glm::tan( angle ) );
+    }
+
+    // The sphere passes through the apex and the rim of the base of the cone.
+    float radius = light.m_Range / ( 2.0f * glm::cos( angle ) * glm::cos( angle ) );
+    return glm::vec4( position + direction * radius, radius );
+}
+
+void UpdateLightBVH( const glm::mat4& rotationMatrix )
+{
+    const uint32_t numPointLights = static_cast<uint32_t>( g_Config.PointLights.size() );
+    const uint32_t numLights = numPointLights + static_cast<uint32_t>( g_Config.SpotLights.size() );
+
+    if ( g_LightBVH.GetNumPrimitives() != numLights )
+    {
+        std::vector<glm::vec4> spheres;
+        spheres.reserve( numLights );
+        for ( const PointLight& light : g_Config.PointLights )
+        {
+            spheres.push_back( GetLightBoundingSphere( light ) );
+        }
+        for ( const SpotLight& light : g_Config.SpotLights )
+        {
+            spheres.push_back( GetLightBoundingSphere( light ) );
+        }
+
+        g_LightBVH.BuildSpheres( spheres );
+        g_LightBVHDirty = false;
+    }
+    else if ( g_LightBVHDirty )
+    {
+        // Usually only a few lights are modified in the light editor,
+        // only the nodes that contain modified lights are refitted.
+        for ( uint32_t i = 0; i < numLights; ++i )
+        {
+            glm::vec4 sphere = i < numPointLights ? GetLightBoundingSphere( g_Config.PointLights[i] ) : GetLightBoundingSphere( g_Config.SpotLights[i - numPointLights] );
+            if ( sphere != g_LightBVH.GetSphere( i ) )
+            {
+                g_LightBVH.UpdateSphere( i, sphere );
+            }
+        }
+
+        g_LightBVH.Update();
+        g_LightBVHDirty = false;
+    }
+    else if ( g_Animate && !g_IsLoading )
+    {
+        // The lights are animated on the GPU (see UpdateLights_CS.hlsl), 
+        // apply the same rotation to the bounding spheres.
+        for ( uint32_t i = 0; i < numLights; ++i )
+        {
+            glm::vec4 sphere = g_LightBVH.GetSphere( i );
+            g_LightBVH.UpdateSphere( i, glm::vec4( glm::vec3( rotationMatrix * glm::vec4( glm::vec3( sphere ), 1 ) ), sphere.w ) );
+        }
+
+        g_LightBVH.Update();
+    }
+}
+
+void PickLight( const glm::vec2& screenPoint )
+{
+    Ray ray = g_Camera->ScreenPointToRay( screenPoint );
+    BVH::Hit lightHit = g_LightBVH.Intersect( ray );
+
+    // Lights that are behind the scene geometry can't be picked.
+    const SceneMeshList* meshList = g_Scene ? g_Scene->GetMeshList() : nullptr;
+    SceneMeshList::RaycastHit sceneHit;
+    if ( lightHit.Primitive != BVH::InvalidPrimitive && meshList && meshList->Raycast( ray, sceneHit, lightHit.Distance ) )
+    {
+        lightHit = BVH::Hit();
+    }
+
+    const uint32_t numPointLights = static_cast<uint32_t>( g_Config.PointLights.size() );
+
+    SelectDirLight( nullptr );
+    if ( lightHit.Primitive == BVH::InvalidPrimitive )
+    {
+        SelectPointLight( nullptr );
+        SelectSpotLight( nullptr );
+    }
+    else if ( lightHit.Primitive < numPointLights )
+    {
+        SelectSpotLight( nullptr );
+        SelectPointLight( &g_Config.PointLights[lightHit.Primitive] );
+    }
+    else
+    {
+        SelectPointLight( nullptr );
+        SelectSpotLight( &g_Config.SpotLights[lightHit.Primitive - numPointLights] );
+    }
+}
+
 void SetMultisampleEnabled( bool multiSampleEnabled )
 {
     if ( g_Config.MultiSampleEnable != multiSampleEnabled )
@@ -2274,58 +2853,751 @@ void SetMultisampleEnabled( bool multiSampleEnabled )
 
 void SavePerformanceData()
 {
-    char buffer[80];
-    auto time = std::time( nullptr );
-    std::tm timeInfo;
-    localtime_s( &timeInfo, &time );
-
-    std::strftime( buffer, 80, "%Y-%m-%d-%H-%M-%S", &timeInfo );
-
     size_t numLights = g_Config.PointLights.size() + g_Config.SpotLights.size();
 
     std::wstringstream fileName;
-    fileName << "../Perf/" << buffer << " (" << g_RenderDevice->GetAdapter()->GetDescription() << ") @ " << g_WindowWidth << "x" << g_WindowHeight << " [" << RenderTechniqueName[(int)g_RenderingTechnique] << ", " << numLights << " lights]" << ".csv";
+    fileName << "../Perf/" << GetTimestampString().c_str() << " (" << g_RenderDevice->GetAdapter()->GetDescription() << ") @ " << g_WindowWidth << "x" << g_WindowHeight << " [" << RenderTechniqueName[(int)g_RenderingTechnique] << ", " << numLights << " lights]" << ".csv";
+
+    {
+        PrintProfileDataVisitor profilerVisitor( fileName.str() );
+        Profiler::Get().Accept( profilerVisitor );
+    }
+
+    // Append the light culling metrics to the profiling data.
+    {
+        std::ofstream file( fileName.str(), std::ios::out | std::ios::app );
+        g_LightCullingMetrics.WriteCSV( file );
+    }
+
+    // Write a JSON report next to the CSV file (see CompareBenchmarkReportFiles).
+    fs::path reportFileName = fs::path( fileName.str() ).replace_extension( "json" );
+    SaveBenchmarkReport( reportFileName );
 
-    PrintProfileDataVisitor profilerVisitor( fileName.str() );
-    Profiler::Get().Accept( profilerVisitor );
+    // The light culling histograms are written to a separate file.
+    g_LightCullingMetrics.Save( reportFileName.replace_filename( reportFileName.stem().wstring() + L" Light Culling.json" ) );
 
     Notify( ConvertString( fileName.str() + L" saved.") );
 }
 
-void ClearProfilingData()
+bool SaveBenchmarkReport( const fs::path& fileName )
 {
-    Profiler::Get().ClearAllProfilingData();
-    g_SelectedProfileMarker = nullptr;
-}
+    size_t numLights = g_Config.PointLights.size() + g_Config.SpotLights.size();
 
-void SetRenderingTechnique(RenderingTechnique technique)
-{
-    g_RenderingTechnique = technique;
-//    ClearProfilingData();
+    BenchmarkReport report;
+    report.SetMetadata( "time", GetTimestampString() );
+    report.SetMetadata( "adapter", ConvertString( g_RenderDevice->GetAdapter()->GetDescription() ) );
+    report.SetMetadata( "resolution", std::to_string( g_WindowWidth ) + "x" + std::to_string( g_WindowHeight ) );
+    report.SetMetadata( "technique", RenderTechniqueName[(int)g_RenderingTechnique] );
+    report.SetMetadata( "lights", std::to_string( numLights ) );
+    report.SetMetadata( "clusterBlockSize", std::to_string( g_ClusterGridBlockSize ) );
+    report.SetMetadata( "cullingOnly", g_CullingOnly ? "true" : "false" );
+    report.SetMetadata( "scene", ConvertString( g_Config.SceneFileName ) );
+    report.AddSystemInformation();
+    Profiler::Get().Accept( report );
+
+    for ( auto& source : g_LightCullingMetrics.GetSources() )
+    {
+        const LightCullingMetrics::SourceMetrics& metrics = source.second;
+        report.SetMetric( source.first + "/cells", metrics.NumCells.GetAverage() );
+        report.SetMetric( source.first + "/lightsPerCell", metrics.AverageLightsPerCell.GetAverage() );
+        report.SetMetric( source.first + "/maxLightsPerCell", metrics.MaxLightsPerCell.GetMax() );
+        report.SetMetric( source.first + "/fillRatio", metrics.FillRatio.GetMax() );
+        report.SetMetric( source.first + "/overflowedLights", metrics.NumOverflowedLights.GetMax() );
+        report.SetMetric( source.first + "/overflowedTransparentLights", metrics.NumOverflowedTransparentLights.GetMax() );
+        report.SetMetric( source.first + "/bvhNodesVisited", metrics.NumBVHNodesVisited.GetAverage() );
+    }
+
+    return report.Save( fileName );
 }
 
-void OnKeyPressed( KeyEventArgs& e )
+// Apply the settings of a benchmark step.
+// Returns false if the step cannot be run.
+bool ApplyBenchmarkStep( const BenchmarkSweep::Step& step )
 {
-    if ( ImGui::GetIO().WantCaptureKeyboard ) return;
+    auto technique = std::find_if( std::begin( RenderTechniqueName ), std::end( RenderTechniqueName ), [&step]( const char* name )
+    {
+        return step.Technique == name;
+    } );
 
-    switch ( e.Key )
+    if ( technique == std::end( RenderTechniqueName ) )
     {
-    case KeyCode::F1:
-        g_RenderDebugTexture = !g_RenderDebugTexture;
-        g_RenderDebugClusters = false;
-        break;
-    case KeyCode::F2:
-        g_RenderDebugClusters = !g_RenderDebugClusters;
-        g_RenderDebugTexture = false;
-        break;
-    case KeyCode::F4:
-        if ( e.Alt )
-        {
-    case KeyCode::Escape:
-            g_Application.Stop();
-        }
-        break;
-    case KeyCode::Enter:
+        LOG_ERROR( "Unknown rendering technique in benchmark settings: ", step.Technique );
+        return false;
+    }
+
+    SetRenderingTechnique( static_cast<RenderingTechnique>( technique - std::begin( RenderTechniqueName ) ) );
+
+    // The lights of the configuration are used until a different number of lights is requested.
+    uint32_t numPointLights = static_cast<uint32_t>( g_Config.PointLights.size() );
+    uint32_t numSpotLights = static_cast<uint32_t>( g_Config.SpotLights.size() );
+    if ( numPointLights + numSpotLights != step.NumLights )
+    {
+        // Keep the ratio of point lights to spot lights of the configuration.
+        uint32_t numConfigLights = g_Config.NumPointLights + g_Config.NumSpotLights;
+        double pointLightRatio = numConfigLights > 0 ? g_Config.NumPointLights / static_cast<double>( numConfigLights ) : 1.0;
+
+        g_Config.NumPointLights = static_cast<uint32_t>( std::round( step.NumLights * pointLightRatio ) );
+        g_Config.NumSpotLights = step.NumLights - g_Config.NumPointLights;
+
+        GenerateLights();
+    }
+
+    if ( g_ClusterGridBlockSize != step.ClusterBlockSize )
+    {
+        g_ClusterGridBlockSize = step.ClusterBlockSize;
+        UpdateClusterGrid();
+    }
+
+    // The Resize event is handled during the warmup frames.
+    if ( g_WindowWidth != step.Resolution.x || g_WindowHeight != step.Resolution.y )
+    {
+        g_RenderWindow->SetClientSize( step.Resolution.x, step.Resolution.y );
+    }
+
+    return true;
+}
+
+void UpdateBenchmarkSweep( UpdateEventArgs& e )
+{
+    // Wait until all meshes and textures are streamed in.
+    if ( !g_BenchmarkSweep || !g_Scene || !g_Scene->GetStreamingStatistics().IsComplete )
+    {
+        return;
+    }
+
+    const BenchmarkSettings& settings = g_BenchmarkSweep->GetSettings();
+    const std::vector<BenchmarkSweep::Step>& steps = g_BenchmarkSweep->GetSteps();
+
+    // Skip the steps that cannot be run.
+    while ( g_BenchmarkFrame == 0 && g_BenchmarkStep < steps.size() && !ApplyBenchmarkStep( steps[g_BenchmarkStep] ) )
+    {
+        ++g_BenchmarkStep;
+    }
+
+    if ( g_BenchmarkStep >= steps.size() )
+    {
+        g_BenchmarkSweep->SaveSummary( g_BenchmarkDirectory / L"Summary.csv" );
+        g_BenchmarkSweep.reset();
+
+        LOG_INFO( "Benchmark finished." );
+        g_Application.Stop();
+        return;
+    }
+
+    const BenchmarkSweep::Step& step = steps[g_BenchmarkStep];
+
+    uint32_t frame = g_BenchmarkFrame++;
+    if ( frame < settings.WarmupFrames )
+    {
+        frame = 0;
+    }
+    else
+    {
+        frame -= settings.WarmupFrames;
+
+        // Only the measured frames are in the report.
+        if ( frame == 0 )
+        {
+            ClearProfilingData();
+        }
+        else
+        {
+            // The elapsed time of the previous (measured) frame.
+            g_BenchmarkSweep->AddFrameTime( e.ElapsedTime );
+        }
+    }
+
+    BenchmarkCameraPose cameraPose = g_BenchmarkSweep->GetCameraPose( frame );
+    g_Camera->SetTranslate( cameraPose.Position );
+    g_CameraController->SetCameraRotation( cameraPose.Rotation );
+
+    if ( frame + 1 == settings.MeasureFrames && g_BenchmarkFrame > settings.WarmupFrames )
+    {
+        std::wstringstream fileName;
+        fileName << step.Technique.c_str() << " [" << step.NumLights << " lights] @ " << step.Resolution.x << "x" << step.Resolution.y << " (" << step.ClusterBlockSize << ").json";
+
+        fs::path reportFileName = g_BenchmarkDirectory / fileName.str();
+        SaveBenchmarkReport( reportFileName );
+        g_BenchmarkSweep->FinishStep( reportFileName.filename().wstring() );
+
+        g_BenchmarkFrame = 0;
+        ++g_BenchmarkStep;
+    }
+}
+
+void CaptureTimeline( uint32_t numFrames )
+{
+    std::wstringstream fileName;
+    fileName << "../Perf/" << GetTimestampString().c_str() << " [" << RenderTechniqueName[(int)g_RenderingTechnique] << "] Timeline.json";
+
+    Profiler::Get().CaptureTimeline( numFrames, fileName.str() );
+
+    Notify( ConvertString( L"Capturing " + std::to_wstring( numFrames ) + L" frames to " + fileName.str() ) );
+}
+
+void SaveHitches()
+{
+    fs::path fileName = g_FramePacingMonitor.SaveHitchReport( L"../Perf", RenderTechniqueName[(int)g_RenderingTechnique] );
+    if ( !fileName.empty() )
+    {
+        Notify( ConvertString( fileName.wstring() + L" saved." ) );
+    }
+}
+
+void ReadbackLightCullingStats( std::shared_ptr<ComputeCommandBuffer> commandBuffer, const std::string& source, uint32_t maxCells, uint32_t lightIndexListCapacity )
+{
+    LightCullingStatsReadback& readback = g_LightCullingStatsReadbacks[g_LightCullingStatsReadbackIndex];
+
+    // The statistics in the readback buffer must be published before the buffer is reused.
+    PublishLightCullingStats( readback, true );
+
+    commandBuffer->CopyResource( readback.Buffer, g_LightCullingStats );
+
+    readback.RenderFence = nullptr;
+    readback.Source = source;
+    readback.MaxCells = maxCells;
+    readback.LightIndexListCapacity = lightIndexListCapacity;
+    readback.IsPending = true;
+}
+
+void PublishLightCullingStats( LightCullingStatsReadback& readback, bool wait )
+{
+    if ( !readback.IsPending || !readback.RenderFence )
+    {
+        return;
+    }
+
+    if ( readback.RenderFence->GetStatus() != FenceStatus::Ready )
+    {
+        if ( !wait )
+        {
+            return;
+        }
+        readback.RenderFence->WaitFor();
+    }
+
+    uint32_t counters[LightCullingMetrics::NumCounters] = {};
+    readback.Buffer->GetData( counters );
+
+    g_LightCullingMetrics.Publish( readback.Source, LightCullingMetrics::Unpack( counters, readback.MaxCells, readback.LightIndexListCapacity ) );
+
+    readback.RenderFence = nullptr;
+    readback.IsPending = false;
+}
+
+void ClearProfilingData()
+{
+    Profiler::Get().ClearAllProfilingData();
+    g_SelectedProfileMarker = nullptr;
+    g_LightCullingMetrics.Reset();
+}
+
+void SetRenderingTechnique(RenderingTechnique technique)
+{
+    g_RenderingTechnique = technique;
+//    ClearProfilingData();
+}
+
+std::shared_ptr<RenderPass> ShadingPass( std::shared_ptr<RenderPass> pass )
+{
+    pass->SetEnabled( !g_CullingOnly );
+    return pass;
+}
+
+/**
+ * Report the number of triangles that are rendered with and without levels
+ * of detail for the camera poses of all configuration files (in the ../Conf folder)
+ * that use the currently loaded scene.
+ */
+void ReportLODStatistics()
+{
+    if ( !g_Scene || g_IsLoading )
+    {
+        return;
+    }
+
+    uint64_t numTriangles = 0;
+    uint64_t numLODTriangles = 0;
+    uint32_t numPoses = 0;
+
+    for ( auto& entry : fs::directory_iterator( L"../Conf" ) )
+    {
+        if ( entry.path().extension() != L".3dgep" )
+        {
+            continue;
+        }
+
+        ConfigurationSettings config;
+        if ( !config.Load( entry.path().wstring() ) || fs::path( config.SceneFileName ).filename() != fs::path( g_Config.SceneFileName ).filename() )
+        {
+            continue;
+        }
+
+        // Use the same projection as the current camera.
+        Camera camera = *g_Camera;
+        camera.SetTranslate( config.CameraPosition );
+        camera.SetRotate( config.CameraRotation );
+
+        LODStatisticsVisitor lodStatisticsVisitor( camera, g_LODPixelError );
+        g_Scene->Accept( lodStatisticsVisitor );
+
+        LogManager::LogInfo( L"LOD statistics ", entry.path().filename().wstring(), L": ", lodStatisticsVisitor.GetNumTriangles(), L" -> ", lodStatisticsVisitor.GetNumLODTriangles(), L" triangles." );
+
+        numTriangles += lodStatisticsVisitor.GetNumTriangles();
+        numLODTriangles += lodStatisticsVisitor.GetNumLODTriangles();
+        ++numPoses;
+    }
+
+    if ( numPoses > 0 )
+    {
+        std::stringstream ss;
+        ss << "LOD (" << g_LODPixelError << " px): " << numTriangles / numPoses << " -> " << numLODTriangles / numPoses << " triangles per frame (" << numPoses << " camera poses).";
+        LogManager::LogInfo( ss.str() );
+        Notify( ss.str() );
+    }
+    else
+    {
+        Notify( "No camera poses found for the current scene." );
+    }
+}
+
+/**
+ * Compare the cost of computing the world transforms of a synthetic hierarchy of
+ * 100,000 scene nodes by concatenating the local transforms up to the root node
+ * (which is what SceneNode::GetWorldTransform used to do) with the cost of
+ * updating the flat transform hierarchy.
+ */
+void BenchmarkTransformHierarchy()
+{
+    const uint32_t numNodes = 100000;
+    // Every node has 4 children (the hierarchy is about 8 levels deep).
+    const uint32_t numChildren = 4;
+    // The world transform of every node is requested once for every pass that renders
+    // the scene (depth prepass, cluster samples, opaque pass and transparent pass).
+    const uint32_t numPasses = 4;
+
+    HighResolutionTimer timer;
+
+    std::vector< std::shared_ptr<SceneNode> > nodes( numNodes );
+    for ( uint32_t i = 0; i < numNodes; ++i )
+    {
+        glm::mat4 localTransform = glm::translate( glm::linearRand( glm::vec3( -1 ), glm::vec3( 1 ) ) ) * glm::rotate( glm::linearRand( 0.0f, glm::two_pi<float>() ), glm::vec3( 0, 1, 0 ) );
+        nodes[i] = std::make_shared<SceneNode>( localTransform );
+        if ( i > 0 )
+        {
+            nodes[( i - 1 ) / numChildren]->AddChild( nodes[i] );
+        }
+    }
+    std::shared_ptr<TransformHierarchy> transformHierarchy = nodes[0]->GetTransformHierarchy();
+    transformHierarchy->Update();
+
+    timer.Tick();
+    double buildTime = timer.ElapsedSeconds();
+
+    // Accumulate the translations so the compiler can't optimize the loops away.
+    glm::vec4 checksum( 0 );
+
+    for ( uint32_t pass = 0; pass < numPasses; ++pass )
+    {
+        for ( auto& node : nodes )
+        {
+            glm::mat4 worldTransform = node->GetLocalTransform();
+            for ( auto parent = node->GetParent(); parent; parent = parent->GetParent() )
+            {
+                worldTransform = parent->GetLocalTransform() * worldTransform;
+            }
+            checksum += worldTransform[3];
+        }
+    }
+
+    timer.Tick();
+    double recursiveTime = timer.ElapsedSeconds();
+
+    // Dirty the root node so all of the world transforms are updated.
+    nodes[0]->SetLocalTransform( nodes[0]->GetLocalTransform() );
+    transformHierarchy->Update();
+
+    timer.Tick();
+    double fullUpdateTime = timer.ElapsedSeconds();
+
+    for ( uint32_t pass = 0; pass < numPasses; ++pass )
+    {
+        for ( auto& node : nodes )
+        {
+            checksum += node->GetWorldTransform()[3];
+        }
+    }
+
+    timer.Tick();
+    double cachedTime = timer.ElapsedSeconds();
+
+    // Move 1% of the nodes (only leaf nodes are moved).
+    for ( uint32_t i = numNodes / numChildren + 1; i < numNodes; i += 75 )
+    {
+        nodes[i]->SetLocalTransform( nodes[i]->GetLocalTransform() );
+    }
+    transformHierarchy->Update();
+
+    timer.Tick();
+    double partialUpdateTime = timer.ElapsedSeconds();
+
+    std::stringstream ss;
+    ss << "Transform hierarchy (" << numNodes << " nodes, " << numPasses << " passes): "
+       << "recursive " << recursiveTime * 1000.0 << " ms, "
+       << "flat " << ( fullUpdateTime + cachedTime ) * 1000.0 << " ms "
+       << "(update " << fullUpdateTime * 1000.0 << " ms, 1% dirty update " << partialUpdateTime * 1000.0 << " ms).";
+
+    LogManager::LogInfo( ss.str() );
+    LogManager::LogInfo( "Transform hierarchy build time: ", buildTime * 1000.0, " ms (checksum ", glm::length( checksum ), ")." );
+    Notify( ss.str() );
+}
+
+/**
+ * Measure the build, refit and query throughput of a light hierarchy of 100,000
+ * randomly generated point lights. Rays are traced through a grid of points
+ * on the screen one at a time, in packets of 2x2 points and (for a subset of
+ * the rays) by testing every light. If a scene is loaded, the throughput of
+ * the scene raycasts is measured too.
+ */
+void BenchmarkPicking()
+{
+    const uint32_t numLights = 100000;
+    // The number of rays in each direction (must be a multiple of 2).
+    const uint32_t numRaysX = 512;
+    const uint32_t numRaysY = 512;
+    // Only every n-th ray is tested against every light.
+    const uint32_t bruteForceStride = 256;
+    // The number of rays in each direction that are traced against the scene.
+    const uint32_t numSceneRays = 64;
+
+    std::vector<glm::vec4> spheres( numLights );
+    std::vector<PointLight> lights = GenerateLights<PointLight>( CreateLightGenerator(), numLights, LightGenerator::PointLightStream );
+    for ( uint32_t i = 0; i < numLights; ++i )
+    {
+        spheres[i] = GetLightBoundingSphere( lights[i] );
+    }
+
+    // The rays are stored in 2x2 quads so that every 4 consecutive rays form a coherent packet.
+    const Viewport& viewport = g_Camera->GetViewport();
+    std::vector<Ray> rays;
+    rays.reserve( numRaysX * numRaysY );
+    for ( uint32_t y = 0; y < numRaysY; y += 2 )
+    {
+        for ( uint32_t x = 0; x < numRaysX; x += 2 )
+        {
+            for ( uint32_t i = 0; i < 4; ++i )
+            {
+                glm::vec2 screenPoint( viewport.X + ( x + ( i & 1 ) + 0.5f ) * viewport.Width / numRaysX,
+                                       viewport.Y + ( y + ( i >> 1 ) + 0.5f ) * viewport.Height / numRaysY );
+                rays.push_back( g_Camera->ScreenPointToRay( screenPoint ) );
+            }
+        }
+    }
+    const uint32_t numRays = static_cast<uint32_t>( rays.size() );
+
+    HighResolutionTimer timer;
+
+    BVH bvh;
+    bvh.BuildSpheres( spheres );
+
+    timer.Tick();
+    double buildTime = timer.ElapsedSeconds();
+
+    // Count the hits so the compiler can't optimize the loops away.
+    uint32_t numHits = 0;
+    for ( const Ray& ray : rays )
+    {
+        numHits += bvh.Intersect( ray ).Primitive != BVH::InvalidPrimitive ? 1 : 0;
+    }
+
+    timer.Tick();
+    double scalarTime = timer.ElapsedSeconds();
+
+    uint32_t numPacketHits = 0;
+    for ( uint32_t i = 0; i < numRays; i += 4 )
+    {
+        BVH::Hit hits[4];
+        bvh.IntersectPacket( &rays[i], hits );
+        for ( const BVH::Hit& hit : hits )
+        {
+            numPacketHits += hit.Primitive != BVH::InvalidPrimitive ? 1 : 0;
+        }
+    }
+
+    timer.Tick();
+    double packetTime = timer.ElapsedSeconds();
+
+    uint32_t numBruteForceRays = 0;
+    uint32_t numBruteForceHits = 0;
+    for ( uint32_t i = 0; i < numRays; i += bruteForceStride )
+    {
+        const Ray& ray = rays[i];
+        float closest = FLT_MAX;
+        for ( const glm::vec4& sphere : spheres )
+        {
+            glm::vec3 oc = ray.m_Origin - glm::vec3( sphere );
+            float b = glm::dot( oc, ray.m_Direction );
+            float c = glm::dot( oc, oc ) - sphere.w * sphere.w;
+            float discriminant = b * b - c;
+            if ( discriminant >= 0.0f )
+            {
+                float t = -b - glm::sqrt( discriminant );
+                t = t >= 0.0f ? t : -b + glm::sqrt( discriminant );
+                if ( t >= 0.0f && t < closest )
+                {
+                    closest = t;
+                }
+            }
+        }
+        numBruteForceHits += closest < FLT_MAX ? 1 : 0;
+        ++numBruteForceRays;
+    }
+
+    timer.Tick();
+    double bruteForceTime = timer.ElapsedSeconds();
+
+    // Move 1% of the lights.
+    for ( uint32_t i = 0; i < numLights; i += 100 )
+    {
+        bvh.UpdateSphere( i, spheres[i] + glm::vec4( glm::sphericalRand( 0.1f ), 0.0f ) );
+    }
+    bvh.Update();
+
+    timer.Tick();
+    double partialRefitTime = timer.ElapsedSeconds();
+
+    // Rotate all of the lights (like the light animation).
+    glm::mat4 rotationMatrix = glm::rotate( glm::mat4( 1 ), 0.1f, glm::vec3( 0, 1, 0 ) );
+    for ( uint32_t i = 0; i < numLights; ++i )
+    {
+        glm::vec4 sphere = bvh.GetSphere( i );
+        bvh.UpdateSphere( i, glm::vec4( glm::vec3( rotationMatrix * glm::vec4( glm::vec3( sphere ), 1 ) ), sphere.w ) );
+    }
+    bool rebuilt = bvh.Update();
+
+    timer.Tick();
+    double fullRefitTime = timer.ElapsedSeconds();
+
+    std::stringstream ss;
+    ss << "Light picking (" << numLights << " lights, " << numRays << " rays): "
+       << "build " << buildTime * 1000.0 << " ms, "
+       << "single rays " << numRays / scalarTime * 1e-6 << " Mrays/s, "
+       << "packets " << numRays / packetTime * 1e-6 << " Mrays/s, "
+       << "brute force " << numBruteForceRays / bruteForceTime * 1e-6 << " Mrays/s, "
+       << "1% refit " << partialRefitTime * 1000.0 << " ms, "
+       << "100% refit " << fullRefitTime * 1000.0 << " ms" << ( rebuilt ? " (rebuilt)." : "." );
+
+    LogManager::LogInfo( ss.str() );
+    LogManager::LogInfo( "Light picking hits: ", numHits, " single rays, ", numPacketHits, " packets, ", numBruteForceHits, " / ", numBruteForceRays, " brute force." );
+
+    const SceneMeshList* meshList = g_Scene ? g_Scene->GetMeshList() : nullptr;
+    if ( meshList )
+    {
+        timer.Tick();
+
+        uint32_t numSceneHits = 0;
+        for ( uint32_t y = 0; y < numSceneRays; ++y )
+        {
+            for ( uint32_t x = 0; x < numSceneRays; ++x )
+            {
+                glm::vec2 screenPoint( viewport.X + ( x + 0.5f ) * viewport.Width / numSceneRays,
+                                       viewport.Y + ( y + 0.5f ) * viewport.Height / numSceneRays );
+                SceneMeshList::RaycastHit hit;
+                numSceneHits += meshList->Raycast( g_Camera->ScreenPointToRay( screenPoint ), hit ) ? 1 : 0;
+            }
+        }
+
+        timer.Tick();
+        double sceneTime = timer.ElapsedSeconds();
+
+        LogManager::LogInfo( "Scene picking (", meshList->GetNumMeshes(), " meshes): ", numSceneRays * numSceneRays / sceneTime * 1e-6, " Mrays/s (", numSceneHits, " hits)." );
+    }
+
+    Notify( ss.str() );
+}
+
+/**
+ * Compare the time it takes to save and load a configuration file that stores
+ * 100,000 randomly generated lights in the XML archive with a configuration file
+ * that stores the lights in a light set file. The light set is also loaded
+ * with 1,000,000 lights (which is impractical with the XML archive).
+ */
+void BenchmarkLightSets()
+{
+    const uint32_t numLights = 100000;
+    const uint32_t numLightsLarge = 1000000;
+
+    fs::path tempPath = fs::temp_directory_path();
+    fs::path configPath = tempPath / "LightSetBenchmark.3dgep";
+    fs::path lightSetPath = tempPath / "LightSetBenchmark.lights";
+
+    ConfigurationSettings config = g_Config;
+    LightGenerator generator = CreateLightGenerator();
+    config.PointLights = GenerateLights<PointLight>( generator, numLights, LightGenerator::PointLightStream );
+    config.SpotLights = GenerateLights<SpotLight>( generator, numLights / 10, LightGenerator::SpotLightStream );
+
+    HighResolutionTimer timer;
+    timer.Tick();
+
+    config.LightsFileName.clear();
+    config.Save( configPath.wstring() );
+
+    timer.Tick();
+    double xmlSaveTime = timer.ElapsedSeconds();
+    uintmax_t xmlSize = fs::file_size( configPath );
+
+    ConfigurationSettings loadedConfig;
+    loadedConfig.Load( configPath.wstring() );
+
+    timer.Tick();
+    double xmlLoadTime = timer.ElapsedSeconds();
+
+    config.LightsFileName = lightSetPath.filename().wstring();
+    config.Save( configPath.wstring() );
+
+    timer.Tick();
+    double binarySaveTime = timer.ElapsedSeconds();
+    uintmax_t binarySize = fs::file_size( configPath ) + fs::file_size( lightSetPath );
+
+    loadedConfig.Load( configPath.wstring() );
+
+    timer.Tick();
+    double binaryLoadTime = timer.ElapsedSeconds();
+
+    // Make sure the light set contains the same lights as the XML archive.
+    bool lightsMatch = loadedConfig.PointLights.size() == config.PointLights.size() && loadedConfig.SpotLights.size() == config.SpotLights.size();
+    for ( size_t i = 0; lightsMatch && i < config.PointLights.size(); ++i )
+    {
+        lightsMatch = loadedConfig.PointLights[i].m_PositionWS == config.PointLights[i].m_PositionWS && loadedConfig.PointLights[i].m_Range == config.PointLights[i].m_Range;
+    }
+
+    // Only the light set is used for the large number of lights.
+    std::vector<PointLight> pointLights = GenerateLights<PointLight>( generator, numLightsLarge, LightGenerator::PointLightStream );
+    timer.Tick();
+
+    LightSet::Save( lightSetPath, pointLights, config.SpotLights, config.DirectionalLights );
+
+    timer.Tick();
+    double largeSaveTime = timer.ElapsedSeconds();
+
+    LightSet lightSet;
+    lightSet.Open( lightSetPath );
+
+    timer.Tick();
+    double largeOpenTime = timer.ElapsedSeconds();
+
+    lightSet.GetPointLights( pointLights );
+
+    timer.Tick();
+    double largeLoadTime = timer.ElapsedSeconds();
+
+    lightSet.Close();
+    fs::remove( configPath );
+    fs::remove( lightSetPath );
+
+    std::stringstream ss;
+    ss << "Light sets (" << numLights << " point lights, " << numLights / 10 << " spot lights): "
+       << "XML save " << xmlSaveTime * 1000.0 << " ms, load " << xmlLoadTime * 1000.0 << " ms (" << xmlSize / 1024 << " KB), "
+       << "light set save " << binarySaveTime * 1000.0 << " ms, load " << binaryLoadTime * 1000.0 << " ms (" << binarySize / 1024 << " KB)"
+       << ( lightsMatch ? "." : " (lights don't match!)." );
+
+    LogManager::LogInfo( ss.str() );
+    LogManager::LogInfo( "Light set (", numLightsLarge, " point lights): save ", largeSaveTime * 1000.0, " ms, map ", largeOpenTime * 1000.0, " ms, load ", largeLoadTime * 1000.0, " ms." );
+    Notify( ss.str() );
+}
+
+/**
+ * Measure the cost of pushing and popping a CPU profiler marker.
+ * Markers with a compile time hash (PROFILE_MARKER) only write two events to
+ * the ring buffer of the thread. Markers with a runtime name (std::wstring) are
+ * interned on every push which is close to the cost of the old mutex and
+ * std::wstring map lookup. The markers are recorded in batches that fit in the
+ * ring buffer of the thread and the buffer is flushed between the batches so
+ * aggregating the events is not included.
+ */
+void BenchmarkProfilerMarkers()
+{
+    // Every marker records two events (leave room for the benchmark marker).
+    const uint32_t numMarkersPerBatch = ( Profiler::EventBufferCapacity - 2 ) / 2;
+    const uint32_t numBatches = 50;
+    const uint32_t numMarkers = numMarkersPerBatch * numBatches;
+
+    Profiler& profiler = Profiler::Get();
+    HighResolutionTimer timer;
+
+    ScopedProfileMarker benchmarkMarker( PROFILE_MARKER( "Benchmark Profiler Markers" ) );
+
+    std::wstring markerName = L"Runtime Marker";
+    double staticTime = 0.0;
+    double indexedTime = 0.0;
+    double runtimeTime = 0.0;
+
+    for ( uint32_t batch = 0; batch < numBatches; ++batch )
+    {
+        profiler.Flush();
+        timer.Tick();
+
+        for ( uint32_t i = 0; i < numMarkersPerBatch; ++i )
+        {
+            ScopedProfileMarker marker( PROFILE_MARKER( "Static Marker" ) );
+        }
+
+        timer.Tick();
+        staticTime += timer.ElapsedSeconds();
+
+        profiler.Flush();
+        timer.Tick();
+
+        for ( uint32_t i = 0; i < numMarkersPerBatch; ++i )
+        {
+            ScopedProfileMarker marker( PROFILE_MARKER( "Indexed Marker " ), i % 8 );
+        }
+
+        timer.Tick();
+        indexedTime += timer.ElapsedSeconds();
+
+        profiler.Flush();
+        timer.Tick();
+
+        for ( uint32_t i = 0; i < numMarkersPerBatch; ++i )
+        {
+            ScopedProfileMarker marker( markerName );
+        }
+
+        timer.Tick();
+        runtimeTime += timer.ElapsedSeconds();
+    }
+
+    std::stringstream ss;
+    ss << "Profiler markers: static " << staticTime / numMarkers * 1e9 << " ns, indexed " << indexedTime / numMarkers * 1e9
+       << " ns, runtime name " << runtimeTime / numMarkers * 1e9 << " ns per marker.";
+
+    LogManager::LogInfo( ss.str() );
+    Notify( ss.str() );
+}
+
+void OnKeyPressed( KeyEventArgs& e )
+{
+    if ( ImGui::GetIO().WantCaptureKeyboard ) return;
+
+    switch ( e.Key )
+    {
+    case KeyCode::F1:
+        g_RenderDebugTexture = !g_RenderDebugTexture;
+        g_RenderDebugClusters = false;
+        break;
+    case KeyCode::F2:
+        g_RenderDebugClusters = !g_RenderDebugClusters;
+        g_RenderDebugTexture = false;
+        break;
+    case KeyCode::F4:
+        if ( e.Alt )
+        {
+    case KeyCode::Escape:
+            g_Application.Stop();
+        }
+        break;
+    case KeyCode::Enter:
         if ( e.Alt )
         {
     case KeyCode::F11:
@@ -2350,13 +3622,22 @@ void OnKeyPressed( KeyEventArgs& e )
         }
         break;
     case KeyCode::L:
-        g_RenderLights = !g_RenderLights;
+        if ( e.Control && e.Shift )
+        {
+            ReportLODStatistics();
+        }
+        else
+        {
+            g_RenderLights = !g_RenderLights;
+        }
         break;
     case KeyCode::M:
         SetMultisampleEnabled( !g_Config.MultiSampleEnable );
         break;
     case KeyCode::P:
+        if ( e.Control && e.Shift )
         {
+            BenchmarkProfilerMarkers();
         }
         break;
     case KeyCode::R:
@@ -2380,6 +3661,36 @@ void OnKeyPressed( KeyEventArgs& e )
             SaveConfig();
         }
         break;
+    case KeyCode::T:
+        if ( e.Control && e.Shift )
+        {
+            BenchmarkTransformHierarchy();
+        }
+        break;
+    case KeyCode::B:
+        if ( e.Control && e.Shift )
+        {
+            BenchmarkPicking();
+        }
+        break;
+    case KeyCode::C:
+        if ( e.Control && e.Shift )
+        {
+            CaptureTimeline();
+        }
+        break;
+    case KeyCode::K:
+        if ( e.Control && e.Shift )
+        {
+            BenchmarkLightSets();
+        }
+        break;
+    case KeyCode::H:
+        if ( e.Control && e.Shift )
+        {
+            SaveHitches();
+        }
+        break;
     case KeyCode::Y:
         g_InvertY = !g_InvertY;
         break;
@@ -2412,6 +3723,9 @@ void OnKeyPressed( KeyEventArgs& e )
             case KeyCode::D5:
                 g_ShowOptionsWindow = !g_ShowOptionsWindow;
                 break;
+            case KeyCode::D6:
+                g_ShowResourceMemory = !g_ShowResourceMemory;
+                break;
         }
     }
     else
@@ -2457,6 +3771,17 @@ void OnMouseWheel( MouseWheelEventArgs& e )
     }
 }
 
+// Ctrl + left mouse button selects the light under the mouse cursor.
+void OnMouseButtonPressed( MouseButtonEventArgs& e )
+{
+    if ( ImGui::GetIO().WantCaptureMouse ) return;
+
+    if ( e.Button == MouseButton::Left && e.Control )
+    {
+        PickLight( glm::vec2( e.X, e.Y ) );
+    }
+}
+
 
 void OnWindowClose( WindowCloseEventArgs& e )
 {
@@ -2505,6 +3830,8 @@ glm::vec3 HSVtoRGB( float H, float S, float V )
 
 void CreatePointLightsBuffer( std::shared_ptr<CopyCommandBuffer> commandBuffer = nullptr )
 {
+    ResourceRegistry::ScopedGroup resourceGroup( L"Lights" );
+
     bool bSubmit = false;
     if ( !commandBuffer )
     {
@@ -2516,6 +3843,7 @@ void CreatePointLightsBuffer( std::shared_ptr<CopyCommandBuffer> commandBuffer =
     g_PointLightsBuffer->SetName( L"Point Lights Buffer" );
 
     g_PointLightsReadbackBuffer = g_RenderDevice->CreateReadbackBuffer( g_Config.PointLights.size() * sizeof( PointLight ) );
+    g_LightBVHDirty = true;
 
     if ( bSubmit )
     {
@@ -2526,6 +3854,8 @@ void CreatePointLightsBuffer( std::shared_ptr<CopyCommandBuffer> commandBuffer =
 
 void CreateSpotLightsBuffer( std::shared_ptr<CopyCommandBuffer> commandBuffer = nullptr )
 {
+    ResourceRegistry::ScopedGroup resourceGroup( L"Lights" );
+
     bool bSubmit = false;
     if ( !commandBuffer )
     {
@@ -2537,6 +3867,7 @@ void CreateSpotLightsBuffer( std::shared_ptr<CopyCommandBuffer> commandBuffer =
     g_SpotLightsBuffer->SetName( L"Spot Lights Buffer" );
 
     g_SpotLightsReadbackBuffer = g_RenderDevice->CreateReadbackBuffer( g_Config.SpotLights.size() * sizeof( SpotLight ) );
+    g_LightBVHDirty = true;
 
     if ( bSubmit )
     {
@@ -2547,6 +3878,8 @@ void CreateSpotLightsBuffer( std::shared_ptr<CopyCommandBuffer> commandBuffer =
 
 void CreateDirLightsBuffer( std::shared_ptr<CopyCommandBuffer> commandBuffer = nullptr )
 {
+    ResourceRegistry::ScopedGroup resourceGroup( L"Lights" );
+
     bool bSubmit = false;
     if ( !commandBuffer )
     {
@@ -2569,6 +3902,8 @@ void CreateDirLightsBuffer( std::shared_ptr<CopyCommandBuffer> commandBuffer = n
 // Create the lights structured buffers.
 void CreateLightBuffers()
 {
+    ResourceRegistry::ScopedGroup resourceGroup( L"Lights" );
+
     auto commandQueue = g_RenderDevice->GetCopyQueue();
     auto commandBuffer = commandQueue->GetCopyCommandBuffer();
 
@@ -2739,6 +4074,7 @@ void ReadbackLightBufers()
     g_PointLightsReadbackBuffer->GetData( g_Config.PointLights.data() );
     g_SpotLightsReadbackBuffer->GetData( g_Config.SpotLights.data() );
     g_DirectionalLightsReadbackBuffer->GetData( g_Config.DirectionalLights.data() );
+    g_LightBVHDirty = true;
 }
 
 void GenerateLights()
@@ -2747,13 +4083,25 @@ void GenerateLights()
     SelectSpotLight( nullptr );
     SelectDirLight( nullptr );
 
-    g_Config.PointLights = GenerateLights<PointLight>( g_Config.NumPointLights );
-    g_Config.SpotLights = GenerateLights<SpotLight>( g_Config.NumSpotLights );
-    g_Config.DirectionalLights = GenerateLights<DirectionalLight>( g_Config.NumDirectionalLights );
+    HighResolutionTimer timer;
+    timer.Tick();
+
+    LightGenerator generator = CreateLightGenerator();
+    g_Config.PointLights = GenerateLights<PointLight>( generator, g_Config.NumPointLights, LightGenerator::PointLightStream );
+    g_Config.SpotLights = GenerateLights<SpotLight>( generator, g_Config.NumSpotLights, LightGenerator::SpotLightStream );
+    g_Config.DirectionalLights = GenerateLights<DirectionalLight>( generator, g_Config.NumDirectionalLights, LightGenerator::DirectionalLightStream );
+
+    timer.Tick();
+    LogManager::LogInfo( "Generated ", g_Config.NumPointLights + g_Config.NumSpotLights + g_Config.NumDirectionalLights, " lights (", LightDistributionName[static_cast<int>( generator.GetDistribution() )], ", seed ", g_Config.LightsSeed, ") in ", timer.ElapsedSeconds() * 1000.0, " ms." );
 
     CreateLightBuffers();
 }
 
+LightGenerator CreateLightGenerator()
+{
+    return LightGenerator( g_Config, g_Scene ? g_Scene->GetMeshList() : nullptr );
+}
+
 template<typename LightType>
 LightType GenerateLight( const glm::vec4& positionWS, const glm::vec4& directionWS, float spotAngle, float range, const glm::vec3& color )
 {
@@ -2811,20 +4159,16 @@ std::vector<glm::vec4> GenerateColors( uint32_t numColors )
 }
 
 template<typename LightType>
-std::vector<LightType> GenerateLights( uint32_t numLights )
+std::vector<LightType> GenerateLights( const LightGenerator& generator, uint32_t numLights, uint32_t stream )
 {
     std::vector<LightType> lights( numLights );
 
-    for ( auto& light : lights )
+    // The lights are generated on multiple threads.
+    generator.Generate( numLights, stream, [&lights]( uint32_t index, const LightGenerator::Sample& sample )
     {
-        glm::vec4 positionWS = glm::vec4( glm::linearRand( g_Config.LightsMinBounds, g_Config.LightsMaxBounds ), 1.0f );
-        glm::vec4 directionWS = glm::vec4( glm::sphericalRand( 1.0f ), 0.0f );
-        float spotAngle = glm::linearRand( g_Config.MinSpotAngle, g_Config.MaxSpotAngle );
-        float range = glm::linearRand( g_Config.MinRange, g_Config.MaxRange );
-        glm::vec3 color = HSVtoRGB( glm::linearRand( 0.0f, 360.0f ), glm::linearRand( 0.0f, 1.0f ), 1.0f );
-
-        light = GenerateLight<LightType>( positionWS, directionWS, spotAngle, range, color );
-    }
+        glm::vec3 color = HSVtoRGB( sample.Hue, sample.Saturation, 1.0f );
+        lights[index] = GenerateLight<LightType>( sample.PositionWS, sample.DirectionWS, sample.SpotAngle, sample.Range, color );
+    } );
 
     return lights;
 }
@@ -2853,9 +4197,105 @@ void PlotStats( const Core::Statistic<T> &stats, const std::string& overlay = ""
 }
 
 // GUI functions
+void ShowLightCullingMetrics()
+{
+    LightCullingMetrics::SourceMap sources = g_LightCullingMetrics.GetSources();
+    auto iter = sources.find( RenderTechniqueName[(int)g_RenderingTechnique] );
+    if ( iter == sources.end() )
+    {
+        ImGui::TextDisabled( "No light culling statistics for this technique." );
+        return;
+    }
+
+    const LightCullingMetrics::SourceMetrics& metrics = iter->second;
+    const LightCullingStatistics& stats = metrics.Latest;
+
+    const char* cellName = g_RenderingTechnique == RenderingTechnique::ForwardPlus ? "Tiles" : "Unique clusters";
+    ImGui::Text( "%s: %u / %u", cellName, stats.NumCells, stats.MaxCells );
+    ImGui::Text( "Lights per cell: %.2f (max: %u)", stats.GetAverageLightsPerCell(), stats.MaxLightsPerCell );
+    ImGui::Text( "Light index lists: %.2f%% full (%u point, %u spot / %u)", stats.GetFillRatio() * 100.0, stats.NumPointLightIndices, stats.NumSpotLightIndices, stats.LightIndexListCapacity );
+    if ( stats.NumOverflowedLights > 0 || stats.GetFillRatio() > 1.0 )
+    {
+        ImGui::TextColored( ImVec4( 1, 0, 0, 1 ), "Overflowed lights: %u", stats.NumOverflowedLights );
+    }
+    else
+    {
+        ImGui::Text( "Overflowed lights: %u", stats.NumOverflowedLights );
+    }
+    if ( g_RenderingTechnique == RenderingTechnique::ForwardPlus )
+    {
+        if ( stats.NumOverflowedTransparentLights > 0 )
+        {
+            ImGui::TextColored( ImVec4( 1, 0, 0, 1 ), "Overflowed transparent lights: %u", stats.NumOverflowedTransparentLights );
+        }
+        else
+        {
+            ImGui::Text( "Overflowed transparent lights: %u", stats.NumOverflowedTransparentLights );
+        }
+    }
+    if ( g_RenderingTechnique == RenderingTechnique::Clustered_Optimized )
+    {
+        double nodesPerCell = stats.NumCells > 0 ? static_cast<double>( stats.NumBVHNodesVisited ) / stats.NumCells : 0.0;
+        ImGui::Text( "BVH nodes visited: %u (%.2f per cluster)", stats.NumBVHNodesVisited, nodesPerCell );
+    }
+
+    auto binGetter = []( void* data, int idx )
+    {
+        return static_cast<float>( reinterpret_cast<const uint32_t*>( data )[idx] );
+    };
+
+    std::string overlay = "0, 1, 2-3 ... " + LightCullingStatistics::GetHistogramBinName( LightCullingStatistics::NumHistogramBins - 1 ) + " lights";
+    ImGui::PlotHistogram( "Lights per Cell", binGetter, (void*)stats.LightsPerCell.data(), LightCullingStatistics::NumHistogramBins, 0, overlay.c_str(), 0.0f, FLT_MAX, ImVec2( 0, 80 ) );
+}
+
+void ShowFramePacing()
+{
+    const FramePacingMonitor::Histogram& histogram = g_FramePacingMonitor.GetHistogram();
+
+    auto binGetter = []( void* data, int idx )
+    {
+        return static_cast<float>( reinterpret_cast<const uint64_t*>( data )[idx] );
+    };
+
+    // Only show the bins up to the longest frame.
+    int numBins = static_cast<int>( std::min<double>( g_FramePacingMonitor.GetFrameTimes().GetMax() * 1000.0 / FramePacingMonitor::HistogramBinWidth + 2.0, FramePacingMonitor::NumHistogramBins ) );
+    ImGui::PlotHistogram( "Frame Times", binGetter, (void*)histogram.data(), std::max( numBins, 1 ), 0, "1 ms bins", 0.0f, FLT_MAX, ImVec2( 0, 80 ) );
+
+    float hitchThreshold = static_cast<float>( g_FramePacingMonitor.GetHitchThreshold() );
+    if ( ImGui::SliderFloat( "Hitch Threshold", &hitchThreshold, 1.5f, 10.0f, "%.1fx median" ) )
+    {
+        g_FramePacingMonitor.SetHitchThreshold( hitchThreshold );
+    }
+
+    ImGui::Text( "Hitches: %llu / %llu frames", g_FramePacingMonitor.GetNumHitches(), g_FramePacingMonitor.GetNumFrames() );
+    if ( ImGui::Button( "Save Hitches" ) )
+    {
+        SaveHitches();
+    }
+    ImGui::SameLine();
+    if ( ImGui::Button( "Clear Hitches" ) )
+    {
+        g_FramePacingMonitor.Reset();
+    }
+
+    // Show the causes of the most recent hitches.
+    const std::deque<FramePacingMonitor::Hitch>& hitches = g_FramePacingMonitor.GetHitches();
+    const size_t maxHitchesShown = 5;
+    size_t numHitchesShown = 0;
+    for ( auto hitch = hitches.rbegin(); hitch != hitches.rend() && numHitchesShown < maxHitchesShown; ++hitch, ++numHitchesShown )
+    {
+        ImGui::Text( "Frame %llu: %.3f ms (median %.3f ms)", hitch->Frame, hitch->FrameTime, hitch->MedianFrameTime );
+        for ( size_t i = 0; i < std::min<size_t>( hitch->Markers.size(), 3 ) && hitch->Markers[i].Excess > 0.0; ++i )
+        {
+            const FramePacingMonitor::HitchMarker& marker = hitch->Markers[i];
+            ImGui::TextDisabled( "  %s: %.3f ms (P95 %.3f ms)", marker.Name.c_str(), marker.Time, marker.P95 );
+        }
+    }
+}
+
 void ShowStatistics( bool& bShowWindow )
 {
-    static Core::Statistic<double> cpuStats;
+    static Core::Statistic<double> cpuStats( 1024, Core::StatisticMode::Window );
     static HighResolutionTimer timer;
     static double accumulatedTime = 0.0;
     static double averageTime = 0.0;
@@ -2898,6 +4338,95 @@ void ShowStatistics( bool& bShowWindow )
             sprintf_s( overlayBuffer, "Average: %08.5f ms", averageTime * 1000.0 );
 
             PlotStats( cpuStats, overlayBuffer, 0.0f, 33.33f, ImVec2( 0, 80) );
+            ShowPercentiles( cpuStats );
+
+            if ( ImGui::CollapsingHeader( "Frame Pacing" ) )
+            {
+                ShowFramePacing();
+            }
+
+            if ( ImGui::CollapsingHeader( "Light Culling" ) )
+            {
+                ShowLightCullingMetrics();
+            }
+
+            if ( g_Scene && !g_IsLoading )
+            {
+                static glm::mat4 meshletCullingViewMatrix( 0.0f );
+                static MeshletCullingStatistics meshletCullingStats;
+
+                // Only update the meshlet culling statistics when the camera pose changes.
+                if ( g_Camera->GetViewMatrix() != meshletCullingViewMatrix )
+                {
+                    MeshletCullingVisitor meshletCullingVisitor( *g_Camera );
+                    g_Scene->Accept( meshletCullingVisitor );
+
+                    meshletCullingStats = meshletCullingVisitor.GetStatistics();
+                    meshletCullingViewMatrix = g_Camera->GetViewMatrix();
+                }
+
+                const MeshletCullingStatistics& stats = meshletCullingStats;
+                float trianglesCulled = stats.NumTriangles > 0 ? 100.0f * stats.NumTrianglesCulled / stats.NumTriangles : 0.0f;
+
+                ImGui::Separator();
+                ImGui::Text( "Meshlets: %u (Frustum culled: %u, Back face culled: %u)", stats.NumMeshlets, stats.NumFrustumCulled, stats.NumBackfaceCulled );
+                ImGui::Text( "Triangles culled: %u / %u (%.2f%%)", stats.NumTrianglesCulled, stats.NumTriangles, trianglesCulled );
+
+                static glm::mat4 lodStatisticsViewMatrix( 0.0f );
+                static float lodStatisticsPixelError = -1.0f;
+                static uint64_t numTriangles = 0;
+                static uint64_t numLODTriangles = 0;
+
+                // Only update the level of detail statistics when the camera pose or the pixel error changes.
+                if ( g_Camera->GetViewMatrix() != lodStatisticsViewMatrix || g_LODPixelError != lodStatisticsPixelError )
+                {
+                    LODStatisticsVisitor lodStatisticsVisitor( *g_Camera, g_LODPixelError );
+                    g_Scene->Accept( lodStatisticsVisitor );
+
+                    numTriangles = lodStatisticsVisitor.GetNumTriangles();
+                    numLODTriangles = lodStatisticsVisitor.GetNumLODTriangles();
+                    lodStatisticsViewMatrix = g_Camera->GetViewMatrix();
+                    lodStatisticsPixelError = g_LODPixelError;
+                }
+
+                ImGui::Text( "LOD triangles: %llu / %llu", numLODTriangles, numTriangles );
+
+                if ( const SceneMeshList* meshList = g_Scene->GetMeshList() )
+                {
+                    SceneMeshList::CullingStatistics cullingStats = meshList->GetCullingStatistics();
+                    if ( cullingStats.NumCulls > 0 )
+                    {
+                        float meshesVisible = cullingStats.NumMeshes > 0 ? 100.0f * cullingStats.NumVisibleMeshes / cullingStats.NumMeshes : 0.0f;
+                        ImGui::Text( "Meshes visible: %llu / %llu (%.2f%%) over %u passes", cullingStats.NumVisibleMeshes, cullingStats.NumMeshes, meshesVisible, cullingStats.NumCulls );
+                    }
+
+                    SceneMeshList::DrawStatistics drawStats = meshList->GetDrawStatistics();
+                    ImGui::Text( "Draws: %u (%u merged into %u instanced draws)", drawStats.NumDraws, drawStats.NumMergedDraws, drawStats.NumInstancedDraws );
+                    ImGui::Text( "Binds avoided: object %u / %u, material %u / %u, buffers %u / %u",
+                                 drawStats.NumObjectBindsAvoided, drawStats.NumObjectBinds + drawStats.NumObjectBindsAvoided,
+                                 drawStats.NumMaterialBindsAvoided, drawStats.NumMaterialBinds + drawStats.NumMaterialBindsAvoided,
+                                 drawStats.NumBufferBindsAvoided, drawStats.NumBufferBinds + drawStats.NumBufferBindsAvoided );
+                    ImGui::Text( "Object buffer: %u uploads, %u reuses", drawStats.NumObjectBufferUploads, drawStats.NumObjectBufferReuses );
+                    ImGui::Text( "Meshlets culled: %u (%u triangles)", drawStats.NumMeshletsCulled, drawStats.NumMeshletTrianglesCulled );
+                }
+
+                SceneStreamingStatistics streamingStats = g_Scene->GetStreamingStatistics();
+                if ( !streamingStats.IsComplete )
+                {
+                    ImGui::Separator();
+                    ImGui::Text( "Streaming meshes: %u / %u, textures: %u / %u", streamingStats.NumMeshesLoaded, streamingStats.NumMeshes, streamingStats.NumTexturesLoaded, streamingStats.NumTextures );
+                    ImGui::ProgressBar( ( streamingStats.NumMeshesLoaded + streamingStats.NumTexturesLoaded ) / (float)std::max( streamingStats.NumMeshes + streamingStats.NumTextures, 1u ), ImVec2( -1, 0 ) );
+                }
+                ImGui::Text( "Time to first frame: %.2f s", g_TimeToFirstFrame );
+                if ( g_TimeToInteractive >= 0.0f )
+                {
+                    ImGui::Text( "Time to interactive: %.2f s", g_TimeToInteractive );
+                }
+                if ( g_TimeToComplete >= 0.0f )
+                {
+                    ImGui::Text( "Time to complete: %.2f s", g_TimeToComplete );
+                }
+            }
         }
         ImGui::End();
     }
@@ -3012,6 +4541,9 @@ void ShowProfiler( bool& bShowWindow )
             ClearProfilingData();
         }
 
+        // The profile nodes are updated on the aggregation thread.
+        auto profilerLock = profiler.Lock();
+
         if ( g_SelectedProfileMarker )
         {
             const Core::Statistic<double>* pStats = nullptr;
@@ -3031,6 +4563,7 @@ void ShowProfiler( bool& bShowWindow )
             }
 
             PlotStats( *pStats, g_SelectedProfileMarker->Name, 0.0f, 33.33f, ImVec2( 0, 100 ) );
+            ShowPercentiles( *pStats );
             ImGui::PopStyleColor( 2 );
         }
         else
@@ -3147,6 +4680,25 @@ void ShowGenerateLightsWindow( bool& bShowWindow )
             g_Config.MinRange = g_Config.MaxRange - (g_Config.MaxRange * 0.1f);
         }
 
+        ImGui::Combo( "Distribution", reinterpret_cast<int*>( &g_Config.LightsDistribution ), LightDistributionName, static_cast<int>( LightDistribution::NumDistributions ) );
+        ImGui::SameLine(); ShowHelpMarker( "Surface places the lights on the surfaces of the scene." );
+
+        int seed = static_cast<int>( g_Config.LightsSeed );
+        if ( ImGui::InputInt( "Seed", &seed ) )
+        {
+            g_Config.LightsSeed = static_cast<uint32_t>( seed );
+        }
+
+        if ( g_Config.LightsDistribution == LightDistribution::Clustered )
+        {
+            int numClusters = static_cast<int>( g_Config.NumLightClusters );
+            if ( ImGui::DragInt( "Num Clusters", &numClusters, 1, 1, INT_MAX ) )
+            {
+                g_Config.NumLightClusters = glm::clamp<uint32_t>( numClusters, 1, INT_MAX );
+            }
+            ImGui::DragFloat( "Cluster Radius", &g_Config.LightClusterRadius, 0.001f, 0.001f, 1.0f );
+        }
+
 
         if ( ImGui::Button( "Generate Lights" ) )
         {
@@ -3157,6 +4709,93 @@ void ShowGenerateLightsWindow( bool& bShowWindow )
     ImGui::End();
 }
 
+void SaveResourceMemoryReport()
+{
+    std::wstring resolution = L"@ " + std::to_wstring( g_WindowWidth ) + L"x" + std::to_wstring( g_WindowHeight );
+
+    std::wstring fileName = g_RenderDevice->GetResourceRegistry().SaveReport( L"../Perf", resolution );
+    if ( !fileName.empty() )
+    {
+        Notify( ConvertString( fileName + L" saved." ) );
+    }
+}
+
+void ShowResourceMemory( bool& bShowWindow )
+{
+    const double MB = 1024.0 * 1024.0;
+
+    if ( ImGui::Begin( "Resource Memory", &bShowWindow, ImVec2( 600, 500 ) ) )
+    {
+        ResourceRegistry& registry = g_RenderDevice->GetResourceRegistry();
+
+        ResourceMemoryUsage totalUsage = registry.GetTotalUsage();
+        ImGui::Text( "%llu resources: %.2f MB (peak %.2f MB)", totalUsage.NumResources, totalUsage.Size / MB, totalUsage.PeakSize / MB );
+        ImGui::Text( "Created: %llu, released: %llu", registry.GetNumAllocationsAdded(), registry.GetNumAllocationsRemoved() );
+        if ( ImGui::Button( "Save Report" ) )
+        {
+            SaveResourceMemoryReport();
+        }
+
+        if ( ImGui::CollapsingHeader( "Categories" ) )
+        {
+            for ( int i = 0; i < static_cast<int>( ResourceCategory::NumCategories ); ++i )
+            {
+                ResourceCategory category = static_cast<ResourceCategory>( i );
+                ResourceMemoryUsage usage = registry.GetCategoryUsage( category );
+                ImGui::Text( "%-16s %5llu %10.2f MB (peak %.2f MB)", GetResourceCategoryName( category ), usage.NumResources, usage.Size / MB, usage.PeakSize / MB );
+            }
+        }
+
+        if ( ImGui::CollapsingHeader( "Groups" ) )
+        {
+            for ( auto& group : registry.GetGroupUsage() )
+            {
+                std::string groupName = group.first.empty() ? "Other" : ConvertString( group.first );
+                ImGui::Text( "%-16s %5llu %10.2f MB (peak %.2f MB)", groupName.c_str(), group.second.NumResources, group.second.Size / MB, group.second.PeakSize / MB );
+            }
+        }
+
+        if ( ImGui::CollapsingHeader( "Resources" ) )
+        {
+            std::vector<ResourceAllocation> allocations = registry.GetAllocations();
+            std::sort( allocations.begin(), allocations.end(), []( const ResourceAllocation& a, const ResourceAllocation& b )
+            {
+                return a.Size > b.Size;
+            } );
+
+            auto now = std::chrono::steady_clock::now();
+
+            ImGui::Columns( 5 );
+            ImGui::Separator();
+            ImGui::Text( "Name" ); ImGui::NextColumn();
+            ImGui::Text( "Group" ); ImGui::NextColumn();
+            ImGui::Text( "Category" ); ImGui::NextColumn();
+            ImGui::Text( "Size (MB)" ); ImGui::NextColumn();
+            ImGui::Text( "Age (s)" ); ImGui::NextColumn();
+            ImGui::Separator();
+
+            // Only show the largest resources.
+            const size_t maxResourcesShown = 100;
+            for ( size_t i = 0; i < std::min( allocations.size(), maxResourcesShown ); ++i )
+            {
+                const ResourceAllocation& allocation = allocations[i];
+                std::string name = allocation.Name.empty() ? "<unnamed>" : ConvertString( allocation.Name );
+                std::string group = ConvertString( allocation.Group );
+
+                ImGui::Text( "%s", name.c_str() ); ImGui::NextColumn();
+                ImGui::Text( "%s", group.c_str() ); ImGui::NextColumn();
+                ImGui::Text( "%s", GetResourceCategoryName( allocation.Category ) ); ImGui::NextColumn();
+                ImGui::Text( "%.3f", allocation.Size / MB ); ImGui::NextColumn();
+                ImGui::Text( "%.1f", std::chrono::duration<double>( now - allocation.CreationTime ).count() ); ImGui::NextColumn();
+            }
+
+            ImGui::Columns( 1 );
+            ImGui::Separator();
+        }
+    }
+    ImGui::End();
+}
+
 void ShowOptionsWindow( bool& bShowWindow )
 {
     static bool showTestWindow = false;
@@ -3184,6 +4823,7 @@ void ShowOptionsWindow( bool& bShowWindow )
         ImGui::Checkbox( "Update Clusters", &g_UpdateUniqueClusters ); ImGui::SameLine(); ImGui::TextDisabled( "Shift+F" );
         ImGui::Checkbox( "Animate Lights", &g_Animate ); ImGui::SameLine(); ImGui::TextDisabled( "Space" );
         ImGui::Checkbox( "Invert Y", &g_InvertY); ImGui::SameLine(); ImGui::TextDisabled( "Y" );
+        ImGui::SliderFloat( "LOD Pixel Error", &g_LODPixelError, 0.0f, 10.0f ); ImGui::SameLine(); ImGui::TextDisabled( "Ctrl+Shift+L" );
     }
     ImGui::End();
 
@@ -3479,6 +5119,34 @@ void ShowMainMenu( bool& bShowMenu )
             {
                 SavePerformanceData();
             }
+            if ( ImGui::MenuItem( "Capture Timeline", "Ctrl+Shift+C" ) )
+            {
+                CaptureTimeline();
+            }
+            if ( ImGui::MenuItem( "Save Hitches", "Ctrl+Shift+H" ) )
+            {
+                SaveHitches();
+            }
+            if ( ImGui::MenuItem( "Save Resource Memory" ) )
+            {
+                SaveResourceMemoryReport();
+            }
+            if ( ImGui::MenuItem( "Benchmark Transforms", "Ctrl+Shift+T" ) )
+            {
+                BenchmarkTransformHierarchy();
+            }
+            if ( ImGui::MenuItem( "Benchmark Picking", "Ctrl+Shift+B" ) )
+            {
+                BenchmarkPicking();
+            }
+            if ( ImGui::MenuItem( "Benchmark Light Sets", "Ctrl+Shift+K" ) )
+            {
+                BenchmarkLightSets();
+            }
+            if ( ImGui::MenuItem( "Benchmark Profiler Markers", "Ctrl+Shift+P" ) )
+            {
+                BenchmarkProfilerMarkers();
+            }
             if ( ImGui::MenuItem( "Quit", "Alt+F4" ) )
             {
                 g_Application.Stop();
@@ -3493,6 +5161,7 @@ void ShowMainMenu( bool& bShowMenu )
             ImGui::MenuItem( "Generate Lights", "Ctrl+3", &g_ShowGenerateLights );
             ImGui::MenuItem( "Lights Editor", "Ctrl+4", &g_ShowLightsHierarchy );
             ImGui::MenuItem( "Options", "Ctrl+5", &g_ShowOptionsWindow );
+            ImGui::MenuItem( "Resource Memory", "Ctrl+6", &g_ShowResourceMemory );
 
             ImGui::EndMenu();
         }
@@ -3551,6 +5220,10 @@ void OnGUI( RenderEventArgs& e )
     {
         ShowOptionsWindow( g_ShowOptionsWindow );
     }
+    if ( g_ShowResourceMemory )
+    {
+        ShowResourceMemory( g_ShowResourceMemory );
+    }
     if ( g_ShowNotification )
     {
         ShowNotification( g_ShowNotification );